@@ -11,17 +11,28 @@ layout(location=0) in vec3 vPosition;
 layout(location=1) in vec3 vNormal;
 layout(location=2) in vec2 inUVCoordinates;
 
+// Per instance matrices (instanced drawing only).
+layout(location=3) in mat4 instanceMVPMatrix;
+layout(location=7) in mat3 instanceNormalMatrix;
+
 uniform mat4 mvpMatrix;
 uniform mat3 normalMatrix;
 
+uniform bool instancingEnabled;
+
 out vec3 normal;
 out vec2 uvCoordinates;
 
 void main()
 {
 	// Transform vertex position and normal.
-	gl_Position = mvpMatrix * vec4( vPosition.xyz, 1.0f );
-	normal = normalize( normalMatrix * vNormal );
+	if( instancingEnabled ){
+		gl_Position = instanceMVPMatrix * vec4( vPosition.xyz, 1.0f );
+		normal = normalize( instanceNormalMatrix * vNormal );
+	}else{
+		gl_Position = mvpMatrix * vec4( vPosition.xyz, 1.0f );
+		normal = normalize( normalMatrix * vNormal );
+	}
 
 	uvCoordinates = inUVCoordinates;
 }
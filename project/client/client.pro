@@ -134,7 +134,10 @@ HEADERS += \
     ../../src/client/models/3d/auxiliar_lines_renderer.hpp \
     ../../src/client/gui/application.hpp \
     ../../src/client/managers/managers/primitives/system_primitives_factory.hpp \
-    ../../src/client/models/3d/materials/abstract_material.hpp
+    ../../src/client/models/3d/materials/abstract_material.hpp \
+    ../../src/client/models/3d/sets/entities_bvh.hpp \
+    ../../src/client/models/3d/view_frustum.hpp \
+    ../../src/client/models/3d/meshes/mesh_geometry.hpp
 
 
 # Client sources
@@ -221,4 +224,7 @@ SOURCES += \
     ../../src/client/managers/selections/cameras/local_cameras_selection.cpp \
     ../../src/client/models/3d/auxiliar_lines_renderer.cpp \
     ../../src/client/gui/application.cpp \
-    ../../src/client/managers/managers/primitives/system_primitives_factory.cpp
+    ../../src/client/managers/managers/primitives/system_primitives_factory.cpp \
+    ../../src/client/models/3d/sets/entities_bvh.cpp \
+    ../../src/client/models/3d/view_frustum.cpp \
+    ../../src/client/models/3d/meshes/mesh_geometry.cpp
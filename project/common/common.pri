@@ -7,7 +7,7 @@ INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD
 
 # Common libraries
-LIBS += -lpthread -lboost_system -lboost_thread -lboost_filesystem
+LIBS += -lpthread -lboost_system -lboost_thread -lboost_filesystem -lz
 
 INCLUDEPATH += ../../src
 
@@ -122,9 +122,32 @@ HEADERS += \
     ../../src/common/commands/entity_commands/entity_command.hpp \
     ../../src/common/commands/entity_commands/entity_commands.hpp \
     ../../src/common/commands/entity_commands/model_matrix_replacement_command.hpp \
+    ../../src/common/commands/file_commands/file_commands.hpp \
+    ../../src/common/commands/file_commands/file_chunk_command.hpp \
     ../../src/common/3d/plain_material_data.hpp \
     ../../src/common/3d/light_data.hpp \
-    ../../src/common/3d/texture_wall.hpp
+    ../../src/common/3d/texture_wall.hpp \
+    ../../src/common/commands/packed_command.hpp \
+    ../../src/common/packets/packed_scene_update_packet.hpp \
+    ../../src/common/utilities/append_only_log.hpp \
+    ../../src/common/packables/packable_var_uint32.hpp \
+    ../../src/common/utilities/mpsc_queue.hpp \
+    ../../src/common/packables/float_encoding.hpp \
+    ../../src/common/packables/packable_quantized_float.hpp \
+    ../../src/common/packables/packable_normalized_float.hpp \
+    ../../src/common/packables/packable_angle.hpp \
+    ../../src/common/utilities/compression.hpp \
+    ../../src/common/utilities/blob_store.hpp \
+    ../../src/common/packables/packable_blob_hashes.hpp \
+    ../../src/common/utilities/file_view.hpp \
+    ../../src/common/utilities/file_writer.hpp \
+    ../../src/common/primitives/primitive_data/primitive_file.hpp \
+    ../../src/common/utilities/text_parsing.hpp \
+    ../../src/common/primitives/polygon_triangulation.hpp \
+    ../../src/common/primitives/primitive_data/vertex_cache_optimization.hpp \
+    ../../src/common/primitives/primitive_data/mesh_simplification.hpp \
+    ../../src/common/primitives/primitive_data/mesh_bvh.hpp \
+    ../../src/common/utilities/sha1.hpp
 
 
 # Common sources (used by both client and server).
@@ -198,4 +221,23 @@ SOURCES += \
     ../../src/common/3d/transformable.cpp \
     ../../src/common/commands/entity_commands/entity_command.cpp \
     ../../src/common/commands/entity_commands/model_matrix_replacement_command.cpp \
-    ../../src/common/primitives/primitive_data/system_primitive_data.cpp
+    ../../src/common/commands/file_commands/file_chunk_command.cpp \
+    ../../src/common/primitives/primitive_data/system_primitive_data.cpp \
+    ../../src/common/commands/packed_command.cpp \
+    ../../src/common/packets/packed_scene_update_packet.cpp \
+    ../../src/common/packables/packable_var_uint32.cpp \
+    ../../src/common/packables/float_encoding.cpp \
+    ../../src/common/packables/packable_quantized_float.cpp \
+    ../../src/common/packables/packable_normalized_float.cpp \
+    ../../src/common/packables/packable_angle.cpp \
+    ../../src/common/utilities/compression.cpp \
+    ../../src/common/utilities/blob_store.cpp \
+    ../../src/common/packables/packable_blob_hashes.cpp \
+    ../../src/common/utilities/file_view.cpp \
+    ../../src/common/utilities/file_writer.cpp \
+    ../../src/common/primitives/primitive_data/primitive_file.cpp \
+    ../../src/common/primitives/polygon_triangulation.cpp \
+    ../../src/common/primitives/primitive_data/vertex_cache_optimization.cpp \
+    ../../src/common/primitives/primitive_data/mesh_simplification.cpp \
+    ../../src/common/primitives/primitive_data/mesh_bvh.cpp \
+    ../../src/common/utilities/sha1.cpp
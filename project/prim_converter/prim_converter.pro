@@ -0,0 +1,25 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+# Include files and parameters that are common to both client and server.
+include( ../common/common.pri )
+
+DESTDIR = .
+
+CONFIG( debug, debug|release ) {
+    TARGET = prim_converter_debug
+} else {
+    TARGET = prim_converter
+}
+message( Building target: $$TARGET )
+
+BUILD_DATA_DIR = $$DESTDIR/.build_data/$$TARGET
+OBJECTS_DIR = $$BUILD_DATA_DIR/obj
+
+INCLUDEPATH += ../../src
+
+# Converter sources
+SOURCES += \
+    ../../src/prim_converter/main.cpp
@@ -40,7 +40,8 @@ HEADERS += \
     ../../src/server/sync_data/texture_wall_sync_data.hpp \
     ../../src/server/sync_data/material_sync_data.hpp \
     ../../src/server/sync_data/camera_sync_data.hpp \
-    ../../src/server/sync_data/light_sync_data.hpp
+    ../../src/server/sync_data/light_sync_data.hpp \
+    ../../src/server/managers/primitives_import_cache.hpp
 
 # Server sources
 SOURCES += \
@@ -57,4 +58,5 @@ SOURCES += \
     ../../src/server/sync_data/texture_wall_sync_data.cpp \
     ../../src/server/sync_data/material_sync_data.cpp \
     ../../src/server/sync_data/camera_sync_data.cpp \
-    ../../src/server/sync_data/light_sync_data.cpp
+    ../../src/server/sync_data/light_sync_data.cpp \
+    ../../src/server/managers/primitives_import_cache.cpp
@@ -46,7 +46,8 @@ Viewport::Viewport( View view, Projection projection, std::shared_ptr< ComoApp >
     projection_( projection ),
     forceRender_( true ),
     lastMouseWorldPos_( 0.0f ),
-    camerasManager_( comoApp->getScene()->getEntitiesManager()->getCamerasManager() )
+    camerasManager_( comoApp->getScene()->getEntitiesManager()->getCamerasManager() ),
+    cullingStats_()
 {
     try {
         OpenGL::checkStatus( "Viewport constructor - begin" );
@@ -458,6 +459,12 @@ Projection Viewport::getProjection() const
 }
 
 
+CullingStats Viewport::getCullingStats() const
+{
+    return cullingStats_;
+}
+
+
 /***
  * 5. Updating and drawing
  ***/
@@ -503,7 +510,8 @@ void Viewport::render()
     currentCamera().sendToShader( *( comoApp->getScene()->getOpenGL() ) );
 
     // Draw scene.
-    comoApp->getScene()->draw( viewMatrix, projectionMatrix );
+    cullingStats_ = CullingStats();
+    comoApp->getScene()->draw( viewMatrix, projectionMatrix, cullingStats_ );
 
     // If use has selected objects, check if any guide rect must be drawn.
     if( comoApp->getScene()->getEntitiesManager()->getLocalSelection()->size() ){
@@ -112,6 +112,9 @@ class Viewport : public QWindow
 
         CamerasManager* camerasManager_;
 
+        // Entities drawn and culled in the last rendered frame.
+        CullingStats cullingStats_;
+
     public:
         /***
          * 1. Construction
@@ -145,6 +148,7 @@ class Viewport : public QWindow
          ***/
         View getView() const;
         Projection getProjection() const;
+        CullingStats getCullingStats() const;
 
 
         /***
@@ -94,6 +94,10 @@ void CamerasManager::createCamera( const ResourceID &cameraID,
         activeCamera_ = camera.get();
     }
 
+    if( entitiesBVH_ ){
+        camera->insertIntoBVH( entitiesBVH_, cameraID );
+    }
+
     resourcesSelections_.at( cameraID.getCreatorID() )->addResource( cameraID, std::move( camera ) );
 
     notifyObservers();
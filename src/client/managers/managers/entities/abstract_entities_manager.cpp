@@ -12,7 +12,18 @@ AbstractEntitiesManager::AbstractEntitiesManager( ServerInterfacePtr server ) :
 
 
 /***
- * 4. Selecting
+ * 4. Setters
+ ***/
+
+void AbstractEntitiesManager::setEntitiesBVH( EntitiesBVHPtr entitiesBVH )
+{
+    LOCK
+    entitiesBVH_ = entitiesBVH;
+}
+
+
+/***
+ * 5. Selecting
  ***/
 
 ResourceID AbstractEntitiesManager::selectEntityByRayPicking(glm::vec3 rayOrigin, glm::vec3 rayDirection, bool addToSelection, float &t, const float &MAX_T)
@@ -22,6 +22,8 @@
 #include <client/managers/managers/resources/resource_commands_executer.hpp>
 #include <client/models/3d/sets/drawables_set.hpp>
 #include <client/models/3d/sets/pickables_set.hpp>
+#include <client/models/3d/sets/entities_bvh.hpp>
+#include <client/models/3d/view_frustum.hpp>
 
 namespace como {
 
@@ -56,22 +58,49 @@ class AbstractEntitiesManager : public virtual ResourceCommandsExecuter, public
 
 
         /***
-         * 4. Selecting
+         * 4. Setters
+         ***/
+        /*!
+         * \brief Sets the scene BVH the entities created by this manager
+         * are inserted in.
+         */
+        void setEntitiesBVH( EntitiesBVHPtr entitiesBVH );
+
+
+        /***
+         * 5. Selecting
          ***/
         virtual ResourceID selectEntityByRayPicking( glm::vec3 rayOrigin, glm::vec3 rayDirection, bool addToSelection, float& t, const float& MAX_T = FLT_MAX );
 
 
         /***
-         * 5. Drawing
+         * 6. Intersections
+         ***/
+        /*!
+         * \brief Intersects the given ray with the given entity, provided
+         * it belongs to this manager and it's pickable (not selected by any
+         * user).
+         * \return true if the entity was intersected, with the ray parameter
+         * of the intersection in t.
+         */
+        virtual bool intersectsEntity( const ResourceID& entityID, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t ) const = 0;
+
+
+        /***
+         * 7. Drawing
          ***/
-        virtual void drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const = 0;
+        virtual void drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const = 0;
 
 
         /***
-         * 6. Operators
+         * 8. Operators
          ***/
         AbstractEntitiesManager& operator = ( const AbstractEntitiesManager& ) = default;
         AbstractEntitiesManager& operator = ( AbstractEntitiesManager&& ) = default;
+
+
+    protected:
+        EntitiesBVHPtr entitiesBVH_;
 };
 
 } // namespace como
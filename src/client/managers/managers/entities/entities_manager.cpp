@@ -37,6 +37,12 @@ EntitiesManager::EntitiesManager( ServerInterfacePtr server, LogPtr log, OpenGL*
     managers_.push_back( meshesManager_.get() );
     managers_.push_back( camerasManager_.get() );
 
+    // Scene BVH all the entities are inserted in.
+    entitiesBVH_ = EntitiesBVHPtr( new EntitiesBVH );
+    for( const auto& manager : managers_ ){
+        manager->setEntitiesBVH( entitiesBVH_ );
+    }
+
     entitiesSelections_[NO_USER] =
             std::unique_ptr<EntitiesSelection>( new EntitiesSelection(
                                                     lightsManager_->getResourcesSelection( NO_USER ),
@@ -146,18 +152,56 @@ bool EntitiesManager::pick(const glm::vec3 &rayOrigin, glm::vec3 rayDirection, R
 {
     LOCK
 
-    unsigned int nIntersectedManagers = 0;
-    float maxT = MAX_T;
+    std::vector< EntitiesBVHRayHit > candidates;
+    bool entityPicked = false;
+    float entityT;
+
+    t = MAX_T;
+
+    // Only intersect the entities whose bounds are crossed by the ray,
+    // from the nearest to the farthest one.
+    entitiesBVH_->intersectRay( rayOrigin, rayDirection, MAX_T, candidates );
+    for( const EntitiesBVHRayHit& candidate : candidates ){
+        if( candidate.t > t ){
+            break;
+        }
+
+        if( intersectsEntity( candidate.entityID, rayOrigin, rayDirection, entityT ) &&
+            ( entityT < t ) ){
+            pickedElement = candidate.entityID;
+            t = entityT;
+            entityPicked = true;
+        }
+    }
+
+    return entityPicked;
+}
+
+
+bool EntitiesManager::intersectsEntity( const ResourceID& entityID, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t ) const
+{
+    LOCK
 
     for( const auto& manager : managers_ ){
-        if( manager->pick( rayOrigin, rayDirection, pickedElement, t, maxT ) ){
-            nIntersectedManagers++;
+        if( manager->intersectsEntity( entityID, rayOrigin, rayDirection, t ) ){
+            return true;
         }
-        // Force the following manager to find a closer element.
-        maxT = t;
     }
+    return false;
+}
+
 
-    return (nIntersectedManagers > 0);
+void EntitiesManager::getEntitiesInBox( const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector< ResourceID >& entities ) const
+{
+    LOCK
+    entitiesBVH_->queryBox( boxMin, boxMax, entities );
+}
+
+
+void EntitiesManager::getEntitiesInFrustum( const glm::mat4& viewProjectionMatrix, std::vector< ResourceID >& entities ) const
+{
+    LOCK
+    entitiesBVH_->queryFrustum( viewProjectionMatrix, entities );
 }
 
 
@@ -223,13 +267,13 @@ void EntitiesManager::executeRemoteEntityCommand( const EntityCommand &command )
  * 7. Drawing
  ***/
 
-void EntitiesManager::drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const
+void EntitiesManager::drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const
 {
     LOCK
     lightsManager_->sendLightsToShader( *openGL, viewMatrix );
 
     for( const auto& manager : managers_ ){
-        manager->drawAll( openGL, viewMatrix, projectionMatrix );
+        manager->drawAll( openGL, viewMatrix, projectionMatrix, cullingStats );
     }
 }
 
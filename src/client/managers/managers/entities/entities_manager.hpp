@@ -69,6 +69,19 @@ class EntitiesManager : public AbstractEntitiesManager, public ContainerObserver
          * 5. Entity picking
          ***/
         virtual bool pick( const glm::vec3 &rayOrigin, glm::vec3 rayDirection, ResourceID &pickedElement, float &t, const float &MAX_T = FLT_MAX ) const;
+        virtual bool intersectsEntity( const ResourceID& entityID, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t ) const;
+
+        /*!
+         * \brief Gets the entities whose world bounds overlap the given box.
+         */
+        void getEntitiesInBox( const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector< ResourceID >& entities ) const;
+
+        /*!
+         * \brief Gets the entities whose world bounds are, at least
+         * partially, inside the frustum given by a view-projection matrix
+         * (i.e. the one of a selection rectangle).
+         */
+        void getEntitiesInFrustum( const glm::mat4& viewProjectionMatrix, std::vector< ResourceID >& entities ) const;
 
 
         /***
@@ -81,7 +94,7 @@ class EntitiesManager : public AbstractEntitiesManager, public ContainerObserver
         /***
          * 7. Drawing
          ***/
-        void drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const;
+        void drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const;
 
 
         /***
@@ -56,12 +56,13 @@ class SpecializedEntitiesManager : public AbstractEntitiesManager, public Resour
          * 4. Entities picking
          ***/
         virtual bool pick( const glm::vec3 &rayOrigin, glm::vec3 rayDirection, ResourceID &closestObject, float &t, const float &MAX_T = FLT_MAX ) const;
+        virtual bool intersectsEntity( const ResourceID& entityID, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t ) const;
 
 
         /***
          * 5. Drawing
          ***/
-        void drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const;
+        void drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const;
 
 
         /***
@@ -124,16 +125,26 @@ bool SpecializedEntitiesManager<ResourceType, ResourcesSelectionType, LocalResou
 }
 
 
+template <class ResourceType, class ResourcesSelectionType, class LocalResourcesSelectionType>
+bool SpecializedEntitiesManager<ResourceType, ResourcesSelectionType, LocalResourcesSelectionType>::intersectsEntity( const ResourceID& entityID, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t ) const
+{
+    LOCK
+
+    // Only non selected entities can be picked.
+    return this->getResourcesSelection( NO_USER )->intersectsRay( entityID, rayOrigin, rayDirection, t );
+}
+
+
 /***
  * 4. Drawing
  ***/
 
 template <class ResourceType, class ResourcesSelectionType, class LocalResourcesSelectionType>
-void SpecializedEntitiesManager<ResourceType, ResourcesSelectionType, LocalResourcesSelectionType>::drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const
+void SpecializedEntitiesManager<ResourceType, ResourcesSelectionType, LocalResourcesSelectionType>::drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const
 {
     LOCK
     for( const auto& entitiesSelectionPair : this->resourcesSelections_ ){
-        entitiesSelectionPair.second->drawAll( openGL, viewMatrix, projectionMatrix );
+        entitiesSelectionPair.second->drawAll( openGL, viewMatrix, projectionMatrix, cullingStats );
     }
 }
 
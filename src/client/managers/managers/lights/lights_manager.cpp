@@ -147,6 +147,9 @@ void LightsManager::addDirectionalLight( const ResourceID& lightID, const Color&
 
     std::unique_ptr< DirectionalLight >
             light( new DirectionalLight( lightID, lightColor, glm::vec3( 0.0f, -1.0f, 0.0f ), *openGL_ ) );
+    if( entitiesBVH_ ){
+        light->insertIntoBVH( entitiesBVH_, lightID );
+    }
 
     getResourcesSelection( NO_USER )->addResource( lightID, std::move( light ) );
 
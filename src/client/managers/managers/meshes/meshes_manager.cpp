@@ -144,6 +144,25 @@ glm::vec3 MeshesManager::createMesh( const ImportedPrimitiveData& primitiveData,
 }
 
 
+glm::vec3 MeshesManager::createMesh( const ResourceID& primitiveID, const ImportedPrimitiveData& primitiveData, const ResourceID& meshID, const ResourceID& firstMaterialID )
+{
+    LOCK
+    MeshGeometryPtr geometry = primitivesGeometries_[primitiveID].lock();
+
+    if( !geometry ){
+        geometry = MeshGeometryPtr( new MeshGeometry( primitiveData ) );
+        primitivesGeometries_[primitiveID] = geometry;
+    }
+
+    std::unique_ptr< Mesh > mesh( new ImportedMesh( meshID, firstMaterialID, primitiveData, geometry, *materialsManager_ ) );
+    glm::vec3 meshCentroid = mesh->getOriginalCentroid();
+
+    addMesh( std::move( mesh ), meshID );
+
+    return meshCentroid;
+}
+
+
 ResourceID MeshesManager::addMesh( MeshPtr mesh )
 {
     LOCK
@@ -160,6 +179,9 @@ void MeshesManager::addMesh( MeshPtr mesh, const ResourceID& meshID )
     LOCK
 
     mesh->displayVertexNormals( newMeshesDisplayVertexNormals_ );
+    if( entitiesBVH_ ){
+        mesh->insertIntoBVH( entitiesBVH_, meshID );
+    }
 
     // FIXME: Meshes are initially unselected because when loading an Scene
     // from file and then synchronizing them on the client, the created
@@ -82,6 +82,13 @@ class MeshesManager : public SpecializedEntitiesManager< Mesh, MeshesSelection,
         ResourceID createMesh( const ImportedPrimitiveData& primitiveData );
         glm::vec3 createMesh( const ImportedPrimitiveData& primitiveData, const ResourceID& meshID, const ResourceID& firstMaterialID );
 
+        /*!
+         * \brief Creates a mesh from the given primitive, sharing its
+         * geometry with the rest of meshes created from the same primitive.
+         * \return the centroid of the created mesh.
+         */
+        glm::vec3 createMesh( const ResourceID& primitiveID, const ImportedPrimitiveData& primitiveData, const ResourceID& meshID, const ResourceID& firstMaterialID );
+
         ResourceID addMesh( MeshPtr mesh );
         void addMesh( MeshPtr mesh, const ResourceID& meshID );
 
@@ -107,6 +114,10 @@ class MeshesManager : public SpecializedEntitiesManager< Mesh, MeshesSelection,
         TextureWallsManager *textureWallsManager_;
 
         bool newMeshesDisplayVertexNormals_;
+
+        // Geometries of the instantiated primitives, shared by all the
+        // meshes created from each primitive while any of them exists.
+        std::map< ResourceID, std::weak_ptr< MeshGeometry > > primitivesGeometries_;
 };
 
 } // namespace como
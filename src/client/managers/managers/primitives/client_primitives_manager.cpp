@@ -66,7 +66,7 @@ void ClientPrimitivesManager::instantiatePrimitive( ResourceID primitiveID )
     const ResourceID meshID = server_->reserveResourceIDs( 1 );
     const ResourceID firstMaterialID = server_->reserveResourceIDs( primitiveData.materialsInfo_.size() );
 
-    glm::vec3 meshCentroid = meshesManager_->createMesh( primitiveData, meshID, firstMaterialID );
+    glm::vec3 meshCentroid = meshesManager_->createMesh( primitiveID, primitiveData, meshID, firstMaterialID );
 
     // Send the command to the server.
     server_->sendCommand(
@@ -172,7 +172,7 @@ void ClientPrimitivesManager::instantiatePrimitive( UserID userID, ResourceID pr
 
     primitiveData.importFromFile( getPrimitiveFilePath( primitiveID ) );
 
-    meshesManager_->createMesh( primitiveData, meshID, firstMaterialID );
+    meshesManager_->createMesh( primitiveID, primitiveData, meshID, firstMaterialID );
 }
 
 } // namespace como
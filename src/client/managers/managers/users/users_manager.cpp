@@ -17,6 +17,7 @@
 ***/
 
 #include "users_manager.hpp"
+#include <common/packables/packable_file.hpp>
 
 namespace como {
 
@@ -85,6 +86,9 @@ void UsersManager::removeUser( UserID userID )
 {
     users_.erase( userID );
 
+    // Discard the files the user didn't finish streaming.
+    PackableFile::discardFileStreams( userID );
+
     notifyElementDeletion( userID );
 }
 
@@ -36,8 +36,8 @@ Scene::Scene( const char* host, const char* port, const char* userName, LogPtr l
 
         // Signal / slot: when a command is received from server, execute it on
         // the local scene.
-        qRegisterMetaType< std::shared_ptr< const Command > >( "std::shared_ptr< const Command >" );
-        QObject::connect( server_.get(), &ServerInterface::commandReceived, this, &Scene::executeRemoteCommand );
+        qRegisterMetaType< std::shared_ptr< const CommandsList > >( "std::shared_ptr< const CommandsList >" );
+        QObject::connect( server_.get(), &ServerInterface::commandsReceived, this, &Scene::executeRemoteCommands );
         log_->debug( "Remote command execution signal connected\n" );
 
         initOpenGL();
@@ -171,7 +171,7 @@ void Scene::setBackgroundColor( const GLfloat& r, const GLfloat& g, const GLfloa
  * 5. Drawing
  ***/
 
-void Scene::draw( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const
+void Scene::draw( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const
 {
     LOCK
 
@@ -179,7 +179,7 @@ void Scene::draw( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix
     setBackgroundColor( 0.9f, 0.9f, 0.9f, 1.0f );
 
     // Draw all the entities.
-    entitiesManager_->drawAll( openGL_, viewMatrix, projectionMatrix );
+    entitiesManager_->drawAll( openGL_, viewMatrix, projectionMatrix, cullingStats );
 }
 
 
@@ -208,59 +208,13 @@ void Scene::update()
  * 9. Slots
  ***/
 
-void Scene::executeRemoteCommand( std::shared_ptr< const Command > command )
+void Scene::executeRemoteCommands( std::shared_ptr< const CommandsList > commands )
 {
     LOCK
 
-    log_->debug( "Scene - Executing remote command(",
-                 commandTargetStrings[static_cast<unsigned int>( command->getTarget() )],
-                 ") ...\n" );
-
-    switch( command->getTarget() ){
-        case CommandTarget::USER:
-            usersManager_->executeRemoteCommand( dynamic_cast< const UserCommand& >( *command ) );
-        break;
-        case CommandTarget::SELECTION:
-            entitiesManager_->executeRemoteSelectionCommand( dynamic_cast< const SelectionCommand& >( *command ) );
-        break;
-        case CommandTarget::PRIMITIVE:
-            primitivesManager_->executeRemoteCommand( dynamic_cast< const PrimitiveCommand& >( *command ) );
-        break;
-        case CommandTarget::PRIMITIVE_CATEGORY:
-            primitivesManager_->executeRemoteCommand( dynamic_cast< const PrimitiveCategoryCommand& >( *command ) );
-        break;
-        case CommandTarget::MATERIAL:
-            materialsManager_->executeRemoteCommand( dynamic_cast< const MaterialCommand& >( *command ) );
-        break;
-        case CommandTarget::LIGHT:
-            entitiesManager_->getLightsManager()->executeRemoteCommand( dynamic_cast< const LightCommand& >( *command ) );
-        break;
-        case CommandTarget::RESOURCE:{
-            entitiesManager_->executeResourceCommand( dynamic_cast< const ResourceCommand& >( *command ) );
-        }break;
-        case CommandTarget::RESOURCES_SELECTION:{
-            entitiesManager_->executeResourcesSelectionCommand( dynamic_cast< const ResourcesSelectionCommand& >( *command ) );
-        }break;
-        case CommandTarget::GEOMETRIC_PRIMITIVE:{
-            systemPrimitivesFactory_->executeRemoteCommand( dynamic_cast< const SystemPrimitiveCommand& >( *command ) );
-        }break;
-        case CommandTarget::TEXTURE:
-            texturesManager_->executeRemoteCommand( dynamic_cast< const TextureCommand& >( *command ) );
-        break;
-        case CommandTarget::TEXTURE_WALL:
-            textureWallsManager_->executeRemoteCommand( dynamic_cast< const TextureWallCommand& >( *command ) );
-        break;
-        case CommandTarget::CAMERA:
-            entitiesManager_->getCamerasManager()->executeRemoteCommand( dynamic_cast< const CameraCommand& >( *command ) );
-        break;
-        case CommandTarget::ENTITY:
-            entitiesManager_->executeRemoteEntityCommand( dynamic_cast< const EntityCommand& >( *command ) );
-        break;
+    for( const auto& command : *commands ){
+        executeRemoteCommand( *command );
     }
-
-    log_->debug( "Scene - Executing remote command(",
-                 commandTargetStrings[static_cast<unsigned int>( command->getTarget() )],
-                 ") ...OK\n" );
 }
 
 
@@ -343,4 +297,66 @@ void Scene::initManagers( const UserAcceptancePacket& userAcceptancePacket )
     }
 }
 
+
+/***
+ * 11. Remote commands execution
+ ***/
+
+void Scene::executeRemoteCommand( const Command& command )
+{
+    log_->debug( "Scene - Executing remote command(",
+                 commandTargetStrings[static_cast<unsigned int>( command.getTarget() )],
+                 ") ...\n" );
+
+    switch( command.getTarget() ){
+        case CommandTarget::USER:
+            usersManager_->executeRemoteCommand( dynamic_cast< const UserCommand& >( command ) );
+        break;
+        case CommandTarget::SELECTION:
+            entitiesManager_->executeRemoteSelectionCommand( dynamic_cast< const SelectionCommand& >( command ) );
+        break;
+        case CommandTarget::PRIMITIVE:
+            primitivesManager_->executeRemoteCommand( dynamic_cast< const PrimitiveCommand& >( command ) );
+        break;
+        case CommandTarget::PRIMITIVE_CATEGORY:
+            primitivesManager_->executeRemoteCommand( dynamic_cast< const PrimitiveCategoryCommand& >( command ) );
+        break;
+        case CommandTarget::MATERIAL:
+            materialsManager_->executeRemoteCommand( dynamic_cast< const MaterialCommand& >( command ) );
+        break;
+        case CommandTarget::LIGHT:
+            entitiesManager_->getLightsManager()->executeRemoteCommand( dynamic_cast< const LightCommand& >( command ) );
+        break;
+        case CommandTarget::RESOURCE:{
+            entitiesManager_->executeResourceCommand( dynamic_cast< const ResourceCommand& >( command ) );
+        }break;
+        case CommandTarget::RESOURCES_SELECTION:{
+            entitiesManager_->executeResourcesSelectionCommand( dynamic_cast< const ResourcesSelectionCommand& >( command ) );
+        }break;
+        case CommandTarget::GEOMETRIC_PRIMITIVE:{
+            systemPrimitivesFactory_->executeRemoteCommand( dynamic_cast< const SystemPrimitiveCommand& >( command ) );
+        }break;
+        case CommandTarget::TEXTURE:
+            texturesManager_->executeRemoteCommand( dynamic_cast< const TextureCommand& >( command ) );
+        break;
+        case CommandTarget::TEXTURE_WALL:
+            textureWallsManager_->executeRemoteCommand( dynamic_cast< const TextureWallCommand& >( command ) );
+        break;
+        case CommandTarget::CAMERA:
+            entitiesManager_->getCamerasManager()->executeRemoteCommand( dynamic_cast< const CameraCommand& >( command ) );
+        break;
+        case CommandTarget::ENTITY:
+            entitiesManager_->executeRemoteEntityCommand( dynamic_cast< const EntityCommand& >( command ) );
+        break;
+        case CommandTarget::FILE:
+            // File chunks are written to disk when unpacked, so there is
+            // nothing left to do here.
+        break;
+    }
+
+    log_->debug( "Scene - Executing remote command(",
+                 commandTargetStrings[static_cast<unsigned int>( command.getTarget() )],
+                 ") ...OK\n" );
+}
+
 } // namespace como
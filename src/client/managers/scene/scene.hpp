@@ -87,7 +87,7 @@ class Scene : public QOffscreenSurface, public BasicScene, public Observer, publ
         /***
          * 5. Drawing
          ***/
-        void draw( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const ;
+        void draw( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const ;
 
 
         /***
@@ -112,9 +112,9 @@ class Scene : public QOffscreenSurface, public BasicScene, public Observer, publ
         /***
          * 9. Slots
          ***/
-        // TODO: Pass command by reference. By now it must be passed using
-        // a std::shared_ptr because of Qt signal / slot mechanism.
-        void executeRemoteCommand( std::shared_ptr< const Command > command );
+        // The commands are passed using a std::shared_ptr because of Qt
+        // signal / slot mechanism.
+        void executeRemoteCommands( std::shared_ptr< const CommandsList > commands );
 
     private:
         /***
@@ -124,6 +124,12 @@ class Scene : public QOffscreenSurface, public BasicScene, public Observer, publ
         void initManagers( const UserAcceptancePacket& userAcceptancePacket );
 
 
+        /***
+         * 11. Remote commands execution
+         ***/
+        void executeRemoteCommand( const Command& command );
+
+
     private:
         // Users and resources managers.
         UsersManagerPtr usersManager_;
@@ -272,11 +272,11 @@ void EntitiesSelection::update()
  * 8. Drawing
  ***/
 
-void EntitiesSelection::drawAll( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix ) const
+void EntitiesSelection::drawAll( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix, CullingStats& cullingStats ) const
 {
     LOCK
     for( auto selection : specializedEntitiesSelections_ ){
-        selection->drawAll( openGL, viewMatrix, projectionMatrix );
+        selection->drawAll( openGL, viewMatrix, projectionMatrix, cullingStats );
     }
 }
 
@@ -94,7 +94,7 @@ class EntitiesSelection : public AbstractEntitiesSet, public Observer, public Lo
         /***
          * 8. Drawing
          ***/
-        virtual void drawAll(OpenGLPtr openGL, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix) const;
+        virtual void drawAll(OpenGLPtr openGL, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix, CullingStats& cullingStats ) const;
 
 
         /***
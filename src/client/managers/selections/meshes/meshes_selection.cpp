@@ -17,6 +17,7 @@
 ***/
 
 #include "meshes_selection.hpp"
+#include <client/models/3d/meshes/imported_mesh.hpp>
 
 namespace como {
 
@@ -125,4 +126,39 @@ void MeshesSelection::displayEdges( bool display )
 }
 
 
+/***
+ * 6. Drawing
+ ***/
+
+void MeshesSelection::drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const
+{
+    LOCK
+
+    std::vector< Mesh* > visibleMeshes;
+    std::map< const MeshGeometry*, std::vector< const ImportedMesh* > > instanceableMeshes;
+
+    getVisibleEntities( viewMatrix, projectionMatrix, cullingStats, visibleMeshes );
+
+    // Draw the meshes which can't be instanced and group the rest by
+    // geometry.
+    for( Mesh* mesh : visibleMeshes ){
+        const ImportedMesh* importedMesh = dynamic_cast< const ImportedMesh* >( mesh );
+
+        if( ( importedMesh != nullptr ) && importedMesh->instanceable() ){
+            instanceableMeshes[ &( importedMesh->geometry() ) ].push_back( importedMesh );
+        }else{
+            mesh->draw( openGL, viewMatrix, projectionMatrix, &borderColor_ );
+        }
+    }
+
+    for( const auto& geometryMeshes : instanceableMeshes ){
+        if( geometryMeshes.second.size() == 1 ){
+            geometryMeshes.second.front()->draw( openGL, viewMatrix, projectionMatrix, &borderColor_ );
+        }else{
+            ImportedMesh::drawInstanced( openGL, viewMatrix, projectionMatrix, geometryMeshes.second );
+        }
+    }
+}
+
+
 } // namespace como
@@ -78,7 +78,17 @@ class MeshesSelection : public virtual EntitiesSet< Mesh >, public AbstractMesh
 
 
         /***
-         * 6. Operators
+         * 6. Drawing
+         ***/
+        /*!
+         * \brief Draws the visible meshes. Imported meshes sharing their
+         * geometry are drawn with instanced draw calls when possible.
+         */
+        virtual void drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const;
+
+
+        /***
+         * 7. Operators
          ***/
         MeshesSelection& operator = ( const MeshesSelection& ) = default;
         MeshesSelection& operator = ( MeshesSelection&& ) = default;
@@ -22,6 +22,10 @@ namespace como {
 
 const unsigned int TIME_BETWEEN_SHIPMENTS = 1000 / SHIPMENTS_PER_SECOND;
 
+// Directory where the files received from the server are kept across
+// sessions.
+const char BLOBS_DIR[] = "data/blobs";
+
 
 /***
  * 1. Construction
@@ -41,6 +45,12 @@ ServerInterface::ServerInterface( const char *host, const char *port, const char
         connect( host, port, userName, userAcceptancePacket );
 
         localUserColor_ = userAcceptancePacket.getSelectionColor();
+
+        // Compress the packets exchanged with the server if it accepted it.
+        sceneUpdatePacketToServer_.setCompressionEnabled(
+                    userAcceptancePacket.getCapabilities() & COMPRESSION_CAPABILITY );
+        sceneUpdatePacketFromServer_.setCompressionEnabled(
+                    userAcceptancePacket.getCapabilities() & COMPRESSION_CAPABILITY );
         resourceIDsGenerator_ = ResourceIDsGeneratorPtr( new ResourceIDsGenerator( userAcceptancePacket.getId() ) );
 
         // Create the "worker threads" which will be communicating with the server.
@@ -95,6 +105,14 @@ void ServerInterface::connect( const char* host, const char* port, const char* u
     // Prepare a NEW_USER network package with the user name, and send it to
     // the server.
     newUserPacket.setName( userName );
+
+    // Tell the server which files we already have, so it doesn't send them
+    // again.
+    if( PackableFile::blobStore() == nullptr ){
+        PackableFile::setBlobStore( std::make_shared< BlobStore >( BLOBS_DIR ) );
+    }
+    newUserPacket.setKnownBlobs( PackableFile::blobStore()->blobHashes() );
+
     newUserPacket.send( socket_ );
 
     log_->debug( "Sending NEW_USER packet ...OK\n" );
@@ -104,6 +122,10 @@ void ServerInterface::connect( const char* host, const char* port, const char* u
     userAcceptancePacket.recv( socket_ );
     log_->debug( "Receiving USER_ACCEPTANCE packet ...OK\n" );
 
+    // Pack and unpack the commands with the float encoding chosen by the
+    // server.
+    setFloatEncoding( userAcceptancePacket.getFloatEncoding() );
+
     selectionColor = userAcceptancePacket.getSelectionColor();
     log_->debug( "User accepted: \n",
                  "\tID: [", userAcceptancePacket.getId(), "]\n",
@@ -180,6 +202,15 @@ void ServerInterface::sendCommand( CommandConstPtr sceneCommand )
         std::rethrow_exception( lastException_ );
     }
 
+    // Big files are streamed in chunks, queued before the command which
+    // references them.
+    const PackableFile* file = sceneCommand->getFile();
+    if( ( file != nullptr ) && file->isStreamed() ){
+        for( auto& chunk : FileChunkCommand::generateFileChunks( sceneCommand->getUserID(), *file ) ){
+            sceneCommandsToServer_.push( std::move( chunk ) );
+        }
+    }
+
     // Queue the new scene command.
     sceneCommandsToServer_.push( std::move( sceneCommand ) );
 }
@@ -215,11 +246,17 @@ void ServerInterface::sendPendingCommands()
     LOCK
 
     unsigned int nCommands = 0;
+    PacketSize commandsSize = 0;
 
     sceneUpdatePacketToServer_.clear();
 
-    // Move commands from the queue to the SCENE_UPDATE packet.
-    while( ( nCommands < MAX_COMMANDS_PER_SCENE_UPDATE ) && !sceneCommandsToServer_.empty() ){
+    // Move commands from the queue to the SCENE_UPDATE packet until the next
+    // one doesn't fit in it.
+    while( !sceneCommandsToServer_.empty() &&
+           ( !nCommands ||
+             ( commandsSize + sceneCommandsToServer_.front()->getPacketSize() <= MAX_SCENE_UPDATE_COMMANDS_SIZE ) ) ){
+        commandsSize += sceneCommandsToServer_.front()->getPacketSize();
+
         // TODO: Delete the second argument is not necessary in a SCENE_UPDATE
         // packet sent from client to server.
         sceneUpdatePacketToServer_.addCommand( std::move( sceneCommandsToServer_.front() ), 0, 0 );
@@ -257,7 +294,7 @@ void ServerInterface::listen()
  * 10. Handlers
  ***/
 
-void ServerInterface::onSceneUpdatePacketReceived( const boost::system::error_code& errorCode, PacketPtr packet )
+void ServerInterface::onSceneUpdatePacketReceived( const boost::system::error_code& errorCode, const Packet& packet )
 {
     LOCK // Private but handler method.
     try {
@@ -269,9 +306,7 @@ void ServerInterface::onSceneUpdatePacketReceived( const boost::system::error_co
                         );
         }
 
-        const CommandsList* sceneCommands = nullptr;
-
-        SceneUpdatePacket* sceneUpdate = dynamic_cast< SceneUpdatePacket *>( packet.get() );
+        const SceneUpdatePacket* sceneUpdate = dynamic_cast< const SceneUpdatePacket* >( &packet );
         //const UserConnectionCommand* userConnectedCommand = nullptr;
 
         if( !sceneUpdate ){
@@ -280,10 +315,10 @@ void ServerInterface::onSceneUpdatePacketReceived( const boost::system::error_co
 
         log_->debug( "Scene update received with nCommands: ", sceneUpdate->getCommands()->size(), "\n" );
 
-        sceneCommands = sceneUpdate->getCommands();
-        for( const auto& command : *sceneCommands ){
-            emit commandReceived( std::shared_ptr< const Command >( command->clone() ) );
-        }
+        // Move the received commands to the GUI thread in a single batch.
+        emit commandsReceived(
+                    std::make_shared< const CommandsList >(
+                        sceneUpdatePacketFromServer_.takeCommands() ) );
         listen();
     }catch( std::runtime_error& ){
         lastException_ = std::current_exception();
@@ -291,7 +326,7 @@ void ServerInterface::onSceneUpdatePacketReceived( const boost::system::error_co
 }
 
 
-void ServerInterface::onSceneUpdatePacketSended( const boost::system::error_code& errorCode, PacketPtr packet )
+void ServerInterface::onSceneUpdatePacketSended( const boost::system::error_code& errorCode, const Packet& packet )
 {
     LOCK // Private but handler method.
 
@@ -304,7 +339,7 @@ void ServerInterface::onSceneUpdatePacketSended( const boost::system::error_code
                         );
         }
 
-        log_->debug( "SCENE_UPDATE sent to the server - nCommands ", ( dynamic_cast< const SceneUpdatePacket* >( packet.get() ) )->getCommands()->size(), "\n" );
+        log_->debug( "SCENE_UPDATE sent to the server - nCommands ", ( dynamic_cast< const SceneUpdatePacket& >( packet ) ).getCommands()->size(), "\n" );
 
         setTimer();
     }catch( std::exception& ){
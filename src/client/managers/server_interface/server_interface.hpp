@@ -31,11 +31,10 @@
 #include <common/ids/resource_id.hpp>
 #include <common/ids/resource_ids_generator.hpp>
 
-Q_DECLARE_METATYPE( std::shared_ptr< const como::Command > )
+Q_DECLARE_METATYPE( std::shared_ptr< const como::CommandsList > )
 
 namespace como {
 
-const unsigned int MAX_COMMANDS_PER_SCENE_UPDATE = 4;
 const unsigned int SHIPMENTS_PER_SECOND = 33;
 
 class ServerInterface : public QObject, public Lockable
@@ -105,15 +104,15 @@ class ServerInterface : public QObject, public Lockable
          * 9. Signals
          ***/
     signals:
-        void commandReceived( std::shared_ptr< const Command > command );
+        void commandsReceived( std::shared_ptr< const CommandsList > commands );
 
 
         /***
          * 10. Handlers
          ***/
     private:
-        void onSceneUpdatePacketReceived( const boost::system::error_code& errorCode, PacketPtr packet );
-        void onSceneUpdatePacketSended( const boost::system::error_code& errorCode, PacketPtr packet );
+        void onSceneUpdatePacketReceived( const boost::system::error_code& errorCode, const Packet& packet );
+        void onSceneUpdatePacketSended( const boost::system::error_code& errorCode, const Packet& packet );
 
 
         /***
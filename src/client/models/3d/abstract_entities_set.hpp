@@ -21,6 +21,7 @@
 
 #include <client/managers/selections/resources/resources_selection.hpp>
 #include <client/models/3d/entity.hpp>
+#include <client/models/3d/view_frustum.hpp>
 
 namespace como {
 
@@ -80,7 +81,12 @@ class AbstractEntitiesSet : public Transformable, public virtual Observable // T
         /***
          * 7. Drawing
          ***/
-        virtual void drawAll( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix ) const = 0;
+        /*!
+         * \brief Draws the entities in the set which are inside the view
+         * frustum, adding the number of drawn and culled entities to
+         * cullingStats.
+         */
+        virtual void drawAll( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix, CullingStats& cullingStats ) const = 0;
 
 
         /***
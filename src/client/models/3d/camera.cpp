@@ -122,7 +122,7 @@ void Camera::update()
     transformedCenter = modelMatrix_ * originalCenter;
 
     // Update view matrix.
-    viewMatrix = glm::inverse( modelMatrix_ );
+    viewMatrix = inverseModelMatrix_;
 }
 
 
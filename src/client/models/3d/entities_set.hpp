@@ -86,11 +86,17 @@ class EntitiesSet : public AbstractEntitiesSet, public ResourcesSelection< Entit
          ***/
         bool intersectsRay( glm::vec3 r0, glm::vec3 r1, ResourceID& closestEntity, float& minT ) const;
 
+        /*!
+         * \brief Intersects the given ray with the given entity, if it's in
+         * this set.
+         */
+        bool intersectsRay( const ResourceID& entityID, glm::vec3 r0, glm::vec3 r1, float& t ) const;
+
 
         /***
          * 7. Drawing
          ***/
-        virtual void drawAll( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix ) const;
+        virtual void drawAll( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix, CullingStats& cullingStats ) const;
 
 
         /***
@@ -100,7 +106,18 @@ class EntitiesSet : public AbstractEntitiesSet, public ResourcesSelection< Entit
         EntitiesSet& operator = ( EntitiesSet&& ) = default;
 
 
-    private:
+    protected:
+        /***
+         * 8. Drawing (protected)
+         ***/
+        /*!
+         * \brief Gets the entities in the set which are inside the view
+         * frustum, adding the number of visible and culled entities to
+         * cullingStats.
+         */
+        void getVisibleEntities( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats, std::vector< EntitySubtype* >& visibleEntities ) const;
+
+
         glm::vec4 borderColor_;
 };
 
@@ -332,17 +349,72 @@ bool EntitiesSet<EntitySubtype>::intersectsRay( glm::vec3 r0, glm::vec3 r1, Reso
 }
 
 
+template <class EntitySubtype>
+bool EntitiesSet<EntitySubtype>::intersectsRay( const ResourceID& entityID, glm::vec3 r0, glm::vec3 r1, float& t ) const
+{
+    LOCK
+
+    const auto entityIt = this->resources_.find( entityID );
+    if( entityIt == this->resources_.end() ){
+        return false;
+    }
+
+    entityIt->second->intersects( r0, r1, t );
+
+    return ( t >= 0.0f );
+}
+
+
 /***
  * 7. Drawing
  ***/
 
 template <class EntitySubtype>
-void EntitiesSet<EntitySubtype>::drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) const
+void EntitiesSet<EntitySubtype>::drawAll( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats ) const
 {
     LOCK
 
+    std::vector< EntitySubtype* > visibleEntities;
+
+    getVisibleEntities( viewMatrix, projectionMatrix, cullingStats, visibleEntities );
+    for( EntitySubtype* entity : visibleEntities ){
+        entity->draw( openGL, viewMatrix, projectionMatrix, &borderColor_ );
+    }
+}
+
+
+/***
+ * 8. Drawing (protected)
+ ***/
+
+template <class EntitySubtype>
+void EntitiesSet<EntitySubtype>::getVisibleEntities( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, CullingStats& cullingStats, std::vector< EntitySubtype* >& visibleEntities ) const
+{
+    LOCK
+
+    const ViewFrustum frustum( projectionMatrix * viewMatrix );
+    PackedBounds entitiesBounds;
+    std::vector< std::uint8_t > entitiesVisible;
+    glm::vec3 boundsMin, boundsMax;
+    unsigned int entityIndex = 0;
+
+    // Pack the entities' world bounds and test them against the frustum
+    // all at once.
+    entitiesBounds.reserve( this->resources_.size() );
+    for( const auto& entityPair : this->resources_ ){
+        entityPair.second->getWorldBounds( boundsMin, boundsMax );
+        entitiesBounds.push_back( boundsMin, boundsMax );
+    }
+    const unsigned int nVisibleEntities = frustum.cullBoxes( entitiesBounds, entitiesVisible );
+    cullingStats.nDrawnEntities += nVisibleEntities;
+    cullingStats.nCulledEntities += entitiesBounds.size() - nVisibleEntities;
+
+    visibleEntities.clear();
+    visibleEntities.reserve( nVisibleEntities );
     for( auto& entityPair : this->resources_ ){
-        entityPair.second->draw( openGL, viewMatrix, projectionMatrix, &borderColor_ );
+        if( entitiesVisible[entityIndex++] ){
+            visibleEntities.push_back( entityPair.second.get() );
+        }
     }
 }
 
@@ -30,7 +30,9 @@ namespace como {
 Entity::Entity( const ResourceID& id, const std::string& name, DrawableType type ) :
     Resource( id, name ),
     type_( type ),
-    modelMatrix_( 1.0f )
+    entitiesBVHLeaf_( 0 ),
+    modelMatrix_( 1.0f ),
+    inverseModelMatrix_( 1.0f )
 {
     // Initialize the drawable's original orientation.
     originalOrientation[X] = glm::vec4( 1.0f, 0.0f, 0.0f, 1.0f );
@@ -39,6 +41,28 @@ Entity::Entity( const ResourceID& id, const std::string& name, DrawableType type
 }
 
 
+Entity::~Entity()
+{
+    if( entitiesBVH_ ){
+        entitiesBVH_->removeEntity( entitiesBVHLeaf_ );
+    }
+}
+
+
+void Entity::insertIntoBVH( EntitiesBVHPtr entitiesBVH, const ResourceID& entityID )
+{
+    glm::vec3 boundsMin, boundsMax;
+
+    if( entitiesBVH_ ){
+        entitiesBVH_->removeEntity( entitiesBVHLeaf_ );
+    }
+
+    getWorldBounds( boundsMin, boundsMax );
+    entitiesBVH_ = entitiesBVH;
+    entitiesBVHLeaf_ = entitiesBVH_->insertEntity( entityID, boundsMin, boundsMax );
+}
+
+
 /***
  * 2. Getters
  ***/
@@ -82,6 +106,15 @@ void Entity::update()
     for( unsigned int i = 0; i<3; i++ ){
         transformedOrientation[i] = modelMatrix_ * originalOrientation[i];
     }
+
+    inverseModelMatrix_ = glm::inverse( modelMatrix_ );
+
+    if( entitiesBVH_ ){
+        glm::vec3 boundsMin, boundsMax;
+
+        getWorldBounds( boundsMin, boundsMax );
+        entitiesBVH_->moveEntity( entitiesBVHLeaf_, boundsMin, boundsMax );
+    }
 }
 
 } // namespace como.
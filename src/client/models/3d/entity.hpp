@@ -24,6 +24,7 @@
 #include <common/3d/transformable.hpp>
 #include <glm/vec4.hpp>
 #include <client/models/utilities/open_gl.hpp>
+#include <client/models/3d/sets/entities_bvh.hpp>
 
 namespace como {
 
@@ -54,6 +55,10 @@ class Entity : public Resource, public Drawable, public Transformable
         /*! Type of drawable */
         const DrawableType type_;
 
+        /*! Scene BVH the entity's bounds are kept updated in (if any) */
+        EntitiesBVHPtr entitiesBVH_;
+        unsigned int entitiesBVHLeaf_;
+
 
     protected:
         // TODO: Try to make these attributes private?.
@@ -62,6 +67,9 @@ class Entity : public Resource, public Drawable, public Transformable
 
         glm::mat4 modelMatrix_;
 
+        // Inverse of modelMatrix_, updated in update().
+        glm::mat4 inverseModelMatrix_;
+
 
     public:
         /***
@@ -72,7 +80,13 @@ class Entity : public Resource, public Drawable, public Transformable
         Entity( const Entity& ) = delete;
         Entity( Entity&& ) = delete;
 
-        virtual ~Entity(){}
+        virtual ~Entity();
+
+        /*!
+         * \brief Inserts the entity's world bounds in the given scene BVH,
+         * which will be kept updated as the entity is transformed.
+         */
+        void insertIntoBVH( EntitiesBVHPtr entitiesBVH, const ResourceID& entityID );
 
 
         /***
@@ -81,6 +95,12 @@ class Entity : public Resource, public Drawable, public Transformable
         glm::mat4 getModelMatrix() const;
         DrawableType getType() const;
 
+        /*!
+         * \brief Gets the axis aligned box bounding the entity in world
+         * coordinates.
+         */
+        virtual void getWorldBounds( glm::vec3& boundsMin, glm::vec3& boundsMax ) const = 0;
+
 
         /***
          * 3. Transformations
@@ -17,6 +17,7 @@
 ***/
 
 #include "imported_mesh.hpp"
+#include <map>
 
 namespace como {
 
@@ -30,6 +31,12 @@ ImportedMesh::ImportedMesh( const ResourceID& id, const ResourceID& firstMateria
 {}
 
 
+ImportedMesh::ImportedMesh( const ResourceID& id, const ResourceID& firstMaterialID, const ImportedPrimitiveData& primitiveData, MeshGeometryPtr geometry, MaterialsManager& materialsManager, bool displayVertexNormals ) :
+    Mesh( id, firstMaterialID, primitiveData, geometry, materialsManager, displayVertexNormals ),
+    trianglesGroups_( primitiveData.trianglesGroups_ )
+{}
+
+
 /***
  * 3. Getters
  ***/
@@ -40,6 +47,22 @@ std::string ImportedMesh::typeName() const
 }
 
 
+bool ImportedMesh::instanceable() const
+{
+    if( displaysEdges() || displaysVertexNormals() ){
+        return false;
+    }
+
+    for( const TrianglesGroupWithMaterial& trianglesGroup : trianglesGroups_ ){
+        if( materialIncludesTexture( trianglesGroup.materialIndex ) ){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
 /***
  * 4. Drawing
  ***/
@@ -49,7 +72,11 @@ void ImportedMesh::draw( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const gl
     openGL->setShadingMode( ShadingMode::SOLID_LIGHTING );
     sendToShader( *openGL, viewMatrix, projectionMatrix );
 
-    for( const auto& trianglesGroup : trianglesGroups_ ){
+    const unsigned int lodLevel = selectLODLevel( viewMatrix, projectionMatrix );
+
+    for( unsigned int i = 0; i < trianglesGroups_.size(); i++ ){
+        const TrianglesGroupWithMaterial& trianglesGroup = trianglesGroups_[i];
+
         if( materialIncludesTexture( trianglesGroup.materialIndex ) ){
             openGL->setShadingMode( ShadingMode::SOLID_LIGHTING_AND_TEXTURING );
         }else{
@@ -59,7 +86,11 @@ void ImportedMesh::draw( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const gl
         // Send this mesh's material to shader.
         sendMaterialToShader( trianglesGroup.materialIndex );
 
-        drawTriangles( trianglesGroup.firstTriangleIndex, trianglesGroup.nTriangles );
+        if( lodLevel ){
+            drawLODTriangles( lodLevel, i );
+        }else{
+            drawTriangles( trianglesGroup.firstTriangleIndex, trianglesGroup.nTriangles );
+        }
     }
 
     drawEdges( openGL, viewMatrix, projectionMatrix, contourColor );
@@ -70,6 +101,72 @@ void ImportedMesh::draw( OpenGLPtr openGL, const glm::mat4 &viewMatrix, const gl
 }
 
 
+void ImportedMesh::drawInstanced( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, const std::vector< const ImportedMesh* >& meshes )
+{
+    // Meshes drawn together, grouped by level of detail and by materials
+    // (every batch starts with the mesh whose materials are sent to the
+    // shader).
+    std::map< unsigned int, std::vector< std::vector< const ImportedMesh* > > > batches;
+    std::vector< MeshInstanceData > instances;
+
+    for( const ImportedMesh* mesh : meshes ){
+        std::vector< std::vector< const ImportedMesh* > >& lodBatches =
+                batches[ mesh->selectLODLevel( viewMatrix, projectionMatrix ) ];
+        auto batchIt = lodBatches.begin();
+
+        while( ( batchIt != lodBatches.end() ) && !mesh->sharesMaterialsWith( *( batchIt->front() ) ) ){
+            batchIt++;
+        }
+        if( batchIt != lodBatches.end() ){
+            batchIt->push_back( mesh );
+        }else{
+            lodBatches.push_back( std::vector< const ImportedMesh* >( 1, mesh ) );
+        }
+    }
+
+    for( const auto& lodBatches : batches ){
+        const unsigned int lodLevel = lodBatches.first;
+
+        for( const std::vector< const ImportedMesh* >& batch : lodBatches.second ){
+            const ImportedMesh& firstMesh = *( batch.front() );
+
+            if( batch.size() == 1 ){
+                firstMesh.draw( openGL, viewMatrix, projectionMatrix );
+                continue;
+            }
+
+            instances.resize( batch.size() );
+            for( unsigned int i = 0; i < batch.size(); i++ ){
+                const glm::mat4 modelViewMatrix = viewMatrix * batch[i]->modelMatrix_;
+
+                instances[i].mvpMatrix = projectionMatrix * modelViewMatrix;
+                instances[i].normalMatrix = glm::mat3( glm::transpose( glm::inverse( modelViewMatrix ) ) );
+            }
+
+            openGL->setShadingMode( ShadingMode::SOLID_LIGHTING );
+            openGL->enableInstancing();
+            firstMesh.geometry_->bind();
+            firstMesh.geometry_->enableInstances( instances );
+
+            for( unsigned int i = 0; i < firstMesh.trianglesGroups_.size(); i++ ){
+                const TrianglesGroupWithMaterial& trianglesGroup = firstMesh.trianglesGroups_[i];
+
+                firstMesh.sendMaterialToShader( trianglesGroup.materialIndex );
+
+                if( lodLevel ){
+                    firstMesh.drawLODTrianglesInstanced( lodLevel, i, batch.size() );
+                }else{
+                    firstMesh.drawTrianglesInstanced( trianglesGroup.firstTriangleIndex, trianglesGroup.nTriangles, batch.size() );
+                }
+            }
+
+            firstMesh.geometry_->disableInstances();
+            openGL->disableInstancing();
+        }
+    }
+}
+
+
 /***
  * 6. Protected construction
  ***/
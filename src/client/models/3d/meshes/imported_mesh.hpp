@@ -31,6 +31,7 @@ class ImportedMesh : public Mesh
          * 1. Construction
          ***/
         ImportedMesh( const ResourceID& id, const ResourceID& firstMaterialID, const ImportedPrimitiveData& primitiveData, MaterialsManager& materialsManager, bool displayVertexNormals = false );
+        ImportedMesh( const ResourceID& id, const ResourceID& firstMaterialID, const ImportedPrimitiveData& primitiveData, MeshGeometryPtr geometry, MaterialsManager& materialsManager, bool displayVertexNormals = false );
         ImportedMesh() = delete;
         ImportedMesh( const ImportedMesh& ) = delete;
         ImportedMesh( ImportedMesh&& ) = delete;
@@ -47,12 +48,26 @@ class ImportedMesh : public Mesh
          ***/
         virtual std::string typeName() const;
 
+        /*!
+         * \brief Tells whether the mesh can be drawn with instanced draw
+         * calls, along with other meshes sharing its geometry (it doesn't
+         * display its edges, its vertex normals nor any texture).
+         */
+        bool instanceable() const;
+
 
         /***
          * 4. Drawing
          ***/
         virtual void draw( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, const glm::vec4* contourColor = nullptr ) const;
 
+        /*!
+         * \brief Draws the given instanceable meshes, which must share their
+         * geometry. Meshes with the same level of detail and materials are
+         * drawn together, with an instanced draw call per triangles group.
+         */
+        static void drawInstanced( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, const std::vector< const ImportedMesh* >& meshes );
+
 
         /***
          * 5. Operators
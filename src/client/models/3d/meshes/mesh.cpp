@@ -17,9 +17,10 @@
 ***/
 
 #include "mesh.hpp"
+#include <algorithm>
+#include <cmath>
 
 #define GLM_FORCE_RADIANS
-#include <glm/gtx/intersect.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <common/primitives/primitive_data/imported_primitive_data.hpp>
 
@@ -36,53 +37,30 @@ GLint Mesh::uniformColorLocation = -1;
 GLint Mesh::mvpMatrixLocation_ = -1;
 GLint Mesh::normalMatrixLocation_ = -1;
 
-const GLint SHADER_VERTEX_ATTR_LOCATION = 0;
-const GLint SHADER_NORMAL_ATTR_LOCATION = 1;
-const GLint SHADER_UV_ATTR_LOCATION = 2;
-
 
 /***
  * 1. Construction.
  ***/
 
 Mesh::Mesh( const ResourceID& meshID, const ResourceID& firstMaterialID, const PrimitiveData& primitiveData, MaterialsManager& materialsManager, bool displayVertexNormals ) :
+    Mesh( meshID, firstMaterialID, primitiveData, MeshGeometryPtr( new MeshGeometry( primitiveData ) ), materialsManager, displayVertexNormals )
+{}
+
+
+Mesh::Mesh( const ResourceID& meshID, const ResourceID& firstMaterialID, const PrimitiveData& primitiveData, MeshGeometryPtr geometry, MaterialsManager& materialsManager, bool displayVertexNormals ) :
     Entity( meshID, primitiveData.name + " # " + meshID.toString(), DrawableType::MESH ),
+    geometry_( geometry ),
     type_( MeshType::MESH ),
-    vertexData_( primitiveData.vertexData ),
     displayVertexNormals_( displayVertexNormals ),
     displayEdges_( true ),
     materialsManager_( &materialsManager )
 {
-    ResourceID currentMaterialID = firstMaterialID;
-
-    init( primitiveData.oglData );
-    for( const auto& materialInfo : primitiveData.materialsInfo_ ){
-        materialsManager_->createMaterial( materialInfo, currentMaterialID, id() );
-        materialIDs_.push_back( currentMaterialID );
-        currentMaterialID++;
-    }
-
+    initShaderLocations();
+    initMaterials( firstMaterialID, primitiveData );
     computeCentroid();
 }
 
 
-/***
- * 2. Destruction.
- ***/
-
-Mesh::~Mesh()
-{
-    // Tell OpenGL we are done with allocated buffer objects and
-    // vertex attribute arrays.
-    // TODO: If sometime move semantics are implemented, make sure
-    // moved Mesh doesn't delete OpenGL resources on
-    // destruction.
-    glDeleteBuffers( 1, &vbo );
-    glDeleteBuffers( 1, &ebo );
-    glDeleteVertexArrays( 1, &vao );
-}
-
-
 /***
  * 3. Getters
  ***/
@@ -115,9 +93,32 @@ glm::vec3 Mesh::centroid() const
 }
 
 
+void Mesh::getWorldBounds( glm::vec3& boundsMin, glm::vec3& boundsMax ) const
+{
+    glm::vec3 originalBoundsMin, originalBoundsMax;
+    geometry_->getBounds( originalBoundsMin, originalBoundsMax );
+
+    // Transform the box's center and bound its transformed half extents
+    // (Arvo's method).
+    const glm::vec3 center = 0.5f * ( originalBoundsMin + originalBoundsMax );
+    const glm::vec3 halfExtent = 0.5f * ( originalBoundsMax - originalBoundsMin );
+    const glm::vec3 worldCenter = glm::vec3( modelMatrix_ * glm::vec4( center, 1.0f ) );
+    glm::vec3 worldHalfExtent( 0.0f );
+
+    for( unsigned int i = 0; i < 3; i++ ){
+        for( unsigned int j = 0; j < 3; j++ ){
+            worldHalfExtent[i] += std::abs( modelMatrix_[j][i] ) * halfExtent[j];
+        }
+    }
+
+    boundsMin = worldCenter - worldHalfExtent;
+    boundsMax = worldCenter + worldHalfExtent;
+}
+
+
 bool Mesh::includesUV() const
 {
-    return includesUV_;
+    return geometry_->includesUV();
 }
 
 
@@ -127,6 +128,18 @@ std::string Mesh::typeName() const
 }
 
 
+unsigned int Mesh::nLODLevels() const
+{
+    return geometry_->lodTrianglesGroupsStarts().size();
+}
+
+
+const MeshGeometry& Mesh::geometry() const
+{
+    return *geometry_;
+}
+
+
 /***
  * 4. Setters
  ***/
@@ -149,44 +162,19 @@ void Mesh::displayEdges( bool display )
 
 void Mesh::intersects( glm::vec3 rayOrigin, glm::vec3 rayDirection, float& minT, unsigned int* triangle ) const
 {
-    const float MAX_T = 999999.9f;
-    float t = MAX_T;
-    glm::vec3 intersection;
-
-    minT = MAX_T;
+    GLuint closestTriangle;
 
     // Transform the ray's origin and direction from world to object
     // coordinates.
-    rayOrigin = glm::vec3( glm::inverse( modelMatrix_ ) * glm::vec4( rayOrigin, 1.0f ) );
-    rayDirection = glm::vec3( glm::inverse( modelMatrix_ ) * glm::vec4( rayDirection, 0.0f ) );
-
-    // Normalize the direction of the ray.
-    rayDirection = rayDirection;
-
-    // Compute intersections with all triangles in this Mesh.
-    for( unsigned int i = 0; i < vertexData_.vertexTriangles.size(); i++ ){
-        if( glm::intersectRayTriangle( rayOrigin,
-                                       rayDirection,
-                                       vertexData_.vertices[vertexData_.vertexTriangles[i][0]],
-                                       vertexData_.vertices[vertexData_.vertexTriangles[i][1]],
-                                       vertexData_.vertices[vertexData_.vertexTriangles[i][2]],
-                                       intersection ) ){
-
-            // There was an intersection with this triangle. Get the parameter t.
-            t = intersection.z;
-
-            // Do we have a new minimum t?
-            if( t < minT ){
-                minT = t;
-                if( triangle != nullptr ){
-                    *triangle = i;
-                }
-            }
-        }
-    }
+    rayOrigin = glm::vec3( inverseModelMatrix_ * glm::vec4( rayOrigin, 1.0f ) );
+    rayDirection = glm::vec3( inverseModelMatrix_ * glm::vec4( rayDirection, 0.0f ) );
 
-    // If the ray didn't intersect the mesh, we "return" -1.
-    if( minT >= MAX_T ){
+    if( geometry_->intersects( rayOrigin, rayDirection, minT, closestTriangle ) ){
+        if( triangle != nullptr ){
+            *triangle = closestTriangle;
+        }
+    }else{
+        // If the ray didn't intersect the mesh, we "return" -1.
         minT = -1.0f;
     }
 }
@@ -204,19 +192,13 @@ Mesh::Mesh( const ResourceID& meshID, const std::string& meshName, const Resourc
     displayEdges_( true ),
     materialsManager_( &materialsManager )
 {
-    ResourceID currentMaterialID = firstMaterialID;
     ImportedPrimitiveData primitiveData;
     primitiveData.importFromFile( filePath );
 
-    vertexData_ = primitiveData.vertexData;
-    for( const auto& materialInfo : primitiveData.materialsInfo_ ){
-        materialsManager_->createMaterial( materialInfo, currentMaterialID, id() );
-        materialIDs_.push_back( currentMaterialID );
-        currentMaterialID++;
-    }
-
-    init( primitiveData.oglData );
+    geometry_ = MeshGeometryPtr( new MeshGeometry( primitiveData ) );
 
+    initShaderLocations();
+    initMaterials( firstMaterialID, primitiveData );
     computeCentroid();
 }
 
@@ -225,41 +207,6 @@ Mesh::Mesh( const ResourceID& meshID, const std::string& meshName, const Resourc
  * 8. Initialization
  ***/
 
-void Mesh::init( const MeshOpenGLData& oglData )
-{
-    genOpenGLBuffers();
-
-    initShaderLocations();
-
-    populateOpenGLBuffers( oglData );
-
-    includesUV_ = oglData.includesUV;
-    componensPerVertex_ = oglData.componentsPerVertex();
-
-    initVAO();
-
-    // Set both original and transformed centroids.
-    originalCentroid = glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f );
-    transformedCentroid = glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f );
-}
-
-
-void Mesh::genOpenGLBuffers()
-{
-    // Generate a VAO for the Mesh and bind it as the active one.
-    glGenVertexArrays( 1, &vao );
-    glBindVertexArray( vao );
-
-    // Generate a VBO and bind it for holding vertex data.
-    glGenBuffers( 1, &vbo );
-    glBindBuffer( GL_ARRAY_BUFFER, vbo );
-
-    // Generate an EBO and bind it for holding vertex indices.
-    glGenBuffers( 1, &ebo );
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ebo );
-}
-
-
 void Mesh::initShaderLocations()
 {
     GLint currentShaderProgram;
@@ -286,82 +233,22 @@ void Mesh::initShaderLocations()
 }
 
 
-void Mesh::populateOpenGLBuffers( const MeshOpenGLData& oglData )
-{
-    const unsigned int vboSize = oglData.vboData.size() * sizeof( GLfloat );
-    const unsigned int eboSize = oglData.eboData.size() * sizeof( GLuint );
-
-    // Populate the VBO.
-    glBufferData( GL_ARRAY_BUFFER, vboSize, &( oglData.vboData[0] ), GL_STATIC_DRAW );
-
-    // Populate the EBO.
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, eboSize, &( oglData.eboData[0] ), GL_STATIC_DRAW );
-
-    nEboElements_ = oglData.eboData.size();
-}
-
-
-// TODO: Remove this method.
-void Mesh::initMeshBuffers()
+void Mesh::initMaterials( const ResourceID& firstMaterialID, const PrimitiveData& primitiveData )
 {
-    GLint currentShaderProgram;
-
-    // Generate a VAO for the Mesh and bind it as the active one.
-    glGenVertexArrays( 1, &vao );
-    glBindVertexArray( vao );
-
-    // Generate a VBO and bind it for holding vertex data.
-    glGenBuffers( 1, &vbo );
-    glBindBuffer( GL_ARRAY_BUFFER, vbo );
-
-    // Generate an EBO and bind it for holding vertex indices.
-    glGenBuffers( 1, &ebo );
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ebo );
-
-    if( uniformColorLocation == -1 ){
-        // Location of uniform shader variable "color" hasn't been initialized yet.
-
-        // Get current shader program id.
-        glGetIntegerv( GL_CURRENT_PROGRAM, &currentShaderProgram );
-
-        // Get location of uniform shader variable "color".
-        uniformColorLocation = glGetUniformLocation( currentShaderProgram, "material.color" );
-
-        // Get location of uniform shader variable "mvpMatrix".
-        mvpMatrixLocation_ = glGetUniformLocation( currentShaderProgram, "mvpMatrix" );
-
-        // Get location of uniform shader variable "normalMatrix".
-        normalMatrixLocation_ = glGetUniformLocation( currentShaderProgram, "normalMatrix" );
-    }
-
-    // Set both original and transformed centroids.
-    originalCentroid = glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f );
-    transformedCentroid = glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f );
-}
-
-void Mesh::initVAO()
-{
-    // Set the organization of the vertex and normals data in the VBO.
-    glBindVertexArray( vao );
-    glBindBuffer( GL_ARRAY_BUFFER, vbo );
-    glVertexAttribPointer( SHADER_VERTEX_ATTR_LOCATION, 3, GL_FLOAT, GL_FALSE, getBytesPerVertex(), (void *)( 0 ) );
-    glVertexAttribPointer( SHADER_NORMAL_ATTR_LOCATION, 3, GL_FLOAT, GL_FALSE, getBytesPerVertex(), (void *)( COMPONENTS_PER_VERTEX_POSITION * sizeof( GL_FLOAT ) ) );
-
-    // Enable previous vertex data arrays.
-    glEnableVertexAttribArray( SHADER_VERTEX_ATTR_LOCATION );
-    glEnableVertexAttribArray( SHADER_NORMAL_ATTR_LOCATION );
+    ResourceID currentMaterialID = firstMaterialID;
 
-    if( includesUV_ ){
-        glVertexAttribPointer( SHADER_UV_ATTR_LOCATION, 2, GL_FLOAT, GL_FALSE, getBytesPerVertex(), (void *)( COMPONENTS_PER_VERTEX_POSITION * 2 * sizeof( GL_FLOAT ) ) );
-        glEnableVertexAttribArray( SHADER_UV_ATTR_LOCATION );
+    for( const auto& materialInfo : primitiveData.materialsInfo_ ){
+        materialsManager_->createMaterial( materialInfo, currentMaterialID, id() );
+        materialIDs_.push_back( currentMaterialID );
+        currentMaterialID++;
     }
 }
 
 
 void Mesh::computeCentroid()
 {
-    originalCentroid = glm::vec4( vertexData_.centroid(), 1.0f );
-    transformedCentroid = originalCentroid;
+    originalCentroid = glm::vec4( geometry_->centroid(), 1.0f );
+    transformedCentroid = modelMatrix_ * originalCentroid;
 }
 
 
@@ -369,20 +256,34 @@ void Mesh::computeCentroid()
  * 9. Getters (protected)
  ***/
 
-unsigned int Mesh::getBytesPerVertex() const
+bool Mesh::materialIncludesTexture( unsigned int index ) const
 {
-    return getComponentsPerVertex() * sizeof( GL_FLOAT );
+    return materialsManager_->materialIncludesTexture( materialIDs_[index] );
 }
 
-unsigned int Mesh::getComponentsPerVertex() const
+
+bool Mesh::sharesMaterialsWith( const Mesh& mesh ) const
 {
-    return componensPerVertex_;
-}
+    if( materialIDs_.size() != mesh.materialIDs_.size() ){
+        return false;
+    }
 
+    for( unsigned int i = 0; i < materialIDs_.size(); i++ ){
+        const MaterialConstPtr material = materialsManager_->getMaterial( materialIDs_[i] );
+        const MaterialConstPtr meshMaterial = mesh.materialsManager_->getMaterial( mesh.materialIDs_[i] );
+
+        if( material->includesTexture() ||
+            meshMaterial->includesTexture() ||
+            ( material->getColor() != meshMaterial->getColor() ) ||
+            ( material->getAmbientReflectivity() != meshMaterial->getAmbientReflectivity() ) ||
+            ( material->getDiffuseReflectivity() != meshMaterial->getDiffuseReflectivity() ) ||
+            ( material->getSpecularReflectivity() != meshMaterial->getSpecularReflectivity() ) ||
+            ( material->getSpecularExponent() != meshMaterial->getSpecularExponent() ) ){
+            return false;
+        }
+    }
 
-bool Mesh::materialIncludesTexture( unsigned int index ) const
-{
-    return materialsManager_->materialIncludesTexture( materialIDs_[index] );
+    return true;
 }
 
 
@@ -410,9 +311,7 @@ void Mesh::sendToShader( OpenGL& openGL, const glm::mat4 &viewMatrix, const glm:
     openGL.setMVPMatrix( modelMatrix_, viewMatrix, projectionMatrix );
 
     // Bind Mesh VAO and VBOs as the active ones.
-    glBindVertexArray( vao );
-    glBindBuffer( GL_ARRAY_BUFFER, vbo );
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ebo );
+    geometry_->bind();
 }
 
 
@@ -454,7 +353,7 @@ void Mesh::drawEdges( OpenGLPtr openGL, const glm::mat4& viewMatrix, const glm::
         glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
 
         // Draw Mesh's contour
-        glDrawElements( GL_TRIANGLES, nEboElements_, GL_UNSIGNED_INT, NULL );
+        glDrawElements( GL_TRIANGLES, geometry_->nEboElements(), GL_UNSIGNED_INT, NULL );
 
         // Return polygon mode to previos GL_FILL.
         glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
@@ -471,7 +370,7 @@ void Mesh::drawVertexNormals( OpenGLPtr openGL, const glm::mat4& viewMatrix, con
     openGL->setMVPMatrix( modelMatrix_, viewMatrix, projectionMatrix );
 
     // We don't want to send UV coordinates to shader.
-    if( includesUV_ ){
+    if( geometry_->includesUV() ){
         glDisableVertexAttribArray( SHADER_UV_ATTR_LOCATION );
     }
 
@@ -481,9 +380,9 @@ void Mesh::drawVertexNormals( OpenGLPtr openGL, const glm::mat4& viewMatrix, con
     assert( colorUniformLocation != -1 );
     openGL->setUniformVec4( colorUniformLocation, color );
 
-    glDrawArrays( GL_POINTS, 0, vertexData_.vertices.size() * componensPerVertex_ );
+    glDrawArrays( GL_POINTS, 0, geometry_->vertexData().vertices.size() * geometry_->componentsPerVertex() );
 
-    if( includesUV_ ){
+    if( geometry_->includesUV() ){
         glEnableVertexAttribArray( SHADER_UV_ATTR_LOCATION );
     }
 
@@ -504,7 +403,73 @@ void Mesh::drawTriangles( unsigned int firstTriangleIndex, unsigned int nTriangl
 
 void Mesh::drawTriangles() const
 {
-    glDrawElements( GL_TRIANGLES, nEboElements_, GL_UNSIGNED_INT, NULL );
+    glDrawElements( GL_TRIANGLES, geometry_->nEboElements(), GL_UNSIGNED_INT, NULL );
+}
+
+
+unsigned int Mesh::selectLODLevel( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const
+{
+    const std::vector< std::vector< GLuint > >& lodTrianglesGroupsStarts = geometry_->lodTrianglesGroupsStarts();
+
+    if( lodTrianglesGroupsStarts.empty() ){
+        return 0;
+    }
+
+    // Bounding sphere in world space.
+    const float scale = std::max( glm::length( glm::vec3( modelMatrix_[0] ) ),
+                                  std::max( glm::length( glm::vec3( modelMatrix_[1] ) ),
+                                            glm::length( glm::vec3( modelMatrix_[2] ) ) ) );
+    const float radius = geometry_->boundingRadius() * scale;
+
+    // Radius of the sphere once projected, relative to half the viewport
+    // height.
+    float projectedRadius = radius * projectionMatrix[1][1];
+    if( projectionMatrix[2][3] != 0.0f ){
+        // Perspective projection.
+        const float distance = -( viewMatrix * transformedCentroid ).z;
+        if( distance <= radius ){
+            return 0;
+        }
+        projectedRadius /= distance;
+    }
+
+    unsigned int lodLevel = 0;
+    while( ( lodLevel < lodTrianglesGroupsStarts.size() ) &&
+           ( lodLevel < sizeof( LOD_PROJECTED_RADIUS_THRESHOLDS ) / sizeof( LOD_PROJECTED_RADIUS_THRESHOLDS[0] ) ) &&
+           ( projectedRadius < LOD_PROJECTED_RADIUS_THRESHOLDS[lodLevel] ) ){
+        lodLevel++;
+    }
+
+    return lodLevel;
+}
+
+
+void Mesh::drawLODTriangles( unsigned int lodLevel, unsigned int trianglesGroupIndex ) const
+{
+    const std::vector< GLuint >& trianglesGroupsStarts = geometry_->lodTrianglesGroupsStarts()[lodLevel - 1];
+
+    drawTriangles( trianglesGroupsStarts[trianglesGroupIndex],
+                   trianglesGroupsStarts[trianglesGroupIndex + 1] - trianglesGroupsStarts[trianglesGroupIndex] );
+}
+
+
+void Mesh::drawTrianglesInstanced( unsigned int firstTriangleIndex, unsigned int nTriangles, unsigned int nInstances ) const
+{
+    glDrawElementsInstanced( GL_TRIANGLES,
+                             nTriangles * 3,
+                             GL_UNSIGNED_INT,
+                             ( void* )( firstTriangleIndex * 3 * sizeof( GL_UNSIGNED_INT ) ),
+                             nInstances );
+}
+
+
+void Mesh::drawLODTrianglesInstanced( unsigned int lodLevel, unsigned int trianglesGroupIndex, unsigned int nInstances ) const
+{
+    const std::vector< GLuint >& trianglesGroupsStarts = geometry_->lodTrianglesGroupsStarts()[lodLevel - 1];
+
+    drawTrianglesInstanced( trianglesGroupsStarts[trianglesGroupIndex],
+                            trianglesGroupsStarts[trianglesGroupIndex + 1] - trianglesGroupsStarts[trianglesGroupIndex],
+                            nInstances );
 }
 
 
@@ -31,12 +31,15 @@
 #include <client/models/3d/materials/material.hpp>
 #include <common/packables/packable_color.hpp>
 #include <common/primitives/primitive_data/primitive_data.hpp>
+#include <client/models/3d/meshes/mesh_geometry.hpp>
+#include <memory>
 
 
 namespace como {
 
-const GLuint COMPONENTS_PER_VERTEX_POSITION = 3;
-const GLuint COMPONENTS_PER_VERTEX = 6;
+// Projected radius (as a fraction of half the viewport height) below which
+// every level of detail is used, from the finest to the coarsest one.
+const float LOD_PROJECTED_RADIUS_THRESHOLDS[] = { 0.5f, 0.25f, 0.1f };
 
 enum class MeshType : std::uint8_t {
     MESH = 0,
@@ -56,6 +59,12 @@ class Mesh : public AbstractMesh, public Entity
          * 1. Construction.
          ***/
         Mesh( const ResourceID& meshID, const ResourceID& firstMaterialID, const PrimitiveData& primitiveData, MaterialsManager& materialsManager, bool displayVertexNormals = false );
+
+        /*!
+         * \brief Constructs a mesh sharing the given geometry (created from
+         * primitiveData). Only the materials are taken from primitiveData.
+         */
+        Mesh( const ResourceID& meshID, const ResourceID& firstMaterialID, const PrimitiveData& primitiveData, MeshGeometryPtr geometry, MaterialsManager& materialsManager, bool displayVertexNormals = false );
         Mesh( const Mesh& b ) = delete;
         Mesh( Mesh&& ) = delete;
 
@@ -63,7 +72,7 @@ class Mesh : public AbstractMesh, public Entity
         /***
          * 2. Destruction.
          ***/
-        virtual ~Mesh();
+        virtual ~Mesh() = default;
 
 
         /***
@@ -74,8 +83,11 @@ class Mesh : public AbstractMesh, public Entity
         bool displaysEdges() const;
         glm::vec3 getOriginalCentroid() const;
         virtual glm::vec3 centroid() const;
+        virtual void getWorldBounds( glm::vec3& boundsMin, glm::vec3& boundsMax ) const;
         bool includesUV() const;
         virtual std::string typeName() const;
+        unsigned int nLODLevels() const;
+        const MeshGeometry& geometry() const;
 
 
         /***
@@ -108,23 +120,22 @@ class Mesh : public AbstractMesh, public Entity
         /***
          * 8. Initialization
          ***/
-        void init( const MeshOpenGLData& oglData );
-        void genOpenGLBuffers();
         void initShaderLocations();
-        void populateOpenGLBuffers( const MeshOpenGLData& oglData );
-        void initMeshBuffers();
-        void initVBO();
-        virtual void initVAO();
+        void initMaterials( const ResourceID& firstMaterialID, const PrimitiveData& primitiveData );
         void computeCentroid();
 
 
         /***
          * 9. Getters (protected)
          ***/
-        virtual unsigned int getBytesPerVertex() const;
-        virtual unsigned int getComponentsPerVertex() const;
         bool materialIncludesTexture( unsigned int index ) const;
 
+        /*!
+         * \brief Tells whether the mesh's materials look the same as the
+         * given mesh ones (texturing materials never do).
+         */
+        bool sharesMaterialsWith( const Mesh& mesh ) const;
+
 
         /***
          * 10. Updating
@@ -150,14 +161,38 @@ class Mesh : public AbstractMesh, public Entity
         virtual void drawTriangles( unsigned int firstTriangleIndex, unsigned int nTriangles ) const;
         virtual void drawTriangles() const;
 
+        /*!
+         * \brief Returns the level of detail the mesh should be drawn with
+         * (0 for full resolution) given its projected size.
+         */
+        unsigned int selectLODLevel( const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix ) const;
+
+        /*!
+         * \brief Draws the triangles of the given triangles group at the
+         * given level of detail (1 for the finest simplified one).
+         */
+        void drawLODTriangles( unsigned int lodLevel, unsigned int trianglesGroupIndex ) const;
+
+        /*!
+         * \brief Instanced version of drawTriangles().
+         */
+        void drawTrianglesInstanced( unsigned int firstTriangleIndex, unsigned int nTriangles, unsigned int nInstances ) const;
+
+        /*!
+         * \brief Instanced version of drawLODTriangles().
+         */
+        void drawLODTrianglesInstanced( unsigned int lodLevel, unsigned int trianglesGroupIndex, unsigned int nInstances ) const;
+
+
+        // Geometry (vertex data, BVH and OpenGL buffers), shared with the
+        // meshes created from the same primitive.
+        MeshGeometryPtr geometry_;
+
 
     private:
         // Mesh type
         MeshType type_;
 
-        // Mesh vertex data (vertices and vertex triangles).
-        MeshVertexData vertexData_;
-
         // Location of the uniform shader variable used for coloring geometries.
         static GLint uniformColorLocation;
 
@@ -167,26 +202,12 @@ class Mesh : public AbstractMesh, public Entity
         // Location of the shader uniform variable for normal matrix.
         static GLint normalMatrixLocation_;
 
-        // VAO : Vertex Attributes Array.
-        GLuint vao;
-
-        // VBO for transformed vertex data.
-        GLuint vbo;
-
-        // EBO : Elements-Buffer Array.
-        GLuint ebo;
-        GLsizei nEboElements_;
-
-        bool includesUV_;
-
         bool displayVertexNormals_;
 
         // Mesh's centroid.
         glm::vec4 originalCentroid;
         glm::vec4 transformedCentroid;
 
-        unsigned int componensPerVertex_;
-
         // Mesh's material.
         //ConstMaterialsVector materials_;
         std::vector< ResourceID > materialIDs_;
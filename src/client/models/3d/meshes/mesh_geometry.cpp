@@ -0,0 +1,340 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "mesh_geometry.hpp"
+#include <algorithm>
+
+#define GLM_FORCE_RADIANS
+#include <glm/gtx/intersect.hpp>
+
+namespace como {
+
+/***
+ * 1. Construction
+ ***/
+
+MeshGeometry::MeshGeometry( const PrimitiveData& primitiveData ) :
+    vertexData_( primitiveData.vertexData ),
+    bvhReady_( false ),
+    instancesVBO_( 0 ),
+    instancesVBOSize_( 0 ),
+    includesUV_( primitiveData.oglData.includesUV ),
+    componentsPerVertex_( primitiveData.oglData.componentsPerVertex() )
+{
+    // Check the indices before creating any OpenGL buffer, so a malformed
+    // primitive neither leaks them nor reaches the BVH or the draw calls.
+    primitiveData.validateIndices();
+
+    initOpenGLBuffers( primitiveData.oglData );
+    initVAO();
+    computeBounds();
+
+    if( vertexData_.vertexTriangles.size() < MIN_ASYNC_BVH_TRIANGLES ){
+        buildBVH();
+    }else{
+        bvhThread_ = std::thread( &MeshGeometry::buildBVH, this );
+    }
+}
+
+
+/***
+ * 2. Destruction
+ ***/
+
+MeshGeometry::~MeshGeometry()
+{
+    if( bvhThread_.joinable() ){
+        bvhThread_.join();
+    }
+
+    glDeleteBuffers( 1, &vbo_ );
+    glDeleteBuffers( 1, &ebo_ );
+    if( instancesVBO_ ){
+        glDeleteBuffers( 1, &instancesVBO_ );
+    }
+    glDeleteVertexArrays( 1, &vao_ );
+}
+
+
+/***
+ * 3. Getters
+ ***/
+
+const MeshVertexData& MeshGeometry::vertexData() const
+{
+    return vertexData_;
+}
+
+
+GLsizei MeshGeometry::nEboElements() const
+{
+    return nEboElements_;
+}
+
+
+const std::vector< std::vector< GLuint > >& MeshGeometry::lodTrianglesGroupsStarts() const
+{
+    return lodTrianglesGroupsStarts_;
+}
+
+
+bool MeshGeometry::includesUV() const
+{
+    return includesUV_;
+}
+
+
+unsigned int MeshGeometry::componentsPerVertex() const
+{
+    return componentsPerVertex_;
+}
+
+
+glm::vec3 MeshGeometry::centroid() const
+{
+    return centroid_;
+}
+
+
+float MeshGeometry::boundingRadius() const
+{
+    return boundingRadius_;
+}
+
+
+void MeshGeometry::getBounds( glm::vec3& boundsMin, glm::vec3& boundsMax ) const
+{
+    boundsMin = boundsMin_;
+    boundsMax = boundsMax_;
+}
+
+
+std::size_t MeshGeometry::cpuMemorySize() const
+{
+    std::size_t lodSize = 0;
+
+    for( const std::vector< GLuint >& trianglesGroupsStarts : lodTrianglesGroupsStarts_ ){
+        lodSize += trianglesGroupsStarts.capacity() * sizeof( GLuint );
+    }
+
+    return sizeof( MeshGeometry ) +
+            vertexData_.vertices.capacity() * sizeof( Vertex ) +
+            vertexData_.vertexTriangles.capacity() * sizeof( IndicesTriangle ) +
+            ( bvhReady_.load( std::memory_order_acquire ) ? bvh_->memorySize() : 0 ) +
+            lodSize;
+}
+
+
+std::size_t MeshGeometry::gpuMemorySize() const
+{
+    return vboSize_ + eboSize_ + instancesVBOSize_;
+}
+
+
+/***
+ * 4. Intersections
+ ***/
+
+bool MeshGeometry::intersects( const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t, GLuint& triangle ) const
+{
+    const float MAX_T = 999999.9f;
+    glm::vec3 intersection;
+
+    if( bvhReady_.load( std::memory_order_acquire ) ){
+        return bvh_->intersects( rayOrigin, rayDirection, t, triangle );
+    }
+
+    // The BVH is still being built. Intersect every triangle.
+    t = MAX_T;
+    for( unsigned int i = 0; i < vertexData_.vertexTriangles.size(); i++ ){
+        if( glm::intersectRayTriangle( rayOrigin,
+                                       rayDirection,
+                                       vertexData_.vertices[vertexData_.vertexTriangles[i][0]],
+                                       vertexData_.vertices[vertexData_.vertexTriangles[i][1]],
+                                       vertexData_.vertices[vertexData_.vertexTriangles[i][2]],
+                                       intersection ) &&
+                ( intersection.z < t ) ){
+            t = intersection.z;
+            triangle = i;
+        }
+    }
+
+    return ( t < MAX_T );
+}
+
+
+/***
+ * 5. Drawing
+ ***/
+
+void MeshGeometry::bind() const
+{
+    glBindVertexArray( vao_ );
+    glBindBuffer( GL_ARRAY_BUFFER, vbo_ );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ebo_ );
+}
+
+
+void MeshGeometry::enableInstances( const std::vector< MeshInstanceData >& instances )
+{
+    const std::size_t instancesSize = instances.size() * sizeof( MeshInstanceData );
+    const GLsizei stride = sizeof( MeshInstanceData );
+
+    if( !instancesVBO_ ){
+        glGenBuffers( 1, &instancesVBO_ );
+    }
+    glBindBuffer( GL_ARRAY_BUFFER, instancesVBO_ );
+
+    // Orphan the previous contents instead of waiting for the draw calls
+    // using them.
+    if( instancesSize > instancesVBOSize_ ){
+        instancesVBOSize_ = std::max( instancesSize, 2 * instancesVBOSize_ );
+    }
+    glBufferData( GL_ARRAY_BUFFER, instancesVBOSize_, nullptr, GL_STREAM_DRAW );
+    glBufferSubData( GL_ARRAY_BUFFER, 0, instancesSize, instances.data() );
+
+    for( GLint i = 0; i < 4; i++ ){
+        glVertexAttribPointer( SHADER_INSTANCE_MVP_MATRIX_ATTR_LOCATION + i, 4, GL_FLOAT, GL_FALSE, stride,
+                               (void *)( i * 4 * sizeof( GLfloat ) ) );
+        glVertexAttribDivisor( SHADER_INSTANCE_MVP_MATRIX_ATTR_LOCATION + i, 1 );
+        glEnableVertexAttribArray( SHADER_INSTANCE_MVP_MATRIX_ATTR_LOCATION + i );
+    }
+    for( GLint i = 0; i < 3; i++ ){
+        glVertexAttribPointer( SHADER_INSTANCE_NORMAL_MATRIX_ATTR_LOCATION + i, 3, GL_FLOAT, GL_FALSE, stride,
+                               (void *)( ( 16 + i * 3 ) * sizeof( GLfloat ) ) );
+        glVertexAttribDivisor( SHADER_INSTANCE_NORMAL_MATRIX_ATTR_LOCATION + i, 1 );
+        glEnableVertexAttribArray( SHADER_INSTANCE_NORMAL_MATRIX_ATTR_LOCATION + i );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, vbo_ );
+}
+
+
+void MeshGeometry::disableInstances()
+{
+    for( GLint i = 0; i < 4; i++ ){
+        glDisableVertexAttribArray( SHADER_INSTANCE_MVP_MATRIX_ATTR_LOCATION + i );
+    }
+    for( GLint i = 0; i < 3; i++ ){
+        glDisableVertexAttribArray( SHADER_INSTANCE_NORMAL_MATRIX_ATTR_LOCATION + i );
+    }
+}
+
+
+/***
+ * 7. Initialization
+ ***/
+
+void MeshGeometry::initOpenGLBuffers( const MeshOpenGLData& oglData )
+{
+    // Generate a VAO for the geometry and bind it as the active one.
+    glGenVertexArrays( 1, &vao_ );
+    glBindVertexArray( vao_ );
+
+    // Generate a VBO and an EBO for holding vertex data and indices.
+    glGenBuffers( 1, &vbo_ );
+    glBindBuffer( GL_ARRAY_BUFFER, vbo_ );
+    glGenBuffers( 1, &ebo_ );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ebo_ );
+
+    vboSize_ = oglData.vboData.size() * sizeof( GLfloat );
+    eboSize_ = oglData.eboData.size() * sizeof( GLuint );
+    for( const MeshLODLevel& lodLevel : oglData.lodLevels ){
+        eboSize_ += lodLevel.eboData.size() * sizeof( GLuint );
+    }
+
+    // Populate the VBO.
+    glBufferData( GL_ARRAY_BUFFER, vboSize_, &( oglData.vboData[0] ), GL_STATIC_DRAW );
+
+    // Populate the EBO with the full resolution triangles followed by the
+    // ones of every level of detail.
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, eboSize_, nullptr, GL_STATIC_DRAW );
+    glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, 0, oglData.eboData.size() * sizeof( GLuint ), &( oglData.eboData[0] ) );
+
+    nEboElements_ = oglData.eboData.size();
+
+    lodTrianglesGroupsStarts_.clear();
+    GLuint firstLODTriangle = nEboElements_ / 3;
+    for( const MeshLODLevel& lodLevel : oglData.lodLevels ){
+        std::vector< GLuint > trianglesGroupsStarts( 1, firstLODTriangle );
+
+        glBufferSubData( GL_ELEMENT_ARRAY_BUFFER,
+                         firstLODTriangle * 3 * sizeof( GLuint ),
+                         lodLevel.eboData.size() * sizeof( GLuint ),
+                         &( lodLevel.eboData[0] ) );
+
+        for( GLuint trianglesGroupSize : lodLevel.trianglesGroupsSizes ){
+            trianglesGroupsStarts.push_back( trianglesGroupsStarts.back() + trianglesGroupSize );
+        }
+        firstLODTriangle = trianglesGroupsStarts.back();
+
+        lodTrianglesGroupsStarts_.push_back( trianglesGroupsStarts );
+    }
+}
+
+
+void MeshGeometry::initVAO()
+{
+    const GLsizei bytesPerVertex = componentsPerVertex_ * sizeof( GL_FLOAT );
+
+    // Set the organization of the vertex and normals data in the VBO.
+    glBindVertexArray( vao_ );
+    glBindBuffer( GL_ARRAY_BUFFER, vbo_ );
+    glVertexAttribPointer( SHADER_VERTEX_ATTR_LOCATION, 3, GL_FLOAT, GL_FALSE, bytesPerVertex, (void *)( 0 ) );
+    glVertexAttribPointer( SHADER_NORMAL_ATTR_LOCATION, 3, GL_FLOAT, GL_FALSE, bytesPerVertex, (void *)( COMPONENTS_PER_VERTEX_POSITION * sizeof( GL_FLOAT ) ) );
+
+    // Enable previous vertex data arrays.
+    glEnableVertexAttribArray( SHADER_VERTEX_ATTR_LOCATION );
+    glEnableVertexAttribArray( SHADER_NORMAL_ATTR_LOCATION );
+
+    if( includesUV_ ){
+        glVertexAttribPointer( SHADER_UV_ATTR_LOCATION, 2, GL_FLOAT, GL_FALSE, bytesPerVertex, (void *)( COMPONENTS_PER_VERTEX_POSITION * 2 * sizeof( GL_FLOAT ) ) );
+        glEnableVertexAttribArray( SHADER_UV_ATTR_LOCATION );
+    }
+}
+
+
+void MeshGeometry::computeBounds()
+{
+    centroid_ = vertexData_.centroid();
+
+    boundingRadius_ = 0.0f;
+    boundsMin_ = boundsMax_ = centroid_;
+    for( const glm::vec3& vertex : vertexData_.vertices ){
+        boundingRadius_ = std::max( boundingRadius_, glm::length( vertex - centroid_ ) );
+        boundsMin_ = glm::min( boundsMin_, vertex );
+        boundsMax_ = glm::max( boundsMax_, vertex );
+    }
+}
+
+
+
+void MeshGeometry::buildBVH()
+{
+    // vertexData_ isn't modified after construction, so it can be read
+    // here while the GUI thread intersects rays with it.
+    try{
+        bvh_.reset( new MeshBVH( vertexData_ ) );
+        bvhReady_.store( true, std::memory_order_release );
+    }catch( std::exception& ){
+        // Keep intersecting every triangle. This may run in bvhThread_, so
+        // nothing can be thrown from here.
+    }
+}
+
+} // namespace como
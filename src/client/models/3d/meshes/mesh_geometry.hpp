@@ -0,0 +1,207 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef MESH_GEOMETRY_HPP
+#define MESH_GEOMETRY_HPP
+
+#define GL_GLEXT_PROTOTYPES
+extern "C" {
+    #include <GL/gl.h>
+}
+#include <common/primitives/primitive_data/primitive_data.hpp>
+#include <common/primitives/primitive_data/mesh_bvh.hpp>
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace como {
+
+const GLuint COMPONENTS_PER_VERTEX_POSITION = 3;
+const GLuint COMPONENTS_PER_VERTEX = 6;
+
+// Locations of the vertex attributes in the shaders. The instance matrices
+// take one location per column.
+const GLint SHADER_VERTEX_ATTR_LOCATION = 0;
+const GLint SHADER_NORMAL_ATTR_LOCATION = 1;
+const GLint SHADER_UV_ATTR_LOCATION = 2;
+const GLint SHADER_INSTANCE_MVP_MATRIX_ATTR_LOCATION = 3;
+const GLint SHADER_INSTANCE_NORMAL_MATRIX_ATTR_LOCATION = 7;
+
+// Geometries with fewer triangles build their BVH right away instead of in
+// a worker thread.
+const std::size_t MIN_ASYNC_BVH_TRIANGLES = 64 * 1024;
+
+
+/*!
+ * \brief Data sent to the shaders for every instance of a geometry drawn
+ * with an instanced draw call.
+ */
+struct MeshInstanceData {
+    glm::mat4 mvpMatrix;
+    glm::mat3 normalMatrix;
+};
+
+
+/*!
+ * \class MeshGeometry
+ *
+ * \brief Geometry of a mesh (vertex data, BVH and OpenGL buffers), which
+ * can be shared by all the meshes created from the same primitive.
+ *
+ * The BVH of big geometries is built in a worker thread, so creating them
+ * doesn't stall the GUI thread. Rays are intersected against every
+ * triangle until the BVH is ready.
+ */
+class MeshGeometry
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        MeshGeometry( const PrimitiveData& primitiveData );
+        MeshGeometry() = delete;
+        MeshGeometry( const MeshGeometry& ) = delete;
+        MeshGeometry( MeshGeometry&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        /*! \brief Destructor. Waits for the BVH build to finish. */
+        ~MeshGeometry();
+
+
+        /***
+         * 3. Getters
+         ***/
+        const MeshVertexData& vertexData() const;
+        GLsizei nEboElements() const;
+
+        /*!
+         * \brief For every level of detail, the first triangle of every
+         * triangles group in the EBO, followed by the level's end.
+         */
+        const std::vector< std::vector< GLuint > >& lodTrianglesGroupsStarts() const;
+
+        bool includesUV() const;
+        unsigned int componentsPerVertex() const;
+        glm::vec3 centroid() const;
+
+        /*!
+         * \brief Radius of the sphere around the centroid which bounds the
+         * geometry.
+         */
+        float boundingRadius() const;
+        void getBounds( glm::vec3& boundsMin, glm::vec3& boundsMax ) const;
+
+        /*! \brief Main memory taken by the geometry (in bytes). */
+        std::size_t cpuMemorySize() const;
+
+        /*! \brief GPU memory taken by the geometry's buffers (in bytes). */
+        std::size_t gpuMemorySize() const;
+
+
+        /***
+         * 4. Intersections
+         ***/
+        /*!
+         * \brief Intersects the given ray with the geometry (see
+         * MeshBVH::intersects()).
+         */
+        bool intersects( const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t, GLuint& triangle ) const;
+
+
+        /***
+         * 5. Drawing
+         ***/
+        /*!
+         * \brief Binds the geometry's VAO, VBO and EBO as the active ones.
+         */
+        void bind() const;
+
+        /*!
+         * \brief Uploads the given instances data and enables it as
+         * instanced vertex attributes. The geometry must be bound.
+         */
+        void enableInstances( const std::vector< MeshInstanceData >& instances );
+
+        /*!
+         * \brief Disables the instanced vertex attributes. The geometry
+         * must be bound.
+         */
+        void disableInstances();
+
+
+        /***
+         * 6. Operators
+         ***/
+        MeshGeometry& operator = ( const MeshGeometry& ) = delete;
+        MeshGeometry& operator = ( MeshGeometry&& ) = delete;
+
+
+    private:
+        /***
+         * 7. Initialization
+         ***/
+        void initOpenGLBuffers( const MeshOpenGLData& oglData );
+        void initVAO();
+        void computeBounds();
+        void buildBVH();
+
+
+        // Vertex data (vertices and vertex triangles).
+        MeshVertexData vertexData_;
+
+        // BVH used for intersecting rays with vertexData_, only accessed
+        // once bvhReady_ is set.
+        std::unique_ptr< MeshBVH > bvh_;
+        std::atomic< bool > bvhReady_;
+        std::thread bvhThread_;
+
+        // VAO, VBO and EBO. The levels of detail are stored in the EBO after
+        // the full resolution triangles.
+        GLuint vao_;
+        GLuint vbo_;
+        GLuint ebo_;
+        GLsizei nEboElements_;
+        std::size_t vboSize_;
+        std::size_t eboSize_;
+
+        std::vector< std::vector< GLuint > > lodTrianglesGroupsStarts_;
+
+        // Buffer for the instances data, grown as needed.
+        GLuint instancesVBO_;
+        std::size_t instancesVBOSize_;
+
+        bool includesUV_;
+        unsigned int componentsPerVertex_;
+
+        glm::vec3 centroid_;
+        float boundingRadius_;
+        glm::vec3 boundsMin_;
+        glm::vec3 boundsMax_;
+};
+
+typedef std::shared_ptr< MeshGeometry > MeshGeometryPtr;
+
+} // namespace como
+
+#endif // MESH_GEOMETRY_HPP
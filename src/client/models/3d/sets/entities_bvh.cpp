@@ -0,0 +1,436 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "entities_bvh.hpp"
+#include <client/models/3d/view_frustum.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace como {
+
+const unsigned int NULL_NODE = std::numeric_limits< unsigned int >::max();
+
+// Margin added to the entities bounds on every side, relative to their
+// largest extent.
+const float BOUNDS_MARGIN_RATIO = 0.1f;
+
+
+static float surfaceArea( const glm::vec3& boundsMin, const glm::vec3& boundsMax )
+{
+    const glm::vec3 extent = boundsMax - boundsMin;
+    return 2.0f * ( extent.x * extent.y + extent.y * extent.z + extent.z * extent.x );
+}
+
+
+static float unionSurfaceArea( const glm::vec3& aMin, const glm::vec3& aMax, const glm::vec3& bMin, const glm::vec3& bMax )
+{
+    return surfaceArea( glm::min( aMin, bMin ), glm::max( aMax, bMax ) );
+}
+
+
+/***
+ * 1. Construction
+ ***/
+
+EntitiesBVH::EntitiesBVH() :
+    root_( NULL_NODE ),
+    freeList_( NULL_NODE ),
+    nEntities_( 0 )
+{}
+
+
+/***
+ * 3. Entities insertion / removal
+ ***/
+
+unsigned int EntitiesBVH::insertEntity( const ResourceID& entityID, const glm::vec3& boundsMin, const glm::vec3& boundsMax )
+{
+    LOCK
+
+    const unsigned int leaf = allocateNode();
+    const glm::vec3 extent = boundsMax - boundsMin;
+    const glm::vec3 margin( BOUNDS_MARGIN_RATIO * std::max( extent.x, std::max( extent.y, extent.z ) ) );
+
+    nodes_[leaf].boundsMin = boundsMin - margin;
+    nodes_[leaf].boundsMax = boundsMax + margin;
+    nodes_[leaf].height = 0;
+    nodes_[leaf].entityID = entityID;
+    insertLeaf( leaf );
+    nEntities_++;
+
+    return leaf;
+}
+
+
+void EntitiesBVH::removeEntity( unsigned int leaf )
+{
+    LOCK
+
+    removeLeaf( leaf );
+    freeNode( leaf );
+    nEntities_--;
+}
+
+
+void EntitiesBVH::moveEntity( unsigned int leaf, const glm::vec3& boundsMin, const glm::vec3& boundsMax )
+{
+    LOCK
+
+    Node& node = nodes_[leaf];
+    if( glm::all( glm::lessThanEqual( node.boundsMin, boundsMin ) ) &&
+        glm::all( glm::lessThanEqual( boundsMax, node.boundsMax ) ) ){
+        return;
+    }
+
+    const glm::vec3 extent = boundsMax - boundsMin;
+    const glm::vec3 margin( BOUNDS_MARGIN_RATIO * std::max( extent.x, std::max( extent.y, extent.z ) ) );
+
+    removeLeaf( leaf );
+    node.boundsMin = boundsMin - margin;
+    node.boundsMax = boundsMax + margin;
+    insertLeaf( leaf );
+}
+
+
+/***
+ * 4. Queries
+ ***/
+
+void EntitiesBVH::intersectRay( const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float maxT, std::vector< EntitiesBVHRayHit >& hits ) const
+{
+    LOCK
+
+    std::vector< unsigned int > nodesStack;
+    const glm::vec3 invDirection = 1.0f / rayDirection;
+
+    hits.clear();
+    if( root_ == NULL_NODE ){
+        return;
+    }
+
+    nodesStack.push_back( root_ );
+    while( !nodesStack.empty() ){
+        const Node& node = nodes_[nodesStack.back()];
+        nodesStack.pop_back();
+
+        // Slab test. A NaN (ray parallel to and lying on a slab's plane)
+        // is ignored by std::max / std::min as used here.
+        float tEntry = 0.0f;
+        float tExit = maxT;
+        for( unsigned int axis = 0; axis < 3; axis++ ){
+            float tNear = ( node.boundsMin[axis] - rayOrigin[axis] ) * invDirection[axis];
+            float tFar = ( node.boundsMax[axis] - rayOrigin[axis] ) * invDirection[axis];
+            if( tNear > tFar ){
+                std::swap( tNear, tFar );
+            }
+            tEntry = std::max( tEntry, tNear );
+            tExit = std::min( tExit, tFar );
+        }
+        if( tEntry > tExit ){
+            continue;
+        }
+
+        if( node.height == 0 ){
+            hits.push_back( EntitiesBVHRayHit{ node.entityID, tEntry } );
+        }else{
+            nodesStack.push_back( node.children[0] );
+            nodesStack.push_back( node.children[1] );
+        }
+    }
+
+    std::sort( hits.begin(), hits.end(),
+               []( const EntitiesBVHRayHit& a, const EntitiesBVHRayHit& b ){
+                    return a.t < b.t;
+               });
+}
+
+
+void EntitiesBVH::queryBox( const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector< ResourceID >& entities ) const
+{
+    LOCK
+
+    std::vector< unsigned int > nodesStack;
+
+    entities.clear();
+    if( root_ == NULL_NODE ){
+        return;
+    }
+
+    nodesStack.push_back( root_ );
+    while( !nodesStack.empty() ){
+        const Node& node = nodes_[nodesStack.back()];
+        nodesStack.pop_back();
+
+        if( glm::any( glm::lessThan( node.boundsMax, boxMin ) ) ||
+            glm::any( glm::lessThan( boxMax, node.boundsMin ) ) ){
+            continue;
+        }
+
+        if( node.height == 0 ){
+            entities.push_back( node.entityID );
+        }else{
+            nodesStack.push_back( node.children[0] );
+            nodesStack.push_back( node.children[1] );
+        }
+    }
+}
+
+
+void EntitiesBVH::queryFrustum( const glm::mat4& viewProjectionMatrix, std::vector< ResourceID >& entities ) const
+{
+    LOCK
+
+    const ViewFrustum frustum( viewProjectionMatrix );
+
+    // Nodes to visit, along with a flag telling if their parent is
+    // completely inside the frustum (so they don't need to be tested).
+    std::vector< std::pair< unsigned int, bool > > nodesStack;
+
+    entities.clear();
+    if( root_ == NULL_NODE ){
+        return;
+    }
+
+    nodesStack.push_back( std::make_pair( root_, false ) );
+    while( !nodesStack.empty() ){
+        const Node& node = nodes_[nodesStack.back().first];
+        bool inside = nodesStack.back().second;
+        nodesStack.pop_back();
+
+        if( !inside ){
+            const FrustumIntersection intersection =
+                    frustum.testBox( node.boundsMin, node.boundsMax );
+
+            if( intersection == FrustumIntersection::OUTSIDE ){
+                continue;
+            }
+            inside = ( intersection == FrustumIntersection::INSIDE );
+        }
+
+        if( node.height == 0 ){
+            entities.push_back( node.entityID );
+        }else{
+            nodesStack.push_back( std::make_pair( node.children[0], inside ) );
+            nodesStack.push_back( std::make_pair( node.children[1], inside ) );
+        }
+    }
+}
+
+
+/***
+ * 5. Getters
+ ***/
+
+unsigned int EntitiesBVH::size() const
+{
+    LOCK
+
+    return nEntities_;
+}
+
+
+/***
+ * 7. Nodes management
+ ***/
+
+unsigned int EntitiesBVH::allocateNode()
+{
+    unsigned int node = freeList_;
+
+    if( node == NULL_NODE ){
+        node = nodes_.size();
+        nodes_.push_back( Node() );
+    }else{
+        freeList_ = nodes_[node].parent;
+    }
+
+    nodes_[node].parent = NULL_NODE;
+    nodes_[node].children[0] = nodes_[node].children[1] = NULL_NODE;
+    nodes_[node].height = 0;
+
+    return node;
+}
+
+
+void EntitiesBVH::freeNode( unsigned int node )
+{
+    nodes_[node].parent = freeList_;
+    nodes_[node].height = -1;
+    freeList_ = node;
+}
+
+
+/***
+ * 8. Tree structure
+ ***/
+
+void EntitiesBVH::insertLeaf( unsigned int leaf )
+{
+    if( root_ == NULL_NODE ){
+        root_ = leaf;
+        nodes_[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Descend to the sibling which minimizes the surface area added to
+    // the tree: the cost of pairing the leaf with a node is the surface
+    // area of their union plus the area all its ancestors grow.
+    const glm::vec3 leafMin = nodes_[leaf].boundsMin;
+    const glm::vec3 leafMax = nodes_[leaf].boundsMax;
+    unsigned int sibling = root_;
+
+    while( nodes_[sibling].height > 0 ){
+        const Node& node = nodes_[sibling];
+        const float area = surfaceArea( node.boundsMin, node.boundsMax );
+        const float combinedArea = unionSurfaceArea( node.boundsMin, node.boundsMax, leafMin, leafMax );
+
+        // Cost of creating a new parent for this node and the leaf, and
+        // minimum cost of pushing the leaf further down.
+        const float cost = 2.0f * combinedArea;
+        const float inheritanceCost = 2.0f * ( combinedArea - area );
+        float childrenCosts[2];
+
+        for( unsigned int i = 0; i < 2; i++ ){
+            const Node& child = nodes_[node.children[i]];
+            childrenCosts[i] = unionSurfaceArea( child.boundsMin, child.boundsMax, leafMin, leafMax ) + inheritanceCost;
+            if( child.height > 0 ){
+                childrenCosts[i] -= surfaceArea( child.boundsMin, child.boundsMax );
+            }
+        }
+
+        if( cost < childrenCosts[0] && cost < childrenCosts[1] ){
+            break;
+        }
+        sibling = node.children[ ( childrenCosts[0] < childrenCosts[1] ) ? 0 : 1 ];
+    }
+
+    // Create a new parent for the sibling and the leaf.
+    const unsigned int oldParent = nodes_[sibling].parent;
+    const unsigned int newParent = allocateNode();
+
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].children[0] = sibling;
+    nodes_[newParent].children[1] = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if( oldParent != NULL_NODE ){
+        unsigned int* children = nodes_[oldParent].children;
+        children[ ( children[0] == sibling ) ? 0 : 1 ] = newParent;
+    }else{
+        root_ = newParent;
+    }
+
+    refitAncestors( newParent );
+}
+
+
+void EntitiesBVH::removeLeaf( unsigned int leaf )
+{
+    if( leaf == root_ ){
+        root_ = NULL_NODE;
+        return;
+    }
+
+    // Replace the leaf's parent with the leaf's sibling.
+    const unsigned int parent = nodes_[leaf].parent;
+    const unsigned int grandParent = nodes_[parent].parent;
+    const unsigned int sibling = nodes_[parent].children[ ( nodes_[parent].children[0] == leaf ) ? 1 : 0 ];
+
+    nodes_[sibling].parent = grandParent;
+    freeNode( parent );
+
+    if( grandParent != NULL_NODE ){
+        unsigned int* children = nodes_[grandParent].children;
+        children[ ( children[0] == parent ) ? 0 : 1 ] = sibling;
+        refitAncestors( grandParent );
+    }else{
+        root_ = sibling;
+    }
+}
+
+
+void EntitiesBVH::refitAncestors( unsigned int node )
+{
+    while( node != NULL_NODE ){
+        node = balance( node );
+        refit( node );
+        node = nodes_[node].parent;
+    }
+}
+
+
+unsigned int EntitiesBVH::rotateUp( unsigned int node, unsigned int childSlot )
+{
+    // The child at childSlot (C) takes the node's (A) place. A becomes C's
+    // first child and keeps the shorter of C's children in place of C.
+    const unsigned int child = nodes_[node].children[childSlot];
+    const unsigned int grandChildren[2] = { nodes_[child].children[0], nodes_[child].children[1] };
+    const unsigned int parent = nodes_[node].parent;
+    const unsigned int tallerGrandChild =
+            ( nodes_[grandChildren[0]].height > nodes_[grandChildren[1]].height ) ? 0 : 1;
+
+    nodes_[child].children[0] = node;
+    nodes_[child].children[1] = grandChildren[tallerGrandChild];
+    nodes_[child].parent = parent;
+    nodes_[node].parent = child;
+    nodes_[node].children[childSlot] = grandChildren[1 - tallerGrandChild];
+    nodes_[grandChildren[1 - tallerGrandChild]].parent = node;
+
+    if( parent != NULL_NODE ){
+        unsigned int* children = nodes_[parent].children;
+        children[ ( children[0] == node ) ? 0 : 1 ] = child;
+    }else{
+        root_ = child;
+    }
+
+    refit( node );
+    refit( child );
+
+    return child;
+}
+
+
+unsigned int EntitiesBVH::balance( unsigned int node )
+{
+    if( nodes_[node].height < 2 ){
+        return node;
+    }
+
+    const int balanceFactor =
+            nodes_[nodes_[node].children[1]].height - nodes_[nodes_[node].children[0]].height;
+    if( balanceFactor > 1 ){
+        return rotateUp( node, 1 );
+    }else if( balanceFactor < -1 ){
+        return rotateUp( node, 0 );
+    }
+    return node;
+}
+
+
+void EntitiesBVH::refit( unsigned int node )
+{
+    const Node& child0 = nodes_[nodes_[node].children[0]];
+    const Node& child1 = nodes_[nodes_[node].children[1]];
+
+    nodes_[node].height = 1 + std::max( child0.height, child1.height );
+    nodes_[node].boundsMin = glm::min( child0.boundsMin, child1.boundsMin );
+    nodes_[node].boundsMax = glm::max( child0.boundsMax, child1.boundsMax );
+}
+
+} // namespace como
@@ -0,0 +1,170 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef ENTITIES_BVH_HPP
+#define ENTITIES_BVH_HPP
+
+#include <common/ids/resource_id.hpp>
+#include <common/utilities/lockable.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace como {
+
+/*!
+ * \brief Entity whose bounds are crossed by a ray.
+ */
+struct EntitiesBVHRayHit {
+    ResourceID entityID;
+
+    // Ray parameter at which the ray enters the entity's bounds.
+    float t;
+};
+
+
+/*!
+ * \class EntitiesBVH
+ *
+ * \brief Dynamic bounding volume hierarchy over the world space bounds of
+ * the entities in the scene, used as broadphase for picking and area
+ * queries. Entities are inserted where they increase the surface area of
+ * the tree the least, and the tree is kept balanced with rotations (as
+ * Box2D's dynamic tree does). Leaves keep enlarged bounds, so entities
+ * moved by small amounts don't need to be reinserted.
+ */
+class EntitiesBVH : public Lockable
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        EntitiesBVH();
+        EntitiesBVH( const EntitiesBVH& ) = delete;
+        EntitiesBVH( EntitiesBVH&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~EntitiesBVH() = default;
+
+
+        /***
+         * 3. Entities insertion / removal
+         ***/
+        /*!
+         * \brief Inserts an entity with the given world space bounds.
+         * \return the leaf holding the entity, used for moving or removing
+         * it later.
+         */
+        unsigned int insertEntity( const ResourceID& entityID, const glm::vec3& boundsMin, const glm::vec3& boundsMax );
+        void removeEntity( unsigned int leaf );
+
+        /*!
+         * \brief Updates the bounds of the entity held by the given leaf.
+         * The leaf is only reinserted if the new bounds aren't contained
+         * in its enlarged ones.
+         */
+        void moveEntity( unsigned int leaf, const glm::vec3& boundsMin, const glm::vec3& boundsMax );
+
+
+        /***
+         * 4. Queries
+         ***/
+        /*!
+         * \brief Gets the entities whose bounds are crossed by the given ray
+         * for t in [0, maxT], sorted by the parameter t at which the ray
+         * enters their bounds.
+         */
+        void intersectRay( const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float maxT, std::vector< EntitiesBVHRayHit >& hits ) const;
+
+        /*!
+         * \brief Gets the entities whose bounds overlap the given box.
+         */
+        void queryBox( const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector< ResourceID >& entities ) const;
+
+        /*!
+         * \brief Gets the entities whose bounds are, at least partially,
+         * inside the frustum given by a view-projection matrix.
+         */
+        void queryFrustum( const glm::mat4& viewProjectionMatrix, std::vector< ResourceID >& entities ) const;
+
+
+        /***
+         * 5. Getters
+         ***/
+        unsigned int size() const;
+
+
+        /***
+         * 6. Operators
+         ***/
+        EntitiesBVH& operator = ( const EntitiesBVH& ) = delete;
+        EntitiesBVH& operator = ( EntitiesBVH&& ) = delete;
+
+
+    private:
+        struct Node {
+            // Enlarged bounds for leaves, union of the children bounds
+            // for inner nodes.
+            glm::vec3 boundsMin;
+            glm::vec3 boundsMax;
+
+            // Parent node, or next node in the free list for free nodes.
+            unsigned int parent;
+
+            unsigned int children[2];
+
+            // Height of the node's subtree (0 for leaves, -1 for free
+            // nodes).
+            int height;
+
+            ResourceID entityID;
+        };
+
+
+        /***
+         * 7. Nodes management
+         ***/
+        unsigned int allocateNode();
+        void freeNode( unsigned int node );
+
+
+        /***
+         * 8. Tree structure
+         ***/
+        void insertLeaf( unsigned int leaf );
+        void removeLeaf( unsigned int leaf );
+        void refitAncestors( unsigned int node );
+        unsigned int rotateUp( unsigned int node, unsigned int childSlot );
+        unsigned int balance( unsigned int node );
+        void refit( unsigned int node );
+
+
+        std::vector< Node > nodes_;
+        unsigned int root_;
+        unsigned int freeList_;
+        unsigned int nEntities_;
+};
+
+typedef std::shared_ptr< EntitiesBVH > EntitiesBVHPtr;
+
+} // namespace como
+
+#endif // ENTITIES_BVH_HPP
@@ -0,0 +1,173 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "view_frustum.hpp"
+
+#if defined( __SSE__ ) || defined( _M_X64 )
+#define VIEW_FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace como {
+
+/***
+ * 1. PackedBounds
+ ***/
+
+void PackedBounds::clear()
+{
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+
+void PackedBounds::reserve( unsigned int nBoxes )
+{
+    minX.reserve( nBoxes );
+    minY.reserve( nBoxes );
+    minZ.reserve( nBoxes );
+    maxX.reserve( nBoxes );
+    maxY.reserve( nBoxes );
+    maxZ.reserve( nBoxes );
+}
+
+
+void PackedBounds::push_back( const glm::vec3& boundsMin, const glm::vec3& boundsMax )
+{
+    minX.push_back( boundsMin.x );
+    minY.push_back( boundsMin.y );
+    minZ.push_back( boundsMin.z );
+    maxX.push_back( boundsMax.x );
+    maxY.push_back( boundsMax.y );
+    maxZ.push_back( boundsMax.z );
+}
+
+
+unsigned int PackedBounds::size() const
+{
+    return minX.size();
+}
+
+
+/***
+ * 2. ViewFrustum construction
+ ***/
+
+ViewFrustum::ViewFrustum( const glm::mat4& viewProjectionMatrix )
+{
+    // Extract the planes from the view-projection matrix rows
+    // (Gribb & Hartmann).
+    for( unsigned int i = 0; i < 3; i++ ){
+        for( unsigned int j = 0; j < 4; j++ ){
+            planes_[2 * i][j] = viewProjectionMatrix[j][3] + viewProjectionMatrix[j][i];
+            planes_[2 * i + 1][j] = viewProjectionMatrix[j][3] - viewProjectionMatrix[j][i];
+        }
+    }
+}
+
+
+/***
+ * 3. ViewFrustum intersections
+ ***/
+
+FrustumIntersection ViewFrustum::testBox( const glm::vec3& boundsMin, const glm::vec3& boundsMax ) const
+{
+    FrustumIntersection intersection = FrustumIntersection::INSIDE;
+
+    for( const glm::vec4& plane : planes_ ){
+        const glm::vec3 normal( plane );
+        glm::vec3 nearestCorner, farthestCorner;
+
+        // Box corners farthest along the plane normal and in the opposite
+        // direction.
+        for( unsigned int axis = 0; axis < 3; axis++ ){
+            farthestCorner[axis] = ( normal[axis] >= 0.0f ) ? boundsMax[axis] : boundsMin[axis];
+            nearestCorner[axis] = ( normal[axis] >= 0.0f ) ? boundsMin[axis] : boundsMax[axis];
+        }
+        if( glm::dot( normal, farthestCorner ) + plane.w < 0.0f ){
+            return FrustumIntersection::OUTSIDE;
+        }else if( glm::dot( normal, nearestCorner ) + plane.w < 0.0f ){
+            intersection = FrustumIntersection::INTERSECTING;
+        }
+    }
+
+    return intersection;
+}
+
+
+unsigned int ViewFrustum::cullBoxes( const PackedBounds& bounds, std::vector< std::uint8_t >& visible ) const
+{
+    const unsigned int nBoxes = bounds.size();
+    const float* farthestCorners[6][3];
+    unsigned int nVisibleBoxes = 0;
+    unsigned int i = 0;
+
+    visible.resize( nBoxes );
+
+    // All the boxes share the corner farthest along each plane normal, so
+    // the coordinates array to read for each plane can be chosen once.
+    for( unsigned int plane = 0; plane < 6; plane++ ){
+        farthestCorners[plane][0] = ( planes_[plane].x >= 0.0f ) ? bounds.maxX.data() : bounds.minX.data();
+        farthestCorners[plane][1] = ( planes_[plane].y >= 0.0f ) ? bounds.maxY.data() : bounds.minY.data();
+        farthestCorners[plane][2] = ( planes_[plane].z >= 0.0f ) ? bounds.maxZ.data() : bounds.minZ.data();
+    }
+
+#ifdef VIEW_FRUSTUM_SSE
+    for( ; i + 4 <= nBoxes; i += 4 ){
+        __m128 insideMask = _mm_cmpeq_ps( _mm_setzero_ps(), _mm_setzero_ps() );
+
+        for( unsigned int plane = 0; plane < 6; plane++ ){
+            const __m128 distance =
+                    _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( planes_[plane].x ), _mm_loadu_ps( farthestCorners[plane][0] + i ) ),
+                                            _mm_mul_ps( _mm_set1_ps( planes_[plane].y ), _mm_loadu_ps( farthestCorners[plane][1] + i ) ) ),
+                                _mm_add_ps( _mm_mul_ps( _mm_set1_ps( planes_[plane].z ), _mm_loadu_ps( farthestCorners[plane][2] + i ) ),
+                                            _mm_set1_ps( planes_[plane].w ) ) );
+            insideMask = _mm_and_ps( insideMask, _mm_cmpge_ps( distance, _mm_setzero_ps() ) );
+        }
+
+        const int mask = _mm_movemask_ps( insideMask );
+        for( unsigned int j = 0; j < 4; j++ ){
+            visible[i + j] = ( mask >> j ) & 1;
+            nVisibleBoxes += visible[i + j];
+        }
+    }
+#endif
+
+    for( ; i < nBoxes; i++ ){
+        visible[i] = 1;
+        for( unsigned int plane = 0; plane < 6 && visible[i]; plane++ ){
+            const float distance =
+                    ( planes_[plane].x * farthestCorners[plane][0][i] +
+                      planes_[plane].y * farthestCorners[plane][1][i] ) +
+                    ( planes_[plane].z * farthestCorners[plane][2][i] +
+                      planes_[plane].w );
+            if( !( distance >= 0.0f ) ){
+                visible[i] = 0;
+            }
+        }
+        nVisibleBoxes += visible[i];
+    }
+
+    return nVisibleBoxes;
+}
+
+} // namespace como
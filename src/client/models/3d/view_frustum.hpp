@@ -0,0 +1,123 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef VIEW_FRUSTUM_HPP
+#define VIEW_FRUSTUM_HPP
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace como {
+
+/*!
+ * \brief Position of a box relative to a view frustum.
+ */
+enum class FrustumIntersection {
+    OUTSIDE,
+    INTERSECTING,
+    INSIDE
+};
+
+
+/*!
+ * \brief Number of entities drawn and culled while rendering a frame.
+ */
+struct CullingStats {
+    unsigned int nDrawnEntities;
+    unsigned int nCulledEntities;
+};
+
+
+/*!
+ * \brief Array of axis aligned boxes, stored as one array per coordinate
+ * so they can be tested against a frustum four at a time.
+ */
+struct PackedBounds {
+    std::vector< float > minX;
+    std::vector< float > minY;
+    std::vector< float > minZ;
+    std::vector< float > maxX;
+    std::vector< float > maxY;
+    std::vector< float > maxZ;
+
+    void clear();
+    void reserve( unsigned int nBoxes );
+    void push_back( const glm::vec3& boundsMin, const glm::vec3& boundsMax );
+    unsigned int size() const;
+};
+
+
+/*!
+ * \class ViewFrustum
+ *
+ * \brief Frustum bounded by the six clipping planes of a view-projection
+ * matrix.
+ */
+class ViewFrustum
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        ViewFrustum( const glm::mat4& viewProjectionMatrix );
+        ViewFrustum() = delete;
+        ViewFrustum( const ViewFrustum& ) = default;
+        ViewFrustum( ViewFrustum&& ) = default;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~ViewFrustum() = default;
+
+
+        /***
+         * 3. Intersections
+         ***/
+        /*!
+         * \brief Tells whether the given box is outside, inside or
+         * intersecting the frustum.
+         */
+        FrustumIntersection testBox( const glm::vec3& boundsMin, const glm::vec3& boundsMax ) const;
+
+        /*!
+         * \brief Tests all the given boxes against the frustum, setting
+         * visible[i] to 1 if the i-th box is (at least partially) inside the
+         * frustum and to 0 otherwise.
+         * \return the number of visible boxes.
+         */
+        unsigned int cullBoxes( const PackedBounds& bounds, std::vector< std::uint8_t >& visible ) const;
+
+
+        /***
+         * 4. Operators
+         ***/
+        ViewFrustum& operator = ( const ViewFrustum& ) = default;
+        ViewFrustum& operator = ( ViewFrustum&& ) = default;
+
+
+    private:
+        // Frustum planes (left, right, bottom, top, near and far). Points
+        // inside the frustum are in the positive side of all of them.
+        glm::vec4 planes_[6];
+};
+
+} // namespace como
+
+#endif // VIEW_FRUSTUM_HPP
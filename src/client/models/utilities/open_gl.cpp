@@ -192,6 +192,24 @@ void OpenGL::setUniformVec4( GLint location, const glm::vec4& value )
 }
 
 
+void OpenGL::enableInstancing()
+{
+    LOCK
+
+    GLint uniformLocation = getShaderVariableLocation( "instancingEnabled" );
+    glUniform1i( uniformLocation, 1 );
+}
+
+
+void OpenGL::disableInstancing()
+{
+    LOCK
+
+    GLint uniformLocation = getShaderVariableLocation( "instancingEnabled" );
+    glUniform1i( uniformLocation, 0 );
+}
+
+
 /***
  * 5. Utilities
  ***/
@@ -80,6 +80,14 @@ class OpenGL : public Lockable
         void setUniformVec3( GLint location, const glm::vec3& value );
         void setUniformVec4( GLint location, const glm::vec4& value );
 
+        /*!
+         * \brief Makes the default shader program take the MVP and normal
+         * matrices from the instanced vertex attributes instead of from the
+         * uniform variables.
+         */
+        void enableInstancing();
+        void disableInstancing();
+
 
         /***
          * 5. Utilities
@@ -21,6 +21,7 @@
 
 #include "camera_command.hpp"
 #include <common/packables/packable_float.hpp>
+#include <common/packables/packable_normalized_float.hpp>
 
 namespace como {
 
@@ -64,7 +65,7 @@ class CameraCreationCommand : public CameraCommand
     private:
         PackableArray< PackableFloat, float, 3 > cameraEye_;
         PackableArray< PackableFloat, float, 3 > cameraCenter_;
-        PackableArray< PackableFloat, float, 3 > cameraUp_;
+        PackableArray< PackableNormalizedFloat, float, 3 > cameraUp_;
 };
 
 } // namespace como
@@ -60,6 +60,18 @@ UserID Command::getUserID() const
 }
 
 
+const PackableFile* Command::getFile() const
+{
+    return nullptr;
+}
+
+
+PackableFile* Command::getFile()
+{
+    return nullptr;
+}
+
+
 /***
  * 4. Buffer pre reading
  ***/
@@ -32,6 +32,8 @@
 
 namespace como {
 
+class PackableFile;
+
 /*
  * Possible values for a command's target. A command's target indicates
  * the element / entity the command focuses on (ie. an user or a drawable).
@@ -50,7 +52,8 @@ enum class CommandTarget : std::uint8_t
     TEXTURE,
     TEXTURE_WALL,
     CAMERA,
-    ENTITY
+    ENTITY,
+    FILE
 };
 
 
@@ -79,7 +82,8 @@ const char commandTargetStrings[][32]
     "TEXTURE",
     "TEXTURE_WALL",
     "CAMERA",
-    "ENTITY"
+    "ENTITY",
+    "FILE"
 };
 
 #define COMMAND_CLONE_METHOD(T) virtual Command* clone() const { return new T( *this ); }
@@ -148,6 +152,15 @@ class Command : public CompositePackable
         /*! \brief Returns the ID of the user who performed this command */
         UserID getUserID() const ;
 
+        /*!
+         * \brief Returns the file carried by this command, if any (nullptr
+         * otherwise).
+         */
+        virtual const PackableFile* getFile() const;
+
+        /*! \brief Non-const version of the previous method. */
+        virtual PackableFile* getFile();
+
 
         /***
          * 4. Buffer pre reading
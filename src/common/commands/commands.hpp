@@ -33,5 +33,6 @@
 #include "texture_wall_commands/texture_wall_commands.hpp"
 #include "camera_commands/camera_commands.hpp"
 #include "entity_commands/entity_commands.hpp"
+#include "file_commands/file_commands.hpp"
 
 #endif // COMMANDS_HPP
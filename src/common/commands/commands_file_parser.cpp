@@ -19,9 +19,16 @@
 #include "commands_file_parser.hpp"
 #include <common/exceptions/file_not_open_exception.hpp>
 #include <common/packables/packable_packet_size.hpp>
+#include <common/packables/float_encoding.hpp>
+#include <common/packables/packable_file.hpp>
 
 namespace como {
 
+// Scene files always store IEEE-754 floats, whatever the float encoding
+// used in the network.
+const FloatEncoding SCENE_FILE_FLOAT_ENCODING = FloatEncoding::IEEE_754;
+
+
 /***
  * 1. Construction
  ***/
@@ -67,7 +74,11 @@ CommandPtr CommandsFileParser::readNextCommand( std::ifstream& file )
                     std::to_string( commandSize.getValue() ) +
                     std::string( " bytes could be read" ) );
     }
-    command->unpack( commandBuffer.data() );
+    command->unpack( commandBuffer.data(), SCENE_FILE_FLOAT_ENCODING );
+
+    // Commands read from file are used right away, so wait for their files
+    // to be written.
+    PackableFile::flushWrites();
 
     return command;
 }
@@ -75,8 +86,18 @@ CommandPtr CommandsFileParser::readNextCommand( std::ifstream& file )
 
 void CommandsFileParser::writeCommand( const Command &command, std::ofstream &file )
 {
+    // Scene files are self-contained, so the contents of streamed files are
+    // always written inline.
+    CommandPtr inlineCommand;
+    const Command* writtenCommand = &command;
+    if( ( command.getFile() != nullptr ) && command.getFile()->isStreamed() ){
+        inlineCommand = CommandPtr( command.clone() );
+        inlineCommand->getFile()->setStreamed( false );
+        writtenCommand = inlineCommand.get();
+    }
+
     char commandSizeBuffer[8];
-    const PackablePacketSize commandSize( command.getPacketSize() );
+    const PackablePacketSize commandSize( writtenCommand->getPacketSize( SCENE_FILE_FLOAT_ENCODING ) );
     std::vector< char > commandBuffer;
 
     // Write command's size to file.
@@ -85,7 +106,7 @@ void CommandsFileParser::writeCommand( const Command &command, std::ofstream &fi
 
     // Write command to file.
     commandBuffer.resize( commandSize.getValue() );
-    command.pack( commandBuffer.data() );
+    writtenCommand->pack( commandBuffer.data(), SCENE_FILE_FLOAT_ENCODING );
     file.write( commandBuffer.data(), commandSize.getValue() );
 }
 
@@ -0,0 +1,199 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "file_chunk_command.hpp"
+#include <algorithm>
+#include <cstring>
+
+#define ADD_PACKABLES \
+    addPackable( &fileID_ ); \
+    addPackable( &fileSize_ ); \
+    addPackable( &offset_ ); \
+    addPackable( &chunkSize_ );
+
+namespace como {
+
+/***
+ * 1. Construction
+ ***/
+
+FileChunkCommand::FileChunkCommand( const std::string& unpackingDirPath ) :
+    Command( CommandTarget::FILE, NO_USER ),
+    unpackingDirPath_( unpackingDirPath ),
+    fileID_( NO_RESOURCE ),
+    fileSize_( 0 ),
+    offset_( 0 ),
+    chunkSize_( 0 )
+{
+    ADD_PACKABLES
+}
+
+
+FileChunkCommand::FileChunkCommand( UserID userID,
+                                    const ResourceID& fileID,
+                                    std::uint32_t fileSize,
+                                    std::uint32_t offset,
+                                    std::vector< char > data ) :
+    Command( CommandTarget::FILE, userID ),
+    fileID_( fileID ),
+    fileSize_( fileSize ),
+    offset_( offset ),
+    chunkSize_( static_cast< std::uint32_t >( data.size() ) ),
+    data_( std::move( data ) )
+{
+    ADD_PACKABLES
+}
+
+
+FileChunkCommand::FileChunkCommand( UserID userID,
+                                    const ResourceID& fileID,
+                                    FileViewConstPtr fileView,
+                                    std::uint32_t offset,
+                                    std::uint32_t chunkSize ) :
+    Command( CommandTarget::FILE, userID ),
+    fileID_( fileID ),
+    fileSize_( fileView->size() ),
+    offset_( offset ),
+    chunkSize_( chunkSize ),
+    fileView_( fileView )
+{
+    ADD_PACKABLES
+}
+
+
+FileChunkCommand::FileChunkCommand( const FileChunkCommand& b ) :
+    Command( b ),
+    unpackingDirPath_( b.unpackingDirPath_ ),
+    fileID_( b.fileID_ ),
+    fileSize_( b.fileSize_ ),
+    offset_( b.offset_ ),
+    chunkSize_( b.chunkSize_ ),
+    data_( b.data_ ),
+    fileView_( b.fileView_ )
+{
+    ADD_PACKABLES
+}
+
+
+std::list< CommandConstPtr > FileChunkCommand::generateFileChunks( UserID userID, const PackableFile& file )
+{
+    std::list< CommandConstPtr > chunks;
+    const FileViewConstPtr fileView = file.getFileView();
+    std::uint32_t offset = 0;
+
+    while( offset < fileView->size() ){
+        chunks.push_back(
+                    CommandConstPtr(
+                        new FileChunkCommand( userID,
+                                              file.getFileID(),
+                                              fileView,
+                                              offset,
+                                              std::min( FILE_CHUNK_SIZE, fileView->size() - offset ) ) ) );
+        offset += FILE_CHUNK_SIZE;
+    }
+
+    return chunks;
+}
+
+
+/***
+ * 3. Packing and unpacking
+ ***/
+
+void* FileChunkCommand::pack( void* buffer ) const
+{
+    char* castedBuffer = static_cast< char* >( Command::pack( buffer ) );
+
+    std::memcpy( castedBuffer, chunkData(), chunkSize_.getValue() );
+
+    return static_cast< void* >( castedBuffer + chunkSize_.getValue() );
+}
+
+
+const void* FileChunkCommand::unpack( const void* buffer )
+{
+    const char* castedBuffer = static_cast< const char* >( Command::unpack( buffer ) );
+
+    data_.assign( castedBuffer, castedBuffer + chunkSize_.getValue() );
+    fileView_.reset();
+
+    PackableFile::writeFileChunk( unpackingDirPath_,
+                                  fileID_.getValue(),
+                                  fileSize_.getValue(),
+                                  offset_.getValue(),
+                                  data_.data(),
+                                  chunkSize_.getValue() );
+
+    return static_cast< const void* >( castedBuffer + data_.size() );
+}
+
+
+const void* FileChunkCommand::unpack( const void* buffer ) const
+{
+    const char* castedBuffer = static_cast< const char* >( Command::unpack( buffer ) );
+
+    if( std::memcmp( castedBuffer, chunkData(), chunkSize_.getValue() ) ){
+        throw std::runtime_error( "ERROR unpacked data doesn't match file chunk contents (const)" );
+    }
+
+    return static_cast< const void* >( castedBuffer + chunkSize_.getValue() );
+}
+
+
+/***
+ * 4. Getters
+ ***/
+
+PacketSize FileChunkCommand::getPacketSize() const
+{
+    return Command::getPacketSize() + chunkSize_.getValue();
+}
+
+
+ResourceID FileChunkCommand::fileID() const
+{
+    return fileID_.getValue();
+}
+
+
+std::uint32_t FileChunkCommand::offset() const
+{
+    return offset_.getValue();
+}
+
+
+std::uint32_t FileChunkCommand::chunkSize() const
+{
+    return chunkSize_.getValue();
+}
+
+
+/***
+ * 6. Auxiliar methods
+ ***/
+
+const char* FileChunkCommand::chunkData() const
+{
+    if( fileView_ != nullptr ){
+        return fileView_->data() + offset_.getValue();
+    }else{
+        return data_.data();
+    }
+}
+
+} // namespace como
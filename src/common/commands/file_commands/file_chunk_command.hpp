@@ -0,0 +1,141 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef FILE_CHUNK_COMMAND_HPP
+#define FILE_CHUNK_COMMAND_HPP
+
+#include <common/commands/command.hpp>
+#include <common/packables/packable_file.hpp>
+#include <list>
+#include <vector>
+
+namespace como {
+
+/*! Maximum size (in bytes) of the data carried by a FileChunkCommand. */
+const std::uint32_t FILE_CHUNK_SIZE = 16 * 1024;
+
+/*!
+ * \class FileChunkCommand
+ *
+ * \brief Command carrying a chunk of a streamed file (see PackableFile).
+ * Chunks are sent in order, before the command creating a resource from the
+ * file, and interleaved with the rest of commands in the scene updates.
+ */
+class FileChunkCommand : public Command
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        FileChunkCommand() = delete;
+        FileChunkCommand( const std::string& unpackingDirPath );
+        FileChunkCommand( UserID userID,
+                          const ResourceID& fileID,
+                          std::uint32_t fileSize,
+                          std::uint32_t offset,
+                          std::vector< char > data );
+        FileChunkCommand( UserID userID,
+                          const ResourceID& fileID,
+                          FileViewConstPtr fileView,
+                          std::uint32_t offset,
+                          std::uint32_t chunkSize );
+        FileChunkCommand( const FileChunkCommand& );
+        FileChunkCommand( FileChunkCommand&& ) = delete;
+        COMMAND_CLONE_METHOD( FileChunkCommand )
+
+        /*!
+         * \brief Splits the contents of the given file into a list of
+         * FileChunkCommand. The chunks reference the file's shared view
+         * instead of copying its contents.
+         */
+        static std::list< CommandConstPtr > generateFileChunks( UserID userID, const PackableFile& file );
+
+
+        /***
+         * 2. Destruction
+         ***/
+        virtual ~FileChunkCommand() = default;
+
+
+        /***
+         * 3. Packing and unpacking
+         ***/
+        virtual void* pack( void* buffer ) const;
+
+        /*!
+         * \brief Unpacks the chunk from the given buffer and writes it to
+         * the file being assembled (see PackableFile::writeFileChunk()).
+         */
+        virtual const void* unpack( const void* buffer );
+        virtual const void* unpack( const void* buffer ) const;
+        virtual void* pack( void* buffer, FloatEncoding ) const { return pack( buffer ); }
+        virtual const void* unpack( const void* buffer, FloatEncoding ) { return unpack( buffer ); }
+
+
+        /***
+         * 4. Getters
+         ***/
+        virtual PacketSize getPacketSize() const;
+        virtual PacketSize getPacketSize( FloatEncoding ) const { return getPacketSize(); }
+        ResourceID fileID() const;
+        std::uint32_t offset() const;
+        std::uint32_t chunkSize() const;
+
+
+        /***
+         * 5. Operators
+         ***/
+        FileChunkCommand& operator = ( const FileChunkCommand& ) = delete;
+        FileChunkCommand& operator = ( FileChunkCommand&& ) = delete;
+
+
+    private:
+        /*! \brief Path of the directory where the file is assembled. */
+        std::string unpackingDirPath_;
+
+        /*! \brief ID of the streamed file this chunk belongs to. */
+        PackableResourceID fileID_;
+
+        /*! \brief Total size of the streamed file. */
+        PackableUint32< std::uint32_t > fileSize_;
+
+        /*! \brief Position of this chunk in the streamed file. */
+        PackableUint32< std::uint32_t > offset_;
+
+        /*! \brief Size of this chunk. */
+        PackableUint32< std::uint32_t > chunkSize_;
+
+        /*! \brief Chunk contents (when unpacked). */
+        std::vector< char > data_;
+
+        /*!
+         * \brief View of the file the chunk contents are packed from (when
+         * generated with generateFileChunks()).
+         */
+        FileViewConstPtr fileView_;
+
+
+        /***
+         * 6. Auxiliar methods
+         ***/
+        const char* chunkData() const;
+};
+
+} // namespace como
+
+#endif // FILE_CHUNK_COMMAND_HPP
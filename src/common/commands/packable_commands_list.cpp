@@ -48,7 +48,7 @@ PackableCommandsList::PackableCommandsList( const PackableCommandsList& b ) :
 void* PackableCommandsList::pack( void* buffer ) const
 {
     CommandsList::const_iterator it;
-    PackableUint8< std::uint8_t > nCommands;
+    PackableVarUint32 nCommands;
 
     // Retrieve the number of commands and pack it.
     nCommands.setValue( commands_.size() );
@@ -65,7 +65,7 @@ void* PackableCommandsList::pack( void* buffer ) const
 
 const void* PackableCommandsList::unpack( const void* buffer )
 {
-    PackableUint8< std::uint8_t > nCommands;
+    PackableVarUint32 nCommands;
     unsigned int i;
 
     // Unpack the number of commands.
@@ -85,7 +85,7 @@ const void* PackableCommandsList::unpack( const void* buffer )
 
 const void* PackableCommandsList::unpack( const void* buffer ) const
 {
-    const PackableUint8< std::uint8_t > nCommands( commands_.size() );
+    const PackableVarUint32 nCommands( commands_.size() );
     CommandsList::const_iterator it;
 
     // Unpack the number of commands.
@@ -108,9 +108,9 @@ PacketSize PackableCommandsList::getPacketSize() const
 {
     CommandsList::const_iterator it;
 
-    // The size of the list (Uint8) is packed / unpacked along with the list
-    // itself. Sum its size (in bytes) to the total packet size.
-    PacketSize packetSize = sizeof( std::uint8_t );
+    // The size of the list (VarUint32) is packed / unpacked along with the
+    // list itself. Sum its size (in bytes) to the total packet size.
+    PacketSize packetSize = PackableVarUint32::packetSize( commands_.size() );
 
     // Sum the packet size of every command present in this list to the total
     // packet size.
@@ -138,6 +138,16 @@ void PackableCommandsList::addCommand( CommandConstPtr command )
 }
 
 
+CommandsList PackableCommandsList::takeCommands()
+{
+    CommandsList commands;
+
+    commands.swap( commands_ );
+
+    return commands;
+}
+
+
 void PackableCommandsList::clear()
 {
     commands_.clear();
@@ -317,6 +327,10 @@ CommandPtr PackableCommandsList::createEmtpyCommandFromBuffer(const void *buffer
             }
         break;
 
+        case CommandTarget::FILE:
+            command = CommandPtr( new FileChunkCommand( unpackingDirPath ) );
+        break;
+
         default:
             int commandTarget = static_cast< int >( Command::getTarget( buffer ) );
             throw std::runtime_error( "Received an unrecognized command (target: " +
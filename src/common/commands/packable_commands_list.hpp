@@ -21,6 +21,7 @@
 
 #include "commands.hpp"
 #include <common/packables/packable.hpp>
+#include <common/packables/packable_var_uint32.hpp>
 #include <list>
 
 namespace como {
@@ -121,6 +122,12 @@ class PackableCommandsList : public Packable
         /*! \brief Add a command to the list */
         void addCommand( CommandConstPtr command );
 
+        /*!
+         * \brief Moves the commands out of this list, leaving it empty.
+         * \return the commands held by this list.
+         */
+        CommandsList takeCommands();
+
         /*! \brief Clear the commands list by removing all its elements */
         void clear();
 
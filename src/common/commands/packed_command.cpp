@@ -0,0 +1,97 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "packed_command.hpp"
+#include <common/utilities/compression.hpp>
+
+namespace como {
+
+/***
+ * 1. Construction
+ ***/
+
+PackedCommand::PackedCommand( const Command& command, bool sendToAuthor ) :
+    authorID_( command.getUserID() ),
+    sendToAuthor_( sendToAuthor ),
+    buffer_( command.getPacketSize() ),
+    checksum_( 0 )
+{
+    command.pack( buffer_.data() );
+}
+
+
+/***
+ * 3. Getters
+ ***/
+
+UserID PackedCommand::authorID() const
+{
+    return authorID_;
+}
+
+
+bool PackedCommand::mustBeSentToUser( UserID userID ) const
+{
+    return ( authorID_ != userID ) || sendToAuthor_;
+}
+
+
+PacketSize PackedCommand::size() const
+{
+    return buffer_.size();
+}
+
+
+boost::asio::const_buffer PackedCommand::buffer() const
+{
+    return boost::asio::buffer( buffer_ );
+}
+
+
+const std::vector< char >* PackedCommand::compressedBuffer() const
+{
+    std::call_once( compressionFlag_, &PackedCommand::compress, this );
+
+    return compressedBuffer_.empty() ? nullptr : &compressedBuffer_;
+}
+
+
+std::uint32_t PackedCommand::checksum() const
+{
+    std::call_once( compressionFlag_, &PackedCommand::compress, this );
+
+    return checksum_;
+}
+
+
+/***
+ * 5. Compression
+ ***/
+
+void PackedCommand::compress() const
+{
+    checksum_ = como::checksum( buffer_.data(), buffer_.size() );
+
+    if( ( buffer_.size() < MIN_COMPRESSED_COMMAND_SIZE ) ||
+            !compressSegment( buffer_.data(), buffer_.size(), compressedBuffer_ ) ){
+        compressedBuffer_.clear();
+    }
+    compressedBuffer_.shrink_to_fit();
+}
+
+} // namespace como
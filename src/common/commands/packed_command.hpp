@@ -0,0 +1,153 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PACKED_COMMAND_HPP
+#define PACKED_COMMAND_HPP
+
+#include <common/commands/command.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace como {
+
+// Packed commands smaller than this aren't compressed.
+const PacketSize MIN_COMPRESSED_COMMAND_SIZE = 1024;
+
+/*!
+ * \class PackedCommand
+ *
+ * \brief Immutable wire encoding of a Command. A command is packed only
+ * once when it is created and the resulting bytes are shared (by reference
+ * counting) among all the packets it is sent in.
+ */
+class PackedCommand
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*! \brief Default constructor */
+        PackedCommand() = delete;
+
+        /*!
+         * \brief Packs the given command.
+         * \param command command to be packed.
+         * \param sendToAuthor true if the command must also be sent back to
+         * the user who performed it.
+         */
+        PackedCommand( const Command& command, bool sendToAuthor );
+
+        /*! \brief Copy constructor */
+        PackedCommand( const PackedCommand& ) = delete;
+
+        /*! \brief Move constructor */
+        PackedCommand( PackedCommand&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+
+        /*! \brief Destructor */
+        ~PackedCommand() = default;
+
+
+        /***
+         * 3. Getters
+         ***/
+
+        /*! \brief Returns the ID of the user who performed the command */
+        UserID authorID() const;
+
+        /*!
+         * \brief Returns true if the command must be sent to the user with
+         * the given ID.
+         */
+        bool mustBeSentToUser( UserID userID ) const;
+
+        /*! \brief Returns the size (in bytes) of the packed command */
+        PacketSize size() const;
+
+        /*! \brief Returns a buffer wrapping the packed command */
+        boost::asio::const_buffer buffer() const;
+
+        /*!
+         * \brief Returns the packed command compressed as a segment of a
+         * compressed stream (see compressSegment()), or nullptr if the
+         * command is smaller than MIN_COMPRESSED_COMMAND_SIZE or it doesn't
+         * get smaller. The command is compressed the first time this is
+         * called and the result is shared by all the packets it is sent in.
+         */
+        const std::vector< char >* compressedBuffer() const;
+
+        /*! \brief Returns the checksum of the packed command (see checksum()) */
+        std::uint32_t checksum() const;
+
+
+        /***
+         * 4. Operators
+         ***/
+
+        /*! \brief Copy assignment operator */
+        PackedCommand& operator = ( const PackedCommand& ) = delete;
+
+        /*! \brief Move assignment operator */
+        PackedCommand& operator = ( PackedCommand&& ) = delete;
+
+
+    private:
+        /***
+         * 5. Compression
+         ***/
+
+        /*! \brief Computes the checksum and the compressed buffer. */
+        void compress() const;
+
+
+        /***
+         * Attributes
+         ***/
+
+        /*! ID of the user who performed the command */
+        const UserID authorID_;
+
+        /*! True if the command must be sent back to its author */
+        const bool sendToAuthor_;
+
+        /*! Packed command */
+        std::vector< char > buffer_;
+
+        /*! Ensures compress() is called only once */
+        mutable std::once_flag compressionFlag_;
+
+        /*! Packed command compressed (empty if it isn't worth it) */
+        mutable std::vector< char > compressedBuffer_;
+
+        /*! Checksum of the packed command */
+        mutable std::uint32_t checksum_;
+};
+
+typedef std::shared_ptr< const PackedCommand > PackedCommandConstPtr;
+
+} // namespace como
+
+#endif // PACKED_COMMAND_HPP
@@ -26,6 +26,8 @@ PrimitiveCreationCommand::PrimitiveCreationCommand( UserID userID, ResourceID pr
     primitiveFile_( unpackingDirPath, primitive.filePath )
 
 {
+    primitiveFile_.setFileID( primitiveID );
+
     ADD_PACKABLES
 }
 
@@ -56,4 +58,16 @@ PrimitiveInfo PrimitiveCreationCommand::getPrimitiveInfo() const
 }
 
 
+const PackableFile* PrimitiveCreationCommand::getFile() const
+{
+    return &primitiveFile_;
+}
+
+
+PackableFile* PrimitiveCreationCommand::getFile()
+{
+    return &primitiveFile_;
+}
+
+
 } // namespace como
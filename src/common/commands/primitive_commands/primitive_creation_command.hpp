@@ -57,6 +57,8 @@ class PrimitiveCreationCommand : public PrimitiveCommand
          * 3. Getters
          ***/
         PrimitiveInfo getPrimitiveInfo() const;
+        virtual const PackableFile* getFile() const;
+        virtual PackableFile* getFile();
 
 
         /***
@@ -21,6 +21,7 @@
 
 #include "selection_command.hpp"
 #include <common/packables/packable_float.hpp>
+#include <common/packables/packable_angle.hpp>
 #include <common/packables/array/packable_array_3.hpp>
 
 namespace como {
@@ -41,7 +42,7 @@ class SelectionTransformationCommand : public SelectionCommand
 {
     private:
         PackableSelectionTransformationCommandType transformationType_;
-        PackableFloat transformationAngle_;
+        PackableAngle transformationAngle_;
         PackableArray3< PackableFloat, float > transformationVector_;
         PackableArray3< PackableFloat, float > pivotPoint_;
 
@@ -36,6 +36,8 @@ TextureCreationCommand::TextureCreationCommand( const ResourceID &textureID, con
     TextureCommand( textureID, textureID.getCreatorID(), TextureCommandType::TEXTURE_CREATION ),
     textureFile_( unpackingDirPath, textureFilePath )
 {
+    textureFile_.setFileID( textureID );
+
     addPackable( &textureFile_ );
 }
 
@@ -57,4 +59,16 @@ std::string TextureCreationCommand::textureFilePath() const
     return textureFile_.getFilePath();
 }
 
+
+const PackableFile* TextureCreationCommand::getFile() const
+{
+    return &textureFile_;
+}
+
+
+PackableFile* TextureCreationCommand::getFile()
+{
+    return &textureFile_;
+}
+
 } // namespace como
@@ -48,6 +48,8 @@ class TextureCreationCommand : public TextureCommand
          * 3. Getters
          ***/
         std::string textureFilePath() const;
+        virtual const PackableFile* getFile() const;
+        virtual PackableFile* getFile();
 
 
         /***
@@ -85,6 +85,9 @@ class PackableArray : public AbstractPackableWrapper< std::array< ElementPlainTy
         /*! \brief see Packable::getPacketSize */
         virtual PacketSize getPacketSize() const;
 
+        /*! \brief see Packable::getPacketSize( FloatEncoding ) const */
+        virtual PacketSize getPacketSize( FloatEncoding floatEncoding ) const;
+
         /*!
          * \brief returns a reference to the indexed element.
          * \param index - the index of the requested array element.
@@ -135,6 +138,12 @@ class PackableArray : public AbstractPackableWrapper< std::array< ElementPlainTy
         /*! \brief see Packable::unpack const */
         virtual const void* unpack( const void* buffer ) const;
 
+        /*! \brief see Packable::pack( void*, FloatEncoding ) const */
+        virtual void* pack( void* buffer, FloatEncoding floatEncoding ) const;
+
+        /*! \brief see Packable::unpack( const void*, FloatEncoding ) */
+        virtual const void* unpack( const void* buffer, FloatEncoding floatEncoding );
+
 
         /***
          * 6. Operators
@@ -188,6 +197,13 @@ PacketSize PackableArray<ElementPackableType, ElementPlainType, ARRAY_SIZE>::get
 }
 
 
+template <class ElementPackableType, class ElementPlainType, unsigned int ARRAY_SIZE >
+PacketSize PackableArray<ElementPackableType, ElementPlainType, ARRAY_SIZE>::getPacketSize( FloatEncoding floatEncoding ) const
+{
+    return static_cast< const Packable& >( elements_[0] ).getPacketSize( floatEncoding ) * ARRAY_SIZE;
+}
+
+
 template <class ElementPackableType, class ElementPlainType, unsigned int ARRAY_SIZE >
 std::array< ElementPlainType, ARRAY_SIZE > PackableArray<ElementPackableType, ElementPlainType, ARRAY_SIZE>::getValue() const
 {
@@ -299,6 +315,32 @@ const void* PackableArray<ElementPackableType, ElementPlainType, ARRAY_SIZE>::un
 }
 
 
+template <class ElementPackableType, class ElementPlainType, unsigned int ARRAY_SIZE >
+void* PackableArray<ElementPackableType, ElementPlainType, ARRAY_SIZE>::pack( void* buffer, FloatEncoding floatEncoding ) const
+{
+    unsigned int i;
+
+    for( i=0; i<ARRAY_SIZE; i++ ){
+        buffer = static_cast< const Packable& >( elements_[i] ).pack( buffer, floatEncoding );
+    }
+
+    return buffer;
+}
+
+
+template <class ElementPackableType, class ElementPlainType, unsigned int ARRAY_SIZE >
+const void* PackableArray<ElementPackableType, ElementPlainType, ARRAY_SIZE>::unpack( const void* buffer, FloatEncoding floatEncoding )
+{
+    unsigned int i;
+
+    for( i=0; i<ARRAY_SIZE; i++ ){
+        buffer = static_cast< Packable& >( elements_[i] ).unpack( buffer, floatEncoding );
+    }
+
+    return buffer;
+}
+
+
 /***
  * 6. Operators
  ***/
@@ -17,6 +17,7 @@
 ***/
 
 #include "composite_packable.hpp"
+#include <common/packables/float_encoding.hpp>
 
 namespace como {
 
@@ -26,39 +27,51 @@ namespace como {
  ***/
 
 void* CompositePackable::pack( void* buffer ) const
+{
+    return CompositePackable::pack( buffer, getFloatEncoding() );
+}
+
+
+const void* CompositePackable::unpack( const void* buffer )
+{
+    return CompositePackable::unpack( buffer, getFloatEncoding() );
+}
+
+
+const void* CompositePackable::unpack( const void* buffer ) const
 {
     std::vector< PackablePair >::const_iterator it;
 
     for( it = packables_.begin(); it != packables_.end(); it++ ){
-        buffer = it->constant->pack( buffer );
+        buffer = it->constant->unpack( buffer );
     }
 
     return buffer;
 }
 
 
-const void* CompositePackable::unpack( const void* buffer )
+void* CompositePackable::pack( void* buffer, FloatEncoding floatEncoding ) const
 {
-    std::vector< PackablePair >::iterator it;
+    std::vector< PackablePair >::const_iterator it;
 
     for( it = packables_.begin(); it != packables_.end(); it++ ){
-        if( it->variable != nullptr ){
-            buffer = it->variable->unpack( buffer );
-        }else{
-            buffer = it->constant->unpack( buffer );
-        }
+        buffer = it->constant->pack( buffer, floatEncoding );
     }
 
     return buffer;
 }
 
 
-const void* CompositePackable::unpack( const void* buffer ) const
+const void* CompositePackable::unpack( const void* buffer, FloatEncoding floatEncoding )
 {
-    std::vector< PackablePair >::const_iterator it;
+    std::vector< PackablePair >::iterator it;
 
     for( it = packables_.begin(); it != packables_.end(); it++ ){
-        buffer = it->constant->unpack( buffer );
+        if( it->variable != nullptr ){
+            buffer = it->variable->unpack( buffer, floatEncoding );
+        }else{
+            buffer = it->constant->unpack( buffer );
+        }
     }
 
     return buffer;
@@ -71,12 +84,18 @@ const void* CompositePackable::unpack( const void* buffer ) const
 
 
 PacketSize CompositePackable::getPacketSize() const
+{
+    return CompositePackable::getPacketSize( getFloatEncoding() );
+}
+
+
+PacketSize CompositePackable::getPacketSize( FloatEncoding floatEncoding ) const
 {
     PacketSize packetSize = 0;
     std::vector< PackablePair >::const_iterator it;
 
     for( it = packables_.begin(); it != packables_.end(); it++ ){
-        packetSize += it->constant->getPacketSize();
+        packetSize += it->constant->getPacketSize( floatEncoding );
     }
 
     return packetSize;
@@ -135,6 +135,12 @@ class CompositePackable : public Packable
          */
         virtual const void* unpack( const void* buffer ) const ;
 
+        /*! \brief see Packable::pack( void*, FloatEncoding ) const */
+        virtual void* pack( void* buffer, FloatEncoding floatEncoding ) const;
+
+        /*! \brief see Packable::unpack( const void*, FloatEncoding ) */
+        virtual const void* unpack( const void* buffer, FloatEncoding floatEncoding );
+
 
         /***
          * 4. Getters
@@ -147,6 +153,9 @@ class CompositePackable : public Packable
          * would ocuppy once packed.
          */
         virtual PacketSize getPacketSize() const;
+
+        /*! \brief see Packable::getPacketSize( FloatEncoding ) const */
+        virtual PacketSize getPacketSize( FloatEncoding floatEncoding ) const;
     protected:
 
         /*!
@@ -0,0 +1,45 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "float_encoding.hpp"
+#include <atomic>
+
+namespace como {
+
+// Float encoding used by this process.
+static std::atomic< FloatEncoding > floatEncoding( FloatEncoding::IEEE_754 );
+
+
+std::uint8_t floatEncodingBit( FloatEncoding floatEncoding )
+{
+    return static_cast< std::uint8_t >( 1 << static_cast< std::uint8_t >( floatEncoding ) );
+}
+
+
+void setFloatEncoding( FloatEncoding newFloatEncoding )
+{
+    floatEncoding = newFloatEncoding;
+}
+
+
+FloatEncoding getFloatEncoding()
+{
+    return floatEncoding;
+}
+
+} // namespace como
@@ -0,0 +1,58 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef FLOAT_ENCODING_HPP
+#define FLOAT_ENCODING_HPP
+
+#include <common/packables/packable_integer.hpp>
+#include <cstdint>
+
+namespace como {
+
+/*!
+ * \brief Encoding used for packing the floats whose range is known
+ * (directions and angles). Other floats are always packed as IEEE-754
+ * floats.
+ */
+enum class FloatEncoding : std::uint8_t
+{
+    IEEE_754 = 0,
+    QUANTIZED_16
+};
+typedef PackableUint8< FloatEncoding > PackableFloatEncoding;
+
+/*! \brief Returns the bit representing the given encoding in a mask of
+ * supported float encodings. */
+std::uint8_t floatEncodingBit( FloatEncoding floatEncoding );
+
+// Mask of float encodings supported by this build.
+const std::uint8_t SUPPORTED_FLOAT_ENCODINGS = 0x03;
+
+/*!
+ * \brief Set the float encoding used by this process. It is chosen by the
+ * server and sent to the users in the USER_ACCEPTED packet, so all the
+ * commands in a session are packed with the same encoding.
+ */
+void setFloatEncoding( FloatEncoding floatEncoding );
+
+/*! \brief Returns the float encoding used by this process. */
+FloatEncoding getFloatEncoding();
+
+} // namespace como
+
+#endif // FLOAT_ENCODING_HPP
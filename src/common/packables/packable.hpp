@@ -28,6 +28,8 @@ const unsigned int NAME_SIZE = 64;
 
 typedef std::uint32_t PacketSize;
 
+enum class FloatEncoding : std::uint8_t;
+
 /*!
  * \class Packable
  *
@@ -83,6 +85,24 @@ class Packable
          */
         virtual const void* unpack( const void* buffer ) const = 0;
 
+        /*!
+         * \brief Packs this packable into the given buffer, using the given
+         * float encoding instead of the one used by this process.
+         * \param buffer a pointer to the buffer where this packable will be packed into.
+         * \param floatEncoding encoding used for packing the floats whose range is known.
+         * \return a pointer to the first position in the buffer after this packable's packed data.
+         */
+        virtual void* pack( void* buffer, FloatEncoding ) const { return pack( buffer ); }
+
+        /*!
+         * \brief Unpacks this packable from the given buffer, using the given
+         * float encoding instead of the one used by this process.
+         * \param buffer a pointer to the buffer where this packable will be unpacked from.
+         * \param floatEncoding encoding used for unpacking the floats whose range is known.
+         * \return a pointer to the first position in the buffer after this packable's packed data.
+         */
+        virtual const void* unpack( const void* buffer, FloatEncoding ) { return unpack( buffer ); }
+
 
         /***
          * 4. Getters
@@ -94,6 +114,14 @@ class Packable
          */
         virtual PacketSize getPacketSize() const = 0;
 
+        /*!
+         * \brief Returns the size that this packable's data would occupy once
+         * packed with the given float encoding.
+         * \param floatEncoding encoding used for packing the floats whose range is known.
+         * \return the size that this packable's data would occupy once packed.
+         */
+        virtual PacketSize getPacketSize( FloatEncoding ) const { return getPacketSize(); }
+
 
         /***
          * 5. Operators
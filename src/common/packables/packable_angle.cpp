@@ -0,0 +1,58 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "packable_angle.hpp"
+#include <cmath>
+
+namespace como {
+
+const float PI = 3.14159265358979f;
+const float ANGLE_SCALE = 32768.0f / PI;
+
+
+/***
+ * 1. Construction
+ ***/
+
+PackableAngle::PackableAngle( float value ) :
+    PackableQuantizedFloat( value )
+{}
+
+
+/***
+ * 4. Quantization
+ ***/
+
+std::int16_t PackableAngle::quantize( float value ) const
+{
+    // Wrap the angle to [-pi, pi). Rounding may still give 32768 (pi), which
+    // wraps to -32768 (-pi) when truncated to 16 bits.
+    value = std::remainder( value, 2.0f * PI );
+
+    return static_cast< std::int16_t >(
+                static_cast< std::uint16_t >(
+                    static_cast< std::int32_t >( std::round( value * ANGLE_SCALE ) ) ) );
+}
+
+
+float PackableAngle::dequantize( std::int16_t quantizedValue ) const
+{
+    return quantizedValue / ANGLE_SCALE;
+}
+
+} // namespace como
@@ -0,0 +1,88 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PACKABLE_ANGLE_HPP
+#define PACKABLE_ANGLE_HPP
+
+#include <common/packables/packable_quantized_float.hpp>
+
+namespace como {
+
+/*!
+ * \class PackableAngle
+ *
+ * \brief Angle in radians, quantized as a 16 bits fraction of half a turn.
+ * The quantized angle is wrapped to [-pi, pi).
+ */
+class PackableAngle : public PackableQuantizedFloat
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*! \brief Default constructor */
+        PackableAngle() = default;
+
+        /*!
+         * \brief Constructs a PackableAngle from the given value.
+         * \param value value to initialize PackableAngle with.
+         */
+        PackableAngle( float value );
+
+        /*! \brief Copy constructor */
+        PackableAngle( const PackableAngle& ) = default;
+
+        /*! \brief Move constructor */
+        PackableAngle( PackableAngle&& ) = default;
+
+
+        /***
+         * 2. Destruction
+         ***/
+
+        /*! \brief Destructor */
+        virtual ~PackableAngle() = default;
+
+
+        /***
+         * 3. Operators
+         ***/
+
+        /*! \brief Copy assignment operator */
+        PackableAngle& operator = ( const PackableAngle& ) = default;
+
+        /*! \brief Move assignment operator */
+        PackableAngle& operator = ( PackableAngle&& ) = default;
+
+
+    protected:
+        /***
+         * 4. Quantization
+         ***/
+
+        /*! \brief see PackableQuantizedFloat::quantize */
+        virtual std::int16_t quantize( float value ) const;
+
+        /*! \brief see PackableQuantizedFloat::dequantize */
+        virtual float dequantize( std::int16_t quantizedValue ) const;
+};
+
+} // namespace como
+
+#endif // PACKABLE_ANGLE_HPP
@@ -0,0 +1,112 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "packable_blob_hashes.hpp"
+#include <common/packables/packable_var_uint32.hpp>
+
+namespace como {
+
+/***
+ * 3. Packing and unpacking
+ ***/
+
+void* PackableBlobHashes::pack( void* buffer ) const
+{
+    const PackableVarUint32 nHashes( hashes_.size() );
+    PackableBlobHash packableHash;
+
+    buffer = nHashes.pack( buffer );
+
+    for( const BlobHash& hash : hashes_ ){
+        packableHash.setValue( hash );
+        buffer = packableHash.pack( buffer );
+    }
+
+    return buffer;
+}
+
+
+const void* PackableBlobHashes::unpack( const void* buffer )
+{
+    PackableVarUint32 nHashes;
+    PackableBlobHash packableHash;
+
+    buffer = nHashes.unpack( buffer );
+    if( nHashes.getValue() > MAX_BLOB_HASHES ){
+        throw std::runtime_error( "PackableBlobHashes::unpack() - Too many hashes" );
+    }
+
+    hashes_.clear();
+    for( unsigned int i = 0; i < nHashes.getValue(); i++ ){
+        buffer = packableHash.unpack( buffer );
+        hashes_.insert( packableHash.getValue() );
+    }
+
+    return buffer;
+}
+
+
+const void* PackableBlobHashes::unpack( const void* buffer ) const
+{
+    const PackableVarUint32 nHashes( hashes_.size() );
+    PackableBlobHash packableHash;
+
+    buffer = nHashes.unpack( buffer );
+
+    for( const BlobHash& hash : hashes_ ){
+        packableHash.setValue( hash );
+        buffer = static_cast< const PackableBlobHash& >( packableHash ).unpack( buffer );
+    }
+
+    return buffer;
+}
+
+
+/***
+ * 4. Getters
+ ***/
+
+PacketSize PackableBlobHashes::getPacketSize() const
+{
+    return PackableVarUint32::packetSize( hashes_.size() ) +
+            hashes_.size() * PackableBlobHash().getPacketSize();
+}
+
+
+const std::set< BlobHash >& PackableBlobHashes::getValue() const
+{
+    return hashes_;
+}
+
+
+/***
+ * 5. Setters
+ ***/
+
+void PackableBlobHashes::setValue( const std::set< BlobHash >& hashes )
+{
+    hashes_.clear();
+    for( const BlobHash& hash : hashes ){
+        if( hashes_.size() == MAX_BLOB_HASHES ){
+            break;
+        }
+        hashes_.insert( hash );
+    }
+}
+
+} // namespace como
@@ -0,0 +1,96 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PACKABLE_BLOB_HASHES_HPP
+#define PACKABLE_BLOB_HASHES_HPP
+
+#include <common/packables/array/packable_array.hpp>
+#include <common/packables/packable_integer.hpp>
+#include <common/utilities/blob_store.hpp>
+#include <set>
+
+namespace como {
+
+/*! Convenient typedef for packing / unpacking a BlobHash. */
+typedef PackableArray< PackableUint32< std::uint32_t >, std::uint32_t, 5 > PackableBlobHash;
+
+/*! Maximum number of hashes in a PackableBlobHashes. */
+const std::uint32_t MAX_BLOB_HASHES = 4096;
+
+/*!
+ * \class PackableBlobHashes
+ *
+ * \brief Packable set of blob hashes (ie. the blobs some peer already has).
+ */
+class PackableBlobHashes : public Packable
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        PackableBlobHashes() = default;
+        PackableBlobHashes( const PackableBlobHashes& ) = default;
+        PackableBlobHashes( PackableBlobHashes&& ) = default;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        virtual ~PackableBlobHashes() = default;
+
+
+        /***
+         * 3. Packing and unpacking
+         ***/
+        virtual void* pack( void* buffer ) const;
+        virtual const void* unpack( const void* buffer );
+        virtual const void* unpack( const void* buffer ) const;
+
+
+        /***
+         * 4. Getters
+         ***/
+        virtual PacketSize getPacketSize() const;
+        const std::set< BlobHash >& getValue() const;
+
+
+        /***
+         * 5. Setters
+         ***/
+
+        /*!
+         * \brief Sets the hashes held by this packable. Only the first
+         * MAX_BLOB_HASHES ones are kept.
+         */
+        void setValue( const std::set< BlobHash >& hashes );
+
+
+        /***
+         * 6. Operators
+         ***/
+        PackableBlobHashes& operator = ( const PackableBlobHashes& ) = default;
+        PackableBlobHashes& operator = ( PackableBlobHashes&& ) = default;
+
+
+    private:
+        std::set< BlobHash > hashes_;
+};
+
+} // namespace como
+
+#endif // PACKABLE_BLOB_HASHES_HPP
@@ -18,10 +18,16 @@
 
 #include "packable_file.hpp"
 #include <common/exceptions/file_not_open_exception.hpp>
+#include <algorithm>
+#include <cstring>
 
 namespace como {
 
 int PackableFile::fileCounter = 0;
+std::map< ResourceID, PackableFile::FileStream > PackableFile::fileStreams_;
+std::mutex PackableFile::fileStreamsMutex_;
+BlobStorePtr PackableFile::blobStore_;
+FileWriterPtr PackableFile::fileWriter_;
 
 
 /***
@@ -30,25 +36,32 @@ int PackableFile::fileCounter = 0;
 
 PackableFile::PackableFile( const std::string& unpackingDirPath ) :
     unpackingDirPath_( unpackingDirPath ),
+    fileID_( NO_RESOURCE ),
     fileName_( "" ),
     filePath_( "" ),
-    fileSize_( 0 )
+    fileSize_( 0 ),
+    streamed_( 0 )
 {
     // "Register" the fileSize as part of this CompositePackable (for automatic
     // packing / unpacking when calling CompositePackable packing / unpacking
     // methods).
     // The file content's are packed / unpacked explicitly in this class.
+    addPackable( &fileID_ );
     addPackable( &fileName_ );
     addPackable( &fileSize_ );
+    addPackable( &streamed_ );
+    addPackable( &contentHash_ );
 }
 
 
 PackableFile::PackableFile( const std::string& unpackingDirPath, const std::string& filePath, bool createFile ) :
     CompositePackable(),
     unpackingDirPath_( unpackingDirPath ),
+    fileID_( NO_RESOURCE ),
     fileName_( boost::filesystem::basename( filePath ) + boost::filesystem::extension( filePath ) ),
     filePath_( filePath ),
-    fileSize_( 0 )
+    fileSize_( 0 ),
+    streamed_( 0 )
 {
     // Check that we can create or open the file, as requested.
     if( createFile ){
@@ -77,16 +90,24 @@ PackableFile::PackableFile( const std::string& unpackingDirPath, const std::stri
     // CompositePackable (for automatic packing / unpacking when calling
     // CompositePackable packing / unpacking methods).
     // The file content's are packed / unpacked explicitly in this class.
+    addPackable( &fileID_ );
     addPackable( &fileName_ );
     addPackable( &fileSize_ );
+    addPackable( &streamed_ );
+    addPackable( &contentHash_ );
 }
 
 
 PackableFile::PackableFile( const PackableFile& b ) :
     CompositePackable( b ),
+    fileID_( b.fileID_ ),
     fileName_( b.fileName_ ),
     filePath_( b.filePath_ ),
-    fileSize_( b.fileSize_ )
+    fileSize_( b.fileSize_ ),
+    streamed_( b.streamed_ ),
+    contentHash_( b.contentHash_ ),
+    fileView_( b.fileView_ ),
+    fileViewPath_( b.fileViewPath_ )
 {
     // Check that we can open the file.
     file_.open( filePath_.c_str(), std::ios_base::in | std::ios_base::binary );
@@ -101,8 +122,11 @@ PackableFile::PackableFile( const PackableFile& b ) :
     // CompositePackable (for automatic packing / unpacking when calling
     // CompositePackable packing / unpacking methods).
     // The file content's are packed / unpacked explicitly in this class.
+    addPackable( &fileID_ );
     addPackable( &fileName_ );
     addPackable( &fileSize_ );
+    addPackable( &streamed_ );
+    addPackable( &contentHash_ );
 }
 
 
@@ -113,32 +137,23 @@ PackableFile::PackableFile( const PackableFile& b ) :
 void* PackableFile::PackableFile::pack( void* buffer ) const
 {
     char* castedBuffer = nullptr;
-    char errorMessage[128];
 
     // Pack the file path and size, among other packables held by this
     // CompositePackable (parent class), into the given buffer.
     buffer = CompositePackable::pack( buffer );
     // TODO: If I inherit another class from PackableFile, would't this pack all its packables before finisihing the packing of this class? Check also for other classes.
 
-    // Pack the file contents into the given buffer.
-    castedBuffer = static_cast< char* >( buffer );
-
-    file_.open( filePath_.c_str(), std::ios_base::in | std::ios_base::binary );
-    if( !file_ ){
-        throw FileNotOpenException( filePath_ );
+    // Streamed files' contents are sent apart.
+    if( isStreamed() ){
+        return buffer;
     }
 
-    file_.read( castedBuffer, fileSize_.getValue() );
-    if( !file_ ){
-        unsigned int bytesRead = static_cast< unsigned int >( file_.gcount() );
-        sprintf( errorMessage,
-                 "ERROR packing file [%s]. Only %u bytes could be read",
-                 filePath_.c_str(),
-                 bytesRead );
-        throw std::runtime_error( errorMessage );
-    }
+    // Pack the file contents into the given buffer, copying them from the
+    // file's shared view.
+    castedBuffer = static_cast< char* >( buffer );
 
-    file_.close();
+    const FileViewConstPtr view = getFileView();
+    std::memcpy( castedBuffer, view->data(), fileSize_.getValue() );
 
     // Increment buffer pointer to the first position after packed file contents.
     castedBuffer += fileSize_.getValue();
@@ -151,8 +166,6 @@ void* PackableFile::PackableFile::pack( void* buffer ) const
 const void* PackableFile::unpack( const void* buffer )
 {
     const char* castedBuffer = nullptr;
-    char errorMessage[128];
-    std::string filePathBaseName;
 
     // Unpack the file path and size, among other packables held by this
     // CompositePackable (parent class), from the given buffer.
@@ -161,29 +174,33 @@ const void* PackableFile::unpack( const void* buffer )
     // Set the file path for the file being unpacked.
     filePath_ = generateUnpackedFilePath();
 
-    // Maybe the file being unpacked will be placed in a directory which
-    // doesn't exist. Create it.
-    filePathBaseName = filePath_.substr( 0, filePath_.rfind( '/' ) );
-    boost::filesystem::create_directories( filePathBaseName.c_str() );
+    // Streamed files' contents were already received as file chunks.
+    if( isStreamed() ){
+        takeStreamedFile();
+        return buffer;
+    }
 
-    // Unpack the file contents from the given buffer and write them to file.
+    // Unpack the file contents from the given buffer. They are copied, as
+    // the buffer could be reused before the file is written.
     castedBuffer = static_cast< const char* >( buffer );
 
-    file_.open( filePath_.c_str(), std::ios_base::out | std::ios_base::binary );
+    const std::shared_ptr< std::vector< char > > contents(
+                new std::vector< char >( castedBuffer, castedBuffer + fileSize_.getValue() ) );
+    const std::string filePath = filePath_;
+    const BlobHash contentHash = contentHash_.getValue();
+    const BlobStorePtr blobStore = PackableFile::blobStore();
 
-    if( !file_.is_open() ){
-        sprintf( errorMessage, "ERROR creating file [%s] for unpacking", filePath_.c_str() );
-        throw std::runtime_error( errorMessage );
-    }
+    runFileTask( filePath, [=](){
+        writeToFile( filePath, 0, *contents, true );
 
-    file_.write( castedBuffer, fileSize_.getValue() );
-
-    if( !file_ ){
-        sprintf( errorMessage, "ERROR unpacking file [%s]", filePath_.c_str() );
-        throw std::runtime_error( errorMessage );
-    }
+        if( blobStore ){
+            blobStore->storeFile( contentHash, filePath );
+        }
+    });
 
-    file_.close();
+    // Files unpacked inline (ie. from a scene file) are streamed from now on
+    // if they are too big, as any other file.
+    streamed_.setValue( ( fileSize_.getValue() > MAX_INLINE_FILE_SIZE ) ? 1 : 0 );
 
     // Increment buffer pointer to the first position after packed file contents.
     castedBuffer += fileSize_.getValue();
@@ -196,36 +213,23 @@ const void* PackableFile::unpack( const void* buffer )
 const void* PackableFile::unpack( const void* buffer ) const
 {
     const char* castedBuffer = nullptr;
-    char* fileContents = nullptr;
-    char errorMessage[128];
 
     // Unpack the file path and size, among other packables held by this
     // CompositePackable (parent class), from the given buffer.
     buffer = CompositePackable::unpack( buffer );
 
-    // Read the file contents for checking if they match the buffer contents.
-    fileContents = new char[fileSize_.getValue()];
-
-    file_.open( filePath_.c_str(), std::ios_base::in | std::ios_base::binary );
-    file_.read( fileContents, fileSize_.getValue() );
-
-    if( !file_ ){
-        sprintf( errorMessage, "ERROR when unpacking file (const)" );
-        throw std::runtime_error( errorMessage );
+    if( isStreamed() ){
+        return buffer;
     }
 
-    file_.close();
-
     // Unpack data from the given buffer and check if it matches the file contents.
     castedBuffer = static_cast< const char* >( buffer );
 
-    if( strncmp( fileContents, castedBuffer, fileSize_.getValue() ) ){
+    const FileViewConstPtr view = getFileView();
+    if( std::memcmp( view->data(), castedBuffer, fileSize_.getValue() ) ){
         throw std::runtime_error( "ERROR unpacked data doesn't match file contents (const)" );
     }
 
-    // Free allocated resources.
-    delete [] fileContents;
-
     // Return a pointer to the next free position in the buffer.
     castedBuffer += fileSize_.getValue();
     return static_cast< const void* >( castedBuffer );
@@ -238,7 +242,11 @@ const void* PackableFile::unpack( const void* buffer ) const
 
 PacketSize PackableFile::getPacketSize() const
 {
-    return CompositePackable::getPacketSize() + getFileSize();
+    if( isStreamed() ){
+        return CompositePackable::getPacketSize();
+    }else{
+        return CompositePackable::getPacketSize() + getFileSize();
+    }
 }
 
 
@@ -264,8 +272,181 @@ std::string PackableFile::getFilePath() const
 }
 
 
+ResourceID PackableFile::getFileID() const
+{
+    return fileID_.getValue();
+}
+
+
+FileViewConstPtr PackableFile::getFileView() const
+{
+    if( ( fileView_ == nullptr ) || ( fileViewPath_ != filePath_ ) ){
+        fileView_ = FileView::open( filePath_ );
+        fileViewPath_ = filePath_;
+
+        if( fileView_->size() != fileSize_.getValue() ){
+            throw std::runtime_error( std::string( "ERROR mapping file [" ) +
+                                      filePath_ +
+                                      "]: its size changed" );
+        }
+    }
+
+    return fileView_;
+}
+
+
+BlobHash PackableFile::getContentHash() const
+{
+    return contentHash_.getValue();
+}
+
+
+bool PackableFile::isStreamed() const
+{
+    return streamed_.getValue() != 0;
+}
+
+
+/***
+ * 5. Setters
+ ***/
+
+void PackableFile::setFileID( const ResourceID& fileID )
+{
+    fileID_.setValue( fileID );
+}
+
+
+void PackableFile::setStreamed( bool streamed )
+{
+    streamed_.setValue( streamed ? 1 : 0 );
+}
+
+
+/***
+ * 6. File streams
+ ***/
+
+void PackableFile::writeFileChunk( const std::string& unpackingDirPath,
+                                   const ResourceID& fileID,
+                                   std::uint32_t fileSize,
+                                   std::uint32_t offset,
+                                   const char* data,
+                                   std::uint32_t size )
+{
+    std::string filePath;
+    bool newFile = false;
+
+    if( ( offset > fileSize ) || ( size > fileSize - offset ) ){
+        throw std::runtime_error( "PackableFile::writeFileChunk() - Chunk out of file bounds" );
+    }
+
+    {
+        std::lock_guard< std::mutex > lock( fileStreamsMutex_ );
+
+        auto fileStreamIt = fileStreams_.find( fileID );
+
+        // Chunks are sent in order, so the file is complete once all its
+        // bytes have been received.
+        const std::uint32_t receivedBytes =
+                ( fileStreamIt != fileStreams_.end() ) ? fileStreamIt->second.receivedBytes : 0;
+        if( offset != receivedBytes ){
+            throw std::runtime_error( "PackableFile::writeFileChunk() - Chunk received out of order" );
+        }
+
+        if( fileStreamIt == fileStreams_.end() ){
+            FileStream fileStream;
+            fileStream.filePath = unpackingDirPath +
+                    "/stream_" +
+                    std::to_string( fileID.getCreatorID() ) +
+                    "_" +
+                    std::to_string( fileID.getResourceIndex() ) +
+                    ".tmp";
+            fileStream.receivedBytes = 0;
+
+            fileStreamIt = fileStreams_.insert( std::make_pair( fileID, fileStream ) ).first;
+            newFile = true;
+        }
+
+        fileStreamIt->second.receivedBytes += size;
+        filePath = fileStreamIt->second.filePath;
+    }
+
+    const std::shared_ptr< std::vector< char > > chunk(
+                new std::vector< char >( data, data + size ) );
+
+    runFileTask( filePath, [=](){
+        writeToFile( filePath, offset, *chunk, newFile );
+    });
+}
+
+
+void PackableFile::discardFileStreams( UserID creatorID )
+{
+    std::vector< std::string > streamFilePaths;
+
+    {
+        std::lock_guard< std::mutex > lock( fileStreamsMutex_ );
+
+        for( auto it = fileStreams_.begin(); it != fileStreams_.end(); ){
+            if( it->first.getCreatorID() == creatorID ){
+                streamFilePaths.push_back( it->second.filePath );
+                it = fileStreams_.erase( it );
+            }else{
+                it++;
+            }
+        }
+    }
+
+    // Remove the files once the writes of their chunks already queued are
+    // done.
+    for( const std::string& streamFilePath : streamFilePaths ){
+        runFileTask( streamFilePath, [=](){
+            boost::system::error_code errorCode;
+            boost::filesystem::remove( streamFilePath, errorCode );
+        });
+    }
+}
+
+
+void PackableFile::setBlobStore( BlobStorePtr blobStore )
+{
+    std::lock_guard< std::mutex > lock( fileStreamsMutex_ );
+    blobStore_ = blobStore;
+}
+
+
+BlobStorePtr PackableFile::blobStore()
+{
+    std::lock_guard< std::mutex > lock( fileStreamsMutex_ );
+    return blobStore_;
+}
+
+
+void PackableFile::setFileWriter( FileWriterPtr fileWriter )
+{
+    std::lock_guard< std::mutex > lock( fileStreamsMutex_ );
+    fileWriter_ = fileWriter;
+}
+
+
+void PackableFile::flushWrites()
+{
+    FileWriterPtr fileWriter;
+
+    {
+        std::lock_guard< std::mutex > lock( fileStreamsMutex_ );
+        fileWriter = fileWriter_;
+    }
+
+    if( fileWriter ){
+        fileWriter->flush();
+    }
+}
+
+
 /***
- * 6. Auxiliar methods
+ * 7. Auxiliar methods
  ***/
 
 void PackableFile::updateFileSize()
@@ -281,6 +462,10 @@ void PackableFile::updateFileSize()
     // Update the file size and close the file.
     fileSize_.setValue( static_cast< std::uint32_t >( file_.tellg() ) );
     file_.close();
+
+    contentHash_.setValue( computeFileHash( filePath_ ) );
+
+    streamed_.setValue( ( fileSize_.getValue() > MAX_INLINE_FILE_SIZE ) ? 1 : 0 );
 }
 
 
@@ -294,4 +479,104 @@ std::string PackableFile::generateUnpackedFilePath() const
             boost::filesystem::extension( fileName_.getValue() );
 }
 
+
+
+void PackableFile::takeStreamedFile()
+{
+    BlobStorePtr blobStore;
+    std::string streamFilePath;
+    const std::string filePath = filePath_;
+    const BlobHash contentHash = contentHash_.getValue();
+
+    {
+        std::lock_guard< std::mutex > lock( fileStreamsMutex_ );
+
+        blobStore = blobStore_;
+
+        const auto fileStreamIt = fileStreams_.find( fileID_.getValue() );
+        if( fileStreamIt != fileStreams_.end() ){
+            if( fileStreamIt->second.receivedBytes < fileSize_.getValue() ){
+                throw std::runtime_error( std::string( "ERROR unpacking streamed file [" ) +
+                                          fileName_.getValue() +
+                                          "]: not all its chunks were received" );
+            }
+
+            streamFilePath = fileStreamIt->second.filePath;
+            fileStreams_.erase( fileStreamIt );
+        }
+    }
+
+    if( streamFilePath != "" ){
+        // The chunks' writes were queued before this task, so the file is
+        // complete once it runs.
+        runFileTask( filePath, [=](){
+            boost::filesystem::create_directories( boost::filesystem::path( filePath ).parent_path() );
+            boost::filesystem::rename( streamFilePath, filePath );
+
+            if( blobStore ){
+                blobStore->storeFile( contentHash, filePath );
+            }
+        });
+    }else if( blobStore && blobStore->contains( contentHash ) ){
+        // The sender knew we already had this file.
+        runFileTask( filePath, [=](){
+            boost::filesystem::create_directories( boost::filesystem::path( filePath ).parent_path() );
+            blobStore->retrieveFile( contentHash, filePath );
+        });
+    }else{
+        throw std::runtime_error( std::string( "ERROR unpacking streamed file [" ) +
+                                  fileName_.getValue() +
+                                  "]: no chunks were received" );
+    }
+}
+
+
+void PackableFile::runFileTask( const std::string& filePath,
+                                std::function< void() > task )
+{
+    FileWriterPtr fileWriter;
+
+    {
+        std::lock_guard< std::mutex > lock( fileStreamsMutex_ );
+        fileWriter = fileWriter_;
+    }
+
+    if( fileWriter ){
+        fileWriter->addFileTask( filePath, std::move( task ) );
+    }else{
+        task();
+    }
+}
+
+
+void PackableFile::writeToFile( const std::string& filePath,
+                                std::uint32_t offset,
+                                const std::vector< char >& data,
+                                bool newFile )
+{
+    std::fstream file;
+
+    if( newFile ){
+        // Maybe the file will be placed in a directory which doesn't exist.
+        // Create it.
+        boost::filesystem::create_directories( boost::filesystem::path( filePath ).parent_path() );
+
+        file.open( filePath.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc );
+        if( !file.is_open() ){
+            throw std::runtime_error( std::string( "ERROR creating file [" ) + filePath + "] for unpacking" );
+        }
+        file.close();
+    }
+
+    file.open( filePath.c_str(), std::ios_base::in | std::ios_base::out | std::ios_base::binary );
+    file.seekp( offset );
+    file.write( data.data(), data.size() );
+    file.close();
+
+    // Closing flushes the written data, so check the stream afterwards.
+    if( !file ){
+        throw std::runtime_error( std::string( "ERROR unpacking file [" ) + filePath + "]" );
+    }
+}
+
 } // namespace como
@@ -22,24 +22,71 @@
 #include "composite_packable.hpp"
 #include "packable_string.hpp"
 #include "packable_integer.hpp"
+#include "ids/packable_resource_id.hpp"
+#include "packable_blob_hashes.hpp"
+#include <common/utilities/file_view.hpp>
+#include <common/utilities/file_writer.hpp>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <boost/filesystem.hpp>
 
 namespace como {
 
+/*!
+ * Files bigger than this size (in bytes) aren't packed inline. Their
+ * contents are streamed apart, as a sequence of FileChunkCommand.
+ */
+const std::uint32_t MAX_INLINE_FILE_SIZE = 16 * 1024;
+
 /*!
  * \class PackableFile
  *
  * \brief Wrapping class which contains a file whose data can be packed into
  * or unpacked from a given buffer.
+ *
+ * Files bigger than MAX_INLINE_FILE_SIZE are "streamed": only their
+ * metadata is packed, and their contents must have been received as file
+ * chunks (see FileChunkCommand) with the same file ID before unpacking.
+ *
+ * Every file carries its content hash. If a blob store is set, unpacked
+ * files are kept in it, and streamed files whose chunks weren't sent are
+ * retrieved from it.
+ *
+ * If a file writer is set, unpacked contents are written to disk by it
+ * instead of by the unpacking thread (see flushWrites()).
  */
 class PackableFile : public CompositePackable {
     private:   
         static int fileCounter;
 
+        /*! \brief File being assembled from the chunks received so far. */
+        struct FileStream {
+            std::string filePath;
+            std::uint32_t receivedBytes;
+        };
+
+        /*! \brief Files being received in chunks, indexed by file ID. */
+        static std::map< ResourceID, FileStream > fileStreams_;
+
+        /*! \brief Mutex protecting fileStreams_. */
+        static std::mutex fileStreamsMutex_;
+
+        /*! \brief Store keeping every unpacked file (if any). */
+        static BlobStorePtr blobStore_;
+
+        /*! \brief Writer performing the unpacking writes (if any). */
+        static FileWriterPtr fileWriter_;
+
         /*! \brief Path of the directory where this file will be unpacked */
         std::string unpackingDirPath_;
 
+        /*!
+         * \brief ID used for matching this file with its chunks (usually
+         * the ID of the resource created from this file).
+         */
+        PackableResourceID fileID_;
+
         PackableString fileName_;
 
         /*! \brief Path to the file to be packed / unpacked */
@@ -48,9 +95,24 @@ class PackableFile : public CompositePackable {
         /*! \brief Size of the file to be packed / unpacked */
         PackableUint32< std::uint32_t > fileSize_;
 
+        /*! \brief Whether the file contents are streamed apart or not. */
+        PackableUint8< std::uint8_t > streamed_;
+
+        /*! \brief Hash of the file contents. */
+        PackableBlobHash contentHash_;
+
         /*! \brief File to be packed / unpacked */
         mutable std::fstream file_;
 
+        /*!
+         * \brief Shared view of the file, mapped the first time its
+         * contents are needed.
+         */
+        mutable FileViewConstPtr fileView_;
+
+        /*! \brief Path of the file mapped by fileView_. */
+        mutable std::string fileViewPath_;
+
 
     public:
         /***
@@ -116,6 +178,20 @@ class PackableFile : public CompositePackable {
         virtual const void* unpack( const void* buffer ) const ;
 
 
+        /*!
+         * \brief see Packable::pack( void*, FloatEncoding ) const - Files
+         * don't hold floats, so the float encoding is ignored.
+         */
+        virtual void* pack( void* buffer, FloatEncoding ) const { return pack( buffer ); }
+
+
+        /*!
+         * \brief see Packable::unpack( const void*, FloatEncoding ) - Files
+         * don't hold floats, so the float encoding is ignored.
+         */
+        virtual const void* unpack( const void* buffer, FloatEncoding ) { return unpack( buffer ); }
+
+
         /***
          * 4. Getters
          ***/
@@ -128,6 +204,9 @@ class PackableFile : public CompositePackable {
          */
         virtual PacketSize getPacketSize() const;
 
+        /*! \brief see Packable::getPacketSize( FloatEncoding ) const */
+        virtual PacketSize getPacketSize( FloatEncoding ) const { return getPacketSize(); }
+
         /*!
          * \brief Returns the size (in bytes) that the file held by this
          * PackableFile would ocuppy once packed.
@@ -137,6 +216,24 @@ class PackableFile : public CompositePackable {
 
         std::string getFileName() const;
 
+        /*! \brief Returns the ID matching this file with its chunks. */
+        ResourceID getFileID() const;
+
+        /*! \brief Returns the hash of the file contents. */
+        BlobHash getContentHash() const;
+
+        /*!
+         * \brief Returns a shared view of the file contents. The file is
+         * mapped only once, whatever the number of times it's packed.
+         */
+        FileViewConstPtr getFileView() const;
+
+        /*!
+         * \brief Returns true if the file contents are streamed apart
+         * instead of being packed inline.
+         */
+        bool isStreamed() const;
+
         /*!
          * \brief Returns a pointer to the path of the primitive's
          * specification file.
@@ -145,18 +242,106 @@ class PackableFile : public CompositePackable {
 
 
         /***
-         * 6. Auxiliar methods
+         * 5. Setters
+         ***/
+
+        /*! \brief Sets the ID matching this file with its chunks. */
+        void setFileID( const ResourceID& fileID );
+
+        /*!
+         * \brief Forces the file contents to be streamed apart or packed
+         * inline (ie. for writing them to a scene file).
+         */
+        void setStreamed( bool streamed );
+
+
+        /***
+         * 6. File streams
+         ***/
+
+        /*!
+         * \brief Writes a chunk of the file with the given ID. The file is
+         * assembled in the given directory until a PackableFile with the
+         * same ID is unpacked.
+         */
+        static void writeFileChunk( const std::string& unpackingDirPath,
+                                    const ResourceID& fileID,
+                                    std::uint32_t fileSize,
+                                    std::uint32_t offset,
+                                    const char* data,
+                                    std::uint32_t size );
+
+        /*!
+         * \brief Discards the files created by the given user which are
+         * still being received in chunks (ie. because the user was removed
+         * before finishing sending them), along with their temporary files.
+         */
+        static void discardFileStreams( UserID creatorID );
+
+        /*!
+         * \brief Sets the blob store where every unpacked file is kept
+         * from now on (nullptr for none).
+         */
+        static void setBlobStore( BlobStorePtr blobStore );
+
+        /*! \brief Returns the blob store set with setBlobStore(). */
+        static BlobStorePtr blobStore();
+
+        /*!
+         * \brief Sets the writer performing the unpacking writes from now
+         * on (nullptr for writing them in the unpacking thread).
+         */
+        static void setFileWriter( FileWriterPtr fileWriter );
+
+        /*!
+         * \brief Waits until every file unpacked so far has been written
+         * to disk.
+         */
+        static void flushWrites();
+
+
+        /***
+         * 7. Auxiliar methods
          ***/
     protected:
-        /*! \brief Update the fileSize attribute. Used when initializing. */
+        /*!
+         * \brief Update the fileSize and contentHash attributes. Used when
+         * initializing.
+         */
         void updateFileSize();
 
         std::string generateUnpackedFilePath() const;
 
+        /*!
+         * \brief Moves the file assembled from the chunks with this file's
+         * ID to filePath_. If no chunks were received, the file is
+         * retrieved from the blob store instead. Throws if any chunk is
+         * still missing or the blob store doesn't have the file.
+         */
+        void takeStreamedFile();
+
+        /*!
+         * \brief Performs the given task writing the file with the given
+         * path in the file writer, or right away if there is no file writer
+         * set.
+         */
+        static void runFileTask( const std::string& filePath,
+                                 std::function< void() > task );
+
+        /*!
+         * \brief Writes the given data at the given offset of a file. If
+         * newFile is true, the file (and its parent directories) is created
+         * first.
+         */
+        static void writeToFile( const std::string& filePath,
+                                 std::uint32_t offset,
+                                 const std::vector< char >& data,
+                                 bool newFile );
+
 
     public:
         /***
-         * 7. Operators
+         * 8. Operators
          ***/
 
         /*! \brief Copy assignment operator */
@@ -18,53 +18,40 @@
 
 #include "packable_float.hpp"
 #include <common/packables/packable_integer.hpp>
-#include <cmath>
+#include <cstring>
 
 namespace como {
 
-const float FLOAT_PRECISION = 10000.0f;
+static_assert( sizeof( float ) == sizeof( std::uint32_t ), "PackableFloat requires 32 bits floats" );
 
 
-/***
- * 1. Construction
- ***/
-
 PackableFloat::PackableFloat( float value )
  : PackableWrapper< float >( value )
 {}
 
 
-/***
- * 3. Packing and unpacking
- ***/
 
 void* PackableFloat::pack( void* buffer ) const
 {
-    PackableUint32< std::int32_t > integralPart;
-    PackableUint32< std::int32_t > fractionalPart;
-
-    // Get the value's integral and fractional parts.
-    integralPart = static_cast< std::int32_t >( getValue() );
-    fractionalPart = ( getValue() - integralPart.getValue() ) * FLOAT_PRECISION;
+    const float value = getValue();
+    std::uint32_t bits;
 
-    // Pack previous values.
-    buffer = integralPart.pack( buffer );
-    buffer = fractionalPart.pack( buffer );
+    // Pack the IEEE-754 representation of the value in network byte order.
+    std::memcpy( &bits, &value, sizeof( bits ) );
 
-    return buffer;
+    return PackableUint32< std::uint32_t >( bits ).pack( buffer );
 }
 
 const void* PackableFloat::unpack( const void* buffer )
 {
-    PackableUint32< std::int32_t > integralPart;
-    PackableUint32< std::int32_t > fractionalPart;
+    PackableUint32< std::uint32_t > bits;
+    float value;
 
-    // Unpack the value's integral and fractional parts from buffer and
-    // build the float from them.
-    buffer = integralPart.unpack( buffer );
-    buffer = fractionalPart.unpack( buffer );
+    buffer = bits.unpack( buffer );
 
-    setValue( static_cast< float >( integralPart.getValue() ) + static_cast< float >( fractionalPart.getValue() / FLOAT_PRECISION ) );
+    const std::uint32_t unpackedBits = bits.getValue();
+    std::memcpy( &value, &unpackedBits, sizeof( value ) );
+    setValue( value );
 
     return buffer;
 }
@@ -72,27 +59,21 @@ const void* PackableFloat::unpack( const void* buffer )
 
 const void* PackableFloat::unpack( const void* buffer ) const
 {
-    // Get the current value's integral and fractional parts.
-    const PackableUint32< std::int32_t > integralPart( static_cast< std::int32_t >( getValue() ) );
-    const PackableUint32< std::int32_t > fractionalPart( ( getValue() - integralPart.getValue() ) * FLOAT_PRECISION );
+    const float value = getValue();
+    std::uint32_t bits;
 
-    // Unpack the integral and fractional parts from buffer and check if they
-    // match the previous ones.
-    buffer = integralPart.unpack( buffer );
-    buffer = fractionalPart.unpack( buffer );
+    // Unpack the IEEE-754 representation from buffer and check if it matches
+    // the current value.
+    std::memcpy( &bits, &value, sizeof( bits ) );
 
-    return buffer;
+    return PackableUint32< std::uint32_t >( bits ).unpack( buffer );
 }
 
 
-/***
- * 4. Getters
- ***/
 
 PacketSize PackableFloat::getPacketSize() const
 {
-    return 8;   // Two 4 bytes integers for value's both integral and
-                // fractional parts.
+    return 4;   // IEEE-754 single precision float.
 }
 
 } // namespace como
@@ -0,0 +1,54 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "packable_normalized_float.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace como {
+
+const float NORMALIZED_FLOAT_SCALE = 32767.0f;
+
+
+/***
+ * 1. Construction
+ ***/
+
+PackableNormalizedFloat::PackableNormalizedFloat( float value ) :
+    PackableQuantizedFloat( value )
+{}
+
+
+/***
+ * 4. Quantization
+ ***/
+
+std::int16_t PackableNormalizedFloat::quantize( float value ) const
+{
+    value = std::max( -1.0f, std::min( value, 1.0f ) );
+
+    return static_cast< std::int16_t >( std::round( value * NORMALIZED_FLOAT_SCALE ) );
+}
+
+
+float PackableNormalizedFloat::dequantize( std::int16_t quantizedValue ) const
+{
+    return std::max( -1.0f, quantizedValue / NORMALIZED_FLOAT_SCALE );
+}
+
+} // namespace como
@@ -0,0 +1,88 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PACKABLE_NORMALIZED_FLOAT_HPP
+#define PACKABLE_NORMALIZED_FLOAT_HPP
+
+#include <common/packables/packable_quantized_float.hpp>
+
+namespace como {
+
+/*!
+ * \class PackableNormalizedFloat
+ *
+ * \brief Float in range [-1, 1] (ie. a component of a unit vector),
+ * quantized as a 16 bits signed normalized integer.
+ */
+class PackableNormalizedFloat : public PackableQuantizedFloat
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*! \brief Default constructor */
+        PackableNormalizedFloat() = default;
+
+        /*!
+         * \brief Constructs a PackableNormalizedFloat from the given value.
+         * \param value value to initialize PackableNormalizedFloat with.
+         */
+        PackableNormalizedFloat( float value );
+
+        /*! \brief Copy constructor */
+        PackableNormalizedFloat( const PackableNormalizedFloat& ) = default;
+
+        /*! \brief Move constructor */
+        PackableNormalizedFloat( PackableNormalizedFloat&& ) = default;
+
+
+        /***
+         * 2. Destruction
+         ***/
+
+        /*! \brief Destructor */
+        virtual ~PackableNormalizedFloat() = default;
+
+
+        /***
+         * 3. Operators
+         ***/
+
+        /*! \brief Copy assignment operator */
+        PackableNormalizedFloat& operator = ( const PackableNormalizedFloat& ) = default;
+
+        /*! \brief Move assignment operator */
+        PackableNormalizedFloat& operator = ( PackableNormalizedFloat&& ) = default;
+
+
+    protected:
+        /***
+         * 4. Quantization
+         ***/
+
+        /*! \brief see PackableQuantizedFloat::quantize */
+        virtual std::int16_t quantize( float value ) const;
+
+        /*! \brief see PackableQuantizedFloat::dequantize */
+        virtual float dequantize( std::int16_t quantizedValue ) const;
+};
+
+} // namespace como
+
+#endif // PACKABLE_NORMALIZED_FLOAT_HPP
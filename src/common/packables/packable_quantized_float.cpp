@@ -0,0 +1,103 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "packable_quantized_float.hpp"
+#include <common/packables/packable_float.hpp>
+#include <common/packables/packable_integer.hpp>
+
+namespace como {
+
+/***
+ * 1. Construction
+ ***/
+
+PackableQuantizedFloat::PackableQuantizedFloat( float value ) :
+    PackableWrapper< float >( value )
+{}
+
+
+/***
+ * 3. Packing and unpacking
+ ***/
+
+void* PackableQuantizedFloat::pack( void* buffer ) const
+{
+    return pack( buffer, getFloatEncoding() );
+}
+
+
+const void* PackableQuantizedFloat::unpack( const void* buffer )
+{
+    return unpack( buffer, getFloatEncoding() );
+}
+
+
+const void* PackableQuantizedFloat::unpack( const void* buffer ) const
+{
+    if( getFloatEncoding() == FloatEncoding::QUANTIZED_16 ){
+        return PackableUint16< std::int16_t >( quantize( getValue() ) ).unpack( buffer );
+    }else{
+        return PackableFloat( getValue() ).unpack( buffer );
+    }
+}
+
+
+void* PackableQuantizedFloat::pack( void* buffer, FloatEncoding floatEncoding ) const
+{
+    if( floatEncoding == FloatEncoding::QUANTIZED_16 ){
+        return PackableUint16< std::int16_t >( quantize( getValue() ) ).pack( buffer );
+    }else{
+        return PackableFloat( getValue() ).pack( buffer );
+    }
+}
+
+
+const void* PackableQuantizedFloat::unpack( const void* buffer, FloatEncoding floatEncoding )
+{
+    if( floatEncoding == FloatEncoding::QUANTIZED_16 ){
+        PackableUint16< std::int16_t > quantizedValue;
+
+        buffer = quantizedValue.unpack( buffer );
+        setValue( dequantize( quantizedValue.getValue() ) );
+    }else{
+        PackableFloat value;
+
+        buffer = value.unpack( buffer );
+        setValue( value.getValue() );
+    }
+
+    return buffer;
+}
+
+
+/***
+ * 4. Getters
+ ***/
+
+PacketSize PackableQuantizedFloat::getPacketSize() const
+{
+    return getPacketSize( getFloatEncoding() );
+}
+
+
+PacketSize PackableQuantizedFloat::getPacketSize( FloatEncoding floatEncoding ) const
+{
+    return ( floatEncoding == FloatEncoding::QUANTIZED_16 ) ? 2 : 4;
+}
+
+} // namespace como
@@ -0,0 +1,121 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PACKABLE_QUANTIZED_FLOAT_HPP
+#define PACKABLE_QUANTIZED_FLOAT_HPP
+
+#include <common/packables/packable_wrapper.hpp>
+#include <common/packables/float_encoding.hpp>
+
+namespace como {
+
+/*!
+ * \class PackableQuantizedFloat
+ *
+ * \brief Base class for floats with a known range. They are packed as
+ * IEEE-754 floats or, if the current float encoding is QUANTIZED_16, as 16
+ * bits integers given by quantize().
+ */
+class PackableQuantizedFloat : public PackableWrapper< float >
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*! \brief Default constructor */
+        PackableQuantizedFloat() = default;
+
+        /*!
+         * \brief Constructs a PackableQuantizedFloat from the given value.
+         * \param value value to initialize PackableQuantizedFloat with.
+         */
+        PackableQuantizedFloat( float value );
+
+        /*! \brief Copy constructor */
+        PackableQuantizedFloat( const PackableQuantizedFloat& ) = default;
+
+        /*! \brief Move constructor */
+        PackableQuantizedFloat( PackableQuantizedFloat&& ) = default;
+
+
+        /***
+         * 2. Destruction
+         ***/
+
+        /*! \brief Destructor */
+        virtual ~PackableQuantizedFloat() = default;
+
+
+        /***
+         * 3. Packing and unpacking
+         ***/
+
+        /*! \brief see Packable::pack */
+        virtual void* pack( void* buffer ) const;
+
+        /*! \brief see Packable::unpack */
+        virtual const void* unpack( const void* buffer );
+
+        /*! \brief see Packable::unpack const */
+        virtual const void* unpack( const void* buffer ) const;
+
+        /*! \brief see Packable::pack( void*, FloatEncoding ) const */
+        virtual void* pack( void* buffer, FloatEncoding floatEncoding ) const;
+
+        /*! \brief see Packable::unpack( const void*, FloatEncoding ) */
+        virtual const void* unpack( const void* buffer, FloatEncoding floatEncoding );
+
+
+        /***
+         * 4. Getters
+         ***/
+
+        /*! \brief see Packable::getPacketSize const */
+        virtual PacketSize getPacketSize() const;
+
+        /*! \brief see Packable::getPacketSize( FloatEncoding ) const */
+        virtual PacketSize getPacketSize( FloatEncoding floatEncoding ) const;
+
+
+        /***
+         * 5. Operators
+         ***/
+
+        /*! \brief Copy assignment operator */
+        PackableQuantizedFloat& operator = ( const PackableQuantizedFloat& ) = default;
+
+        /*! \brief Move assignment operator */
+        PackableQuantizedFloat& operator = ( PackableQuantizedFloat&& ) = default;
+
+
+    protected:
+        /***
+         * 6. Quantization
+         ***/
+
+        /*! \brief Returns the 16 bits integer the given value is packed as. */
+        virtual std::int16_t quantize( float value ) const = 0;
+
+        /*! \brief Returns the value represented by the given 16 bits integer. */
+        virtual float dequantize( std::int16_t quantizedValue ) const = 0;
+};
+
+} // namespace como
+
+#endif // PACKABLE_QUANTIZED_FLOAT_HPP
@@ -0,0 +1,118 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "packable_var_uint32.hpp"
+#include <string>
+
+namespace como {
+
+/***
+ * 1. Construction
+ ***/
+
+PackableVarUint32::PackableVarUint32( std::uint32_t value ) :
+    PackableWrapper< std::uint32_t >( value )
+{}
+
+
+/***
+ * 3. Packing and unpacking
+ ***/
+
+void* PackableVarUint32::pack( void* buffer ) const
+{
+    std::uint8_t* castedBuffer = static_cast< std::uint8_t* >( buffer );
+    std::uint32_t value = getValue();
+
+    // Pack the value in groups of 7 bits, marking every byte but the last
+    // one with the continuation bit.
+    while( value >= 0x80 ){
+        *castedBuffer++ = static_cast< std::uint8_t >( value | 0x80 );
+        value >>= 7;
+    }
+    *castedBuffer++ = static_cast< std::uint8_t >( value );
+
+    return static_cast< void* >( castedBuffer );
+}
+
+
+const void* PackableVarUint32::unpack( const void* buffer )
+{
+    const std::uint8_t* castedBuffer = static_cast< const std::uint8_t* >( buffer );
+    std::uint32_t value = 0;
+    unsigned int shift = 0;
+    std::uint8_t byte;
+
+    do {
+        if( shift >= 7 * MAX_VAR_UINT32_PACKET_SIZE ){
+            throw std::runtime_error( "ERROR: Unpacked a malformed variable length integer" );
+        }
+
+        byte = *castedBuffer++;
+        value |= static_cast< std::uint32_t >( byte & 0x7F ) << shift;
+        shift += 7;
+    }while( byte & 0x80 );
+
+    setValue( value );
+
+    return static_cast< const void* >( castedBuffer );
+}
+
+
+const void* PackableVarUint32::unpack( const void* buffer ) const
+{
+    PackableVarUint32 unpackedValue;
+
+    buffer = unpackedValue.unpack( buffer );
+
+    // If the unpacked value isn't the expected one, throw an exception.
+    if( unpackedValue.getValue() != getValue() ){
+        throw std::runtime_error( std::string( "ERROR: Unpacked an unexpected variable length integer. Expected value (" ) +
+                                  std::to_string( getValue() ) +
+                                  "), unpacked value (" +
+                                  std::to_string( unpackedValue.getValue() ) +
+                                  ")" );
+    }
+
+    return buffer;
+}
+
+
+/***
+ * 4. Getters
+ ***/
+
+PacketSize PackableVarUint32::getPacketSize() const
+{
+    return packetSize( getValue() );
+}
+
+
+PacketSize PackableVarUint32::packetSize( std::uint32_t value )
+{
+    PacketSize size = 1;
+
+    while( value >= 0x80 ){
+        value >>= 7;
+        size++;
+    }
+
+    return size;
+}
+
+} // namespace como
@@ -0,0 +1,111 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PACKABLE_VAR_UINT32_HPP
+#define PACKABLE_VAR_UINT32_HPP
+
+#include <common/packables/packable_wrapper.hpp>
+#include <cstdint>
+
+namespace como {
+
+// Maximum number of bytes occupied by a packed PackableVarUint32.
+const PacketSize MAX_VAR_UINT32_PACKET_SIZE = 5;
+
+/*!
+ * \class PackableVarUint32
+ *
+ * \brief Unsigned 32 bits integer packed with a variable length encoding.
+ *
+ * The value is packed in groups of 7 bits, starting with the least
+ * significant ones. The most significant bit of each byte is set when more
+ * bytes follow, so small values take only one byte.
+ */
+class PackableVarUint32 : public PackableWrapper< std::uint32_t >
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*! \brief Default constructor */
+        PackableVarUint32() = default;
+
+        /*!
+         * \brief Constructs a PackableVarUint32 from the given value.
+         * \param value value to initialize PackableVarUint32 with.
+         */
+        PackableVarUint32( std::uint32_t value );
+
+        /*! \brief Copy constructor */
+        PackableVarUint32( const PackableVarUint32& ) = default;
+
+        /*! \brief Move constructor */
+        PackableVarUint32( PackableVarUint32&& ) = default;
+
+
+        /***
+         * 2. Destruction
+         ***/
+
+        /*! \brief Destructor */
+        virtual ~PackableVarUint32() = default;
+
+
+        /***
+         * 3. Packing and unpacking
+         ***/
+
+        /*! \brief see Packable::pack */
+        virtual void* pack( void* buffer ) const;
+
+        /*! \brief see Packable::unpack */
+        virtual const void* unpack( const void* buffer );
+
+        /*! \brief see Packable::unpack const */
+        virtual const void* unpack( const void* buffer ) const;
+
+
+        /***
+         * 4. Getters
+         ***/
+
+        /*! \brief see Packable::getPacketSize const */
+        virtual PacketSize getPacketSize() const;
+
+        /*!
+         * \brief Returns the size (in bytes) that the given value would
+         * occupy once packed.
+         */
+        static PacketSize packetSize( std::uint32_t value );
+
+
+        /***
+         * 5. Operators
+         ***/
+
+        /*! \brief Copy assignment operator */
+        PackableVarUint32& operator = ( const PackableVarUint32& ) = default;
+
+        /*! \brief Move assignment operator */
+        PackableVarUint32& operator = ( PackableVarUint32&& ) = default;
+};
+
+} // namespace como
+
+#endif // PACKABLE_VAR_UINT32_HPP
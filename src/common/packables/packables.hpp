@@ -25,6 +25,9 @@
 #include "array/packable_array_3.hpp"
 #include "packable_file.hpp"
 #include "packable_float.hpp"
+#include "packable_normalized_float.hpp"
+#include "packable_angle.hpp"
+#include "packable_var_uint32.hpp"
 #include "composite_packable.hpp"
 #include "ids/packable_resource_id.hpp"
 
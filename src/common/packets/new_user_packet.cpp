@@ -27,35 +27,54 @@ namespace como {
  ***/
 
 NewUserPacket::NewUserPacket() :
-    Packet( PacketType::NEW_USER )
+    Packet( PacketType::NEW_USER ),
+    floatEncodings_( SUPPORTED_FLOAT_ENCODINGS ),
+    capabilities_( SUPPORTED_CAPABILITIES )
 {
     // Since no user name has been given, set a default one.
     name_ = "Unnamed";
 
-    // Register the user name field as part of this CompositePackable.
+    // Register the user name, float encodings, capabilities and known blobs
+    // fields as part of this CompositePackable.
     addPackable( &name_ );
+    addPackable( &floatEncodings_ );
+    addPackable( &capabilities_ );
+    addPackable( &knownBlobs_ );
 }
 
 
 NewUserPacket::NewUserPacket( const char* name ) :
-    Packet( PacketType::NEW_USER )
+    Packet( PacketType::NEW_USER ),
+    floatEncodings_( SUPPORTED_FLOAT_ENCODINGS ),
+    capabilities_( SUPPORTED_CAPABILITIES )
 {
     // Set the user name field.
     name_ = name;
 
-    // Register the user name field as part of this CompositePackable.
+    // Register the user name, float encodings, capabilities and known blobs
+    // fields as part of this CompositePackable.
     addPackable( &name_ );
+    addPackable( &floatEncodings_ );
+    addPackable( &capabilities_ );
+    addPackable( &knownBlobs_ );
 }
 
 
 NewUserPacket::NewUserPacket( const NewUserPacket& b ) :
-    Packet( b )
+    Packet( b ),
+    floatEncodings_( b.floatEncodings_ ),
+    capabilities_( b.capabilities_ ),
+    knownBlobs_( b.knownBlobs_ )
 {
     // Copy the user name from the source packet.
     name_ = b.name_;
 
-    // Register the user name field as part of this CompositePackable.
+    // Register the user name, float encodings, capabilities and known blobs
+    // fields as part of this CompositePackable.
     addPackable( &name_ );
+    addPackable( &floatEncodings_ );
+    addPackable( &capabilities_ );
+    addPackable( &knownBlobs_ );
 }
 
 
@@ -75,6 +94,24 @@ const char* NewUserPacket::getName() const
 }
 
 
+std::uint8_t NewUserPacket::getFloatEncodings() const
+{
+    return floatEncodings_.getValue();
+}
+
+
+std::uint8_t NewUserPacket::getCapabilities() const
+{
+    return capabilities_.getValue();
+}
+
+
+const std::set< BlobHash >& NewUserPacket::getKnownBlobs() const
+{
+    return knownBlobs_.getValue();
+}
+
+
 bool NewUserPacket::expectedType() const
 {
     return ( Packet::getType() == PacketType::NEW_USER );
@@ -91,6 +128,12 @@ void NewUserPacket::setName( const char* name )
 }
 
 
+void NewUserPacket::setKnownBlobs( const std::set< BlobHash >& knownBlobs )
+{
+    knownBlobs_.setValue( knownBlobs );
+}
+
+
 /***
  * 5. Operators
  ***/
@@ -101,6 +144,9 @@ NewUserPacket& NewUserPacket::operator = (const NewUserPacket& b)
         Packet::operator =( b );
 
         name_ = b.name_;
+        floatEncodings_ = b.floatEncodings_;
+        capabilities_ = b.capabilities_;
+        knownBlobs_ = b.knownBlobs_;
     }
 
     return *this;
@@ -21,6 +21,8 @@
 
 #include "packet.hpp"
 #include <common/packables/packable_string.hpp>
+#include <common/packables/float_encoding.hpp>
+#include <common/packables/packable_blob_hashes.hpp>
 
 namespace como {
 
@@ -36,6 +38,16 @@ class NewUserPacket : public Packet
         // Name of the user trying to connect to server
         PackableString name_;
 
+        // Mask of float encodings supported by the user.
+        PackableUint8< std::uint8_t > floatEncodings_;
+
+        // Mask of optional capabilities supported by the user.
+        PackableUint8< std::uint8_t > capabilities_;
+
+        // Hashes of the files the user already has, so the server doesn't
+        // send them again.
+        PackableBlobHashes knownBlobs_;
+
     public:
         /***
          * 1. Construction
@@ -58,12 +70,16 @@ class NewUserPacket : public Packet
          ***/
         virtual bool expectedType() const;
         const char* getName() const ;
+        std::uint8_t getFloatEncodings() const ;
+        std::uint8_t getCapabilities() const ;
+        const std::set< BlobHash >& getKnownBlobs() const ;
 
 
         /***
          * 4. Setters
          ***/
         void setName( const char* name );
+        void setKnownBlobs( const std::set< BlobHash >& knownBlobs );
 
 
         /***
@@ -0,0 +1,259 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "packed_scene_update_packet.hpp"
+#include <common/utilities/compression.hpp>
+#include <algorithm>
+
+namespace como {
+
+/***
+ * 1. Construction
+ ***/
+
+PackedSceneUpdatePacket::PackedSceneUpdatePacket() :
+    header_( PacketType::SCENE_UPDATE ),
+    nUnsyncCommands_( 0 ),
+    commandsSize_( 0 ),
+    prefixBuffer_{ 0 },
+    compressionEnabled_( false )
+{}
+
+
+/***
+ * 3. Getters
+ ***/
+
+unsigned int PackedSceneUpdatePacket::nCommands() const
+{
+    return commands_.size();
+}
+
+
+bool PackedSceneUpdatePacket::fits( const PackedCommand& command ) const
+{
+    return commands_.empty() ||
+            ( commandsSize_ + command.size() <= MAX_SCENE_UPDATE_COMMANDS_SIZE );
+}
+
+
+/***
+ * 4. Setters
+ ***/
+
+void PackedSceneUpdatePacket::addCommand( PackedCommandConstPtr command )
+{
+    commandsSize_ += command->size();
+    commands_.push_back( std::move( command ) );
+}
+
+
+void PackedSceneUpdatePacket::addCommand( PackedCommandConstPtr command,
+                                          const std::uint32_t& commandIndex,
+                                          const std::uint32_t& historicSize )
+{
+    addCommand( std::move( command ) );
+
+    nUnsyncCommands_ = historicSize - (commandIndex + 1);
+}
+
+
+void PackedSceneUpdatePacket::setNUnsyncCommands( std::uint32_t nUnsyncCommands )
+{
+    nUnsyncCommands_ = nUnsyncCommands;
+}
+
+
+void PackedSceneUpdatePacket::clear()
+{
+    commands_.clear();
+    buffers_.clear();
+    commandsSize_ = 0;
+}
+
+
+void PackedSceneUpdatePacket::setCompressionEnabled( bool compressionEnabled )
+{
+    compressionEnabled_ = compressionEnabled;
+}
+
+
+/***
+ * 5. Asynchronous communication
+ ***/
+
+void PackedSceneUpdatePacket::asyncSend( Socket& socket, PackedPacketHandler packetHandler )
+{
+    // The body follows the SceneUpdatePacket layout: the number of unsync
+    // commands, the number of commands (VarUint32) and the commands
+    // themselves.
+    const PackableVarUint32 nCommands( commands_.size() );
+    const PacketSize bodyPrefixSize = nUnsyncCommands_.getPacketSize() + nCommands.getPacketSize();
+    void* buffer = prefixBuffer_;
+
+    header_.setBodySize( bodyPrefixSize + commandsSize_ );
+    header_.setCompressed( false );
+
+    // Pack the header and the body fields preceding the commands.
+    buffer = header_.pack( buffer );
+    buffer = nUnsyncCommands_.pack( buffer );
+    buffer = nCommands.pack( buffer );
+
+    buffers_.clear();
+    if( !compressionEnabled_ ||
+            ( header_.getBodySize() < MIN_COMPRESSED_BODY_SIZE ) ||
+            !gatherCompressedBody( bodyPrefixSize ) ){
+        // Gather the prefix and the shared command buffers.
+        buffers_.push_back( boost::asio::buffer( prefixBuffer_, static_cast< char* >( buffer ) - prefixBuffer_ ) );
+        for( const auto& command : commands_ ){
+            buffers_.push_back( command->buffer() );
+        }
+    }
+
+    // Write the packet asynchronously into the socket.
+
+    boost::asio::async_write(
+                socket,
+                buffers_,
+                [packetHandler]( const boost::system::error_code& errorCode, std::size_t ){
+                    packetHandler( errorCode );
+                });
+}
+
+
+/***
+ * 7. Compression
+ ***/
+
+bool PackedSceneUpdatePacket::gatherCompressedBody( PacketSize bodyPrefixSize )
+{
+    const PacketSize headerSize = header_.getPacketSize();
+    PackablePacketSize uncompressedBodySize( header_.getBodySize() );
+    const char* bodyPrefix = prefixBuffer_ + headerSize;
+
+    std::vector< boost::asio::const_buffer > storedData;
+    std::size_t storedDataSize = 0;
+    std::uint32_t bodyChecksum;
+    std::size_t framingSize;
+    PacketSize compressedBodySize;
+
+    // Only the commands big enough are compressed (and only once, see
+    // PackedCommand::compressedBuffer()). Small ones are sent uncompressed,
+    // as compressing them for every user would cost more than it saves.
+    if( std::none_of( commands_.begin(), commands_.end(),
+                      []( const PackedCommandConstPtr& command ){
+                          return command->compressedBuffer() != nullptr;
+                      }) ){
+        return false;
+    }
+
+    // Reserve enough room for the whole framing, so the buffers pointing
+    // to it aren't invalidated while it is packed. Every run of
+    // uncompressed data needs at most one stored block more than its size
+    // requires.
+    framingSize = headerSize +
+            uncompressedBodySize.getPacketSize() +
+            STREAM_HEADER_SIZE +
+            STORED_BLOCK_HEADER_SIZE * ( commands_.size() + 1 + header_.getBodySize() / MAX_STORED_BLOCK_SIZE ) +
+            STREAM_TRAILER_SIZE;
+    compressedPacket_.clear();
+    compressedPacket_.reserve( framingSize );
+
+    // The header and the uncompressed body size are packed at the end,
+    // once the compressed body size is known.
+    compressedPacket_.resize( headerSize + uncompressedBodySize.getPacketSize() + STREAM_HEADER_SIZE );
+    packStreamHeader( compressedPacket_.data() + headerSize + uncompressedBodySize.getPacketSize() );
+    buffers_.push_back( boost::asio::buffer( compressedPacket_ ) );
+
+    // Gather the body fields preceding the commands and the commands.
+    bodyChecksum = checksum( bodyPrefix, bodyPrefixSize );
+    storedData.push_back( boost::asio::buffer( bodyPrefix, bodyPrefixSize ) );
+    storedDataSize = bodyPrefixSize;
+
+    for( const auto& command : commands_ ){
+        const std::vector< char >* compressedCommand = command->compressedBuffer();
+
+        bodyChecksum = combineChecksums( bodyChecksum, command->checksum(), command->size() );
+
+        if( compressedCommand ){
+            gatherStoredBlocks( storedData, storedDataSize );
+            storedData.clear();
+            storedDataSize = 0;
+
+            buffers_.push_back( boost::asio::buffer( *compressedCommand ) );
+        }else{
+            storedData.push_back( command->buffer() );
+            storedDataSize += command->size();
+        }
+    }
+    gatherStoredBlocks( storedData, storedDataSize );
+
+    compressedPacket_.resize( compressedPacket_.size() + STREAM_TRAILER_SIZE );
+    packStreamTrailer( &compressedPacket_[compressedPacket_.size() - STREAM_TRAILER_SIZE], bodyChecksum );
+    buffers_.push_back( boost::asio::buffer( &compressedPacket_[compressedPacket_.size() - STREAM_TRAILER_SIZE],
+                                             STREAM_TRAILER_SIZE ) );
+
+    compressedBodySize = boost::asio::buffer_size( buffers_ ) - headerSize;
+    if( compressedBodySize >= header_.getBodySize() ){
+        buffers_.clear();
+        return false;
+    }
+
+    header_.setCompressed( true );
+    header_.setBodySize( compressedBodySize );
+    uncompressedBodySize.pack( header_.pack( compressedPacket_.data() ) );
+
+    return true;
+}
+
+
+void PackedSceneUpdatePacket::gatherStoredBlocks( const std::vector< boost::asio::const_buffer >& data,
+                                                  std::size_t dataSize )
+{
+    auto dataBuffer = data.begin();
+    std::size_t dataBufferOffset = 0;
+
+    // Split the data in blocks of at most MAX_STORED_BLOCK_SIZE bytes,
+    // which can span several data buffers.
+    while( dataSize ){
+        std::size_t blockSize = std::min( dataSize, MAX_STORED_BLOCK_SIZE );
+        const std::size_t blockHeaderOffset = compressedPacket_.size();
+
+        compressedPacket_.resize( blockHeaderOffset + STORED_BLOCK_HEADER_SIZE );
+        packStoredBlockHeader( &compressedPacket_[blockHeaderOffset], blockSize );
+        buffers_.push_back( boost::asio::buffer( &compressedPacket_[blockHeaderOffset],
+                                                 STORED_BLOCK_HEADER_SIZE ) );
+        dataSize -= blockSize;
+
+        while( blockSize ){
+            const std::size_t pieceSize =
+                    std::min( boost::asio::buffer_size( *dataBuffer ) - dataBufferOffset, blockSize );
+
+            buffers_.push_back( boost::asio::buffer( *dataBuffer + dataBufferOffset, pieceSize ) );
+            blockSize -= pieceSize;
+            dataBufferOffset += pieceSize;
+
+            if( dataBufferOffset == boost::asio::buffer_size( *dataBuffer ) ){
+                dataBuffer++;
+                dataBufferOffset = 0;
+            }
+        }
+    }
+}
+
+} // namespace como
@@ -0,0 +1,164 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PACKED_SCENE_UPDATE_PACKET_HPP
+#define PACKED_SCENE_UPDATE_PACKET_HPP
+
+#include "scene_update_packet.hpp"
+#include <common/commands/packed_command.hpp>
+#include <vector>
+
+namespace como {
+
+typedef std::function< void( const boost::system::error_code& errorCode ) > PackedPacketHandler;
+
+/*!
+ * \class PackedSceneUpdatePacket
+ *
+ * \brief SCENE_UPDATE packet made of already packed commands. It has the
+ * same wire format as SceneUpdatePacket, but instead of packing its
+ * commands it sends the buffers shared by them in a single gather write.
+ */
+class PackedSceneUpdatePacket
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        PackedSceneUpdatePacket();
+        PackedSceneUpdatePacket( const PackedSceneUpdatePacket& ) = delete;
+        PackedSceneUpdatePacket( PackedSceneUpdatePacket&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~PackedSceneUpdatePacket() = default;
+
+
+        /***
+         * 3. Getters
+         ***/
+        unsigned int nCommands() const;
+
+        /*!
+         * \brief Returns true if the given command fits in this packet
+         * without exceeding MAX_SCENE_UPDATE_COMMANDS_SIZE. An empty packet
+         * accepts any command.
+         */
+        bool fits( const PackedCommand& command ) const;
+
+
+        /***
+         * 4. Setters
+         ***/
+        void addCommand( PackedCommandConstPtr command );
+
+        /*!
+         * \brief Adds one command from a command' historic to the list of
+         * commands held by this packet.
+         * \param command command to be added.
+         * \param commandIndex command's index in the historic.
+         * \param historicSize size of the historic where the command was
+         * retrieved from.
+         */
+        void addCommand( PackedCommandConstPtr command,
+                         const std::uint32_t& commandIndex,
+                         const std::uint32_t& historicSize );
+        void setNUnsyncCommands( std::uint32_t nUnsyncCommands );
+        void clear();
+
+        /*! \brief see Packet::setCompressionEnabled */
+        void setCompressionEnabled( bool compressionEnabled );
+
+
+        /***
+         * 5. Asynchronous communication
+         ***/
+        void asyncSend( Socket& socket, PackedPacketHandler packetHandler );
+
+
+        /***
+         * 6. Operators
+         ***/
+        PackedSceneUpdatePacket& operator = ( const PackedSceneUpdatePacket& ) = delete;
+        PackedSceneUpdatePacket& operator = ( PackedSceneUpdatePacket&& ) = delete;
+
+
+    private:
+        /***
+         * 7. Compression
+         ***/
+        /*!
+         * \brief Gathers the packet as a compressed stream made of the
+         * commands' compressed buffers (shared among all the packets they
+         * are sent in) and stored blocks for the rest of the body. The
+         * fields preceding the commands must be already packed in
+         * prefixBuffer_.
+         * \return true if the body got smaller, false otherwise.
+         */
+        bool gatherCompressedBody( PacketSize bodyPrefixSize );
+
+        /*!
+         * \brief Gathers the given data as stored blocks of the compressed
+         * stream.
+         * \param data buffers with the data to be stored.
+         * \param dataSize total size of the data to be stored.
+         */
+        void gatherStoredBlocks( const std::vector< boost::asio::const_buffer >& data,
+                                 std::size_t dataSize );
+
+
+        /***
+         * Attributes
+         ***/
+        /*! Packet header */
+        PacketHeader header_;
+
+        /*!
+         * Number of commands to be received from server to be fully
+         * synchronised with it
+         */
+        PackableUint32< std::uint32_t > nUnsyncCommands_;
+
+        /*! Packed commands attached to this packet */
+        std::vector< PackedCommandConstPtr > commands_;
+
+        /*! Total size (in bytes) of the packed commands */
+        PacketSize commandsSize_;
+
+        /*! Buffer where the packet header and the commands count are packed */
+        char prefixBuffer_[PACKET_HEADER_BUFFER_SIZE];
+
+        /*! Buffers sent in the gather write */
+        std::vector< boost::asio::const_buffer > buffers_;
+
+        /*! Compress the packet body when sending it. */
+        bool compressionEnabled_;
+
+        /*!
+         * Buffer with the header, the uncompressed body size and the
+         * framing (stream header, stored blocks' headers and stream
+         * trailer) of the compressed body
+         */
+        std::vector< char > compressedPacket_;
+};
+
+} // namespace como
+
+#endif // PACKED_SCENE_UPDATE_PACKET_HPP
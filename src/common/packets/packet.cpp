@@ -17,6 +17,8 @@
 ***/
 
 #include "packet.hpp"
+#include <common/utilities/compression.hpp>
+#include <algorithm>
 
 namespace como {
 
@@ -27,16 +29,18 @@ namespace como {
 
 Packet::Packet( PacketType type ) :
     header_( type ),
-    headerBuffer_{ 0 }
+    compressionEnabled_( false ),
+    recvBufferBegin_( 0 ),
+    recvBufferEnd_( 0 )
 {}
 
 Packet::Packet( const Packet& b ) :
     CompositePackable(),
     header_( b.header_ ),
-    bodyBuffer_{ b.bodyBuffer_ }
-{
-    strncpy( headerBuffer_, b.headerBuffer_, PACKET_HEADER_BUFFER_SIZE );
-}
+    compressionEnabled_( b.compressionEnabled_ ),
+    recvBufferBegin_( 0 ),
+    recvBufferEnd_( 0 )
+{}
 
 
 /***
@@ -50,100 +54,107 @@ PacketType Packet::getType() const
 
 
 /***
- * 4. Synchronous communication.
+ * 4. Setters
  ***/
 
-void Packet::send( boost::asio::ip::tcp::socket& socket )
+void Packet::setCompressionEnabled( bool compressionEnabled )
 {
-    boost::system::error_code errorCode;
+    compressionEnabled_ = compressionEnabled;
+}
 
-    // Update and pack the packet's header into the buffer.
-    updateHeader();
-    packHeader( headerBuffer_ );
 
-    // Write synchronously the packet's header into the socket.
-    boost::asio::write( socket, boost::asio::buffer( headerBuffer_, (int)( header_.getPacketSize() ) ), errorCode );
-    if( errorCode ){
-        throw std::runtime_error( std::string( "ERROR when sending packet header' (" ) + errorCode.message() + ")" );
-    }
+/***
+ * 5. Synchronous communication.
+ ***/
+
+void Packet::send( boost::asio::ip::tcp::socket& socket )
+{
+    boost::system::error_code errorCode;
 
-    // Pack the packet's body into the buffer.
-    bodyBuffer_.resize( header_.getBodySize() );
-    packBody( &( bodyBuffer_[0] ) );
+    // Pack the packet's header and body into the buffer.
+    packIntoSendBuffer();
 
-    // Write synchronously the packet's body into the socket.
-    boost::asio::write( socket, boost::asio::buffer( &( bodyBuffer_[0] ), (int)( header_.getBodySize() ) ), errorCode );
+    // Write synchronously the whole packet into the socket.
+    boost::asio::write( socket, boost::asio::buffer( sendBuffer_ ), errorCode );
     if( errorCode ){
-        throw std::runtime_error( std::string( "ERROR when sending packet body' (" ) + errorCode.message() + ")" );
+        throw std::runtime_error( std::string( "ERROR when sending packet' (" ) + errorCode.message() + ")" );
     }
-    bodyBuffer_.clear();
 }
 
 
 void Packet::recv( boost::asio::ip::tcp::socket& socket )
 {
     boost::system::error_code errorCode;
-
-    // Read synchronously the packet's header from the socket.
-    boost::asio::read( socket, boost::asio::buffer( headerBuffer_, (int)( header_.getPacketSize() ) ), errorCode );
-
-    if( errorCode ){
-        throw std::runtime_error( std::string( "ERROR when receiving packet header' (" ) + errorCode.message() + ")" );
-    }
-
-    // Unpack the packet's header from the buffer and check its type.
-    unpackHeader( headerBuffer_ );
-    if( !expectedType() ){
-        throw std::runtime_error( std::string( "ERROR: Received an unexpected packet" ) );
-    }
-
-    // Read synchronously the packet's body from the socket.
-    bodyBuffer_.resize( header_.getBodySize() );
-    boost::asio::read( socket, boost::asio::buffer( &( bodyBuffer_[0] ), (int)( header_.getBodySize() ) ), errorCode );
-
-    if( errorCode ){
-        throw std::runtime_error( std::string( "ERROR when receiving packet body' (" ) + errorCode.message() + ")" );
+    PacketSize missingBytes;
+
+    // Read synchronously the packet's header and then its body. We read
+    // exactly the missing bytes, so no byte following this packet in the
+    // socket is consumed here.
+    while( ( missingBytes = pendingRecvBytes() ) > 0 ){
+        reserveRecvBuffer( missingBytes );
+        boost::asio::read( socket, boost::asio::buffer( &( recvBuffer_[recvBufferEnd_] ), missingBytes ), errorCode );
+
+        if( errorCode ){
+            throw std::runtime_error( std::string( "ERROR when receiving packet' (" ) + errorCode.message() + ")" );
+        }
+        recvBufferEnd_ += missingBytes;
     }
 
-    // Unpack the packet's body.
-    unpackBody( &( bodyBuffer_[0] ) );
-
-    bodyBuffer_.clear();
+    // Unpack the packet.
+    unpackRecvBuffer();
 }
 
 
 /***
- * 5. Asynchronous communication
+ * 6. Asynchronous communication
  ***/
 
 void Packet::asyncSend( Socket& socket, PacketHandler packetHandler )
 {
-    // Update and pack the packet's header into the buffer.
-    updateHeader();
-    packHeader( headerBuffer_ );
+    // Pack the packet's header and body into the buffer.
+    packIntoSendBuffer();
 
-    // Write asynchronously the packet's header into the socket.
+    // Write asynchronously the whole packet into the socket.
     boost::asio::async_write(
                 socket,
-                boost::asio::buffer( headerBuffer_, (int)( header_.getPacketSize() ) ),
-                boost::bind( &Packet::asyncSendBody, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred, boost::ref( socket ), packetHandler )
+                boost::asio::buffer( sendBuffer_ ),
+                boost::bind( &Packet::onPacketSend, this, _1, _2, packetHandler )
                 );
 }
 
 
 void Packet::asyncRecv( Socket& socket, PacketHandler packetHandler )
 {
-    // Read asynchronously the packet's header from the socket.
-    boost::asio::async_read(
-                socket,
-                boost::asio::buffer( headerBuffer_, (int)( header_.getPacketSize() ) ),
-                boost::bind( &Packet::asyncRecvBody, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred, boost::ref( socket ), packetHandler )
-                );
+    PacketSize missingBytes = 0;
+
+    try{
+        missingBytes = pendingRecvBytes();
+    }catch( std::exception& ){
+        // The header of a packet already read from the socket is malformed.
+        boost::asio::post( socket.get_executor(),
+                           boost::bind( &Packet::onPacketRecv, this, boost::system::errc::make_error_code( boost::system::errc::bad_message ), 0, boost::ref( socket ), packetHandler ) );
+        return;
+    }
+
+    if( !missingBytes ){
+        // The whole packet was already read from the socket along with a
+        // previous one. Unpack it without reading from the socket again.
+        boost::asio::post( socket.get_executor(),
+                           boost::bind( &Packet::onPacketRecv, this, boost::system::error_code(), 0, boost::ref( socket ), packetHandler ) );
+        return;
+    }
+
+    // Read asynchronously as many bytes as available in the socket, so
+    // other queued packets are received along with this one.
+    reserveRecvBuffer( std::max( missingBytes, MIN_ASYNC_RECV_SIZE ) );
+    socket.async_read_some(
+                boost::asio::buffer( &( recvBuffer_[recvBufferEnd_] ), recvBuffer_.size() - recvBufferEnd_ ),
+                boost::bind( &Packet::onPacketRecv, this, _1, _2, boost::ref( socket ), packetHandler ) );
 }
 
 
 /***
- * 6. Packing and unpacking
+ * 7. Packing and unpacking
  ***/
 
 void* Packet::pack( void* buffer ) const
@@ -168,15 +179,13 @@ const void* Packet::unpack( const void* buffer ) const
 
 
 /***
- * 7. Operators
+ * 8. Operators
  ***/
 
 Packet& Packet::operator =( const Packet& b )
 {
     if( this != &b ){
         header_ = b.header_;
-        strncpy( headerBuffer_, b.headerBuffer_, PACKET_HEADER_BUFFER_SIZE );
-        bodyBuffer_ = b.bodyBuffer_;
     }
 
     return *this;
@@ -184,78 +193,48 @@ Packet& Packet::operator =( const Packet& b )
 
 
 /***
- * 8. Asynchronous communication (private)
+ * 9. Asynchronous communication (private)
  ***/
 
-void Packet::asyncSendBody( const boost::system::error_code& headerErrorCode, std::size_t, Socket& socket, PacketHandler packetHandler )
-{
-    if( headerErrorCode ){
-        packetHandler( headerErrorCode, PacketPtr( clone() ) );
-        return;
-    }
-
-    // Pack the packet's body into the buffer.
-    bodyBuffer_.resize( header_.getBodySize() );
-    packBody( &( bodyBuffer_[0] ) );
-
-    // Write asynchronously the packet's body into the socket.
-    boost::asio::async_write(
-                socket,
-                boost::asio::buffer( &( bodyBuffer_[0] ), (int)( header_.getBodySize() ) ),
-                boost::bind( &Packet::onPacketSend, this, _1, _2, packetHandler )
-                );
-}
-
 void Packet::onPacketSend( const boost::system::error_code& errorCode, std::size_t, PacketHandler packetHandler )
 {
     // Call the packet handler.
-    packetHandler( errorCode, PacketPtr( clone() ) );
-
-    bodyBuffer_.clear();
+    packetHandler( errorCode, *this );
 }
 
 
-void Packet::asyncRecvBody( const boost::system::error_code& headerErrorCode, std::size_t, Socket& socket, PacketHandler packetHandler )
+void Packet::onPacketRecv( const boost::system::error_code& errorCode, std::size_t nBytes, Socket& socket, PacketHandler packetHandler )
 {
-    if( headerErrorCode ){
-        packetHandler( headerErrorCode, PacketPtr( clone() ) );
+    if( errorCode ){
+        packetHandler( errorCode, *this );
         return;
     }
 
-    // Unpack the packet's header from the buffer.
-    unpackHeader( headerBuffer_ );
-
-    // Check that the received packet has the expected type.
-    if( !expectedType() ){
-        throw std::runtime_error( std::string( "ERROR: Unexpected packet" ) );
-    }
-
-    // Write synchronously the packet's body to the socket.
-    // Write asynchronously the packet's header to the socket.
-    bodyBuffer_.resize( header_.getBodySize() );
-    boost::asio::async_read(
-                socket,
-                boost::asio::buffer( &( bodyBuffer_[0] ), (int)( header_.getBodySize() ) ),
-                boost::bind( &Packet::onPacketRecv, this, _1, _2, packetHandler ) );
-}
+    recvBufferEnd_ += nBytes;
 
+    // Keep reading until the packet is complete and unpack it from the
+    // buffer. A malformed packet is reported to the handler as an error,
+    // so the peer sending it can't bring down the thread receiving it.
+    try{
+        if( pendingRecvBytes() ){
+            asyncRecv( socket, packetHandler );
+            return;
+        }
 
-void Packet::onPacketRecv( const boost::system::error_code& errorCode, std::size_t, PacketHandler packetHandler )
-{   
-    if( !errorCode ){
-        // Unpack the packet's body from the buffer.
-        unpackBody( &( bodyBuffer_[0] ) );
+        unpackRecvBuffer();
+    }catch( std::exception& ){
+        packetHandler( boost::system::errc::make_error_code( boost::system::errc::bad_message ), *this );
+        return;
     }
 
-    // Call the packet handler.
-    packetHandler( errorCode, PacketPtr( clone() ) );
-
-    bodyBuffer_.clear();
+    // Call the packet handler. The handler could destroy this packet, so
+    // don't access it after this call.
+    packetHandler( errorCode, *this );
 }
 
 
 /***
- * 9. Packing and unpacking (private)
+ * 10. Packing and unpacking (private)
  ***/
 
 void* Packet::packHeader( void* buffer ) const
@@ -295,7 +274,7 @@ const void* Packet::unpackBody( const void* buffer ) const
 
 
 /***
- * 10. Auxiliar networking methods.
+ * 11. Auxiliar networking methods.
  ***/
 
 void Packet::updateHeader()
@@ -304,4 +283,123 @@ void Packet::updateHeader()
     header_.setBodySize( getPacketSize() );
 }
 
+
+void Packet::packIntoSendBuffer()
+{
+    PackablePacketSize uncompressedBodySize;
+
+    // Update the header and pack it along with the body.
+    updateHeader();
+    header_.setCompressed( false );
+
+    if( compressionEnabled_ && ( header_.getBodySize() >= MIN_COMPRESSED_BODY_SIZE ) ){
+        // Pack the body apart and compress it into the send buffer, after
+        // the header and the uncompressed body size. If the body doesn't
+        // get smaller, send it uncompressed.
+        uncompressedBody_.resize( header_.getBodySize() );
+        packBody( uncompressedBody_.data() );
+
+        if( compressData( uncompressedBody_.data(),
+                          uncompressedBody_.size(),
+                          sendBuffer_,
+                          header_.getPacketSize() + uncompressedBodySize.getPacketSize() ) ){
+            uncompressedBodySize = header_.getBodySize();
+            header_.setCompressed( true );
+            header_.setBodySize( sendBuffer_.size() - header_.getPacketSize() );
+            uncompressedBodySize.pack( packHeader( sendBuffer_.data() ) );
+            return;
+        }
+    }
+
+    sendBuffer_.resize( header_.getPacketSize() + header_.getBodySize() );
+    packBody( packHeader( sendBuffer_.data() ) );
+}
+
+
+PacketSize Packet::pendingRecvBytes()
+{
+    const PacketSize nBytes = recvBufferEnd_ - recvBufferBegin_;
+    const PacketSize headerSize = header_.getPacketSize();
+
+    // Wait for the header first.
+    if( nBytes < headerSize ){
+        return headerSize - nBytes;
+    }
+
+    // Once the header is available, unpack it for knowing the body size.
+    unpackHeader( &( recvBuffer_[recvBufferBegin_] ) );
+    if( header_.getBodySize() > MAX_PACKET_BODY_SIZE ){
+        throw std::runtime_error( std::string( "ERROR: Received a packet bigger than the maximum packet size" ) );
+    }
+
+    if( nBytes < headerSize + header_.getBodySize() ){
+        return headerSize + header_.getBodySize() - nBytes;
+    }
+
+    return 0;
+}
+
+
+void Packet::reserveRecvBuffer( PacketSize nBytes )
+{
+    // Move the bytes received from the next packet to the beginning of the
+    // buffer.
+    if( recvBufferBegin_ ){
+        std::copy( recvBuffer_.begin() + recvBufferBegin_,
+                   recvBuffer_.begin() + recvBufferEnd_,
+                   recvBuffer_.begin() );
+        recvBufferEnd_ -= recvBufferBegin_;
+        recvBufferBegin_ = 0;
+    }
+
+    if( recvBuffer_.size() < recvBufferEnd_ + nBytes ){
+        recvBuffer_.resize( recvBufferEnd_ + nBytes );
+    }
+}
+
+
+void Packet::unpackRecvBuffer()
+{
+    const char* buffer = &( recvBuffer_[recvBufferBegin_] );
+
+    // Unpack the packet's header from the buffer and check its type.
+    unpackHeader( buffer );
+    if( !expectedType() ){
+        throw std::runtime_error( std::string( "ERROR: Received an unexpected packet" ) );
+    }
+
+    // Unpack the packet's body, decompressing it first if needed.
+    if( header_.isCompressed() ){
+        PackablePacketSize uncompressedBodySize;
+
+        if( !compressionEnabled_ ){
+            throw std::runtime_error( std::string( "ERROR: Received a compressed packet without negotiating compression" ) );
+        }
+
+        if( header_.getBodySize() < uncompressedBodySize.getPacketSize() ){
+            throw std::runtime_error( std::string( "ERROR: Received a malformed compressed packet" ) );
+        }
+
+        const char* compressedBody =
+                static_cast< const char* >( uncompressedBodySize.unpack( buffer + header_.getPacketSize() ) );
+
+        if( uncompressedBodySize.getValue() > MAX_PACKET_BODY_SIZE ){
+            throw std::runtime_error( std::string( "ERROR: Received a packet bigger than the maximum packet size" ) );
+        }
+
+        uncompressedBody_.resize( uncompressedBodySize.getValue() );
+        decompressData( compressedBody,
+                        header_.getBodySize() - uncompressedBodySize.getPacketSize(),
+                        uncompressedBody_.data(),
+                        uncompressedBody_.size() );
+
+        unpackBody( uncompressedBody_.data() );
+    }else{
+        unpackBody( buffer + header_.getPacketSize() );
+    }
+
+    // Remove the packet from the buffer.
+    recvBufferBegin_ += header_.getPacketSize() + header_.getBodySize();
+}
+
 } // namespace como
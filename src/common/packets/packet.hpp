@@ -34,11 +34,29 @@ class Packet;
 // Convenient typedefs.
 typedef boost::asio::ip::tcp::socket Socket;
 typedef std::shared_ptr< Packet > PacketPtr;
-typedef std::function<void( const boost::system::error_code& errorCode, PacketPtr)> PacketHandler;
+typedef std::function<void( const boost::system::error_code& errorCode, const Packet& packet )> PacketHandler;
 
 // Maximum buffer available size for packing a packet.
 const PacketSize PACKET_HEADER_BUFFER_SIZE = 20; // TODO: Use a real value.
 
+// Minimum number of bytes requested to the socket in every asynchronous
+// read, so packets queued in the socket are read together.
+const PacketSize MIN_ASYNC_RECV_SIZE = 64 * 1024;
+
+// Packet bodies smaller than this aren't compressed.
+const PacketSize MIN_COMPRESSED_BODY_SIZE = 1024;
+
+// Maximum size of a received packet body (once uncompressed). Bigger
+// packets are rejected before allocating any buffer for them.
+const PacketSize MAX_PACKET_BODY_SIZE = 16 * 1024 * 1024;
+
+// Optional capabilities negotiated in the NEW_USER / USER_ACCEPTED
+// handshake.
+const std::uint8_t COMPRESSION_CAPABILITY = 0x01;
+
+// Mask of capabilities supported by this build.
+const std::uint8_t SUPPORTED_CAPABILITIES = COMPRESSION_CAPABILITY;
+
 
 /*!
  * \class Packet
@@ -75,21 +93,32 @@ class Packet : public CompositePackable
 
 
         /***
-         * 4. Synchronous communication
+         * 4. Setters
+         ***/
+        /*!
+         * \brief Set whether compression was negotiated for the connection
+         * this packet is sent / received through. If so, only bodies bigger
+         * than MIN_COMPRESSED_BODY_SIZE are compressed when sending it.
+         * Otherwise, receiving a compressed packet throws an exception.
+         */
+        void setCompressionEnabled( bool compressionEnabled );
+
+        /***
+         * 5. Synchronous communication
          ***/
         void send( boost::asio::ip::tcp::socket& socket );
         void recv( boost::asio::ip::tcp::socket& socket );
 
 
         /***
-         * 5. Asynchronous communication
+         * 6. Asynchronous communication
          ***/
         void asyncSend( Socket& socket, PacketHandler packetHandler );
         void asyncRecv( Socket& socket, PacketHandler packetHandler );
 
 
         /***
-         * 6. Packing and unpacking
+         * 7. Packing and unpacking
          ***/
         virtual void* pack( void* buffer ) const;
         virtual const void* unpack( const void* buffer );
@@ -97,7 +126,7 @@ class Packet : public CompositePackable
 
 
         /***
-         * 7. Operators
+         * 8. Operators
          ***/
         Packet& operator = ( const Packet& b );
         Packet& operator = ( Packet&& ) = delete;
@@ -105,16 +134,14 @@ class Packet : public CompositePackable
 
     private:
         /***
-         * 8. Asynchronous communication (private)
+         * 9. Asynchronous communication (private)
          ***/
-        void asyncSendBody( const boost::system::error_code& headerErrorCode, std::size_t, Socket& socket, PacketHandler packetHandler );
         void onPacketSend( const boost::system::error_code& errorCode, std::size_t, PacketHandler packetHandler );
-        void asyncRecvBody( const boost::system::error_code& headerErrorCode, std::size_t, Socket& socket, PacketHandler packetHandler );
-        void onPacketRecv( const boost::system::error_code& errorCode, std::size_t, PacketHandler packetHandler );
+        void onPacketRecv( const boost::system::error_code& errorCode, std::size_t nBytes, Socket& socket, PacketHandler packetHandler );
 
 
         /***
-         * 9. Packing and unpacking (private)
+         * 10. Packing and unpacking (private)
          ***/
         virtual void* packHeader( void* buffer ) const;
         virtual void* packBody( void* buffer ) const;
@@ -125,7 +152,7 @@ class Packet : public CompositePackable
 
 
         /***
-         * 10. Auxiliar networking methods.
+         * 11. Auxiliar networking methods.
          ***/
 
         /*!
@@ -134,6 +161,31 @@ class Packet : public CompositePackable
          */
         void updateHeader();
 
+        /*!
+         * \brief Packs the whole packet (header and body) into the send
+         * buffer.
+         */
+        void packIntoSendBuffer();
+
+        /*!
+         * \brief Returns the number of bytes which must still be received
+         * before the next packet in the reception buffer is complete.
+         */
+        PacketSize pendingRecvBytes();
+
+        /*!
+         * \brief Moves the pending received bytes to the beginning of the
+         * reception buffer and makes room in it for, at least, the given
+         * number of bytes.
+         */
+        void reserveRecvBuffer( PacketSize nBytes );
+
+        /*!
+         * \brief Unpacks the (complete) next packet in the reception buffer
+         * and removes it from the latter.
+         */
+        void unpackRecvBuffer();
+
 
         /***
          * Attributes
@@ -141,9 +193,28 @@ class Packet : public CompositePackable
         /*! Packet header. */
         PacketHeader header_;
 
-        /*! Buffer where this Packet is read from / written to. */
-        mutable char headerBuffer_[PACKET_HEADER_BUFFER_SIZE];
-        mutable std::vector< char > bodyBuffer_;
+        /*! Compress the bodies of this packet when sending it and accept
+         * compressed bodies when receiving it. */
+        bool compressionEnabled_;
+
+        /*! Buffer for the uncompressed body of a compressed packet. */
+        std::vector< char > uncompressedBody_;
+
+        /*! Buffer where this Packet is packed into before being sent. */
+        std::vector< char > sendBuffer_;
+
+        /*!
+         * Buffer where this Packet is received into. It is reused between
+         * receptions and it can hold bytes from the next packets in the
+         * socket.
+         */
+        std::vector< char > recvBuffer_;
+
+        /*! Index of the first byte of the next packet in recvBuffer_ */
+        std::size_t recvBufferBegin_;
+
+        /*! Index of the first byte not received yet in recvBuffer_ */
+        std::size_t recvBufferEnd_;
 };
 
 } // namespace como
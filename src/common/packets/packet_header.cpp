@@ -26,20 +26,24 @@ namespace como {
 
 PacketHeader::PacketHeader( PacketType type ) :
     type_( type ),
-    bodySize_( 0 )
+    bodySize_( 0 ),
+    flags_( 0 )
 {
     addPackable( &type_ );
     addPackable( &bodySize_ );
+    addPackable( &flags_ );
 }
 
 
 PacketHeader::PacketHeader( const PacketHeader& b ) :
     CompositePackable( b ),
     type_( b.type_ ),
-    bodySize_( b.bodySize_ )
+    bodySize_( b.bodySize_ ),
+    flags_( b.flags_ )
 {
     addPackable( &type_ );
     addPackable( &bodySize_ );
+    addPackable( &flags_ );
 }
 
 
@@ -59,6 +63,12 @@ PacketSize PacketHeader::getBodySize() const
 }
 
 
+bool PacketHeader::isCompressed() const
+{
+    return flags_.getValue() & PACKET_COMPRESSED_FLAG;
+}
+
+
 /***
  * 4. Setters
  ***/
@@ -69,6 +79,16 @@ void PacketHeader::setBodySize( PacketSize bodySize )
 }
 
 
+void PacketHeader::setCompressed( bool compressed )
+{
+    if( compressed ){
+        flags_ = flags_.getValue() | PACKET_COMPRESSED_FLAG;
+    }else{
+        flags_ = flags_.getValue() & ~PACKET_COMPRESSED_FLAG;
+    }
+}
+
+
 /***
  * 5. Operators
  ***/
@@ -78,6 +98,7 @@ CompositePackable& PacketHeader::operator = (const PacketHeader& b )
     if( this != &b ){
         type_ = b.type_;
         bodySize_ = b.bodySize_;
+        flags_ = b.flags_;
     }
 
     return *this;
@@ -89,6 +110,7 @@ CompositePackable& PacketHeader::operator = ( PacketHeader&& b )
     if( this != &b ){
         type_ = b.type_;
         bodySize_ = b.bodySize_;
+        flags_ = b.flags_;
     }
 
     return *this;
@@ -39,6 +39,9 @@ enum class PacketType : std::uint8_t
 
 typedef PackableUint32< PacketSize > PackablePacketSize;
 
+// Flags in the packet header.
+const std::uint8_t PACKET_COMPRESSED_FLAG = 0x01;
+
 /*!
  * \class PacketHeader
  *
@@ -53,6 +56,9 @@ class PacketHeader : public CompositePackable
         /*! Size of the packet's body */
         PackablePacketSize bodySize_;
 
+        /*! Flags of the packet (ie. PACKET_COMPRESSED_FLAG) */
+        PackableUint8< std::uint8_t > flags_;
+
     public:
         /***
          * 1. Construction
@@ -92,6 +98,14 @@ class PacketHeader : public CompositePackable
          */
         PacketSize getBodySize() const;
 
+        /*!
+         * \brief Returns true if the packet body associated with this
+         * PacketHeader is compressed. A compressed body starts with its
+         * uncompressed size (PackablePacketSize), followed by the compressed
+         * data.
+         */
+        bool isCompressed() const;
+
 
         /***
          * 4. Setters
@@ -100,6 +114,9 @@ class PacketHeader : public CompositePackable
         /*! \brief Set the value of the body size attribute */
         void setBodySize( PacketSize bodySize );
 
+        /*! \brief Set whether the packet body is compressed or not */
+        void setCompressed( bool compressed );
+
 
         /***
          * 5. Operators
@@ -95,6 +95,12 @@ void SceneUpdatePacket::addCommand( CommandConstPtr command,
 }
 
 
+CommandsList SceneUpdatePacket::takeCommands()
+{
+    return commands_.takeCommands();
+}
+
+
 void SceneUpdatePacket::clear()
 {
     commands_.clear();
@@ -26,6 +26,13 @@
 
 namespace como {
 
+/*!
+ * Budget (in bytes) for the commands in a SCENE_UPDATE packet. Commands are
+ * added to a packet until the next one doesn't fit in it, but a command
+ * bigger than this budget is still sent alone in its own packet.
+ */
+const PacketSize MAX_SCENE_UPDATE_COMMANDS_SIZE = 64 * 1024;
+
 /*!
  * \class SceneUpdatePacket
  *
@@ -87,6 +94,7 @@ class SceneUpdatePacket : public Packet
         void addCommand( CommandConstPtr command,
                          const std::uint32_t& commandIndex,
                          const std::uint32_t& historicSize );
+        CommandsList takeCommands();
         void clear();
 
 
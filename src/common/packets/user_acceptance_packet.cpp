@@ -29,12 +29,16 @@ UserAcceptancePacket::UserAcceptancePacket() :
     id_( 0 ),
     name_( "Unnamed" ),
     sceneName_( "Unnamed scene" ),
-    selectionColor_()
+    selectionColor_(),
+    floatEncoding_( FloatEncoding::IEEE_754 ),
+    capabilities_( 0 )
 {
     addPackable( &id_ );
     addPackable( &name_ );
     addPackable( &sceneName_ );
     addPackable( &selectionColor_ );
+    addPackable( &floatEncoding_ );
+    addPackable( &capabilities_ );
 }
 
 
@@ -43,12 +47,16 @@ UserAcceptancePacket::UserAcceptancePacket( const std::uint32_t& id, const char*
     id_( id ),
     name_( name ),
     sceneName_( sceneName ),
-    selectionColor_( selectionColor )
+    selectionColor_( selectionColor ),
+    floatEncoding_( FloatEncoding::IEEE_754 ),
+    capabilities_( 0 )
 {
     addPackable( &id_ );
     addPackable( &name_ );
     addPackable( &sceneName_ );
     addPackable( &selectionColor_ );
+    addPackable( &floatEncoding_ );
+    addPackable( &capabilities_ );
 }
 
 
@@ -57,12 +65,16 @@ UserAcceptancePacket::UserAcceptancePacket( const UserAcceptancePacket& b ) :
     id_( b.id_ ),
     name_( b.name_ ),
     sceneName_( b.sceneName_ ),
-    selectionColor_( b.selectionColor_ )
+    selectionColor_( b.selectionColor_ ),
+    floatEncoding_( b.floatEncoding_ ),
+    capabilities_( b.capabilities_ )
 {
     addPackable( &id_ );
     addPackable( &name_ );
     addPackable( &sceneName_ );
     addPackable( &selectionColor_ );
+    addPackable( &floatEncoding_ );
+    addPackable( &capabilities_ );
 }
 
 
@@ -101,6 +113,18 @@ Color UserAcceptancePacket::getSelectionColor() const
 }
 
 
+FloatEncoding UserAcceptancePacket::getFloatEncoding() const
+{
+    return floatEncoding_.getValue();
+}
+
+
+std::uint8_t UserAcceptancePacket::getCapabilities() const
+{
+    return capabilities_.getValue();
+}
+
+
 bool UserAcceptancePacket::expectedType() const
 {
     return ( Packet::getType() == PacketType::USER_ACCEPTED );
@@ -143,6 +167,18 @@ void UserAcceptancePacket::setSelectionColor( const std::uint8_t& r, const std::
 }
 
 
+void UserAcceptancePacket::setFloatEncoding( FloatEncoding floatEncoding )
+{
+    floatEncoding_ = floatEncoding;
+}
+
+
+void UserAcceptancePacket::setCapabilities( std::uint8_t capabilities )
+{
+    capabilities_ = capabilities;
+}
+
+
 /***
  * 5. Operators
  ***/
@@ -155,6 +191,8 @@ UserAcceptancePacket& UserAcceptancePacket::operator = (const UserAcceptancePack
         id_ = b.id_;
         name_ = b.name_;
         selectionColor_ = b.selectionColor_;
+        floatEncoding_ = b.floatEncoding_;
+        capabilities_ = b.capabilities_;
     }
 
     return *this;
@@ -26,6 +26,7 @@
 #include <common/packables/packable_color.hpp>
 #include <common/packables/packable_string.hpp>
 #include <common/packables/ids/packable_resource_id.hpp>
+#include <common/packables/float_encoding.hpp>
 
 namespace como {
 
@@ -54,6 +55,12 @@ class UserAcceptancePacket : public Packet
          */
         PackableColor selectionColor_; // RGBA format.
 
+        /*! Float encoding used in the session */
+        PackableFloatEncoding floatEncoding_;
+
+        /*! Optional capabilities enabled in the session */
+        PackableUint8< std::uint8_t > capabilities_;
+
     public:
         /***
          * 1. Construction
@@ -78,6 +85,8 @@ class UserAcceptancePacket : public Packet
         const char* getName() const ;
         const char* getSceneName() const ;
         Color getSelectionColor() const ;
+        FloatEncoding getFloatEncoding() const ;
+        std::uint8_t getCapabilities() const ;
         virtual bool expectedType() const ;
 
 
@@ -89,6 +98,8 @@ class UserAcceptancePacket : public Packet
         void setName( const char* name );
         void setSceneName( const char* name );
         void setSelectionColor( const std::uint8_t& r, const std::uint8_t& g, const std::uint8_t& b, const std::uint8_t& a );
+        void setFloatEncoding( FloatEncoding floatEncoding );
+        void setCapabilities( std::uint8_t capabilities );
 
 
         /***
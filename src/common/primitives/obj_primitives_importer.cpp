@@ -21,14 +21,49 @@
 #include <stdexcept>
 #include <common/exceptions/file_not_open_exception.hpp>
 #include <common/primitives/primitive_data/imported_primitive_data.hpp>
+#include <common/primitives/polygon_triangulation.hpp>
+#include <common/utilities/file_view.hpp>
+#include <common/utilities/text_parsing.hpp>
+#include <boost/thread.hpp>
 #include <map>
 #include <array>
+#include <algorithm>
+#include <cstring>
+#include <clocale>
+#include <exception>
 
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 
 namespace como {
 
+// Minimum size of the chunks an OBJ file is split into for parsing it in
+// parallel.
+const std::uint32_t PARALLEL_PARSING_MIN_CHUNK_SIZE = 4 * 1024 * 1024;
+
+
+/*! \brief Appends src to dst, stealing src's storage if dst is empty. */
+template < class T >
+static void appendVector( std::vector< T >& dst, std::vector< T >& src )
+{
+    if( dst.empty() ){
+        dst.swap( src );
+    }else{
+        dst.insert( dst.end(), src.begin(), src.end() );
+    }
+    src = std::vector< T >();
+}
+
+
+/***
+ * 1. Construction
+ ***/
+
+OBJPrimitivesImporter::OBJPrimitivesImporter( unsigned int maxThreads ) :
+    maxThreads_( maxThreads ? maxThreads : std::max( 1u, boost::thread::hardware_concurrency() ) )
+{}
+
+
 /***
  * 3. Primitives import
  ***/
@@ -54,120 +89,378 @@ PrimitiveInfo OBJPrimitivesImporter::importPrimitive( std::string srcFilePath, s
 
 void OBJPrimitivesImporter::processMeshFile( std::string filePath, PrimitiveInfo& primitiveInfo, ImportedPrimitiveData& primitiveData )
 {
-    std::ifstream file;
-    std::string fileLine;
-
-    // Set '.' as the float separator (for parsing floats from a text
-    // line).
-    setlocale( LC_NUMERIC, "C" );
+    // Set '.' as the float separator (for parsing floats from material
+    // files). Don't change it if it's already set, as primitives can be
+    // imported from several threads at once.
+    if( strcmp( setlocale( LC_NUMERIC, nullptr ), "C" ) ){
+        setlocale( LC_NUMERIC, "C" );
+    }
 
-    file.open( filePath );
-    if( !file.is_open() ){
+    if( !boost::filesystem::exists( filePath ) ){
         throw FileNotOpenException( filePath );
     }
 
     primitiveData.name = boost::filesystem::basename( filePath );
     primitiveInfo.name = primitiveData.name;
 
-    while( !file.eof() ){
-        readLine( file, fileLine );
+    const FileViewConstPtr fileView = FileView::open( filePath );
+    const char* fileBegin = fileView->data();
+    const char* fileEnd = fileBegin + fileView->size();
 
-        processMeshFileLine( filePath, fileLine, primitiveData );
+    // Split big files into chunks of whole lines and parse them in
+    // parallel.
+    unsigned int nChunks = 1;
+    if( fileView->size() >= 2 * PARALLEL_PARSING_MIN_CHUNK_SIZE ){
+        nChunks = std::min( maxThreads_, fileView->size() / PARALLEL_PARSING_MIN_CHUNK_SIZE );
     }
 
-    file.close();
+    std::vector< const char* > chunksBegins( nChunks + 1, fileEnd );
+    chunksBegins[0] = fileBegin;
+    for( unsigned int i = 1; i < nChunks; i++ ){
+        const char* chunkBegin =
+                std::max( chunksBegins[i-1],
+                          fileBegin + static_cast< std::uint64_t >( fileView->size() ) * i / nChunks );
+        const char* lineEnd =
+                static_cast< const char* >( memchr( chunkBegin, '\n', fileEnd - chunkBegin ) );
+        chunksBegins[i] = lineEnd ? ( lineEnd + 1 ) : fileEnd;
+    }
+
+    std::vector< OBJMeshChunk > chunks( nChunks );
+    if( nChunks == 1 ){
+        parseMeshChunk( fileBegin, fileEnd, chunks[0] );
+    }else{
+        std::vector< std::exception_ptr > chunksErrors( nChunks );
+        boost::thread_group threads;
+
+        for( unsigned int i = 0; i < nChunks; i++ ){
+            threads.create_thread( [&, i](){
+                try {
+                    parseMeshChunk( chunksBegins[i], chunksBegins[i+1], chunks[i] );
+                }catch( ... ){
+                    chunksErrors[i] = std::current_exception();
+                }
+            });
+        }
+        threads.join_all();
+
+        for( const std::exception_ptr& chunkError : chunksErrors ){
+            if( chunkError ){
+                std::rethrow_exception( chunkError );
+            }
+        }
+    }
+
+    mergeMeshChunks( filePath, chunks, primitiveData );
 
     if( ( primitiveData.normalData.normals.size() == 0 ) ||
             ( primitiveData.normalData.normalTriangles.size() == 0 )  ){
         computeNormalData( primitiveData.vertexData, primitiveData.normalData );
     }
 
-    primitiveData.generateOGLData();
+    primitiveData.generateOGLData( true );
+    primitiveData.generateOGLLODLevels();
 }
 
-void OBJPrimitivesImporter::processMeshFileLine( std::string filePath, std::string line, ImportedPrimitiveData& primitiveData )
+
+void OBJPrimitivesImporter::parseMeshChunk( const char* begin, const char* end, OBJMeshChunk& chunk ) const
 {
-    std::string lineHeader;
-    std::string lineBody;
+    const char* lineBegin = begin;
+
+    while( lineBegin < end ){
+        const char* lineEnd =
+                static_cast< const char* >( memchr( lineBegin, '\n', end - lineBegin ) );
+        const char* nextLine = lineEnd ? ( lineEnd + 1 ) : end;
+        if( !lineEnd ){
+            lineEnd = end;
+        }
+        if( ( lineEnd > lineBegin ) && ( *( lineEnd - 1 ) == '\r' ) ){
+            lineEnd--;
+        }
 
-    if( !line.size() ){
-        return;
-    }
+        const char* it = lineBegin;
+        skipBlanks( it, lineEnd );
 
-    splitFileLine( line, lineHeader, lineBody );
+        if( startsWithWord( it, lineEnd, "v" ) ){
+            glm::vec3 vertex;
 
-    if( lineHeader == "v" ){
-        glm::vec3 vertex;
+            it++;
+            for( unsigned int i = 0; i < 3; i++ ){
+                skipBlanks( it, lineEnd );
+                if( !parseFloat( it, lineEnd, vertex[i] ) ){
+                    throw std::runtime_error( "ERROR reading OBJ vertex line [" + std::string( lineBegin, lineEnd ) + "]" );
+                }
+            }
+            chunk.vertices.push_back( vertex );
+        }else if( startsWithWord( it, lineEnd, "vt" ) ){
+            glm::vec2 textureCoordinates;
+
+            it += 2;
+            for( unsigned int i = 0; i < 2; i++ ){
+                skipBlanks( it, lineEnd );
+                if( !parseFloat( it, lineEnd, textureCoordinates[i] ) ){
+                    throw std::runtime_error( "ERROR reading OBJ UV line [" + std::string( lineBegin, lineEnd ) + "]" );
+                }
+            }
 
-        // Extract the vertex from the line and add it to the Mesh.
-        sscanf( lineBody.c_str(), "%f %f %f", &vertex[0], &vertex[1], &vertex[2] );
-        primitiveData.vertexData.vertices.push_back( vertex );
-    }else if( lineHeader == "vt" ){
-        glm::vec2 textureCoordinates;
+            // Invert Y component.
+            textureCoordinates.y = 1.0f - textureCoordinates.y;
 
-        // Extract the UV coordinates from the line and add it to the Mesh.
-        sscanf( lineBody.c_str(), "%f %f", &textureCoordinates[0], &textureCoordinates[1] );
+            chunk.uvVertices.push_back( textureCoordinates );
+        }else if( startsWithWord( it, lineEnd, "vn" ) ){
+            glm::vec3 normal;
 
-        // Invert Y component.
-        textureCoordinates.y = 1.0f - textureCoordinates.y;
+            it += 2;
+            for( unsigned int i = 0; i < 3; i++ ){
+                skipBlanks( it, lineEnd );
+                if( !parseFloat( it, lineEnd, normal[i] ) ){
+                    throw std::runtime_error( "ERROR reading OBJ normal line [" + std::string( lineBegin, lineEnd ) + "]" );
+                }
+            }
+            chunk.normals.push_back( glm::normalize( normal ) );
+        }else if( startsWithWord( it, lineEnd, "f" ) ){
+            parseFace( it + 1, lineEnd, chunk );
+        }else if( startsWithWord( it, lineEnd, "mtllib" ) ||
+                  startsWithWord( it, lineEnd, "usemtl" ) ){
+            OBJStatement statement;
+            statement.type = ( *it == 'm' ) ?
+                        OBJStatement::Type::MTLLIB : OBJStatement::Type::USEMTL;
+            statement.nTriangles = 0;
+            statement.includesUV = false;
+
+            it += 6;
+            skipBlanks( it, lineEnd );
+            const char* argumentEnd = lineEnd;
+            while( ( argumentEnd > it ) && atBlank( argumentEnd - 1, lineEnd ) ){
+                argumentEnd--;
+            }
+            statement.argument.assign( it, argumentEnd );
 
-        primitiveData.uvData.uvVertices.push_back( textureCoordinates );
-    }else if( lineHeader == "vn" ){
-        glm::vec3 normal;
+            chunk.statements.push_back( statement );
+        }
 
-        // Extract the normal from the line and add it to the Mesh.
-        sscanf( lineBody.c_str(), "%f %f %f", &normal[0], &normal[1], &normal[2] );
-        primitiveData.normalData.normals.push_back( glm::normalize( normal ) );
+        lineBegin = nextLine;
+    }
+}
 
-    }else if( lineHeader == "f" ){
-        if( primitiveData.trianglesGroups_.size() == 0 ){
-            // A face has been specified without defining its associated
-            // material, so create a default material and a default
-            // triangles group and join them.
-            primitiveData.materialsInfo_.push_back( MaterialInfo() );
 
-            TrianglesGroupWithMaterial newTrianglesGroup;
-            newTrianglesGroup.materialIndex = 0;
+void OBJPrimitivesImporter::parseFace( const char* it, const char* end, OBJMeshChunk& chunk ) const
+{
+    // Face corners are parsed straight into the polygons corners buffer and
+    // dropped from there again if the face turns out to be a triangle.
+    const unsigned int firstCorner = chunk.polygonsCorners.size();
+    FaceComponents faceComponents = FaceComponents::ONLY_VERTICES;
+    const char* const faceBegin = it;
+
+    skipBlanks( it, end );
+    while( it < end ){
+        std::uint32_t vertexIndex = 0;
+        std::uint32_t uvIndex = 0;
+        std::uint32_t normalIndex = 0;
+        bool uvIncluded = false;
+        bool normalIncluded = false;
+
+        // Face vertex: %u, %u/%u, %u//%u or %u/%u/%u.
+        bool validFaceVertex = parseUint32( it, end, vertexIndex );
+        if( validFaceVertex && ( it < end ) && ( *it == '/' ) ){
+            it++;
+            if( ( it < end ) && ( *it != '/' ) ){
+                uvIncluded = true;
+                validFaceVertex = parseUint32( it, end, uvIndex );
+            }
+            if( validFaceVertex && ( it < end ) && ( *it == '/' ) ){
+                it++;
+                normalIncluded = true;
+                validFaceVertex = parseUint32( it, end, normalIndex );
+            }
+        }
 
-            primitiveData.trianglesGroups_.push_back( newTrianglesGroup );
+        // Indices are 1-based in the .obj file. Negative (relative)
+        // indices aren't supported.
+        if( !validFaceVertex ||
+                !vertexIndex ||
+                ( uvIncluded && !uvIndex ) ||
+                ( normalIncluded && !normalIndex ) ||
+                ( ( it < end ) && !atBlank( it, end ) ) ){
+            throw std::runtime_error( "ERROR reading OBJ face line [" + std::string( faceBegin, end ) + "]" );
         }
 
-        const unsigned int nUVTrianglesBeforeFaceInsertion =
-                primitiveData.uvData.uvTriangles.size();
-
-        switch( getFaceType( lineBody ) ){
-            case FaceType::TRIANGLE:
-                processTriangleFaceStr( lineBody, primitiveData );
-            break;
-            case FaceType::QUAD:
-                processQuadFaceStr( lineBody, primitiveData );
-            break;
-            case FaceType::OTHER:
-                throw std::runtime_error( "OBJ primitive importer can't process faces others than triangles and quads" );
-            break;
+        const FaceComponents faceVertexComponents =
+                uvIncluded ?
+                    ( normalIncluded ? FaceComponents::VERTICES_NORMALS_AND_UVS : FaceComponents::VERTICES_AND_UVS ) :
+                    ( normalIncluded ? FaceComponents::VERTICES_AND_NORMALS : FaceComponents::ONLY_VERTICES );
+
+        if( chunk.polygonsCorners.size() == firstCorner ){
+            faceComponents = faceVertexComponents;
+        }else if( faceVertexComponents != faceComponents ){
+            throw std::runtime_error( "ERROR reading OBJ face line (inconsistent face vertices) [" + std::string( faceBegin, end ) + "]" );
         }
 
-        const unsigned int nUVTrianglesAfterFaceInsertion =
-                primitiveData.uvData.uvTriangles.size();
+        chunk.polygonsCorners.push_back( { { vertexIndex - 1, uvIndex - 1, normalIndex - 1 } } );
+
+        skipBlanks( it, end );
+    }
+
+    const unsigned int nFaceVertices = chunk.polygonsCorners.size() - firstCorner;
+    if( nFaceVertices < 3 ){
+        throw std::runtime_error( "ERROR reading OBJ face line (less than three vertices) [" + std::string( faceBegin, end ) + "]" );
+    }
+
+    const bool uvIncluded =
+            ( faceComponents == FaceComponents::VERTICES_AND_UVS ) ||
+            ( faceComponents == FaceComponents::VERTICES_NORMALS_AND_UVS );
+    const bool normalIncluded =
+            ( faceComponents == FaceComponents::VERTICES_AND_NORMALS ) ||
+            ( faceComponents == FaceComponents::VERTICES_NORMALS_AND_UVS );
+
+    if( nFaceVertices > 3 ){
+        OBJPolygon polygon;
+        polygon.firstCorner = firstCorner;
+        polygon.nCorners = nFaceVertices;
+        polygon.firstVertexTriangle = chunk.vertexTriangles.size();
+        polygon.firstUVTriangle = chunk.uvTriangles.size();
+        polygon.firstNormalTriangle = chunk.normalTriangles.size();
+        polygon.includesUV = uvIncluded;
+        polygon.includesNormals = normalIncluded;
+
+        chunk.polygons.push_back( polygon );
+    }
+
+    // Triangulate the face as a fan around its first vertex.
+    const FaceCorner& firstFaceCorner = chunk.polygonsCorners[firstCorner];
+    for( unsigned int i = firstCorner + 1; i + 1 < chunk.polygonsCorners.size(); i++ ){
+        const FaceCorner& corner = chunk.polygonsCorners[i];
+        const FaceCorner& nextCorner = chunk.polygonsCorners[i+1];
 
-        primitiveData.trianglesGroups_.back().includesUV =
-                ( nUVTrianglesAfterFaceInsertion != nUVTrianglesBeforeFaceInsertion );
+        chunk.vertexTriangles.push_back( { { firstFaceCorner[0], corner[0], nextCorner[0] } } );
+        if( uvIncluded ){
+            chunk.uvTriangles.push_back( { { firstFaceCorner[1], corner[1], nextCorner[1] } } );
+        }
+        if( normalIncluded ){
+            chunk.normalTriangles.push_back( { { firstFaceCorner[2], corner[2], nextCorner[2] } } );
+        }
+    }
+
+    if( nFaceVertices == 3 ){
+        chunk.polygonsCorners.resize( firstCorner );
+    }
+
+    // Consecutive faces are recorded as a single statement.
+    if( !chunk.statements.size() ||
+            ( chunk.statements.back().type != OBJStatement::Type::FACES ) ){
+        OBJStatement statement;
+        statement.type = OBJStatement::Type::FACES;
+        statement.nTriangles = 0;
+        statement.includesUV = false;
+
+        chunk.statements.push_back( statement );
+    }
+    chunk.statements.back().nTriangles += nFaceVertices - 2;
+    chunk.statements.back().includesUV = uvIncluded;
+}
+
+
+void OBJPrimitivesImporter::mergeMeshChunks( const std::string& filePath, std::vector< OBJMeshChunk >& chunks, ImportedPrimitiveData& primitiveData )
+{
+    std::vector< OBJPolygon > polygons;
+    std::vector< FaceCorner > polygonsCorners;
+
+    for( OBJMeshChunk& chunk : chunks ){
+        // Make the polygons' indices global to the file.
+        for( OBJPolygon& polygon : chunk.polygons ){
+            polygon.firstCorner += polygonsCorners.size();
+            polygon.firstVertexTriangle += primitiveData.vertexData.vertexTriangles.size();
+            polygon.firstUVTriangle += primitiveData.uvData.uvTriangles.size();
+            polygon.firstNormalTriangle += primitiveData.normalData.normalTriangles.size();
+        }
+        appendVector( polygons, chunk.polygons );
+        appendVector( polygonsCorners, chunk.polygonsCorners );
+
+        appendVector( primitiveData.vertexData.vertices, chunk.vertices );
+        appendVector( primitiveData.uvData.uvVertices, chunk.uvVertices );
+        appendVector( primitiveData.normalData.normals, chunk.normals );
+        appendVector( primitiveData.vertexData.vertexTriangles, chunk.vertexTriangles );
+        appendVector( primitiveData.uvData.uvTriangles, chunk.uvTriangles );
+        appendVector( primitiveData.normalData.normalTriangles, chunk.normalTriangles );
+
+        for( const OBJStatement& statement : chunk.statements ){
+            switch( statement.type ){
+                case OBJStatement::Type::FACES:
+                    if( primitiveData.trianglesGroups_.size() == 0 ){
+                        // A face has been specified without defining its
+                        // associated material, so create a default material
+                        // and a default triangles group and join them.
+                        primitiveData.materialsInfo_.push_back( MaterialInfo() );
+
+                        TrianglesGroupWithMaterial newTrianglesGroup;
+                        newTrianglesGroup.materialIndex = 0;
+
+                        primitiveData.trianglesGroups_.push_back( newTrianglesGroup );
+                    }
+
+                    primitiveData.trianglesGroups_.back().nTriangles += statement.nTriangles;
+                    primitiveData.trianglesGroups_.back().includesUV = statement.includesUV;
+                break;
+                case OBJStatement::Type::MTLLIB:{
+                    boost::filesystem::path fileDirectory = boost::filesystem::path( filePath ).parent_path();
+                    std::string materialFilePath = ( fileDirectory / statement.argument ).string();
+
+                    processMaterialFile( materialFilePath, primitiveData.oglData.includesUV, primitiveData.materialsInfo_ );
+                }break;
+                case OBJStatement::Type::USEMTL:{
+                    TrianglesGroupWithMaterial newTrianglesGroup;
+                    if( primitiveData.trianglesGroups_.size() ){
+                        newTrianglesGroup.firstTriangleIndex =
+                                primitiveData.trianglesGroups_.back().firstTriangleIndex +
+                                primitiveData.trianglesGroups_.back().nTriangles;
+                    }
+                    newTrianglesGroup.materialIndex = primitiveData.getMaterialIndex( statement.argument );
+
+                    primitiveData.trianglesGroups_.push_back( newTrianglesGroup );
+                }break;
+            }
+        }
+    }
+
+    // Every vertex is known now, so concave polygons can be retriangulated.
+    triangulatePolygons( polygons, polygonsCorners, primitiveData );
+}
 
-    }else if( lineHeader == "mtllib" ){
-        boost::filesystem::path fileDirectory = boost::filesystem::path( filePath ).parent_path();
-        std::string materialFilePath = ( fileDirectory / lineBody ).string();
 
-        processMaterialFile( materialFilePath, primitiveData.oglData.includesUV, primitiveData.materialsInfo_ );
-    }else if( lineHeader == "usemtl" ){
-        TrianglesGroupWithMaterial newTrianglesGroup;
-        if( primitiveData.trianglesGroups_.size() ){
-            newTrianglesGroup.firstTriangleIndex =
-                    primitiveData.trianglesGroups_.back().firstTriangleIndex +
-                    primitiveData.trianglesGroups_.back().nTriangles;
+void OBJPrimitivesImporter::triangulatePolygons( const std::vector< OBJPolygon >& polygons, const std::vector< FaceCorner >& polygonsCorners, ImportedPrimitiveData& primitiveData )
+{
+    std::vector< glm::vec3 > polygonVertices;
+    std::vector< PolygonTriangle > polygonTriangles;
+    const VerticesVector& vertices = primitiveData.vertexData.vertices;
+
+    for( const OBJPolygon& polygon : polygons ){
+        const FaceCorner* corners = &polygonsCorners[polygon.firstCorner];
+
+        polygonVertices.clear();
+        for( unsigned int i = 0; i < polygon.nCorners; i++ ){
+            if( corners[i][0] >= vertices.size() ){
+                throw std::runtime_error( "ERROR reading OBJ face (vertex index " +
+                                          std::to_string( corners[i][0] + 1 ) +
+                                          " out of range)" );
+            }
+            polygonVertices.push_back( vertices[corners[i][0]] );
         }
-        newTrianglesGroup.materialIndex = primitiveData.getMaterialIndex( lineBody );
 
-        primitiveData.trianglesGroups_.push_back( newTrianglesGroup );
+        triangulatePolygon( polygonVertices, polygonTriangles );
+
+        for( unsigned int i = 0; i < polygonTriangles.size(); i++ ){
+            const PolygonTriangle& triangle = polygonTriangles[i];
+
+            primitiveData.vertexData.vertexTriangles[polygon.firstVertexTriangle + i] =
+                { { corners[triangle[0]][0], corners[triangle[1]][0], corners[triangle[2]][0] } };
+            if( polygon.includesUV ){
+                primitiveData.uvData.uvTriangles[polygon.firstUVTriangle + i] =
+                    { { corners[triangle[0]][1], corners[triangle[1]][1], corners[triangle[2]][1] } };
+            }
+            if( polygon.includesNormals ){
+                primitiveData.normalData.normalTriangles[polygon.firstNormalTriangle + i] =
+                    { { corners[triangle[0]][2], corners[triangle[1]][2], corners[triangle[2]][2] } };
+            }
+        }
     }
 }
 
@@ -251,273 +544,6 @@ void OBJPrimitivesImporter::readLine( std::ifstream &file, std::string &fileLine
 }
 
 
-FaceType OBJPrimitivesImporter::getFaceType( const std::string &faceBody )
-{   
-    char str[150];
-    const int nFaces =
-            sscanf( faceBody.c_str(), " %s %s %s %s ", str, str, str, str );
-
-    if( nFaces == 3 ){
-        return FaceType::TRIANGLE;
-    }else if( nFaces == 4 ){
-        return FaceType::QUAD;
-    }else{
-        return FaceType::OTHER;
-    }
-}
-
-
-FaceComponents OBJPrimitivesImporter::getFaceComponents( const std::string &faceDefinition )
-{
-    std::string firstTriangleVertexStr = faceDefinition.substr( 0, faceDefinition.find( ' ' ) );
-    size_t firstSlashPosition = std::string::npos;
-    size_t secondSlashPosition = std::string::npos;
-
-    firstSlashPosition = faceDefinition.find( '/' );
-
-    if( firstSlashPosition == std::string::npos ){
-        // No slashes found. Face defines only vertex positions.
-        // Vertex: %u
-        return FaceComponents::ONLY_VERTICES;
-    }else{
-        secondSlashPosition = firstTriangleVertexStr.find( '/', firstSlashPosition + 1 );
-
-        if( secondSlashPosition == std::string::npos ){
-            // Only one slash found per face vertex. Face defines vertex
-            // position and UV coordinates.
-            // Vertex: %u/%u
-            return FaceComponents::VERTICES_AND_UVS;
-        }else{
-            if( secondSlashPosition != (firstSlashPosition + 1) ){
-                // Vertex: %u/%u/%u
-                return FaceComponents::VERTICES_NORMALS_AND_UVS;
-            }else{
-                // Vertex: %u//%u
-                return FaceComponents::VERTICES_AND_NORMALS;
-            }
-        }
-    }
-}
-
-
-void OBJPrimitivesImporter::processTriangleFaceStr( const std::string &lineBody, ImportedPrimitiveData& primitiveData )
-{
-    std::array< GLuint, 3 > vertexTriangle = { 0 };
-    std::array< GLuint, 3 > uvTriangle = { 0 };
-    std::array< GLuint, 3 > normalTriangle = { 0 };
-    int componentsRead;
-    int i;
-
-    switch( getFaceComponents( lineBody ) ){
-        case FaceComponents::ONLY_VERTICES:
-            componentsRead = sscanf( lineBody.c_str(), "%u %u %u", &vertexTriangle[0], &vertexTriangle[1], &vertexTriangle[2] );
-
-            if( componentsRead != 3 ){
-                std::string errorMessage =
-                        "Error reading mesh triangle - line definition [" +
-                        lineBody +
-                        "] - components read [" +
-                        std::to_string( componentsRead ) + "]";
-                throw std::runtime_error( errorMessage );
-            }
-
-            for( i=0; i<3; i++ ){
-                // Decrement every vertex index because they are 1-based in the .obj file.
-                vertexTriangle[i] -= 1;
-            }
-            primitiveData.vertexData.vertexTriangles.push_back( vertexTriangle );
-        break;
-        case FaceComponents::VERTICES_AND_UVS:
-            // Extract the UV coordinates from the line and add it to the Mesh.
-            componentsRead =
-                    sscanf( lineBody.c_str(), "%u/%u %u/%u %u/%u",
-                    &vertexTriangle[0], &uvTriangle[0],
-                    &vertexTriangle[1], &uvTriangle[1],
-                    &vertexTriangle[2], &uvTriangle[2]);
-
-            if( componentsRead != 6 ){
-                throw std::runtime_error( "ERROR reading OBJ face line (v/vt)" );
-            }
-
-            for( i=0; i<3; i++ ){
-                // Decrement every vertex index because they are 1-based in the .obj file.
-                vertexTriangle[i] -= 1;
-                uvTriangle[i] -= 1;
-            }
-
-            primitiveData.vertexData.vertexTriangles.push_back( vertexTriangle );
-            primitiveData.uvData.uvTriangles.push_back( uvTriangle );
-
-        break;
-        case FaceComponents::VERTICES_NORMALS_AND_UVS:
-            componentsRead =
-                    sscanf( lineBody.c_str(), "%u/%u/%u %u/%u/%u %u/%u/%u",
-                    &vertexTriangle[0], &uvTriangle[0], &normalTriangle[0],
-                    &vertexTriangle[1], &uvTriangle[1], &normalTriangle[1],
-                    &vertexTriangle[2], &uvTriangle[2], &normalTriangle[2] );
-
-            if( componentsRead != 9 ){
-                throw std::runtime_error( "ERROR reading OBJ face line (v/vt/vn)" );
-            }
-
-            for( i=0; i<3; i++ ){
-                // Decrement every vertex index because they are 1-based in the .obj file.
-                vertexTriangle[i] -= 1;
-                normalTriangle[i] -= 1;
-                uvTriangle[i] -= 1;
-            }
-
-            primitiveData.vertexData.vertexTriangles.push_back( vertexTriangle );
-            primitiveData.normalData.normalTriangles.push_back( normalTriangle );
-            primitiveData.uvData.uvTriangles.push_back( uvTriangle );
-        break;
-        case FaceComponents::VERTICES_AND_NORMALS:
-            componentsRead =
-                    sscanf( lineBody.c_str(), "%u//%u %u//%u %u//%u",
-                    &vertexTriangle[0], &normalTriangle[0],
-                    &vertexTriangle[1], &normalTriangle[1],
-                    &vertexTriangle[2], &normalTriangle[2] );
-
-            if( componentsRead != 6 ){
-                throw std::runtime_error( "ERROR reading OBJ face line (v//vn)" );
-            }
-
-            for( i=0; i<3; i++ ){
-                // Decrement every vertex index because they are 1-based in the .obj file.
-                vertexTriangle[i] -= 1;
-                normalTriangle[i] -= 1;
-            }
-            primitiveData.vertexData.vertexTriangles.push_back( vertexTriangle );
-            primitiveData.normalData.normalTriangles.push_back( normalTriangle );
-        break;
-    }
-
-    primitiveData.trianglesGroups_.back().nTriangles++;
-}
-
-
-void OBJPrimitivesImporter::processQuadFaceStr( const std::string &lineBody, ImportedPrimitiveData& primitiveData )
-{
-    std::array< GLuint, 4 > vertexQuad = { 0 };
-    std::array< GLuint, 4 > uvQuad = { 0 };
-    std::array< GLuint, 4 > normalQuad = { 0 };
-    int componentsRead;
-    int i;
-
-    switch( getFaceComponents( lineBody ) ){
-        case FaceComponents::ONLY_VERTICES:
-            componentsRead = sscanf( lineBody.c_str(),
-                                     "%u %u %u %u",
-                                     &vertexQuad[0],
-                                     &vertexQuad[1],
-                                     &vertexQuad[2],
-                                     &vertexQuad[3] );
-
-            if( componentsRead != 4 ){
-                throw std::runtime_error( "Error reading mesh quad (Is it a textured mesh?)" );
-            }
-
-            for( i=0; i<4; i++ ){
-                // Decrement every vertex index because they are 1-based in the .obj file.
-                vertexQuad[i] -= 1;
-            }
-            insertQuad( primitiveData.vertexData.vertexTriangles, vertexQuad );
-        break;
-        case FaceComponents::VERTICES_AND_UVS:
-            // Extract the UV coordinates from the line and add it to the Mesh.
-            componentsRead =
-                    sscanf( lineBody.c_str(), "%u/%u %u/%u %u/%u %u/%u",
-                    &vertexQuad[0], &uvQuad[0],
-                    &vertexQuad[1], &uvQuad[1],
-                    &vertexQuad[2], &uvQuad[2],
-                    &vertexQuad[3], &uvQuad[3] );
-
-            if( componentsRead != 8 ){
-                throw std::runtime_error( "ERROR reading OBJ face quad (v/vt)" );
-            }
-
-            for( i=0; i<4; i++ ){
-                // Decrement every vertex index because they are 1-based in the .obj file.
-                vertexQuad[i] -= 1;
-                uvQuad[i] -= 1;
-            }
-            insertQuad( primitiveData.vertexData.vertexTriangles, vertexQuad );
-            insertQuad( primitiveData.uvData.uvTriangles, uvQuad );
-        break;
-        case FaceComponents::VERTICES_NORMALS_AND_UVS:
-            componentsRead =
-                    sscanf( lineBody.c_str(), "%u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u",
-                    &vertexQuad[0], &uvQuad[0], &normalQuad[0],
-                    &vertexQuad[1], &uvQuad[1], &normalQuad[1],
-                    &vertexQuad[2], &uvQuad[2], &normalQuad[2],
-                    &vertexQuad[3], &uvQuad[3], &normalQuad[3] );
-
-            if( componentsRead != 12 ){
-                throw std::runtime_error( "ERROR reading OBJ face quad (v/vt/vn)" );
-            }
-
-            for( i=0; i<4; i++ ){
-                // Decrement every vertex index because they are 1-based in the .obj file.
-                vertexQuad[i] -= 1;
-                uvQuad[i] -= 1;
-                normalQuad[i] -= 1;
-            }
-            insertQuad( primitiveData.vertexData.vertexTriangles, vertexQuad );
-            insertQuad( primitiveData.normalData.normalTriangles, normalQuad );
-            insertQuad( primitiveData.uvData.uvTriangles, uvQuad );
-        break;
-        case FaceComponents::VERTICES_AND_NORMALS:
-            componentsRead =
-                    sscanf( lineBody.c_str(), "%u//%u %u//%u %u//%u %u//%u",
-                    &vertexQuad[0], &normalQuad[0],
-                    &vertexQuad[1], &normalQuad[1],
-                    &vertexQuad[2], &normalQuad[2],
-                    &vertexQuad[3], &normalQuad[3] );
-
-            if( componentsRead != 8 ){
-                throw std::runtime_error( "ERROR reading OBJ face quad (v//vn)" );
-            }
-
-            for( i=0; i<4; i++ ){
-                // Decrement every vertex index because they are 1-based in the .obj file.
-                vertexQuad[i] -= 1;
-                normalQuad[i] -= 1;
-            }
-            insertQuad( primitiveData.vertexData.vertexTriangles, vertexQuad );
-            insertQuad( primitiveData.normalData.normalTriangles, normalQuad );
-        break;
-    }
-
-    primitiveData.trianglesGroups_.back().nTriangles += 2;
-}
-
-
-void OBJPrimitivesImporter::triangulateQuad(const FaceQuad &quad, FaceTriangle &triangle1, FaceTriangle &triangle2 )
-{
-    // First triangle
-    triangle1[0] = quad[0];
-    triangle1[1] = quad[1];
-    triangle1[2] = quad[2];
-
-    // Second triangle
-    triangle2[0] = quad[0];
-    triangle2[1] = quad[2];
-    triangle2[2] = quad[3];
-}
-
-
-void OBJPrimitivesImporter::insertQuad(std::vector<FaceTriangle> &triangles, FaceQuad &quad)
-{
-    FaceTriangle triangle1;
-    FaceTriangle triangle2;
-
-    triangulateQuad( quad, triangle1, triangle2 );
-
-    triangles.push_back( triangle1 );
-    triangles.push_back( triangle2 );
-}
-
-
 void OBJPrimitivesImporter::splitFileLine( const std::string &line, std::string &lineHeader, std::string &lineBody )
 {
     unsigned int i = 0;
@@ -22,13 +22,8 @@
 #include <common/primitives/primitive_data/imported_primitive_data.hpp>
 #include "primitives_importer.hpp"
 #include <map>
-
-enum class FaceType
-{
-    TRIANGLE,
-    QUAD,
-    OTHER
-};
+#include <string>
+#include <vector>
 
 enum class FaceComponents
 {
@@ -38,17 +33,97 @@ enum class FaceComponents
     VERTICES_NORMALS_AND_UVS
 };
 
-typedef std::array< GLuint, 3 > FaceTriangle;
-typedef std::array< GLuint, 4 > FaceQuad;
+// Indices of the vertex, the UV coordinates and the normal of a face corner.
+typedef std::array< GLuint, 3 > FaceCorner;
 
 namespace como {
 
+// Revision of the data generated by the importer (on top of the primitive
+// file version). It is part of the primitives import cache key, so bump it
+// whenever the generated data changes and imports cached from older
+// revisions are regenerated.
+//  1 - Polygons triangulated as fans.
+//  2 - Polygons triangulated by ear clipping.
+//  3 - Vertices welded and triangles reordered for the vertex cache.
+//  4 - LOD chain generated for big meshes.
+const unsigned int OBJ_PRIMITIVES_IMPORTER_REVISION = 4;
+
+
+/*!
+ * \brief OBJ statement which must be processed in file order once every
+ * chunk of the file has been parsed.
+ */
+struct OBJStatement
+{
+    enum class Type
+    {
+        FACES,
+        MTLLIB,
+        USEMTL
+    };
+
+    Type type;
+
+    /*! \brief Triangles defined by a FACES run. */
+    unsigned int nTriangles;
+
+    /*! \brief Whether the last face of a FACES run includes UV coordinates. */
+    bool includesUV;
+
+    /*! \brief Argument of a MTLLIB or USEMTL statement. */
+    std::string argument;
+};
+
+
+/*!
+ * \brief Face with more than three vertices. It is triangulated as a fan
+ * while parsing and retriangulated once every vertex position is known.
+ */
+struct OBJPolygon
+{
+    unsigned int firstCorner;
+    unsigned int nCorners;
+
+    unsigned int firstVertexTriangle;
+    unsigned int firstUVTriangle;
+    unsigned int firstNormalTriangle;
+
+    bool includesUV;
+    bool includesNormals;
+};
+
+
+/*!
+ * \brief Geometry parsed from a contiguous range of lines of an OBJ file.
+ * Indices are already 0-based and global to the file.
+ */
+struct OBJMeshChunk
+{
+    VerticesVector vertices;
+    UVCoordinatesVector uvVertices;
+    NormalsVector normals;
+
+    IndicesTrianglesVector vertexTriangles;
+    UVTrianglesVector uvTriangles;
+    NormalTrianglesVector normalTriangles;
+
+    std::vector< OBJStatement > statements;
+
+    std::vector< OBJPolygon > polygons;
+    std::vector< FaceCorner > polygonsCorners;
+};
+
+
 class OBJPrimitivesImporter : PrimitivesImporter {
     public:
         /***
          * 1. Construction
          ***/
-        OBJPrimitivesImporter() = default;
+        /*!
+         * \brief Constructs an importer which parses big files with up to
+         * maxThreads threads (one per hardware thread if 0).
+         */
+        OBJPrimitivesImporter( unsigned int maxThreads = 0 );
         OBJPrimitivesImporter( OBJPrimitivesImporter& ) = delete;
         OBJPrimitivesImporter( OBJPrimitivesImporter&& ) = delete;
 
@@ -71,7 +146,10 @@ class OBJPrimitivesImporter : PrimitivesImporter {
 
     private:
         virtual void processMeshFile( std::string filePath, PrimitiveInfo& primitiveInfo, ImportedPrimitiveData& primitiveData );
-        void processMeshFileLine( std::string filePath, std::string line, ImportedPrimitiveData& primitiveData );
+        void parseMeshChunk( const char* begin, const char* end, OBJMeshChunk& chunk ) const;
+        void parseFace( const char* it, const char* end, OBJMeshChunk& chunk ) const;
+        void mergeMeshChunks( const std::string& filePath, std::vector< OBJMeshChunk >& chunks, ImportedPrimitiveData& primitiveData );
+        void triangulatePolygons( const std::vector< OBJPolygon >& polygons, const std::vector< FaceCorner >& polygonsCorners, ImportedPrimitiveData& primitiveData );
         void generateMeshVertexData( ImportedPrimitiveData& primitiveData );
         void computeNormalData( const MeshVertexData& vertexData, MeshNormalData& normalData );
 
@@ -93,16 +171,15 @@ class OBJPrimitivesImporter : PrimitivesImporter {
          * 5. Auxiliar methods
          ***/
         void readLine( std::ifstream& file, std::string& fileLine );
-        FaceType getFaceType( const std::string& faceDefinition );
-        FaceComponents getFaceComponents( const std::string& faceDefinition );
-        void processTriangleFaceStr( const std::string& lineBody, ImportedPrimitiveData& primitiveData );
-        void processQuadFaceStr( const std::string& lineBody, ImportedPrimitiveData& primitiveData );
-        void triangulateQuad( const FaceQuad& quad,
-                              FaceTriangle& triangle1,
-                              FaceTriangle& triangle2 );
-        void insertQuad( std::vector< FaceTriangle >& triangles, FaceQuad& quad );
         void splitFileLine( const std::string& line, std::string& lineHeader, std::string& lineBody );
         bool supportedImageFile( const std::string& filePath );
+
+
+        /***
+         * Attributes
+         ***/
+        /*! Maximum number of threads used for parsing a file */
+        const unsigned int maxThreads_;
 };
 
 } // namespace como
@@ -0,0 +1,147 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "polygon_triangulation.hpp"
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace como {
+
+/*!
+ * \brief Compute the (non normalized) normal of a polygon by Newell's
+ * method, which is robust for non planar and concave polygons.
+ */
+static glm::vec3 computePolygonNormal( const std::vector< glm::vec3 >& polygon )
+{
+    glm::vec3 normal( 0.0f );
+
+    for( unsigned int i = 0; i < polygon.size(); i++ ){
+        const glm::vec3& current = polygon[i];
+        const glm::vec3& next = polygon[( i + 1 ) % polygon.size()];
+
+        normal.x += ( current.y - next.y ) * ( current.z + next.z );
+        normal.y += ( current.z - next.z ) * ( current.x + next.x );
+        normal.z += ( current.x - next.x ) * ( current.y + next.y );
+    }
+
+    return normal;
+}
+
+
+/*!
+ * \brief Returns true if the corner (a, b, c) turns the same way as the
+ * polygon whose normal is given.
+ */
+static bool isConvexCorner( const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& normal )
+{
+    return glm::dot( glm::cross( b - a, c - b ), normal ) > 0.0f;
+}
+
+
+static bool isConvexPolygon( const std::vector< glm::vec3 >& polygon, const glm::vec3& normal )
+{
+    const unsigned int nVertices = polygon.size();
+
+    for( unsigned int i = 0; i < nVertices; i++ ){
+        const glm::vec3& previous = polygon[( i + nVertices - 1 ) % nVertices];
+        const glm::vec3& next = polygon[( i + 1 ) % nVertices];
+
+        // Collinear corners don't make the polygon concave.
+        if( glm::dot( glm::cross( polygon[i] - previous, next - polygon[i] ), normal ) < 0.0f ){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static bool isPointInTriangle( const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& normal )
+{
+    return ( glm::dot( glm::cross( b - a, p - a ), normal ) >= 0.0f ) &&
+           ( glm::dot( glm::cross( c - b, p - b ), normal ) >= 0.0f ) &&
+           ( glm::dot( glm::cross( a - c, p - c ), normal ) >= 0.0f );
+}
+
+
+void triangulatePolygon( const std::vector< glm::vec3 >& polygon, std::vector< PolygonTriangle >& triangles )
+{
+    const glm::vec3 normal = computePolygonNormal( polygon );
+
+    triangles.clear();
+    if( polygon.size() < 3 ){
+        return;
+    }
+
+    if( isConvexPolygon( polygon, normal ) ){
+        for( unsigned int i = 1; i + 1 < polygon.size(); i++ ){
+            triangles.push_back( { { 0, i, i + 1 } } );
+        }
+        return;
+    }
+
+    // Ear clipping: repeatedly cut off a convex corner whose triangle
+    // doesn't contain any other remaining vertex.
+    std::vector< unsigned int > remaining( polygon.size() );
+    for( unsigned int i = 0; i < remaining.size(); i++ ){
+        remaining[i] = i;
+    }
+
+    while( remaining.size() > 3 ){
+        const unsigned int nRemaining = remaining.size();
+        unsigned int earIndex = 0;
+        bool earFound = false;
+
+        for( unsigned int i = 0; ( i < nRemaining ) && !earFound; i++ ){
+            const unsigned int previous = remaining[( i + nRemaining - 1 ) % nRemaining];
+            const unsigned int current = remaining[i];
+            const unsigned int next = remaining[( i + 1 ) % nRemaining];
+
+            if( !isConvexCorner( polygon[previous], polygon[current], polygon[next], normal ) ){
+                continue;
+            }
+
+            earFound = true;
+            for( unsigned int vertex : remaining ){
+                if( ( vertex != previous ) && ( vertex != current ) && ( vertex != next ) &&
+                        isPointInTriangle( polygon[vertex], polygon[previous], polygon[current], polygon[next], normal ) ){
+                    earFound = false;
+                    break;
+                }
+            }
+            earIndex = i;
+        }
+
+        // Degenerate (ie. self-intersecting) polygons may have no ears
+        // left. Cut off the first remaining corner so the triangulation
+        // still ends up with polygon.size() - 2 triangles.
+        if( !earFound ){
+            earIndex = 0;
+        }
+
+        triangles.push_back( { { remaining[( earIndex + nRemaining - 1 ) % nRemaining],
+                                 remaining[earIndex],
+                                 remaining[( earIndex + 1 ) % nRemaining] } } );
+        remaining.erase( remaining.begin() + earIndex );
+    }
+
+    triangles.push_back( { { remaining[0], remaining[1], remaining[2] } } );
+}
+
+} // namespace como
@@ -0,0 +1,43 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef POLYGON_TRIANGULATION_HPP
+#define POLYGON_TRIANGULATION_HPP
+
+#include <glm/vec3.hpp>
+#include <array>
+#include <vector>
+
+namespace como {
+
+/*! \brief Triangle given as indices into the vertices of a polygon. */
+typedef std::array< unsigned int, 3 > PolygonTriangle;
+
+/*!
+ * \brief Triangulate a simple polygon (convex or concave) in 3D space.
+ * Convex polygons are triangulated as a fan around their first vertex, and
+ * concave ones by ear clipping.
+ * \param polygon vertices of the polygon, in winding order.
+ * \param triangles vector the (polygon.size() - 2) resulting triangles are
+ * written to. Triangles keep the winding of the polygon.
+ */
+void triangulatePolygon( const std::vector< glm::vec3 >& polygon, std::vector< PolygonTriangle >& triangles );
+
+} // namespace como
+
+#endif // POLYGON_TRIANGULATION_HPP
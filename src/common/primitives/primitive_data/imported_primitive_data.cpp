@@ -57,10 +57,25 @@ void ImportedPrimitiveData::read( std::ifstream &file )
 }
 
 
-void ImportedPrimitiveData::write( std::ofstream &file ) const
+void ImportedPrimitiveData::readSections( const PrimitiveFileReader& reader )
 {
-    PrimitiveData::write( file );
-    writeTrianglesGroups( file );
+    PrimitiveData::readSections( reader );
+    readTrianglesGroups( reader );
+
+    // Every level of detail is drawn with the same triangles groups as the
+    // full resolution mesh.
+    for( const MeshLODLevel& lodLevel : oglData.lodLevels ){
+        if( lodLevel.trianglesGroupsSizes.size() != trianglesGroups_.size() ){
+            throw std::runtime_error( "Primitive file - level of detail with a wrong number of triangles groups" );
+        }
+    }
+}
+
+
+void ImportedPrimitiveData::writeSections( PrimitiveFileWriter& writer ) const
+{
+    PrimitiveData::writeSections( writer );
+    writeTrianglesGroups( writer );
 }
 
 
@@ -93,22 +108,42 @@ void ImportedPrimitiveData::readTrianglesGroups( std::ifstream& file )
 }
 
 
+void ImportedPrimitiveData::readTrianglesGroups( const PrimitiveFileReader& reader )
+{
+    std::vector< PrimitiveFileTrianglesGroup > trianglesGroups;
+
+    reader.readArraySection( PrimitiveFileSection::TRIANGLES_GROUPS, trianglesGroups );
+
+    trianglesGroups_.resize( trianglesGroups.size() );
+    for( unsigned int i = 0; i < trianglesGroups.size(); i++ ){
+        trianglesGroups_[i].firstTriangleIndex = trianglesGroups[i].firstTriangleIndex;
+        trianglesGroups_[i].nTriangles = trianglesGroups[i].nTriangles;
+        trianglesGroups_[i].includesUV = ( trianglesGroups[i].includesUV != 0 );
+        trianglesGroups_[i].materialIndex = trianglesGroups[i].materialIndex;
+    }
+}
+
+
 /***
  * 5. File writting (auxiliar methods)
  ***/
 
-void ImportedPrimitiveData::writeTrianglesGroups( std::ofstream &file ) const
+void ImportedPrimitiveData::writeTrianglesGroups( PrimitiveFileWriter& writer ) const
 {
-    // Write the number of polygons groups.
-    file << trianglesGroups_.size() << std::endl;
+    std::vector< PrimitiveFileTrianglesGroup > trianglesGroups;
 
-    // Write all the polygons groups (one per line).
     for( const auto& trianglesGroup : trianglesGroups_ ){
-        file << trianglesGroup.firstTriangleIndex << " "
-             << trianglesGroup.nTriangles << " "
-             << trianglesGroup.includesUV << " "
-             << trianglesGroup.materialIndex << std::endl;
+        PrimitiveFileTrianglesGroup fileTrianglesGroup;
+
+        fileTrianglesGroup.firstTriangleIndex = trianglesGroup.firstTriangleIndex;
+        fileTrianglesGroup.nTriangles = trianglesGroup.nTriangles;
+        fileTrianglesGroup.includesUV = trianglesGroup.includesUV ? 1 : 0;
+        fileTrianglesGroup.materialIndex = trianglesGroup.materialIndex;
+
+        trianglesGroups.push_back( fileTrianglesGroup );
     }
+
+    writer.addArraySection( PrimitiveFileSection::TRIANGLES_GROUPS, trianglesGroups );
 }
 
 } // namespace como
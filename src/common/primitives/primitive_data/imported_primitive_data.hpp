@@ -50,19 +50,21 @@ struct ImportedPrimitiveData : public PrimitiveData
          * 3. File reading / writing
          ***/
         virtual void read( std::ifstream &file );
-        virtual void write( std::ofstream &file ) const;
+        virtual void readSections( const PrimitiveFileReader& reader );
+        virtual void writeSections( PrimitiveFileWriter& writer ) const;
 
     private:
         /***
          * 4. File reading (auxiliar methods)
          ***/
         void readTrianglesGroups( std::ifstream& file );
+        void readTrianglesGroups( const PrimitiveFileReader& reader );
 
 
         /***
          * 5. File writting (auxiliar methods)
          ***/
-        void writeTrianglesGroups( std::ofstream& file ) const;
+        void writeTrianglesGroups( PrimitiveFileWriter& writer ) const;
 };
 
 } // namespace como
@@ -84,50 +84,6 @@ void MaterialInfo::readFromFile( std::ifstream &file )
 }
 
 
-/***
- * 3. File writting
- ***/
-
-void MaterialInfo::writeToFile( std::ofstream &file ) const
-{
-    file << name << std::endl;
-
-    file << ambientReflectivity[0] << " "
-         << ambientReflectivity[1] << " "
-         << ambientReflectivity[2] << std::endl;
-
-    file << diffuseReflectivity[0] << " "
-         << diffuseReflectivity[1] << " "
-         << diffuseReflectivity[2] << std::endl;
-
-    file << specularReflectivity[0] << " "
-         << specularReflectivity[1] << " "
-         << specularReflectivity[2] << std::endl;
-
-    file << specularExponent << std::endl;
-
-    // If current material includes a texture, we write the following data to
-    // file:
-    // - A line "1" indicating that the current material includes a texture.
-    // - A line "<n>" where n is the size (in bytes) of the texture image file
-    // data.
-    // - <n> bytes of the texture image file.
-    if( textureInfo ){
-        file << "1" << std::endl
-             << textureInfo->imageFileData.size() << std::endl;
-
-        // Write texture data.
-        file.write( &( textureInfo->imageFileData[0] ),
-                textureInfo->imageFileData.size() );
-
-        // Add a new line right after texture data.
-        file << std::endl;
-    }else{
-        file << "0" << std::endl;
-    }
-}
-
-
 /***
  * 5. Auxiliar methods
  ***/
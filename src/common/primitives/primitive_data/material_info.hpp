@@ -56,13 +56,9 @@ struct MaterialInfo : public PlainMaterialData
     /***
      * 3. File reading
      ***/
-    void readFromFile( std::ifstream& file );
-
 
-    /***
-     * 4. File writting
-     ***/
-    void writeToFile( std::ofstream& file ) const;
+    /*! \brief Reads the material from a primitive file in the old text format. */
+    void readFromFile( std::ifstream& file );
 
 
     /***
@@ -0,0 +1,567 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "mesh_bvh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined( __SSE__ ) || defined( _M_X64 )
+#define MESH_BVH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace como {
+
+// Number of triangles per packet.
+const unsigned int PACKET_SIZE = 4;
+
+// Nodes with more triangles than these are always split.
+const unsigned int MAX_LEAF_TRIANGLES = 2 * PACKET_SIZE;
+
+// Number of bins the SAH split candidates are evaluated on.
+const unsigned int SAH_N_BINS = 16;
+
+// Nodes with more triangles than these are binned from a subsample of
+// their triangles.
+const unsigned int SAH_MAX_BINNED_TRIANGLES = 8192;
+
+// Below this depth nodes are split at their median instead, so the depth
+// of the tree is bounded even for degenerate meshes.
+const unsigned int SAH_MAX_DEPTH = 48;
+
+// Upper bound for the depth of the tree (SAH_MAX_DEPTH plus the median
+// splits needed for 2^32 triangles).
+const unsigned int MAX_BVH_DEPTH = SAH_MAX_DEPTH + 32;
+
+// SAH costs of traversing a node and intersecting a triangles packet.
+const float NODE_TRAVERSAL_COST = 1.0f;
+const float PACKET_INTERSECTION_COST = 1.0f;
+
+// Factor the ray's exit distance from a box is scaled by, so rounding
+// errors in the slab test never cull a triangle on the box's boundary.
+const float BOX_EXIT_ROUNDING_FACTOR = 1.0f + 4.0f * std::numeric_limits< float >::epsilon();
+
+const GLuint NO_TRIANGLE = std::numeric_limits< GLuint >::max();
+const std::uint32_t NO_NODE = std::numeric_limits< std::uint32_t >::max();
+
+
+/*!
+ * \brief Axis aligned bounding box used while building the tree.
+ */
+struct BVHBounds {
+    float min[3];
+    float max[3];
+
+    BVHBounds()
+    {
+        for( unsigned int i = 0; i < 3; i++ ){
+            min[i] = std::numeric_limits< float >::max();
+            max[i] = -std::numeric_limits< float >::max();
+        }
+    }
+
+    void grow( const float* point )
+    {
+        for( unsigned int i = 0; i < 3; i++ ){
+            min[i] = std::min( min[i], point[i] );
+            max[i] = std::max( max[i], point[i] );
+        }
+    }
+
+    void grow( const BVHBounds& bounds )
+    {
+        for( unsigned int i = 0; i < 3; i++ ){
+            min[i] = std::min( min[i], bounds.min[i] );
+            max[i] = std::max( max[i], bounds.max[i] );
+        }
+    }
+
+    float surfaceArea() const
+    {
+        if( min[0] > max[0] ){
+            return 0.0f;
+        }
+        const float dx = max[0] - min[0];
+        const float dy = max[1] - min[1];
+        const float dz = max[2] - min[2];
+        return 2.0f * ( dx * dy + dy * dz + dz * dx );
+    }
+};
+
+
+/*!
+ * \brief Triangle being inserted in the tree. Build triangles are
+ * partitioned in place, so every node's ones are contiguous in memory.
+ */
+struct BVHBuildTriangle {
+    BVHBounds bounds;
+    float centroid[3];
+    GLuint index;
+};
+
+
+/*!
+ * \brief Pending node of the tree being built.
+ */
+struct BVHBuildTask {
+    unsigned int begin;
+    unsigned int end;
+    unsigned int depth;
+
+    // Bounds of the triangles and of their centroids.
+    BVHBounds bounds;
+    BVHBounds centroidsBounds;
+
+    // Node whose second child is the one built by this task, if any.
+    std::uint32_t parent;
+};
+
+
+static inline unsigned int packetsCount( unsigned int nTriangles )
+{
+    return ( nTriangles + PACKET_SIZE - 1 ) / PACKET_SIZE;
+}
+
+
+static void computeBounds( const std::vector< BVHBuildTriangle >& buildTriangles, unsigned int begin, unsigned int end, BVHBounds& bounds, BVHBounds& centroidsBounds )
+{
+    for( unsigned int i = begin; i < end; i++ ){
+        bounds.grow( buildTriangles[i].bounds );
+        centroidsBounds.grow( buildTriangles[i].centroid );
+    }
+}
+
+
+/***
+ * 1. Construction
+ ***/
+
+MeshBVH::MeshBVH( const MeshVertexData& vertexData )
+{
+    build( vertexData );
+}
+
+
+void MeshBVH::build( const MeshVertexData& vertexData )
+{
+    const VerticesVector& vertices = vertexData.vertices;
+    const IndicesTrianglesVector& triangles = vertexData.vertexTriangles;
+    std::vector< BVHBuildTriangle > buildTriangles( triangles.size() );
+    std::vector< BVHBuildTask > tasks;
+
+    nodes_.clear();
+    packets_.clear();
+    if( triangles.empty() ){
+        return;
+    }
+
+    for( unsigned int i = 0; i < triangles.size(); i++ ){
+        for( unsigned int j = 0; j < 3; j++ ){
+            if( triangles[i][j] >= vertices.size() ){
+                throw std::out_of_range( "MeshBVH - triangle vertex index out of range" );
+            }
+            buildTriangles[i].bounds.grow( &( vertices[triangles[i][j]][0] ) );
+        }
+        for( unsigned int axis = 0; axis < 3; axis++ ){
+            buildTriangles[i].centroid[axis] = 0.5f * ( buildTriangles[i].bounds.min[axis] + buildTriangles[i].bounds.max[axis] );
+        }
+        buildTriangles[i].index = i;
+    }
+
+    // A binary tree with N leaves has 2N-1 nodes.
+    nodes_.reserve( 2 * packetsCount( triangles.size() ) );
+    packets_.reserve( packetsCount( triangles.size() ) * 5 / 4 );
+
+    tasks.push_back( BVHBuildTask() );
+    tasks.back().begin = 0;
+    tasks.back().end = triangles.size();
+    tasks.back().depth = 0;
+    tasks.back().parent = NO_NODE;
+    computeBounds( buildTriangles, 0, triangles.size(), tasks.back().bounds, tasks.back().centroidsBounds );
+
+    while( !tasks.empty() ){
+        const BVHBuildTask task = tasks.back();
+        const BVHBounds& bounds = task.bounds;
+        const BVHBounds& centroidsBounds = task.centroidsBounds;
+        const unsigned int nTriangles = task.end - task.begin;
+        const std::uint32_t nodeIndex = nodes_.size();
+        BVHBuildTask children[2];
+        unsigned int splitAxis = 0;
+        unsigned int splitPosition = task.begin;
+        tasks.pop_back();
+
+        if( task.parent != NO_NODE ){
+            nodes_[task.parent].offset = nodeIndex;
+        }
+
+        if( nTriangles > PACKET_SIZE && task.depth < SAH_MAX_DEPTH ){
+            // Evaluate the SAH on binned split planes along every axis.
+            const float leafCost = packetsCount( nTriangles ) * PACKET_INTERSECTION_COST;
+            const float invSurfaceArea = 1.0f / std::max( bounds.surfaceArea(), std::numeric_limits< float >::min() );
+            const unsigned int binningStride = std::max( 1u, nTriangles / SAH_MAX_BINNED_TRIANGLES );
+            const unsigned int nBins = std::min( SAH_N_BINS, nTriangles );
+            float binScales[3];
+            BVHBounds binsBounds[3][SAH_N_BINS];
+            unsigned int binsSizes[3][SAH_N_BINS] = {};
+            float bestCost = std::numeric_limits< float >::max();
+            unsigned int bestBin = 0;
+
+            for( unsigned int axis = 0; axis < 3; axis++ ){
+                const float extent = centroidsBounds.max[axis] - centroidsBounds.min[axis];
+                binScales[axis] = ( extent > 0.0f ) ? ( nBins / extent ) : 0.0f;
+            }
+
+            for( unsigned int i = task.begin; i < task.end; i += binningStride ){
+                const BVHBuildTriangle& triangle = buildTriangles[i];
+                for( unsigned int axis = 0; axis < 3; axis++ ){
+                    const unsigned int bin = std::min( nBins - 1,
+                                                       static_cast< unsigned int >( ( triangle.centroid[axis] - centroidsBounds.min[axis] ) * binScales[axis] ) );
+                    binsBounds[axis][bin].grow( triangle.bounds );
+                    binsSizes[axis][bin]++;
+                }
+            }
+
+            for( unsigned int axis = 0; axis < 3; axis++ ){
+                float rightSurfaceAreas[SAH_N_BINS];
+                unsigned int rightSizes[SAH_N_BINS];
+                BVHBounds accumulatedBounds;
+                unsigned int accumulatedSize = 0;
+
+                if( binScales[axis] == 0.0f ){
+                    continue;
+                }
+
+                for( unsigned int bin = nBins - 1; bin > 0; bin-- ){
+                    accumulatedBounds.grow( binsBounds[axis][bin] );
+                    accumulatedSize += binsSizes[axis][bin];
+                    rightSurfaceAreas[bin] = accumulatedBounds.surfaceArea();
+                    rightSizes[bin] = accumulatedSize;
+                }
+
+                // Split between bins bin-1 and bin.
+                accumulatedBounds = BVHBounds();
+                accumulatedSize = 0;
+                for( unsigned int bin = 1; bin < nBins; bin++ ){
+                    accumulatedBounds.grow( binsBounds[axis][bin - 1] );
+                    accumulatedSize += binsSizes[axis][bin - 1];
+                    if( !accumulatedSize || !rightSizes[bin] ){
+                        continue;
+                    }
+
+                    const float cost =
+                            NODE_TRAVERSAL_COST +
+                            PACKET_INTERSECTION_COST * invSurfaceArea *
+                            ( accumulatedBounds.surfaceArea() * packetsCount( accumulatedSize * binningStride ) +
+                              rightSurfaceAreas[bin] * packetsCount( rightSizes[bin] * binningStride ) );
+                    if( cost < bestCost ){
+                        bestCost = cost;
+                        splitAxis = axis;
+                        bestBin = bin;
+                    }
+                }
+            }
+
+            if( bestCost < std::numeric_limits< float >::max() &&
+                ( nTriangles > MAX_LEAF_TRIANGLES || bestCost < leafCost ) ){
+                const unsigned int axis = splitAxis;
+                unsigned int right = task.end;
+
+                // Partition the triangles, computing the children bounds.
+                splitPosition = task.begin;
+                while( splitPosition < right ){
+                    const BVHBuildTriangle& triangle = buildTriangles[splitPosition];
+                    const unsigned int bin = std::min( nBins - 1,
+                                                       static_cast< unsigned int >( ( triangle.centroid[axis] - centroidsBounds.min[axis] ) * binScales[axis] ) );
+                    if( bin < bestBin ){
+                        children[0].bounds.grow( triangle.bounds );
+                        children[0].centroidsBounds.grow( triangle.centroid );
+                        splitPosition++;
+                    }else{
+                        right--;
+                        std::swap( buildTriangles[splitPosition], buildTriangles[right] );
+                        children[1].bounds.grow( buildTriangles[right].bounds );
+                        children[1].centroidsBounds.grow( buildTriangles[right].centroid );
+                    }
+                }
+            }
+        }
+
+        if( nTriangles > MAX_LEAF_TRIANGLES &&
+            ( splitPosition == task.begin || splitPosition == task.end ) ){
+            // No SAH split found (or the tree is too deep): split at the
+            // median along the widest axis.
+            float maxExtent = -1.0f;
+            for( unsigned int axis = 0; axis < 3; axis++ ){
+                if( centroidsBounds.max[axis] - centroidsBounds.min[axis] > maxExtent ){
+                    maxExtent = centroidsBounds.max[axis] - centroidsBounds.min[axis];
+                    splitAxis = axis;
+                }
+            }
+            const unsigned int axis = splitAxis;
+
+            splitPosition = task.begin + nTriangles / 2;
+            std::nth_element( buildTriangles.begin() + task.begin,
+                              buildTriangles.begin() + splitPosition,
+                              buildTriangles.begin() + task.end,
+                              [&]( const BVHBuildTriangle& a, const BVHBuildTriangle& b ){
+                                  return a.centroid[axis] < b.centroid[axis];
+                              } );
+            children[0] = children[1] = BVHBuildTask();
+            computeBounds( buildTriangles, task.begin, splitPosition, children[0].bounds, children[0].centroidsBounds );
+            computeBounds( buildTriangles, splitPosition, task.end, children[1].bounds, children[1].centroidsBounds );
+        }
+
+        nodes_.push_back( Node() );
+        Node& node = nodes_.back();
+        std::copy( bounds.min, bounds.min + 3, node.boundsMin );
+        std::copy( bounds.max, bounds.max + 3, node.boundsMax );
+        node.splitAxis = splitAxis;
+
+        if( splitPosition == task.begin || splitPosition == task.end ){
+            // Leaf node: pack its triangles.
+            node.offset = packets_.size();
+            node.nPackets = packetsCount( nTriangles );
+
+            for( unsigned int i = task.begin; i < task.end; i += PACKET_SIZE ){
+                TrianglesPacket packet;
+
+                for( unsigned int lane = 0; lane < PACKET_SIZE; lane++ ){
+                    GLuint triangle = NO_TRIANGLE;
+                    glm::vec3 v0( 0.0f ), edge1( 0.0f ), edge2( 0.0f );
+
+                    if( i + lane < task.end ){
+                        triangle = buildTriangles[i + lane].index;
+                        v0 = vertices[triangles[triangle][0]];
+                        edge1 = vertices[triangles[triangle][1]] - v0;
+                        edge2 = vertices[triangles[triangle][2]] - v0;
+                    }
+                    for( unsigned int axis = 0; axis < 3; axis++ ){
+                        packet.v0[axis][lane] = v0[axis];
+                        packet.edge1[axis][lane] = edge1[axis];
+                        packet.edge2[axis][lane] = edge2[axis];
+                    }
+                    packet.triangles[lane] = triangle;
+                }
+                packets_.push_back( packet );
+            }
+        }else{
+            // Inner node: its first child is built next, right after it.
+            node.nPackets = 0;
+            node.offset = NO_NODE;
+            children[0].begin = task.begin;
+            children[0].end = splitPosition;
+            children[0].parent = NO_NODE;
+            children[1].begin = splitPosition;
+            children[1].end = task.end;
+            children[1].parent = nodeIndex;
+            children[0].depth = children[1].depth = task.depth + 1;
+            tasks.push_back( children[1] );
+            tasks.push_back( children[0] );
+        }
+    }
+
+    nodes_.shrink_to_fit();
+    packets_.shrink_to_fit();
+}
+
+
+/***
+ * 3. Intersections
+ ***/
+
+bool MeshBVH::intersects( const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t, GLuint& triangle ) const
+{
+    std::uint32_t nodesStack[MAX_BVH_DEPTH + 1];
+    unsigned int stackSize = 0;
+    float invDirection[3];
+    bool directionIsNegative[3];
+
+    t = std::numeric_limits< float >::max();
+    triangle = NO_TRIANGLE;
+    if( nodes_.empty() ){
+        return false;
+    }
+
+    for( unsigned int axis = 0; axis < 3; axis++ ){
+        invDirection[axis] = 1.0f / rayDirection[axis];
+        directionIsNegative[axis] = ( invDirection[axis] < 0.0f );
+    }
+
+    nodesStack[stackSize++] = 0;
+    while( stackSize ){
+        const std::uint32_t nodeIndex = nodesStack[--stackSize];
+        const Node& node = nodes_[nodeIndex];
+
+        // Slab test. A NaN (ray parallel to and lying on a slab's plane)
+        // is ignored by std::max / std::min as used here.
+        float tEntry = 0.0f;
+        float tExit = t;
+        for( unsigned int axis = 0; axis < 3; axis++ ){
+            float tNear = ( node.boundsMin[axis] - rayOrigin[axis] ) * invDirection[axis];
+            float tFar = ( node.boundsMax[axis] - rayOrigin[axis] ) * invDirection[axis];
+            if( directionIsNegative[axis] ){
+                std::swap( tNear, tFar );
+            }
+            tEntry = std::max( tEntry, tNear );
+            tExit = std::min( tExit, tFar * BOX_EXIT_ROUNDING_FACTOR );
+        }
+        if( tEntry > tExit ){
+            continue;
+        }
+
+        if( node.nPackets ){
+            for( unsigned int i = 0; i < node.nPackets; i++ ){
+                intersects( packets_[node.offset + i], rayOrigin, rayDirection, t, triangle );
+            }
+        }else{
+            // Visit the nearest child first.
+            if( directionIsNegative[node.splitAxis] ){
+                nodesStack[stackSize++] = nodeIndex + 1;
+                nodesStack[stackSize++] = node.offset;
+            }else{
+                nodesStack[stackSize++] = node.offset;
+                nodesStack[stackSize++] = nodeIndex + 1;
+            }
+        }
+    }
+
+    return triangle != NO_TRIANGLE;
+}
+
+
+/***
+ * 4. Getters
+ ***/
+
+unsigned int MeshBVH::nNodes() const
+{
+    return nodes_.size();
+}
+
+
+unsigned int MeshBVH::nTrianglesPackets() const
+{
+    return packets_.size();
+}
+
+
+std::size_t MeshBVH::memorySize() const
+{
+    return nodes_.capacity() * sizeof( Node ) +
+            packets_.capacity() * sizeof( TrianglesPacket );
+}
+
+
+/***
+ * 6. Intersections (private)
+ ***/
+
+void MeshBVH::intersects( const TrianglesPacket& packet, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t, GLuint& triangle )
+{
+    // Moller-Trumbore test on the four triangles of the packet, with the
+    // same operations glm::intersectRayTriangle performs, so both give
+    // the same results.
+    float packetT[PACKET_SIZE];
+    unsigned int hitsMask = 0;
+
+#ifdef MESH_BVH_SSE
+    const __m128 dx = _mm_set1_ps( rayDirection[0] );
+    const __m128 dy = _mm_set1_ps( rayDirection[1] );
+    const __m128 dz = _mm_set1_ps( rayDirection[2] );
+    const __m128 e1x = _mm_loadu_ps( packet.edge1[0] );
+    const __m128 e1y = _mm_loadu_ps( packet.edge1[1] );
+    const __m128 e1z = _mm_loadu_ps( packet.edge1[2] );
+    const __m128 e2x = _mm_loadu_ps( packet.edge2[0] );
+    const __m128 e2y = _mm_loadu_ps( packet.edge2[1] );
+    const __m128 e2z = _mm_loadu_ps( packet.edge2[2] );
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps( 1.0f );
+
+    // p = cross( direction, edge2 ), a = dot( edge1, p ).
+    const __m128 px = _mm_sub_ps( _mm_mul_ps( dy, e2z ), _mm_mul_ps( dz, e2y ) );
+    const __m128 py = _mm_sub_ps( _mm_mul_ps( dz, e2x ), _mm_mul_ps( dx, e2z ) );
+    const __m128 pz = _mm_sub_ps( _mm_mul_ps( dx, e2y ), _mm_mul_ps( dy, e2x ) );
+    const __m128 a = _mm_add_ps( _mm_add_ps( _mm_mul_ps( e1x, px ), _mm_mul_ps( e1y, py ) ), _mm_mul_ps( e1z, pz ) );
+    __m128 mask = _mm_cmpge_ps( a, _mm_set1_ps( std::numeric_limits< float >::epsilon() ) );
+    if( !_mm_movemask_ps( mask ) ){
+        return;
+    }
+    const __m128 f = _mm_div_ps( one, a );
+
+    // s = origin - v0, u = f * dot( s, p ).
+    const __m128 sx = _mm_sub_ps( _mm_set1_ps( rayOrigin[0] ), _mm_loadu_ps( packet.v0[0] ) );
+    const __m128 sy = _mm_sub_ps( _mm_set1_ps( rayOrigin[1] ), _mm_loadu_ps( packet.v0[1] ) );
+    const __m128 sz = _mm_sub_ps( _mm_set1_ps( rayOrigin[2] ), _mm_loadu_ps( packet.v0[2] ) );
+    const __m128 u = _mm_mul_ps( f, _mm_add_ps( _mm_add_ps( _mm_mul_ps( sx, px ), _mm_mul_ps( sy, py ) ), _mm_mul_ps( sz, pz ) ) );
+    mask = _mm_and_ps( mask, _mm_and_ps( _mm_cmpge_ps( u, zero ), _mm_cmple_ps( u, one ) ) );
+
+    // q = cross( s, edge1 ), v = f * dot( direction, q ).
+    const __m128 qx = _mm_sub_ps( _mm_mul_ps( sy, e1z ), _mm_mul_ps( sz, e1y ) );
+    const __m128 qy = _mm_sub_ps( _mm_mul_ps( sz, e1x ), _mm_mul_ps( sx, e1z ) );
+    const __m128 qz = _mm_sub_ps( _mm_mul_ps( sx, e1y ), _mm_mul_ps( sy, e1x ) );
+    const __m128 v = _mm_mul_ps( f, _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, qx ), _mm_mul_ps( dy, qy ) ), _mm_mul_ps( dz, qz ) ) );
+    mask = _mm_and_ps( mask, _mm_and_ps( _mm_cmpge_ps( v, zero ), _mm_cmple_ps( _mm_add_ps( v, u ), one ) ) );
+
+    // Ray parameter: f * dot( edge2, q ).
+    const __m128 packetTs = _mm_mul_ps( f, _mm_add_ps( _mm_add_ps( _mm_mul_ps( e2x, qx ), _mm_mul_ps( e2y, qy ) ), _mm_mul_ps( e2z, qz ) ) );
+    mask = _mm_and_ps( mask, _mm_and_ps( _mm_cmpge_ps( packetTs, zero ), _mm_cmple_ps( packetTs, _mm_set1_ps( t ) ) ) );
+
+    hitsMask = _mm_movemask_ps( mask );
+    if( !hitsMask ){
+        return;
+    }
+    _mm_storeu_ps( packetT, packetTs );
+#else
+    for( unsigned int lane = 0; lane < PACKET_SIZE; lane++ ){
+        const glm::vec3 edge1( packet.edge1[0][lane], packet.edge1[1][lane], packet.edge1[2][lane] );
+        const glm::vec3 edge2( packet.edge2[0][lane], packet.edge2[1][lane], packet.edge2[2][lane] );
+        const glm::vec3 s = rayOrigin - glm::vec3( packet.v0[0][lane], packet.v0[1][lane], packet.v0[2][lane] );
+        const glm::vec3 p = glm::cross( rayDirection, edge2 );
+        const float a = glm::dot( edge1, p );
+        if( a < std::numeric_limits< float >::epsilon() ){
+            continue;
+        }
+        const float f = 1.0f / a;
+        const float u = f * glm::dot( s, p );
+        if( u < 0.0f || u > 1.0f ){
+            continue;
+        }
+        const glm::vec3 q = glm::cross( s, edge1 );
+        const float v = f * glm::dot( rayDirection, q );
+        if( v < 0.0f || v + u > 1.0f ){
+            continue;
+        }
+        packetT[lane] = f * glm::dot( edge2, q );
+        if( packetT[lane] >= 0.0f && packetT[lane] <= t ){
+            hitsMask |= ( 1 << lane );
+        }
+    }
+#endif
+
+    for( unsigned int lane = 0; lane < PACKET_SIZE; lane++ ){
+        if( ( hitsMask & ( 1 << lane ) ) &&
+            ( packetT[lane] < t || ( packetT[lane] == t && packet.triangles[lane] < triangle ) ) ){
+            t = packetT[lane];
+            triangle = packet.triangles[lane];
+        }
+    }
+}
+
+} // namespace como
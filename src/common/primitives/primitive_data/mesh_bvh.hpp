@@ -0,0 +1,135 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef MESH_BVH_HPP
+#define MESH_BVH_HPP
+
+#include "mesh_vertex_data.hpp"
+#include <cstdint>
+#include <cstddef>
+
+namespace como {
+
+/*!
+ * \class MeshBVH
+ *
+ * \brief Bounding volume hierarchy over the triangles of a mesh, used for
+ * ray picking. It is built with the surface area heuristic (SAH) and stored
+ * as a flat array of nodes in depth-first order. Leaf triangles are stored
+ * in packets of four, so a ray is tested against four triangles at once.
+ */
+class MeshBVH
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        MeshBVH( const MeshVertexData& vertexData );
+        MeshBVH() = delete;
+        MeshBVH( const MeshBVH& ) = default;
+        MeshBVH( MeshBVH&& ) = default;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~MeshBVH() = default;
+
+
+        /***
+         * 3. Intersections
+         ***/
+        /*!
+         * \brief Intersects the given ray with the mesh. Triangles are
+         * intersected as glm::intersectRayTriangle does: only from their
+         * front side and for t >= 0.
+         * \param rayOrigin origin of the ray, in object coordinates.
+         * \param rayDirection direction of the ray, in object coordinates.
+         * \param t ray parameter of the closest intersection, if any.
+         * \param triangle index of the closest intersected triangle in the
+         * mesh vertex data. Ties are resolved in favour of the lowest index.
+         * \return true if the ray intersects any triangle.
+         */
+        bool intersects( const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t, GLuint& triangle ) const;
+
+
+        /***
+         * 4. Getters
+         ***/
+        unsigned int nNodes() const;
+        unsigned int nTrianglesPackets() const;
+
+        /*! \brief Memory taken by the hierarchy (in bytes). */
+        std::size_t memorySize() const;
+
+
+        /***
+         * 5. Operators
+         ***/
+        MeshBVH& operator = ( const MeshBVH& ) = default;
+        MeshBVH& operator = ( MeshBVH&& ) = default;
+
+
+    private:
+        /*!
+         * \brief Node of the hierarchy. The first child of an inner node
+         * follows it in the nodes array.
+         */
+        struct Node {
+            float boundsMin[3];
+
+            // Leaf nodes: first triangles packet. Inner nodes: index of
+            // the second child.
+            std::uint32_t offset;
+
+            float boundsMax[3];
+
+            // Number of triangles packets (0 for inner nodes).
+            std::uint16_t nPackets;
+
+            // Axis inner nodes are split along.
+            std::uint16_t splitAxis;
+        };
+
+        /*!
+         * \brief Four triangles in structure of arrays layout. Unused lanes
+         * hold degenerate triangles, which are never intersected.
+         */
+        struct TrianglesPacket {
+            float v0[3][4];
+            float edge1[3][4];
+            float edge2[3][4];
+            GLuint triangles[4];
+        };
+
+        void build( const MeshVertexData& vertexData );
+
+
+        /***
+         * 6. Intersections (private)
+         ***/
+        static void intersects( const TrianglesPacket& packet, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float& t, GLuint& triangle );
+
+
+        std::vector< Node > nodes_;
+        std::vector< TrianglesPacket > packets_;
+};
+
+} // namespace como
+
+#endif // MESH_BVH_HPP
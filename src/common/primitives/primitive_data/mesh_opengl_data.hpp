@@ -31,12 +31,27 @@ typedef std::vector< GLfloat > GLFloatBuffer;
 typedef std::vector< GLuint > GLUintBuffer;
 
 
+/*!
+ * \brief Simplified version of a mesh, drawn with the mesh's vertices.
+ */
+struct MeshLODLevel {
+    /*! \brief Triangles of this level, grouped as the mesh's ones. */
+    GLUintBuffer eboData;
+
+    /*! \brief Number of triangles of every triangles group. */
+    std::vector< GLuint > trianglesGroupsSizes;
+};
+
+
 struct MeshOpenGLData {
     bool includesUV;
 
     GLFloatBuffer vboData;
     GLUintBuffer eboData;
 
+    /*! \brief Levels of detail, from the finest to the coarsest one. */
+    std::vector< MeshLODLevel > lodLevels;
+
 
     /***
      * 1. Construction
@@ -0,0 +1,362 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "mesh_simplification.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace como {
+
+// Maximum number of collapse passes performed by simplifyMesh.
+const unsigned int MAX_SIMPLIFICATION_PASSES = 64;
+
+// Fraction by which the simplified mesh may exceed the target number of
+// triangles. The last passes collapse few edges each, so they aren't worth
+// running.
+const float SIMPLIFICATION_TOLERANCE = 0.02f;
+
+
+/*!
+ * \brief Symmetric 4x4 quadric, stored as the 3x3 matrix A (upper half),
+ * the vector b and the scalar c of error(p) = p'Ap + 2b'p + c.
+ */
+struct Quadric
+{
+    float a00, a01, a02, a11, a12, a22;
+    float b0, b1, b2;
+    float c;
+};
+
+
+static void addPlaneQuadric( Quadric& q, const glm::vec3& normal, float d, float weight )
+{
+    q.a00 += weight * normal.x * normal.x;
+    q.a01 += weight * normal.x * normal.y;
+    q.a02 += weight * normal.x * normal.z;
+    q.a11 += weight * normal.y * normal.y;
+    q.a12 += weight * normal.y * normal.z;
+    q.a22 += weight * normal.z * normal.z;
+    q.b0 += weight * normal.x * d;
+    q.b1 += weight * normal.y * d;
+    q.b2 += weight * normal.z * d;
+    q.c += weight * d * d;
+}
+
+
+static void addQuadric( Quadric& q, const Quadric& r )
+{
+    q.a00 += r.a00; q.a01 += r.a01; q.a02 += r.a02;
+    q.a11 += r.a11; q.a12 += r.a12; q.a22 += r.a22;
+    q.b0 += r.b0; q.b1 += r.b1; q.b2 += r.b2;
+    q.c += r.c;
+}
+
+
+static float quadricError( const Quadric& q, const glm::vec3& p )
+{
+    const float error =
+            q.a00 * p.x * p.x + 2.0f * q.a01 * p.x * p.y + 2.0f * q.a02 * p.x * p.z +
+            q.a11 * p.y * p.y + 2.0f * q.a12 * p.y * p.z +
+            q.a22 * p.z * p.z +
+            2.0f * ( q.b0 * p.x + q.b1 * p.y + q.b2 * p.z ) +
+            q.c;
+
+    return std::max( error, 0.0f );
+}
+
+
+/*! \brief Candidate collapse of vertex u onto vertex v. */
+struct EdgeCollapse
+{
+    float cost;
+    GLuint u;
+    GLuint v;
+
+    bool operator < ( const EdgeCollapse& b ) const
+    {
+        return cost < b.cost;
+    }
+};
+
+
+/*!
+ * \brief Flag the vertices which mustn't be moved: those on borders or
+ * non-manifold edges, those shared by several triangles groups and those
+ * sharing their position with other vertices (attribute seams).
+ */
+static void computeLockedVertices( const GLUintBuffer& indices,
+                                   const std::vector< GLuint >& trianglesGroups,
+                                   const GLFloatBuffer& vboData,
+                                   unsigned int componentsPerVertex,
+                                   std::vector< bool >& lockedVertices )
+{
+    const unsigned int nVertices = vboData.size() / componentsPerVertex;
+    const unsigned int nTriangles = indices.size() / 3;
+
+    lockedVertices.assign( nVertices, false );
+
+    // Attribute seams: sort vertices by position and lock equal runs.
+    std::vector< GLuint > verticesByPosition( nVertices );
+    for( GLuint v = 0; v < nVertices; v++ ){
+        verticesByPosition[v] = v;
+    }
+    auto position = [&]( GLuint v ){
+        return &vboData[v * componentsPerVertex];
+    };
+    std::sort( verticesByPosition.begin(), verticesByPosition.end(), [&]( GLuint a, GLuint b ){
+        return std::lexicographical_compare( position( a ), position( a ) + 3,
+                                             position( b ), position( b ) + 3 );
+    });
+    for( unsigned int i = 1; i < nVertices; i++ ){
+        if( std::equal( position( verticesByPosition[i-1] ),
+                        position( verticesByPosition[i-1] ) + 3,
+                        position( verticesByPosition[i] ) ) ){
+            lockedVertices[verticesByPosition[i-1]] = true;
+            lockedVertices[verticesByPosition[i]] = true;
+        }
+    }
+
+    // Borders: every edge of a closed manifold surface is shared by
+    // exactly two triangles of the same group.
+    std::vector< std::array< GLuint, 3 > > edges;
+    edges.reserve( 3 * nTriangles );
+    for( unsigned int t = 0; t < nTriangles; t++ ){
+        for( unsigned int i = 0; i < 3; i++ ){
+            const GLuint a = indices[3*t + i];
+            const GLuint b = indices[3*t + ( i + 1 ) % 3];
+            edges.push_back( { { std::min( a, b ), std::max( a, b ), trianglesGroups[t] } } );
+        }
+    }
+    std::sort( edges.begin(), edges.end() );
+
+    unsigned int runBegin = 0;
+    while( runBegin < edges.size() ){
+        unsigned int runEnd = runBegin + 1;
+        while( ( runEnd < edges.size() ) &&
+               ( edges[runEnd][0] == edges[runBegin][0] ) &&
+               ( edges[runEnd][1] == edges[runBegin][1] ) ){
+            runEnd++;
+        }
+
+        if( ( runEnd - runBegin != 2 ) || ( edges[runBegin][2] != edges[runBegin + 1][2] ) ){
+            lockedVertices[edges[runBegin][0]] = true;
+            lockedVertices[edges[runBegin][1]] = true;
+        }
+        runBegin = runEnd;
+    }
+}
+
+
+void simplifyMesh( const GLUintBuffer& indices,
+                   const std::vector< GLuint >& trianglesGroupsSizes,
+                   const GLFloatBuffer& vboData,
+                   unsigned int componentsPerVertex,
+                   unsigned int targetNTriangles,
+                   GLUintBuffer& simplifiedIndices,
+                   std::vector< GLuint >& simplifiedTrianglesGroupsSizes )
+{
+    const unsigned int nVertices = vboData.size() / componentsPerVertex;
+    auto position = [&]( GLuint v ){
+        return glm::vec3( vboData[v * componentsPerVertex],
+                          vboData[v * componentsPerVertex + 1],
+                          vboData[v * componentsPerVertex + 2] );
+    };
+
+    simplifiedIndices = indices;
+
+    // Group of every triangle.
+    std::vector< GLuint > trianglesGroups;
+    trianglesGroups.reserve( indices.size() / 3 );
+    for( GLuint group = 0; group < trianglesGroupsSizes.size(); group++ ){
+        trianglesGroups.insert( trianglesGroups.end(), trianglesGroupsSizes[group], group );
+    }
+    if( trianglesGroups.size() * 3 != indices.size() ){
+        throw std::runtime_error( "simplifyMesh - triangles groups don't match the indices" );
+    }
+
+    std::vector< bool > lockedVertices;
+    computeLockedVertices( indices, trianglesGroups, vboData, componentsPerVertex, lockedVertices );
+
+    // Vertex quadrics: sum of the (area weighted) planes of the triangles
+    // around every vertex.
+    std::vector< Quadric > quadrics( nVertices );
+    std::memset( quadrics.data(), 0, quadrics.size() * sizeof( Quadric ) );
+    for( unsigned int i = 0; i < indices.size(); i += 3 ){
+        const glm::vec3 p0 = position( indices[i] );
+        const glm::vec3 normal = glm::cross( position( indices[i+1] ) - p0, position( indices[i+2] ) - p0 );
+        const float doubleArea = glm::length( normal );
+
+        if( doubleArea > 0.0f ){
+            const glm::vec3 unitNormal = normal / doubleArea;
+            const float d = -glm::dot( unitNormal, p0 );
+            for( unsigned int j = 0; j < 3; j++ ){
+                addPlaneQuadric( quadrics[indices[i+j]], unitNormal, d, 0.5f * doubleArea );
+            }
+        }
+    }
+
+    std::vector< GLuint > collapseTargets( nVertices );
+    std::vector< bool > touchedVertices( nVertices );
+    std::vector< bool > removedVertices( nVertices );
+    std::vector< GLuint > firstVertexTriangle( nVertices + 1 );
+    std::vector< GLuint > vertexTriangles;
+    std::vector< EdgeCollapse > collapses;
+
+    for( unsigned int pass = 0; pass < MAX_SIMPLIFICATION_PASSES; pass++ ){
+        const unsigned int nTriangles = simplifiedIndices.size() / 3;
+        if( nTriangles <= targetNTriangles * ( 1.0f + SIMPLIFICATION_TOLERANCE ) ){
+            break;
+        }
+
+        // Triangles around every vertex.
+        std::fill( firstVertexTriangle.begin(), firstVertexTriangle.end(), 0 );
+        for( GLuint v : simplifiedIndices ){
+            firstVertexTriangle[v + 1]++;
+        }
+        for( unsigned int v = 0; v < nVertices; v++ ){
+            firstVertexTriangle[v + 1] += firstVertexTriangle[v];
+        }
+        vertexTriangles.resize( simplifiedIndices.size() );
+        {
+            std::vector< GLuint > nextVertexTriangle( firstVertexTriangle.begin(), firstVertexTriangle.end() - 1 );
+            for( unsigned int i = 0; i < simplifiedIndices.size(); i++ ){
+                vertexTriangles[nextVertexTriangle[simplifiedIndices[i]]++] = i / 3;
+            }
+        }
+
+        // Candidate collapses, each edge in its cheapest valid direction.
+        collapses.clear();
+        for( unsigned int i = 0; i < simplifiedIndices.size(); i++ ){
+            const GLuint a = simplifiedIndices[i];
+            const GLuint b = simplifiedIndices[( i % 3 == 2 ) ? ( i - 2 ) : ( i + 1 )];
+            if( a > b ){
+                // Interior edges are visited twice, once in each direction.
+                continue;
+            }
+
+            Quadric edgeQuadric = quadrics[a];
+            addQuadric( edgeQuadric, quadrics[b] );
+
+            const float costAB = lockedVertices[a] ? -1.0f : quadricError( edgeQuadric, position( b ) );
+            const float costBA = lockedVertices[b] ? -1.0f : quadricError( edgeQuadric, position( a ) );
+
+            if( ( costAB >= 0.0f ) && ( ( costBA < 0.0f ) || ( costAB <= costBA ) ) ){
+                collapses.push_back( { costAB, a, b } );
+            }else if( costBA >= 0.0f ){
+                collapses.push_back( { costBA, b, a } );
+            }
+        }
+
+        // Every collapse removes two triangles (on a manifold), so only
+        // the cheapest candidates are needed.
+        const unsigned int nNeededCollapses = ( nTriangles - targetNTriangles + 1 ) / 2;
+        const unsigned int nCandidates =
+                std::min< std::size_t >( collapses.size(), 4 * nNeededCollapses );
+        std::nth_element( collapses.begin(), collapses.begin() + nCandidates, collapses.end() );
+        std::sort( collapses.begin(), collapses.begin() + nCandidates );
+
+        for( GLuint v = 0; v < nVertices; v++ ){
+            collapseTargets[v] = v;
+        }
+        std::fill( touchedVertices.begin(), touchedVertices.end(), false );
+        std::fill( removedVertices.begin(), removedVertices.end(), false );
+
+        unsigned int nCollapses = 0;
+        for( unsigned int c = 0; ( c < nCandidates ) && ( nCollapses < nNeededCollapses ); c++ ){
+            const GLuint u = collapses[c].u;
+            const GLuint v = collapses[c].v;
+
+            if( touchedVertices[u] || removedVertices[v] ){
+                continue;
+            }
+
+            // Reject collapses which flip any of the triangles around u.
+            bool flips = false;
+            for( unsigned int i = firstVertexTriangle[u]; ( i < firstVertexTriangle[u + 1] ) && !flips; i++ ){
+                const GLuint* triangle = &simplifiedIndices[3 * vertexTriangles[i]];
+                if( ( triangle[0] == v ) || ( triangle[1] == v ) || ( triangle[2] == v ) ){
+                    continue;
+                }
+
+                glm::vec3 p[3];
+                glm::vec3 q[3];
+                for( unsigned int j = 0; j < 3; j++ ){
+                    p[j] = position( triangle[j] );
+                    q[j] = ( triangle[j] == u ) ? position( v ) : p[j];
+                }
+                const glm::vec3 oldNormal = glm::cross( p[1] - p[0], p[2] - p[0] );
+                const glm::vec3 newNormal = glm::cross( q[1] - q[0], q[2] - q[0] );
+                flips = ( glm::dot( oldNormal, newNormal ) <= 0.0f );
+            }
+            if( flips ){
+                continue;
+            }
+
+            collapseTargets[u] = v;
+            removedVertices[u] = true;
+            addQuadric( quadrics[v], quadrics[u] );
+            nCollapses++;
+
+            // The triangles around u are checked against the current
+            // positions of their vertices, so none of these can be moved
+            // in the same pass.
+            for( unsigned int i = firstVertexTriangle[u]; i < firstVertexTriangle[u + 1]; i++ ){
+                const GLuint* triangle = &simplifiedIndices[3 * vertexTriangles[i]];
+                touchedVertices[triangle[0]] = true;
+                touchedVertices[triangle[1]] = true;
+                touchedVertices[triangle[2]] = true;
+            }
+        }
+
+        if( !nCollapses ){
+            break;
+        }
+
+        // Apply the collapses, dropping the triangles which degenerate.
+        unsigned int nKeptTriangles = 0;
+        for( unsigned int t = 0; t < nTriangles; t++ ){
+            const GLuint a = collapseTargets[simplifiedIndices[3*t]];
+            const GLuint b = collapseTargets[simplifiedIndices[3*t + 1]];
+            const GLuint c = collapseTargets[simplifiedIndices[3*t + 2]];
+
+            if( ( a != b ) && ( b != c ) && ( c != a ) ){
+                simplifiedIndices[3*nKeptTriangles] = a;
+                simplifiedIndices[3*nKeptTriangles + 1] = b;
+                simplifiedIndices[3*nKeptTriangles + 2] = c;
+                trianglesGroups[nKeptTriangles] = trianglesGroups[t];
+                nKeptTriangles++;
+            }
+        }
+        simplifiedIndices.resize( 3 * nKeptTriangles );
+        trianglesGroups.resize( nKeptTriangles );
+    }
+
+    // Triangles are still sorted by group, as they were never reordered.
+    simplifiedTrianglesGroupsSizes.assign( trianglesGroupsSizes.size(), 0 );
+    for( GLuint group : trianglesGroups ){
+        simplifiedTrianglesGroupsSizes[group]++;
+    }
+}
+
+} // namespace como
@@ -0,0 +1,56 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef MESH_SIMPLIFICATION_HPP
+#define MESH_SIMPLIFICATION_HPP
+
+#include "mesh_opengl_data.hpp"
+
+namespace como {
+
+/*!
+ * \brief Simplify a mesh by quadric error edge collapses (Garland &
+ * Heckbert). Every collapse moves a vertex onto one of its neighbours, so
+ * the simplified triangles reference the original vertex data and no new
+ * vertices are created. Vertices on borders, attribute seams (several
+ * vertices at the same position) or between triangles groups are never
+ * moved, so the simplified mesh doesn't crack nor bleed materials.
+ * \param indices triangles to be simplified, grouped by triangles group.
+ * \param trianglesGroupsSizes number of triangles of every group in indices.
+ * \param vboData interleaved vertex data. Positions are the first three
+ * components of every vertex.
+ * \param componentsPerVertex number of floats per vertex in vboData.
+ * \param targetNTriangles number of triangles to simplify the mesh to. The
+ * result can have slightly more triangles, or many more if the mesh can't be
+ * simplified further.
+ * \param simplifiedIndices simplified triangles, grouped as the original
+ * ones.
+ * \param simplifiedTrianglesGroupsSizes number of simplified triangles of
+ * every group.
+ */
+void simplifyMesh( const GLUintBuffer& indices,
+                   const std::vector< GLuint >& trianglesGroupsSizes,
+                   const GLFloatBuffer& vboData,
+                   unsigned int componentsPerVertex,
+                   unsigned int targetNTriangles,
+                   GLUintBuffer& simplifiedIndices,
+                   std::vector< GLuint >& simplifiedTrianglesGroupsSizes );
+
+} // namespace como
+
+#endif // MESH_SIMPLIFICATION_HPP
@@ -17,12 +17,70 @@
 ***/
 
 #include <common/primitives/primitive_data/primitive_data.hpp>
+#include <common/primitives/primitive_data/vertex_cache_optimization.hpp>
+#include <common/primitives/primitive_data/mesh_simplification.hpp>
+#include <algorithm>
 #include <array>
+#include <limits>
 #include <map>
 
+static_assert( sizeof( como::Vertex ) == 3 * sizeof( float ),
+               "Vertices are stored in primitive files as arrays of floats" );
+static_assert( sizeof( como::IndicesTriangle ) == 3 * sizeof( GLuint ),
+               "Triangles are stored in primitive files as arrays of indices" );
+
 
 namespace como {
 
+// Fraction of the mesh's triangles kept by every level of detail.
+const float LOD_TRIANGLES_RATIOS[] = { 0.5f, 0.25f, 0.1f };
+
+// Meshes with fewer triangles don't get levels of detail.
+const unsigned int LOD_MIN_TRIANGLES = 4096;
+
+// A level of detail is discarded (and no coarser ones are generated) if it
+// doesn't reduce the triangles of the previous level to this fraction.
+const float LOD_MAX_TRIANGLES_FRACTION = 0.8f;
+
+const VertexIndice EMPTY_COMPOUND_VERTEX_SLOT = std::numeric_limits< VertexIndice >::max();
+
+
+static std::size_t hashCompoundVertex( const CompoundVertex& compoundVertex )
+{
+    std::uint32_t hash = compoundVertex[0] * 0x9E3779B1u;
+    hash = ( hash ^ ( hash >> 15 ) ) + compoundVertex[1] * 0x85EBCA77u;
+    hash = ( hash ^ ( hash >> 13 ) ) + compoundVertex[2] * 0xC2B2AE3Du;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+
+/*!
+ * \brief Resize the compound vertices hash table to (the next power of two
+ * of) the given size and reinsert every compound vertex into it.
+ */
+static void resizeCompoundVerticesTable( const std::vector< CompoundVertex >& compoundVertices,
+                                         std::vector< VertexIndice >& table,
+                                         std::size_t size )
+{
+    std::size_t tableSize = 16;
+    while( tableSize < size ){
+        tableSize *= 2;
+    }
+    table.assign( tableSize, EMPTY_COMPOUND_VERTEX_SLOT );
+
+    const std::size_t tableMask = tableSize - 1;
+    for( VertexIndice i = 0; i < compoundVertices.size(); i++ ){
+        std::size_t slot = hashCompoundVertex( compoundVertices[i] ) & tableMask;
+        while( table[slot] != EMPTY_COMPOUND_VERTEX_SLOT ){
+            slot = ( slot + 1 ) & tableMask;
+        }
+        table[slot] = i;
+    }
+}
+
+
 /***
  * 1. Getters
  ***/
@@ -48,19 +106,25 @@ unsigned int PrimitiveData::getMaterialIndex( const std::string& name ) const
  * 2. Data generation
  ***/
 
-void PrimitiveData::generateOGLData()
+void PrimitiveData::generateOGLData( bool optimizeForVertexCache )
 {
-    CompoundVerticesMap compoundVerticesMap;
     unsigned int currentVertexTriangleIndex = 0;
     unsigned int currentTriangleElement = 0;
     unsigned int currentUVTriangleIndex = 0;
 
     CompoundVertex compoundVertex;
-    CompoundVerticesMap::const_iterator finalVerticesIt;
     VertexIndice compoundVertexIndex;
 
     oglData.includesUV = (uvData.uvTriangles.size() > 0);
 
+    // The OpenGL data is generated from scratch: the compound vertices are
+    // numbered from zero and the vertex cache optimization works on the
+    // whole buffers. The levels of detail refer to the previous buffers,
+    // so discard them too.
+    oglData.vboData.clear();
+    oglData.eboData.clear();
+    oglData.lodLevels.clear();
+
     if( vertexData.vertexTriangles.size() != normalData.normalTriangles.size() ){
         throw std::runtime_error(
                     "vertexTriangles != normalTriangles (" +
@@ -69,7 +133,29 @@ void PrimitiveData::generateOGLData()
                     std::to_string( normalData.normalTriangles.size() ) );
     }
 
-    for( const TrianglesGroup& trianglesGroup : getTrianglesGroups() ){
+    const std::vector< TrianglesGroup > trianglesGroups = getTrianglesGroups();
+    unsigned int nTriangles = 0;
+    for( const TrianglesGroup& trianglesGroup : trianglesGroups ){
+        nTriangles += trianglesGroup.nTriangles;
+    }
+
+    // Compound vertices are welded through an open addressing hash table
+    // whose slots hold indices into compoundVertices. It is kept at most
+    // half full.
+    const unsigned int expectedNCompoundVertices =
+            std::min< std::size_t >( 3 * nTriangles,
+                                     std::max( vertexData.vertices.size(),
+                                               std::max( normalData.normals.size(),
+                                                         uvData.uvVertices.size() ) ) );
+    std::vector< CompoundVertex > compoundVertices;
+    std::vector< VertexIndice > compoundVerticesTable;
+
+    compoundVertices.reserve( expectedNCompoundVertices );
+    resizeCompoundVerticesTable( compoundVertices, compoundVerticesTable, 2 * expectedNCompoundVertices );
+    oglData.vboData.reserve( expectedNCompoundVertices * oglData.componentsPerVertex() );
+    oglData.eboData.reserve( 3 * nTriangles );
+
+    for( const TrianglesGroup& trianglesGroup : trianglesGroups ){
         for( currentVertexTriangleIndex = trianglesGroup.firstTriangleIndex;
              currentVertexTriangleIndex < trianglesGroup.firstTriangleIndex + trianglesGroup.nTriangles;
              currentVertexTriangleIndex++ ){
@@ -79,12 +165,17 @@ void PrimitiveData::generateOGLData()
                 compoundVertex[1] = normalData.normalTriangles[currentVertexTriangleIndex][currentTriangleElement];
                 compoundVertex[2] = ( trianglesGroup.includesUV ? uvData.uvTriangles[currentUVTriangleIndex][currentTriangleElement] : 0 );
 
-                finalVerticesIt = compoundVerticesMap.find( compoundVertex );
+                const std::size_t tableMask = compoundVerticesTable.size() - 1;
+                std::size_t slot = hashCompoundVertex( compoundVertex ) & tableMask;
+                while( ( compoundVerticesTable[slot] != EMPTY_COMPOUND_VERTEX_SLOT ) &&
+                       ( compoundVertices[compoundVerticesTable[slot]] != compoundVertex ) ){
+                    slot = ( slot + 1 ) & tableMask;
+                }
 
-                if( finalVerticesIt != compoundVerticesMap.end() ){
-                    compoundVertexIndex = finalVerticesIt->second;
+                if( compoundVerticesTable[slot] != EMPTY_COMPOUND_VERTEX_SLOT ){
+                    compoundVertexIndex = compoundVerticesTable[slot];
                 }else{
-                    compoundVertexIndex = compoundVerticesMap.size();
+                    compoundVertexIndex = compoundVertices.size();
 
                     oglData.vboData.push_back( vertexData.vertices[ compoundVertex[0] ][0] );
                     oglData.vboData.push_back( vertexData.vertices[ compoundVertex[0] ][1] );
@@ -101,7 +192,12 @@ void PrimitiveData::generateOGLData()
                         oglData.vboData.push_back( uvData.uvVertices[ compoundVertex[2] ][1] );
                     }
 
-                    compoundVerticesMap.insert( std::pair< CompoundVertex, VertexIndice >( compoundVertex, compoundVertexIndex ) );
+                    compoundVertices.push_back( compoundVertex );
+                    compoundVerticesTable[slot] = compoundVertexIndex;
+
+                    if( 2 * compoundVertices.size() > compoundVerticesTable.size() ){
+                        resizeCompoundVerticesTable( compoundVertices, compoundVerticesTable, 2 * compoundVerticesTable.size() );
+                    }
                 }
 
                 oglData.eboData.push_back( compoundVertexIndex );
@@ -111,9 +207,75 @@ void PrimitiveData::generateOGLData()
             }
         }
     }
+
+    if( optimizeForVertexCache ){
+        // Triangles are reordered within their groups, so the groups'
+        // ranges remain valid.
+        unsigned int firstIndex = 0;
+        for( const TrianglesGroup& trianglesGroup : trianglesGroups ){
+            optimizeVertexCache( &oglData.eboData[firstIndex],
+                                 3 * trianglesGroup.nTriangles,
+                                 compoundVertices.size() );
+            firstIndex += 3 * trianglesGroup.nTriangles;
+        }
+
+        if( oglData.eboData.size() ){
+            reorderVerticesByFirstUse( &oglData.eboData[0],
+                                       oglData.eboData.size(),
+                                       oglData.vboData,
+                                       oglData.componentsPerVertex() );
+        }
+    }
+}
+
+void PrimitiveData::generateOGLLODLevels()
+{
+    const unsigned int nTriangles = oglData.eboData.size() / 3;
+    std::vector< GLuint > trianglesGroupsSizes;
+
+    oglData.lodLevels.clear();
+    if( nTriangles < LOD_MIN_TRIANGLES ){
+        return;
+    }
+
+    for( const TrianglesGroup& trianglesGroup : getTrianglesGroups() ){
+        trianglesGroupsSizes.push_back( trianglesGroup.nTriangles );
+    }
+
+    // Every level is simplified from the previous one.
+    for( float trianglesRatio : LOD_TRIANGLES_RATIOS ){
+        const GLUintBuffer& previousEboData = oglData.lodLevels.size() ?
+                    oglData.lodLevels.back().eboData : oglData.eboData;
+        const std::vector< GLuint >& previousTrianglesGroupsSizes = oglData.lodLevels.size() ?
+                    oglData.lodLevels.back().trianglesGroupsSizes : trianglesGroupsSizes;
+        MeshLODLevel lodLevel;
+
+        simplifyMesh( previousEboData,
+                      previousTrianglesGroupsSizes,
+                      oglData.vboData,
+                      oglData.componentsPerVertex(),
+                      static_cast< unsigned int >( trianglesRatio * nTriangles ),
+                      lodLevel.eboData,
+                      lodLevel.trianglesGroupsSizes );
+
+        if( lodLevel.eboData.size() > LOD_MAX_TRIANGLES_FRACTION * previousEboData.size() ){
+            break;
+        }
+
+        unsigned int firstIndex = 0;
+        for( GLuint trianglesGroupSize : lodLevel.trianglesGroupsSizes ){
+            optimizeVertexCache( &lodLevel.eboData[firstIndex],
+                                 3 * trianglesGroupSize,
+                                 oglData.vboData.size() / oglData.componentsPerVertex() );
+            firstIndex += 3 * trianglesGroupSize;
+        }
+
+        oglData.lodLevels.push_back( std::move( lodLevel ) );
+    }
 }
 
 
+
 void PrimitiveData::addQuad( const IndicesQuad &verticesQuad, const IndicesQuad &uvQuad )
 {
     IndicesTriangle verticesTriangle1, verticesTriangle2;
@@ -171,29 +333,31 @@ void PrimitiveData::importFromFile( const std::string &filePath )
 {
     std::ifstream file;
 
-    file.open( filePath );
-    if( !file.is_open() ){
-        throw FileNotOpenException( filePath );
-    }
+    if( PrimitiveFileReader::isPrimitiveFile( filePath ) ){
+        const PrimitiveFileReader reader( filePath );
+
+        readSections( reader );
+    }else{
+        // Primitive file in the old text format.
+        file.open( filePath );
+        if( !file.is_open() ){
+            throw FileNotOpenException( filePath );
+        }
 
-    read( file );
+        read( file );
 
-    file.close();
+        file.close();
+    }
 }
 
 
 void PrimitiveData::exportToFile( const std::string& filePath ) const
 {
-    std::ofstream file;
+    PrimitiveFileWriter writer;
 
-    file.open( filePath );
-    if( !file.is_open() ){
-        throw FileNotOpenException( filePath );
-    }
-
-    write( file );
+    writeSections( writer );
 
-    file.close();
+    writer.writeToFile( filePath );
 }
 
 
@@ -206,6 +370,10 @@ std::string PrimitiveData::getNameFromFile(const std::string &filePath)
     std::ifstream file;
     std::string primitiveName;
 
+    if( PrimitiveFileReader::isPrimitiveFile( filePath ) ){
+        return PrimitiveFileReader( filePath ).readStringSection( PrimitiveFileSection::NAME );
+    }
+
     file.open( filePath );
     if( !file.is_open() ){
         throw FileNotOpenException( filePath );
@@ -243,17 +411,29 @@ void PrimitiveData::read( std::ifstream &file )
     readVertices( file );
     readTriangles( file );
     readOpenGLData( file );
+    validateIndices();
     readMaterials( file );
 }
 
 
-void PrimitiveData::write( std::ofstream &file ) const
+void PrimitiveData::readSections( const PrimitiveFileReader& reader )
+{
+    name = reader.readStringSection( PrimitiveFileSection::NAME );
+    reader.readArraySection( PrimitiveFileSection::VERTICES, vertexData.vertices );
+    reader.readArraySection( PrimitiveFileSection::TRIANGLES, vertexData.vertexTriangles );
+    readOpenGLData( reader );
+    validateIndices();
+    readMaterials( reader );
+}
+
+
+void PrimitiveData::writeSections( PrimitiveFileWriter& writer ) const
 {
-    file << name << std::endl;
-    writeVertices( file );
-    writeTriangles( file );
-    writeOpenGLData( file );
-    writeMaterials( file );
+    writer.addSection( PrimitiveFileSection::NAME, name.data(), name.size() );
+    writer.addArraySection( PrimitiveFileSection::VERTICES, vertexData.vertices );
+    writer.addArraySection( PrimitiveFileSection::TRIANGLES, vertexData.vertexTriangles );
+    writeOpenGLData( writer );
+    writeMaterials( writer );
 }
 
 
@@ -374,81 +554,212 @@ void PrimitiveData::readMaterials(std::ifstream &file)
 }
 
 
-/***
- * 7. File writting (auxiliar methods)
- ***/
-
-void PrimitiveData::writeVertices( std::ofstream& file ) const
+void PrimitiveData::readOpenGLData( const PrimitiveFileReader& reader )
 {
-    // Write the number of vertices in the mesh.
-    file << vertexData.vertices.size() << std::endl;
+    std::vector< PrimitiveFileOpenGLInfo > oglInfo;
+
+    reader.readArraySection( PrimitiveFileSection::OPENGL_INFO, oglInfo );
+    if( oglInfo.size() != 1 ){
+        throw std::runtime_error( "Primitive file - missing OpenGL info" );
+    }
+
+    oglData.includesUV = ( oglInfo[0].includesUV != 0 );
+    if( oglInfo[0].componentsPerVertex != oglData.componentsPerVertex() ){
+        throw std::runtime_error( "Primitive file - unexpected number of components per vertex" );
+    }
+
+    // VBO and EBO are stored as they will be sent to OpenGL.
+    reader.readArraySection( PrimitiveFileSection::VBO, oglData.vboData );
+    reader.readArraySection( PrimitiveFileSection::EBO, oglData.eboData );
 
-    // Write all the vertices to the file (one vertex per line).
-    for( const auto& vertex : vertexData.vertices ){
-        file << vertex[0] << " " << vertex[1] << " " << vertex[2] << std::endl;
+    // Levels of detail (optional).
+    std::vector< PrimitiveFileLODLevel > lodLevels;
+    std::vector< GLuint > lodTrianglesGroupsSizes;
+    std::uint64_t nLODIndices = 0;
+    const GLuint* lodIndices =
+            reader.sectionArray< GLuint >( PrimitiveFileSection::LOD_EBO, nLODIndices );
+
+    reader.readArraySection( PrimitiveFileSection::LOD_LEVELS, lodLevels );
+    reader.readArraySection( PrimitiveFileSection::LOD_TRIANGLES_GROUPS_SIZES, lodTrianglesGroupsSizes );
+
+    const std::size_t nVertices = oglData.vboData.size() / oglData.componentsPerVertex();
+
+    oglData.lodLevels.clear();
+    for( const PrimitiveFileLODLevel& fileLODLevel : lodLevels ){
+        MeshLODLevel lodLevel;
+
+        if( ( static_cast< std::uint64_t >( fileLODLevel.firstIndex ) + fileLODLevel.nIndices > nLODIndices ) ||
+                ( static_cast< std::uint64_t >( fileLODLevel.firstTrianglesGroupSize ) + fileLODLevel.nTrianglesGroups > lodTrianglesGroupsSizes.size() ) ){
+            throw std::runtime_error( "Primitive file - level of detail out of bounds" );
+        }
+
+        lodLevel.eboData.assign( lodIndices + fileLODLevel.firstIndex,
+                                 lodIndices + fileLODLevel.firstIndex + fileLODLevel.nIndices );
+        lodLevel.trianglesGroupsSizes.assign( lodTrianglesGroupsSizes.begin() + fileLODLevel.firstTrianglesGroupSize,
+                                              lodTrianglesGroupsSizes.begin() + fileLODLevel.firstTrianglesGroupSize + fileLODLevel.nTrianglesGroups );
+
+        // The level is drawn group by group from its triangles groups
+        // sizes, so they must cover exactly its indices, and these must
+        // reference existing vertices.
+        std::uint64_t nLevelTriangles = 0;
+        for( GLuint trianglesGroupSize : lodLevel.trianglesGroupsSizes ){
+            nLevelTriangles += trianglesGroupSize;
+        }
+        if( nLevelTriangles * 3 != lodLevel.eboData.size() ){
+            throw std::runtime_error( "Primitive file - level of detail triangles groups don't match its indices" );
+        }
+        for( GLuint index : lodLevel.eboData ){
+            if( index >= nVertices ){
+                throw std::runtime_error( "Primitive file - level of detail index out of bounds" );
+            }
+        }
+
+        oglData.lodLevels.push_back( std::move( lodLevel ) );
     }
 }
 
 
-void PrimitiveData::writeTriangles( std::ofstream& file ) const
+void PrimitiveData::readMaterials( const PrimitiveFileReader& reader )
 {
-    // Write the number of triangles in the mesh.
-    file << vertexData.vertexTriangles.size() << std::endl;
+    std::vector< PrimitiveFileMaterial > materials;
+    std::uint64_t materialsDataSize = 0;
+    const char* materialsData =
+            reader.sectionData( PrimitiveFileSection::MATERIALS_DATA, materialsDataSize );
+    unsigned int i;
+
+    reader.readArraySection( PrimitiveFileSection::MATERIALS, materials );
+
+    materialsInfo_.clear();
+    materialsInfo_.resize( materials.size() );
+    for( i = 0; i < materials.size(); i++ ){
+        const PrimitiveFileMaterial& material = materials[i];
+        MaterialInfo& materialInfo = materialsInfo_[i];
+
+        if( ( static_cast< std::uint64_t >( material.nameOffset ) + material.nameSize > materialsDataSize ) ||
+                ( static_cast< std::uint64_t >( material.textureOffset ) + material.textureSize > materialsDataSize ) ){
+            throw std::runtime_error( "Primitive file - material data out of bounds" );
+        }
 
-    // Write all the triangles to the file (one triangle per line).
-    for( const auto& triangle : vertexData.vertexTriangles ){
-        file << triangle[0] << " " << triangle[1] << " " << triangle[2] << std::endl;
+        materialInfo.name.assign( materialsData + material.nameOffset, material.nameSize );
+        materialInfo.ambientReflectivity = glm::vec3( material.ambientReflectivity[0],
+                                                      material.ambientReflectivity[1],
+                                                      material.ambientReflectivity[2] );
+        materialInfo.diffuseReflectivity = glm::vec3( material.diffuseReflectivity[0],
+                                                      material.diffuseReflectivity[1],
+                                                      material.diffuseReflectivity[2] );
+        materialInfo.specularReflectivity = glm::vec3( material.specularReflectivity[0],
+                                                       material.specularReflectivity[1],
+                                                       material.specularReflectivity[2] );
+        materialInfo.specularExponent = material.specularExponent;
+
+        if( material.includesTexture ){
+            materialInfo.textureInfo = std::unique_ptr< TextureInfo >(
+                        new TextureInfo( materialsData + material.textureOffset, material.textureSize ) );
+        }
     }
 }
 
 
-void PrimitiveData::writeOpenGLData( std::ofstream& file ) const
+void PrimitiveData::validateIndices() const
 {
-    unsigned int vertexIndex = 0;
-    unsigned int componentIndex = 0;
-    unsigned int nVBOVertices = 0;
-    unsigned int componentsPerVertex = oglData.componentsPerVertex();
-    unsigned int triangleIndex = 0;
+    const std::size_t nVBOVertices = oglData.vboData.size() / oglData.componentsPerVertex();
+
+    // Primitive files come from other users, so their indices must be
+    // checked before intersecting, welding or drawing the primitive.
+    for( const IndicesTriangle& triangle : vertexData.vertexTriangles ){
+        for( GLuint index : triangle ){
+            if( index >= vertexData.vertices.size() ){
+                throw std::runtime_error( "Primitive file - triangle index out of bounds" );
+            }
+        }
+    }
+    for( GLuint index : oglData.eboData ){
+        if( index >= nVBOVertices ){
+            throw std::runtime_error( "Primitive file - EBO index out of bounds" );
+        }
+    }
+}
 
-    nVBOVertices = oglData.vboData.size() / componentsPerVertex;
 
-    // Write a boolean indicating if the OGL Data includes texture data.
-    file << oglData.includesUV << std::endl;
+/***
+ * 7. File writting (auxiliar methods)
+ ***/
 
-    // Write the number of VBO vertices.
-    file << nVBOVertices << std::endl;
+void PrimitiveData::writeOpenGLData( PrimitiveFileWriter& writer ) const
+{
+    PrimitiveFileOpenGLInfo oglInfo;
 
-    // Write the VBO data to the file (one vertex per line).
-    for( vertexIndex = 0; vertexIndex < nVBOVertices; vertexIndex++ ){
-        for( componentIndex = 0; componentIndex < oglData.componentsPerVertex()-1; componentIndex++ ){
-            file << oglData.vboData[vertexIndex * componentsPerVertex + componentIndex] << " ";
-        }
-        file << oglData.vboData[vertexIndex * componentsPerVertex + componentIndex] << std::endl;
-    }
+    oglInfo.includesUV = oglData.includesUV ? 1 : 0;
+    oglInfo.componentsPerVertex = oglData.componentsPerVertex();
 
-    // Write the number of triangles to the file.
-    file << ( oglData.eboData.size() / 3 ) << std::endl;
+    writer.addSection( PrimitiveFileSection::OPENGL_INFO, &oglInfo, sizeof( oglInfo ), sizeof( oglInfo ) );
+    writer.addArraySection( PrimitiveFileSection::VBO, oglData.vboData );
+    writer.addArraySection( PrimitiveFileSection::EBO, oglData.eboData );
 
-    // Write the EBO data to the file (one triangle per line).
-    for( triangleIndex = 0; triangleIndex < oglData.eboData.size() / 3; triangleIndex++ ){
-        file << oglData.eboData[triangleIndex * 3] << " "
-             << oglData.eboData[triangleIndex * 3 + 1] << " "
-             << oglData.eboData[triangleIndex * 3 + 2] << std::endl;
+    if( oglData.lodLevels.size() ){
+        std::vector< PrimitiveFileLODLevel > lodLevels;
+        std::vector< GLuint > lodTrianglesGroupsSizes;
+        GLUintBuffer lodIndices;
+
+        for( const MeshLODLevel& lodLevel : oglData.lodLevels ){
+            PrimitiveFileLODLevel fileLODLevel;
+
+            fileLODLevel.firstIndex = lodIndices.size();
+            fileLODLevel.nIndices = lodLevel.eboData.size();
+            fileLODLevel.firstTrianglesGroupSize = lodTrianglesGroupsSizes.size();
+            fileLODLevel.nTrianglesGroups = lodLevel.trianglesGroupsSizes.size();
+            lodLevels.push_back( fileLODLevel );
+
+            lodIndices.insert( lodIndices.end(), lodLevel.eboData.begin(), lodLevel.eboData.end() );
+            lodTrianglesGroupsSizes.insert( lodTrianglesGroupsSizes.end(),
+                                            lodLevel.trianglesGroupsSizes.begin(),
+                                            lodLevel.trianglesGroupsSizes.end() );
+        }
+
+        writer.addArraySection( PrimitiveFileSection::LOD_LEVELS, lodLevels );
+        writer.addArraySection( PrimitiveFileSection::LOD_TRIANGLES_GROUPS_SIZES, lodTrianglesGroupsSizes );
+        writer.addArraySection( PrimitiveFileSection::LOD_EBO, lodIndices );
     }
 }
 
 
-void PrimitiveData::writeMaterials(std::ofstream &file) const
+void PrimitiveData::writeMaterials( PrimitiveFileWriter& writer ) const
 {
-    file << materialsInfo_.size() << std::endl;
+    std::vector< PrimitiveFileMaterial > materials;
+    std::vector< char > materialsData;
+    unsigned int i;
 
-    for( const auto& material : materialsInfo_ ){
-        material.writeToFile( file );
-    }
-}
+    for( const auto& materialInfo : materialsInfo_ ){
+        PrimitiveFileMaterial material;
 
+        for( i = 0; i < 3; i++ ){
+            material.ambientReflectivity[i] = materialInfo.ambientReflectivity[i];
+            material.diffuseReflectivity[i] = materialInfo.diffuseReflectivity[i];
+            material.specularReflectivity[i] = materialInfo.specularReflectivity[i];
+        }
+        material.specularExponent = materialInfo.specularExponent;
+
+        material.nameOffset = materialsData.size();
+        material.nameSize = materialInfo.name.size();
+        materialsData.insert( materialsData.end(), materialInfo.name.begin(), materialInfo.name.end() );
 
+        material.includesTexture = ( materialInfo.textureInfo != nullptr ) ? 1 : 0;
+        material.textureOffset = materialsData.size();
+        material.textureSize = 0;
+        if( materialInfo.textureInfo ){
+            const std::string& imageFileData = materialInfo.textureInfo->imageFileData;
+
+            material.textureSize = imageFileData.size();
+            materialsData.insert( materialsData.end(), imageFileData.begin(), imageFileData.end() );
+        }
+        material.reserved = 0;
 
+        materials.push_back( material );
+    }
+
+    writer.addArraySection( PrimitiveFileSection::MATERIALS, materials );
+    writer.addArraySection( PrimitiveFileSection::MATERIALS_DATA, materialsData );
+}
 
 
 } // namespace como
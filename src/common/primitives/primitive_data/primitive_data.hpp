@@ -28,12 +28,12 @@
 #include <common/exceptions/file_not_open_exception.hpp>
 #include <map>
 #include <common/primitives/primitive_data/triangles_group.hpp>
+#include <common/primitives/primitive_data/primitive_file.hpp>
 
 namespace como {
 
 typedef GLuint VertexIndice;
 typedef std::array< VertexIndice, 3 > CompoundVertex; // A vertex formed by a position vertex, a normal and an UV vertex
-typedef std::map< CompoundVertex, VertexIndice > CompoundVerticesMap;
 
 
 struct PrimitiveData
@@ -59,7 +59,22 @@ struct PrimitiveData
         /***
          * 2. Data generation
          ***/
-        void generateOGLData();
+
+        /*!
+         * \brief Generate the OpenGL buffers from the mesh data, welding
+         * identical (vertex, normal, UV) triples into a single vertex.
+         * \param optimizeForVertexCache reorder the triangles within each
+         * triangles group for the GPU's vertex cache (and the vertices by
+         * first use). Worth it for big meshes loaded many times.
+         */
+        void generateOGLData( bool optimizeForVertexCache = false );
+
+        /*!
+         * \brief Generate a chain of simplified levels of detail from the
+         * OpenGL data (which must have been generated already). Meshes too
+         * small to benefit from them get none.
+         */
+        void generateOGLLODLevels();
         void addQuad( const IndicesQuad& verticesQuad,
                       const IndicesQuad& uvQuad );
         void addTriangle( const IndicesTriangle& verticesTriangle,
@@ -72,7 +87,14 @@ struct PrimitiveData
         /***
          * 3. File importing / exporting
          ***/
+
+        /*!
+         * \brief Imports the primitive from a binary primitive file, or from
+         * a primitive file in the old text format.
+         */
         virtual void importFromFile( const std::string &filePath );
+
+        /*! \brief Exports the primitive to a binary primitive file. */
         virtual void exportToFile( const std::string& filePath ) const;
 
 
@@ -82,13 +104,23 @@ struct PrimitiveData
         static std::string getNameFromFile( const std::string& filePath );
         static void triangulateQuad( const IndicesQuad &quad, IndicesTriangle &triangle1, IndicesTriangle &triangle2 );
 
+        /*!
+         * \brief Throws a runtime_error if any triangle or EBO index is out
+         * of bounds. Primitive files are checked when imported.
+         */
+        void validateIndices() const;
+
 
     protected:
         /***
          * 5. File reading / writing
          ***/
+
+        /*! \brief Reads the primitive from a file in the old text format. */
         virtual void read( std::ifstream& file );
-        virtual void write( std::ofstream& file ) const;
+
+        virtual void readSections( const PrimitiveFileReader& reader );
+        virtual void writeSections( PrimitiveFileWriter& writer ) const;
 
 
     private:
@@ -99,15 +131,15 @@ struct PrimitiveData
         void readTriangles( std::ifstream& file );
         void readOpenGLData( std::ifstream& file );
         void readMaterials( std::ifstream &file );
+        void readOpenGLData( const PrimitiveFileReader& reader );
+        void readMaterials( const PrimitiveFileReader& reader );
 
 
         /***
          * 7. File writting (auxiliar methods)
          ***/
-        void writeVertices( std::ofstream& file ) const;
-        void writeTriangles( std::ofstream& file ) const;
-        void writeOpenGLData( std::ofstream& file ) const;
-        void writeMaterials(std::ofstream &file) const;
+        void writeOpenGLData( PrimitiveFileWriter& writer ) const;
+        void writeMaterials( PrimitiveFileWriter& writer ) const;
 };
 
 } // namespace como
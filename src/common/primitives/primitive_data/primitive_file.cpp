@@ -0,0 +1,225 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "primitive_file.hpp"
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace como {
+
+/***
+ * PrimitiveFileWriter - 3. Sections
+ ***/
+
+void PrimitiveFileWriter::addSection( PrimitiveFileSection type,
+                                      const void* data,
+                                      std::uint64_t size,
+                                      std::uint32_t elementSize )
+{
+    const char* castedData = static_cast< const char* >( data );
+    Section section;
+
+    section.entry.type = static_cast< std::uint32_t >( type );
+    section.entry.elementSize = elementSize;
+    section.entry.offset = 0;
+    section.entry.size = size;
+    section.data.assign( castedData, castedData + size );
+
+    sections_.push_back( std::move( section ) );
+}
+
+
+/***
+ * PrimitiveFileWriter - 4. File writing
+ ***/
+
+void PrimitiveFileWriter::writeToFile( const std::string& filePath ) const
+{
+    PrimitiveFileHeader header;
+    std::vector< PrimitiveFileSectionEntry > sectionsTable;
+    std::uint64_t offset;
+    const char padding[PRIMITIVE_FILE_ALIGNMENT] = { 0 };
+
+    std::memcpy( header.magic, PRIMITIVE_FILE_MAGIC, sizeof( header.magic ) );
+    header.version = PRIMITIVE_FILE_VERSION;
+    header.byteOrderMark = PRIMITIVE_FILE_BYTE_ORDER_MARK;
+    header.nSections = sections_.size();
+    header.reserved = 0;
+
+    // Place every section right after the previous one, at an aligned
+    // offset.
+    offset = sizeof( header ) + sections_.size() * sizeof( PrimitiveFileSectionEntry );
+    for( const Section& section : sections_ ){
+        offset = ( offset + PRIMITIVE_FILE_ALIGNMENT - 1 ) / PRIMITIVE_FILE_ALIGNMENT * PRIMITIVE_FILE_ALIGNMENT;
+
+        sectionsTable.push_back( section.entry );
+        sectionsTable.back().offset = offset;
+
+        offset += section.entry.size;
+    }
+
+    // Write to a temporary file first, so the views of a previous file with
+    // the same path (see FileView) aren't truncated.
+    const std::string tmpFilePath = filePath + ".tmp";
+    std::ofstream file( tmpFilePath.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc );
+    if( !file.is_open() ){
+        throw FileNotOpenException( tmpFilePath );
+    }
+
+    file.write( reinterpret_cast< const char* >( &header ), sizeof( header ) );
+    file.write( reinterpret_cast< const char* >( sectionsTable.data() ),
+                sectionsTable.size() * sizeof( PrimitiveFileSectionEntry ) );
+
+    offset = sizeof( header ) + sectionsTable.size() * sizeof( PrimitiveFileSectionEntry );
+    auto sectionEntryIt = sectionsTable.begin();
+    for( const Section& section : sections_ ){
+        file.write( padding, sectionEntryIt->offset - offset );
+        file.write( section.data.data(), section.data.size() );
+
+        offset = sectionEntryIt->offset + section.data.size();
+        sectionEntryIt++;
+    }
+
+    file.close();
+    if( !file ){
+        throw std::runtime_error( "ERROR writing primitive file [" + filePath + "]" );
+    }
+    boost::filesystem::rename( tmpFilePath, filePath );
+}
+
+
+/***
+ * PrimitiveFileReader - 1. Construction
+ ***/
+
+PrimitiveFileReader::PrimitiveFileReader( const std::string& filePath ) :
+    filePath_( filePath ),
+    fileView_( FileView::open( filePath ) ),
+    sectionsTable_( nullptr ),
+    nSections_( 0 )
+{
+    PrimitiveFileHeader header;
+
+    if( fileView_->size() < sizeof( header ) ){
+        throw std::runtime_error( "Primitive file [" + filePath_ + "] - file too short" );
+    }
+    std::memcpy( &header, fileView_->data(), sizeof( header ) );
+
+    if( std::memcmp( header.magic, PRIMITIVE_FILE_MAGIC, sizeof( header.magic ) ) ){
+        throw std::runtime_error( "Primitive file [" + filePath_ + "] - not a binary primitive file" );
+    }
+    if( header.byteOrderMark != PRIMITIVE_FILE_BYTE_ORDER_MARK ){
+        throw std::runtime_error( "Primitive file [" + filePath_ + "] - written with a different byte order" );
+    }
+    if( header.version != PRIMITIVE_FILE_VERSION ){
+        throw std::runtime_error( "Primitive file [" + filePath_ +
+                                  "] - unsupported version (" +
+                                  std::to_string( header.version ) + ")" );
+    }
+
+    const std::uint64_t tableEnd =
+            sizeof( header ) +
+            static_cast< std::uint64_t >( header.nSections ) * sizeof( PrimitiveFileSectionEntry );
+    if( tableEnd > fileView_->size() ){
+        throw std::runtime_error( "Primitive file [" + filePath_ + "] - truncated section table" );
+    }
+
+    // The mapping is page-aligned and the header size is a multiple of 8, so
+    // the table can be used in place.
+    sectionsTable_ = reinterpret_cast< const PrimitiveFileSectionEntry* >( fileView_->data() + sizeof( header ) );
+    nSections_ = header.nSections;
+
+    for( std::uint32_t i = 0; i < nSections_; i++ ){
+        const PrimitiveFileSectionEntry& section = sectionsTable_[i];
+
+        if( ( section.offset % PRIMITIVE_FILE_ALIGNMENT ) ||
+                ( section.offset > fileView_->size() ) ||
+                ( section.size > fileView_->size() - section.offset ) ){
+            throw std::runtime_error( "Primitive file [" + filePath_ +
+                                      "] - section (" +
+                                      std::to_string( section.type ) +
+                                      ") out of file bounds" );
+        }
+    }
+}
+
+
+/***
+ * PrimitiveFileReader - 3. Getters
+ ***/
+
+bool PrimitiveFileReader::isPrimitiveFile( const std::string& filePath )
+{
+    char magic[sizeof( PRIMITIVE_FILE_MAGIC )] = { 0 };
+
+    std::ifstream file( filePath.c_str(), std::ios_base::in | std::ios_base::binary );
+    if( !file.is_open() ){
+        throw FileNotOpenException( filePath );
+    }
+
+    file.read( magic, sizeof( magic ) );
+
+    return file && !std::memcmp( magic, PRIMITIVE_FILE_MAGIC, sizeof( magic ) );
+}
+
+
+bool PrimitiveFileReader::hasSection( PrimitiveFileSection type ) const
+{
+    return findSection( type ) != nullptr;
+}
+
+
+const char* PrimitiveFileReader::sectionData( PrimitiveFileSection type, std::uint64_t& size ) const
+{
+    const PrimitiveFileSectionEntry* section = findSection( type );
+
+    if( section == nullptr ){
+        size = 0;
+        return nullptr;
+    }
+
+    size = section->size;
+    return fileView_->data() + section->offset;
+}
+
+
+std::string PrimitiveFileReader::readStringSection( PrimitiveFileSection type ) const
+{
+    std::uint64_t size = 0;
+    const char* data = sectionData( type, size );
+
+    return ( data != nullptr ) ? std::string( data, size ) : std::string();
+}
+
+
+/***
+ * PrimitiveFileReader - 5. Auxiliar methods
+ ***/
+
+const PrimitiveFileSectionEntry* PrimitiveFileReader::findSection( PrimitiveFileSection type ) const
+{
+    for( std::uint32_t i = 0; i < nSections_; i++ ){
+        if( sectionsTable_[i].type == static_cast< std::uint32_t >( type ) ){
+            return &( sectionsTable_[i] );
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace como
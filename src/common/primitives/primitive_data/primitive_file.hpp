@@ -0,0 +1,331 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PRIMITIVE_FILE_HPP
+#define PRIMITIVE_FILE_HPP
+
+#include <common/exceptions/file_not_open_exception.hpp>
+#include <common/utilities/file_view.hpp>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace como {
+
+/*!
+ * Binary primitive files (.prim) start with a PrimitiveFileHeader, followed
+ * by a table of nSections PrimitiveFileSectionEntry's and the sections
+ * themselves. Every section starts at an offset multiple of
+ * PRIMITIVE_FILE_ALIGNMENT, so arrays can be used right from a memory
+ * mapping of the file. Data is stored in the byte order of the machine
+ * which wrote the file (checked with byteOrderMark).
+ */
+const char PRIMITIVE_FILE_MAGIC[8] = { 'C', 'O', 'M', 'O', 'P', 'R', 'I', 'M' };
+const std::uint32_t PRIMITIVE_FILE_VERSION = 1;
+const std::uint32_t PRIMITIVE_FILE_BYTE_ORDER_MARK = 0x01020304;
+const std::uint64_t PRIMITIVE_FILE_ALIGNMENT = 16;
+
+enum class PrimitiveFileSection : std::uint32_t
+{
+    NAME = 0,
+    VERTICES,
+    TRIANGLES,
+    OPENGL_INFO,
+    VBO,
+    EBO,
+    MATERIALS,
+    MATERIALS_DATA,
+    TRIANGLES_GROUPS,
+    LOD_LEVELS,
+    LOD_TRIANGLES_GROUPS_SIZES,
+    LOD_EBO
+};
+
+struct PrimitiveFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrderMark;
+    std::uint32_t nSections;
+    std::uint32_t reserved;
+};
+
+struct PrimitiveFileSectionEntry
+{
+    std::uint32_t type;
+
+    // Size of every element in the section (1 for raw data).
+    std::uint32_t elementSize;
+
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+// Element of the OPENGL_INFO section.
+struct PrimitiveFileOpenGLInfo
+{
+    std::uint32_t includesUV;
+    std::uint32_t componentsPerVertex;
+};
+
+// Element of the MATERIALS section. Names and texture images are stored in
+// the MATERIALS_DATA section.
+struct PrimitiveFileMaterial
+{
+    float ambientReflectivity[3];
+    float diffuseReflectivity[3];
+    float specularReflectivity[3];
+    float specularExponent;
+    std::uint32_t nameOffset;
+    std::uint32_t nameSize;
+    std::uint32_t includesTexture;
+    std::uint32_t textureOffset;
+    std::uint32_t textureSize;
+    std::uint32_t reserved;
+};
+
+// Element of the TRIANGLES_GROUPS section.
+struct PrimitiveFileTrianglesGroup
+{
+    std::uint32_t firstTriangleIndex;
+    std::uint32_t nTriangles;
+    std::uint32_t includesUV;
+    std::uint32_t materialIndex;
+};
+
+// Element of the (optional) LOD_LEVELS section. The triangles of every level
+// are stored in the LOD_EBO section and the number of triangles of each of
+// its triangles groups in the LOD_TRIANGLES_GROUPS_SIZES section.
+struct PrimitiveFileLODLevel
+{
+    std::uint32_t firstIndex;
+    std::uint32_t nIndices;
+    std::uint32_t firstTrianglesGroupSize;
+    std::uint32_t nTrianglesGroups;
+};
+
+
+/*!
+ * \class PrimitiveFileWriter
+ *
+ * \brief Builds a binary primitive file from its sections.
+ */
+class PrimitiveFileWriter
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        PrimitiveFileWriter() = default;
+        PrimitiveFileWriter( const PrimitiveFileWriter& ) = delete;
+        PrimitiveFileWriter( PrimitiveFileWriter&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~PrimitiveFileWriter() = default;
+
+
+        /***
+         * 3. Sections
+         ***/
+
+        /*! \brief Adds a section with the given raw data. */
+        void addSection( PrimitiveFileSection type,
+                         const void* data,
+                         std::uint64_t size,
+                         std::uint32_t elementSize = 1 );
+
+        /*! \brief Adds a section with the given array. */
+        template < class T >
+        void addArraySection( PrimitiveFileSection type, const std::vector< T >& elements );
+
+
+        /***
+         * 4. File writing
+         ***/
+
+        /*! \brief Writes the header, section table and sections to file. */
+        void writeToFile( const std::string& filePath ) const;
+
+
+        /***
+         * 5. Operators
+         ***/
+        PrimitiveFileWriter& operator = ( const PrimitiveFileWriter& ) = delete;
+        PrimitiveFileWriter& operator = ( PrimitiveFileWriter&& ) = delete;
+
+
+    private:
+        struct Section
+        {
+            PrimitiveFileSectionEntry entry;
+            std::vector< char > data;
+        };
+
+        std::list< Section > sections_;
+};
+
+
+/*!
+ * \class PrimitiveFileReader
+ *
+ * \brief Memory mapping of a binary primitive file, giving access to its
+ * sections without parsing them.
+ */
+class PrimitiveFileReader
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*!
+         * \brief Maps the given file and validates its header and section
+         * table.
+         * \throw std::runtime_error if the file isn't a valid binary
+         * primitive file.
+         */
+        PrimitiveFileReader( const std::string& filePath );
+        PrimitiveFileReader() = delete;
+        PrimitiveFileReader( const PrimitiveFileReader& ) = delete;
+        PrimitiveFileReader( PrimitiveFileReader&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~PrimitiveFileReader() = default;
+
+
+        /***
+         * 3. Getters
+         ***/
+
+        /*!
+         * \brief Returns true if the given file is a binary primitive file
+         * (false for primitive files in the old text format).
+         */
+        static bool isPrimitiveFile( const std::string& filePath );
+
+        bool hasSection( PrimitiveFileSection type ) const;
+
+        /*!
+         * \brief Returns a pointer to the data of the given section and its
+         * size, or nullptr if the file doesn't have such section.
+         */
+        const char* sectionData( PrimitiveFileSection type, std::uint64_t& size ) const;
+
+        /*!
+         * \brief Returns a pointer to the array in the given section and
+         * its number of elements (0 if the file doesn't have such section).
+         */
+        template < class T >
+        const T* sectionArray( PrimitiveFileSection type, std::uint64_t& nElements ) const;
+
+        /*!
+         * \brief Copies the array in the given section into the given
+         * vector.
+         */
+        template < class T >
+        void readArraySection( PrimitiveFileSection type, std::vector< T >& elements ) const;
+
+        /*! \brief Returns the given section as a string. */
+        std::string readStringSection( PrimitiveFileSection type ) const;
+
+
+        /***
+         * 4. Operators
+         ***/
+        PrimitiveFileReader& operator = ( const PrimitiveFileReader& ) = delete;
+        PrimitiveFileReader& operator = ( PrimitiveFileReader&& ) = delete;
+
+
+    private:
+        /***
+         * 5. Auxiliar methods
+         ***/
+        const PrimitiveFileSectionEntry* findSection( PrimitiveFileSection type ) const;
+
+
+        /***
+         * Attributes
+         ***/
+        const std::string filePath_;
+        FileViewConstPtr fileView_;
+        const PrimitiveFileSectionEntry* sectionsTable_;
+        std::uint32_t nSections_;
+};
+
+
+/***
+ * PrimitiveFileWriter - 3. Sections
+ ***/
+
+template < class T >
+void PrimitiveFileWriter::addArraySection( PrimitiveFileSection type, const std::vector< T >& elements )
+{
+    addSection( type, elements.data(), elements.size() * sizeof( T ), sizeof( T ) );
+}
+
+
+/***
+ * PrimitiveFileReader - 3. Getters
+ ***/
+
+template < class T >
+const T* PrimitiveFileReader::sectionArray( PrimitiveFileSection type, std::uint64_t& nElements ) const
+{
+    const PrimitiveFileSectionEntry* section = findSection( type );
+
+    nElements = 0;
+    if( section == nullptr ){
+        return nullptr;
+    }
+
+    if( ( section->elementSize != sizeof( T ) ) || ( section->size % sizeof( T ) ) ){
+        throw std::runtime_error( "Primitive file [" + filePath_ +
+                                  "] - section (" +
+                                  std::to_string( section->type ) +
+                                  ") has an unexpected element size" );
+    }
+
+    nElements = section->size / sizeof( T );
+    return reinterpret_cast< const T* >( fileView_->data() + section->offset );
+}
+
+
+template < class T >
+void PrimitiveFileReader::readArraySection( PrimitiveFileSection type, std::vector< T >& elements ) const
+{
+    std::uint64_t nElements = 0;
+    const T* array = sectionArray< T >( type, nElements );
+
+    elements.resize( nElements );
+    if( nElements ){
+        std::memcpy( elements.data(), array, nElements * sizeof( T ) );
+    }
+}
+
+} // namespace como
+
+#endif // PRIMITIVE_FILE_HPP
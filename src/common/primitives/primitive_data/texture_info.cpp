@@ -38,6 +38,11 @@ TextureInfo::TextureInfo( std::ifstream &file, unsigned int nBytes )
 }
 
 
+TextureInfo::TextureInfo( const char* data, unsigned int nBytes ) :
+    imageFileData( data, nBytes )
+{}
+
+
 /***
  * 2. File loading
  ***/
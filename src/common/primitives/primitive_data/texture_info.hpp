@@ -35,6 +35,7 @@ struct TextureInfo {
      ***/
     TextureInfo( const std::string& filePath );
     TextureInfo( std::ifstream& file, unsigned int nBytes );
+    TextureInfo( const char* data, unsigned int nBytes );
 
 
     /***
@@ -0,0 +1,255 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "vertex_cache_optimization.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace como {
+
+// Size of the simulated LRU cache.
+const unsigned int VERTEX_CACHE_SIZE = 32;
+
+// Valences above this one are scored as this one.
+const unsigned int MAX_SCORED_VALENCE = 32;
+
+// Vertex score tuning parameters (from Forsyth's article).
+const float CACHE_DECAY_POWER = 1.5f;
+const float LAST_TRIANGLE_SCORE = 0.75f;
+const float VALENCE_BOOST_SCALE = 2.0f;
+const float VALENCE_BOOST_POWER = 0.5f;
+
+const GLuint NO_TRIANGLE = std::numeric_limits< GLuint >::max();
+
+
+/*!
+ * \brief Score of a vertex given its position in the cache (-1 if it's not
+ * there) and the number of triangles using it which haven't been output
+ * yet.
+ */
+static float computeVertexScore( int cachePosition, unsigned int nRemainingTriangles )
+{
+    float score = 0.0f;
+
+    if( !nRemainingTriangles ){
+        // Vertex not used anymore.
+        return -1.0f;
+    }
+
+    if( cachePosition >= 0 ){
+        if( cachePosition < 3 ){
+            // Vertex used by the last triangle. Its score is fixed so
+            // triangles sharing an edge with it aren't favoured too much.
+            score = LAST_TRIANGLE_SCORE;
+        }else{
+            const float scaler = 1.0f / ( VERTEX_CACHE_SIZE - 3 );
+            score = std::pow( 1.0f - ( cachePosition - 3 ) * scaler, CACHE_DECAY_POWER );
+        }
+    }
+
+    // Boost vertices with few triangles left, so lone triangles are
+    // output instead of being left behind.
+    score += VALENCE_BOOST_SCALE * std::pow( static_cast< float >( nRemainingTriangles ), -VALENCE_BOOST_POWER );
+
+    return score;
+}
+
+
+void optimizeVertexCache( GLuint* indices, unsigned int nIndices, unsigned int nVertices )
+{
+    const unsigned int nTriangles = nIndices / 3;
+
+    if( nTriangles < 2 ){
+        return;
+    }
+
+    // Precompute vertex scores by cache position and valence.
+    float scoresTable[VERTEX_CACHE_SIZE + 1][MAX_SCORED_VALENCE + 1];
+    for( unsigned int i = 0; i <= VERTEX_CACHE_SIZE; i++ ){
+        for( unsigned int j = 0; j <= MAX_SCORED_VALENCE; j++ ){
+            scoresTable[i][j] = computeVertexScore( static_cast< int >( i ) - 1, j );
+        }
+    }
+
+    // Triangles using each vertex, as a compact adjacency list. Only the
+    // first nRemainingTriangles[v] entries of a vertex are triangles not
+    // output yet.
+    std::vector< unsigned int > nRemainingTriangles( nVertices, 0 );
+    std::vector< unsigned int > firstAdjacentTriangle( nVertices + 1, 0 );
+    std::vector< GLuint > adjacentTriangles( nTriangles * 3 );
+
+    for( unsigned int i = 0; i < nTriangles * 3; i++ ){
+        nRemainingTriangles[indices[i]]++;
+    }
+    for( unsigned int v = 0; v < nVertices; v++ ){
+        firstAdjacentTriangle[v+1] = firstAdjacentTriangle[v] + nRemainingTriangles[v];
+        nRemainingTriangles[v] = 0;
+    }
+    for( unsigned int i = 0; i < nTriangles * 3; i++ ){
+        const GLuint v = indices[i];
+        adjacentTriangles[firstAdjacentTriangle[v] + nRemainingTriangles[v]] = i / 3;
+        nRemainingTriangles[v]++;
+    }
+
+    auto vertexScore = [&]( GLuint v, int cachePosition ){
+        const unsigned int valence =
+                std::min( nRemainingTriangles[v], MAX_SCORED_VALENCE );
+        return scoresTable[cachePosition + 1][valence];
+    };
+
+    std::vector< int > cachePositions( nVertices, -1 );
+    std::vector< float > verticesScores( nVertices );
+    for( unsigned int v = 0; v < nVertices; v++ ){
+        verticesScores[v] = vertexScore( v, -1 );
+    }
+
+    std::vector< float > trianglesScores( nTriangles );
+    std::vector< bool > triangleOutput( nTriangles, false );
+    GLuint bestTriangle = 0;
+    for( unsigned int t = 0; t < nTriangles; t++ ){
+        trianglesScores[t] =
+                verticesScores[indices[3*t]] +
+                verticesScores[indices[3*t+1]] +
+                verticesScores[indices[3*t+2]];
+        if( trianglesScores[t] > trianglesScores[bestTriangle] ){
+            bestTriangle = t;
+        }
+    }
+
+    std::vector< GLuint > cache;
+    std::vector< GLuint > newCache;
+    std::vector< GLuint > outputIndices( nTriangles * 3 );
+    cache.reserve( VERTEX_CACHE_SIZE + 3 );
+    newCache.reserve( VERTEX_CACHE_SIZE + 3 );
+    unsigned int nextUnvisitedTriangle = 0;
+
+    for( unsigned int nOutputTriangles = 0; nOutputTriangles < nTriangles; nOutputTriangles++ ){
+        if( bestTriangle == NO_TRIANGLE ){
+            // None of the cached vertices have triangles left. Continue with
+            // the next triangle not output yet.
+            while( triangleOutput[nextUnvisitedTriangle] ){
+                nextUnvisitedTriangle++;
+            }
+            bestTriangle = nextUnvisitedTriangle;
+        }
+
+        const GLuint* triangle = &indices[3 * bestTriangle];
+        triangleOutput[bestTriangle] = true;
+        newCache.clear();
+
+        for( unsigned int i = 0; i < 3; i++ ){
+            const GLuint v = triangle[i];
+            outputIndices[3 * nOutputTriangles + i] = v;
+
+            // Remove the triangle from the vertex's remaining ones.
+            GLuint* vertexTriangles = &adjacentTriangles[firstAdjacentTriangle[v]];
+            for( unsigned int j = 0; j < nRemainingTriangles[v]; j++ ){
+                if( vertexTriangles[j] == bestTriangle ){
+                    vertexTriangles[j] = vertexTriangles[nRemainingTriangles[v] - 1];
+                    nRemainingTriangles[v]--;
+                    break;
+                }
+            }
+
+            // The triangle's vertices go to the front of the cache.
+            bool alreadyCached = false;
+            for( GLuint cachedVertex : newCache ){
+                alreadyCached = alreadyCached || ( cachedVertex == v );
+            }
+            if( !alreadyCached ){
+                newCache.push_back( v );
+            }
+        }
+
+        for( GLuint v : cache ){
+            if( ( v != triangle[0] ) && ( v != triangle[1] ) && ( v != triangle[2] ) ){
+                newCache.push_back( v );
+            }
+        }
+
+        // Update the scores of the vertices in (or just evicted from) the
+        // cache and of their triangles, looking for the next best one.
+        bestTriangle = NO_TRIANGLE;
+        float bestTriangleScore = -1.0f;
+
+        for( unsigned int i = 0; i < newCache.size(); i++ ){
+            const GLuint v = newCache[i];
+            cachePositions[v] = ( i < VERTEX_CACHE_SIZE ) ? static_cast< int >( i ) : -1;
+            verticesScores[v] = vertexScore( v, cachePositions[v] );
+        }
+
+        for( GLuint v : newCache ){
+            const GLuint* vertexTriangles = &adjacentTriangles[firstAdjacentTriangle[v]];
+
+            for( unsigned int j = 0; j < nRemainingTriangles[v]; j++ ){
+                const GLuint t = vertexTriangles[j];
+
+                trianglesScores[t] =
+                        verticesScores[indices[3*t]] +
+                        verticesScores[indices[3*t+1]] +
+                        verticesScores[indices[3*t+2]];
+                if( trianglesScores[t] > bestTriangleScore ){
+                    bestTriangleScore = trianglesScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if( newCache.size() > VERTEX_CACHE_SIZE ){
+            newCache.resize( VERTEX_CACHE_SIZE );
+        }
+        cache.swap( newCache );
+    }
+
+    std::copy( outputIndices.begin(), outputIndices.end(), indices );
+}
+
+
+void reorderVerticesByFirstUse( GLuint* indices, unsigned int nIndices, GLFloatBuffer& vertexData, unsigned int componentsPerVertex )
+{
+    const unsigned int nVertices = vertexData.size() / componentsPerVertex;
+    const GLuint UNUSED_VERTEX = std::numeric_limits< GLuint >::max();
+    std::vector< GLuint > newVertexIndices( nVertices, UNUSED_VERTEX );
+    GLuint nextVertexIndex = 0;
+
+    for( unsigned int i = 0; i < nIndices; i++ ){
+        if( newVertexIndices[indices[i]] == UNUSED_VERTEX ){
+            newVertexIndices[indices[i]] = nextVertexIndex++;
+        }
+        indices[i] = newVertexIndices[indices[i]];
+    }
+
+    // Vertices not referenced at all go to the end.
+    for( GLuint& newVertexIndex : newVertexIndices ){
+        if( newVertexIndex == UNUSED_VERTEX ){
+            newVertexIndex = nextVertexIndex++;
+        }
+    }
+
+    GLFloatBuffer reorderedVertexData( vertexData.size() );
+    for( unsigned int v = 0; v < nVertices; v++ ){
+        std::copy( vertexData.begin() + v * componentsPerVertex,
+                   vertexData.begin() + ( v + 1 ) * componentsPerVertex,
+                   reorderedVertexData.begin() + newVertexIndices[v] * componentsPerVertex );
+    }
+    vertexData.swap( reorderedVertexData );
+}
+
+} // namespace como
@@ -0,0 +1,47 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef VERTEX_CACHE_OPTIMIZATION_HPP
+#define VERTEX_CACHE_OPTIMIZATION_HPP
+
+#include "mesh_opengl_data.hpp"
+
+namespace como {
+
+/*!
+ * \brief Reorder the given triangles for the GPU's post-transform vertex
+ * cache, following Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+ * \param indices triangle list to be reordered in place.
+ * \param nIndices number of indices (three per triangle).
+ * \param nVertices number of vertices referenced by indices.
+ */
+void optimizeVertexCache( GLuint* indices, unsigned int nIndices, unsigned int nVertices );
+
+/*!
+ * \brief Renumber the vertices in the order they are first referenced by
+ * the given indices, so vertices are fetched sequentially.
+ * \param indices triangle list whose indices are renumbered in place.
+ * \param nIndices number of indices.
+ * \param vertexData interleaved vertex data to be reordered.
+ * \param componentsPerVertex number of floats per vertex in vertexData.
+ */
+void reorderVerticesByFirstUse( GLuint* indices, unsigned int nIndices, GLFloatBuffer& vertexData, unsigned int componentsPerVertex );
+
+} // namespace como
+
+#endif // VERTEX_CACHE_OPTIMIZATION_HPP
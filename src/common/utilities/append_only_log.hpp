@@ -0,0 +1,274 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef APPEND_ONLY_LOG_HPP
+#define APPEND_ONLY_LOG_HPP
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace como {
+
+/*!
+ * \class AppendOnlyLog
+ *
+ * \brief Segmented, append-only sequence of elements with O(1) access by
+ * index.
+ *
+ * Elements are stored in fixed-size chunks that are never moved nor
+ * reallocated, and the number of elements is published through an atomic
+ * counter. This way, a reader can access every element whose index is lower
+ * than size() without any lock, even while a writer is appending new
+ * elements.
+ *
+ * The chunks directory is a ring: the slots of the chunks freed by
+ * discardBefore() are reused by the following ones. The log can therefore
+ * hold up to CHUNK_SIZE * MAX_CHUNKS elements not discarded yet (16.7M
+ * with the default values), while the total number of elements appended
+ * during the log's life is only bounded by its 32 bits indices (~4.29G).
+ *
+ * IMPORTANT: Only one thread at a time may call append(). Serializing the
+ * writers is this class user's responsability.
+ * \tparam T type of the elements stored in the log.
+ * \tparam CHUNK_SIZE number of elements per chunk.
+ * \tparam MAX_CHUNKS maximum number of chunks not discarded at a time.
+ */
+template < class T, std::uint32_t CHUNK_SIZE = 4096, std::uint32_t MAX_CHUNKS = 4096 >
+class AppendOnlyLog
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*! \brief Constructs an empty log. */
+        AppendOnlyLog();
+
+        /*! \brief Copy constructor */
+        AppendOnlyLog( const AppendOnlyLog& ) = delete;
+
+        /*! \brief Move constructor */
+        AppendOnlyLog( AppendOnlyLog&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+
+        /*! \brief Destructor. Frees every chunk in the log. */
+        ~AppendOnlyLog();
+
+
+        /***
+         * 3. Getters
+         ***/
+
+        /*! \brief Returns the number of elements published in the log. */
+        std::uint32_t size() const;
+
+        /*!
+         * \brief Returns the element with the given index.
+         * \param index index of the element. It must be lower than size().
+         */
+        const T& at( std::uint32_t index ) const;
+
+
+        /***
+         * 4. Log modification
+         ***/
+
+        /*!
+         * \brief Appends the given element to the log and publish it to the
+         * readers.
+         * \throw std::runtime_error if the log already holds
+         * CHUNK_SIZE * MAX_CHUNKS elements not discarded, or if the 32 bits
+         * indices are exhausted.
+         */
+        void append( T element );
+
+        /*!
+         * \brief Frees every chunk whose elements all have an index lower
+         * than the given one.
+         *
+         * Accessing a discarded element is undefined behaviour, so the
+         * caller must ensure that no reader will access an index lower than
+         * firstIndex anymore. Like append(), this method must not be called
+         * concurrently with other writers.
+         * \param firstIndex index of the first element which must be kept.
+         */
+        void discardBefore( std::uint32_t firstIndex );
+
+
+        /***
+         * 5. Operators
+         ***/
+
+        /*! \brief Returns the element with the given index (see at()). */
+        const T& operator [] ( std::uint32_t index ) const;
+
+        /*! \brief Copy assignment operator */
+        AppendOnlyLog& operator = ( const AppendOnlyLog& ) = delete;
+
+        /*! \brief Move assignment operator */
+        AppendOnlyLog& operator = ( AppendOnlyLog&& ) = delete;
+
+
+    private:
+        typedef std::array< T, CHUNK_SIZE > Chunk;
+
+        /*! \brief Returns the directory slot of the chunk with the given index */
+        static std::uint32_t chunkSlot( std::uint32_t chunkIndex );
+
+        /*!
+         * Chunks directory (a ring indexed by chunkSlot()). Its size is fixed
+         * so it is never reallocated
+         */
+        std::unique_ptr< std::atomic< Chunk* >[] > chunks_;
+
+        /*! Number of elements published to the readers */
+        std::atomic< std::uint32_t > size_;
+
+        /*! Index of the first chunk not discarded yet */
+        std::uint32_t firstChunk_;
+};
+
+
+/***
+ * 1. Construction
+ ***/
+
+template < class T, std::uint32_t CHUNK_SIZE, std::uint32_t MAX_CHUNKS >
+AppendOnlyLog< T, CHUNK_SIZE, MAX_CHUNKS >::AppendOnlyLog() :
+    chunks_( new std::atomic< Chunk* >[MAX_CHUNKS] ),
+    size_( 0 ),
+    firstChunk_( 0 )
+{
+    for( std::uint32_t i = 0; i < MAX_CHUNKS; i++ ){
+        chunks_[i].store( nullptr, std::memory_order_relaxed );
+    }
+}
+
+
+/***
+ * 2. Destruction
+ ***/
+
+template < class T, std::uint32_t CHUNK_SIZE, std::uint32_t MAX_CHUNKS >
+AppendOnlyLog< T, CHUNK_SIZE, MAX_CHUNKS >::~AppendOnlyLog()
+{
+    for( std::uint32_t i = 0; i < MAX_CHUNKS; i++ ){
+        delete chunks_[i].load( std::memory_order_relaxed );
+    }
+}
+
+
+/***
+ * 3. Getters
+ ***/
+
+template < class T, std::uint32_t CHUNK_SIZE, std::uint32_t MAX_CHUNKS >
+std::uint32_t AppendOnlyLog< T, CHUNK_SIZE, MAX_CHUNKS >::size() const
+{
+    return size_.load( std::memory_order_acquire );
+}
+
+
+template < class T, std::uint32_t CHUNK_SIZE, std::uint32_t MAX_CHUNKS >
+const T& AppendOnlyLog< T, CHUNK_SIZE, MAX_CHUNKS >::at( std::uint32_t index ) const
+{
+    // The element was published (size_ acquired by the caller) after its
+    // chunk was, so a relaxed load is enough here.
+    return ( *( chunks_[chunkSlot( index / CHUNK_SIZE )].load( std::memory_order_relaxed ) ) )[index % CHUNK_SIZE];
+}
+
+
+/***
+ * 4. Log modification
+ ***/
+
+template < class T, std::uint32_t CHUNK_SIZE, std::uint32_t MAX_CHUNKS >
+void AppendOnlyLog< T, CHUNK_SIZE, MAX_CHUNKS >::append( T element )
+{
+    const std::uint32_t index = size_.load( std::memory_order_relaxed );
+    const std::uint32_t chunkIndex = index / CHUNK_SIZE;
+
+    if( index == std::numeric_limits< std::uint32_t >::max() ){
+        throw std::runtime_error( "AppendOnlyLog::append() - Log indices exhausted" );
+    }
+
+    // Allocate a new chunk when the previous one is full, reusing the slot
+    // of a discarded chunk.
+    if( !( index % CHUNK_SIZE ) ){
+        if( ( chunkIndex - firstChunk_ ) >= MAX_CHUNKS ){
+            throw std::runtime_error( "AppendOnlyLog::append() - Log is full" );
+        }
+        chunks_[chunkSlot( chunkIndex )].store( new Chunk, std::memory_order_relaxed );
+    }
+
+    ( *( chunks_[chunkSlot( chunkIndex )].load( std::memory_order_relaxed ) ) )[index % CHUNK_SIZE] = std::move( element );
+
+    // Publish the new element to the readers.
+    size_.store( index + 1, std::memory_order_release );
+}
+
+
+template < class T, std::uint32_t CHUNK_SIZE, std::uint32_t MAX_CHUNKS >
+void AppendOnlyLog< T, CHUNK_SIZE, MAX_CHUNKS >::discardBefore( std::uint32_t firstIndex )
+{
+    const std::uint32_t size = size_.load( std::memory_order_relaxed );
+
+    if( firstIndex > size ){
+        firstIndex = size;
+    }
+
+    // Only the chunks lying entirely below firstIndex are freed.
+    while( firstChunk_ < ( firstIndex / CHUNK_SIZE ) ){
+        delete chunks_[chunkSlot( firstChunk_ )].exchange( nullptr, std::memory_order_relaxed );
+        firstChunk_++;
+    }
+}
+
+
+/***
+ * 5. Operators
+ ***/
+
+template < class T, std::uint32_t CHUNK_SIZE, std::uint32_t MAX_CHUNKS >
+const T& AppendOnlyLog< T, CHUNK_SIZE, MAX_CHUNKS >::operator [] ( std::uint32_t index ) const
+{
+    return at( index );
+}
+
+
+/***
+ * 6. Auxiliar methods
+ ***/
+
+template < class T, std::uint32_t CHUNK_SIZE, std::uint32_t MAX_CHUNKS >
+std::uint32_t AppendOnlyLog< T, CHUNK_SIZE, MAX_CHUNKS >::chunkSlot( std::uint32_t chunkIndex )
+{
+    return chunkIndex % MAX_CHUNKS;
+}
+
+} // namespace como
+
+#endif // APPEND_ONLY_LOG_HPP
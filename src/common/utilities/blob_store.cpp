@@ -0,0 +1,174 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "blob_store.hpp"
+#include <common/utilities/sha1.hpp>
+#include <common/exceptions/file_not_open_exception.hpp>
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace como {
+
+BlobHash computeFileHash( const std::string& filePath )
+{
+    SHA1 sha1;
+    std::vector< char > buffer( 64 * 1024 );
+
+    std::ifstream file( filePath.c_str(), std::ios_base::in | std::ios_base::binary );
+    if( !file.is_open() ){
+        throw FileNotOpenException( filePath );
+    }
+
+    while( file ){
+        file.read( buffer.data(), buffer.size() );
+        sha1.processBytes( buffer.data(), static_cast< std::size_t >( file.gcount() ) );
+    }
+
+    return sha1.getDigest();
+}
+
+
+BlobHash computeDataHash( const void* data, std::size_t size )
+{
+    SHA1 sha1;
+
+    sha1.processBytes( data, size );
+
+    return sha1.getDigest();
+}
+
+
+std::string blobHashToString( const BlobHash& hash )
+{
+    char hashStr[41] = {0};
+
+    for( unsigned int i = 0; i < hash.size(); i++ ){
+        sprintf( &hashStr[8*i], "%08x", hash[i] );
+    }
+
+    return hashStr;
+}
+
+
+/***
+ * 1. Construction
+ ***/
+
+BlobStore::BlobStore( const std::string& dirPath ) :
+    dirPath_( dirPath )
+{
+    boost::filesystem::create_directories( dirPath_ );
+
+    // Index the blobs stored in previous sessions. Their file names are
+    // their hashes.
+    boost::filesystem::directory_iterator fileIterator( dirPath_ );
+    for( ; fileIterator != boost::filesystem::directory_iterator(); fileIterator++ ){
+        const std::string fileName = fileIterator->path().filename().string();
+        BlobHash hash;
+
+        if( fileName.size() == 40 &&
+            sscanf( fileName.c_str(), "%08x%08x%08x%08x%08x",
+                    &hash[0], &hash[1], &hash[2], &hash[3], &hash[4] ) == 5 ){
+            blobs_.insert( hash );
+        }
+    }
+}
+
+
+/***
+ * 3. Getters
+ ***/
+
+bool BlobStore::contains( const BlobHash& hash ) const
+{
+    LOCK
+    return blobs_.count( hash ) != 0;
+}
+
+
+std::set< BlobHash > BlobStore::blobHashes() const
+{
+    LOCK
+    return blobs_;
+}
+
+
+/***
+ * 4. Blobs management
+ ***/
+
+void BlobStore::storeFile( const BlobHash& hash, const std::string& filePath )
+{
+    LOCK
+
+    if( blobs_.count( hash ) ){
+        return;
+    }
+
+    if( computeFileHash( filePath ) != hash ){
+        throw std::runtime_error( std::string( "ERROR storing blob: contents of file [" ) +
+                                  filePath +
+                                  "] don't match hash [" +
+                                  blobHashToString( hash ) +
+                                  "]" );
+    }
+
+    // Copy to a temporary file first, so an interrupted copy never leaves a
+    // corrupted blob behind.
+    const std::string tmpBlobPath = blobPath( hash ) + ".tmp";
+    boost::filesystem::copy_file( filePath,
+                                  tmpBlobPath,
+                                  boost::filesystem::copy_option::overwrite_if_exists );
+    boost::filesystem::rename( tmpBlobPath, blobPath( hash ) );
+
+    blobs_.insert( hash );
+}
+
+
+void BlobStore::retrieveFile( const BlobHash& hash, const std::string& filePath ) const
+{
+    LOCK
+
+    if( !blobs_.count( hash ) ){
+        throw std::runtime_error( std::string( "ERROR retrieving blob [" ) +
+                                  blobHashToString( hash ) +
+                                  "]: not in store" );
+    }
+
+    // Copy to a temporary file first, so the views of a previous file with
+    // the same path (see FileView) aren't truncated.
+    const std::string tmpFilePath = filePath + ".tmp";
+    boost::filesystem::copy_file( blobPath( hash ),
+                                  tmpFilePath,
+                                  boost::filesystem::copy_option::overwrite_if_exists );
+    boost::filesystem::rename( tmpFilePath, filePath );
+}
+
+
+/***
+ * 6. Auxiliar methods
+ ***/
+
+std::string BlobStore::blobPath( const BlobHash& hash ) const
+{
+    return dirPath_ + "/" + blobHashToString( hash );
+}
+
+} // namespace como
@@ -0,0 +1,129 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef BLOB_STORE_HPP
+#define BLOB_STORE_HPP
+
+#include <common/utilities/lockable.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace como {
+
+/*! Content hash (SHA-1) identifying a blob. */
+typedef std::array< std::uint32_t, 5 > BlobHash;
+
+/*! \brief Computes the content hash of the given file. */
+BlobHash computeFileHash( const std::string& filePath );
+
+/*! \brief Computes the content hash of the given data. */
+BlobHash computeDataHash( const void* data, std::size_t size );
+
+/*! \brief Returns the hexadecimal representation of the given hash. */
+std::string blobHashToString( const BlobHash& hash );
+
+
+/*!
+ * \class BlobStore
+ *
+ * \brief Persistent on-disk store of files indexed by their contents' hash,
+ * so identical files are transferred only once.
+ */
+class BlobStore : public Lockable
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*!
+         * \brief Constructs a blob store in the given directory (created if
+         * it doesn't exist) and indexes the blobs already in it.
+         */
+        BlobStore( const std::string& dirPath );
+        BlobStore() = delete;
+        BlobStore( const BlobStore& ) = delete;
+        BlobStore( BlobStore&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~BlobStore() = default;
+
+
+        /***
+         * 3. Getters
+         ***/
+
+        /*! \brief Returns true if the store contains the given blob. */
+        bool contains( const BlobHash& hash ) const;
+
+        /*! \brief Returns the hashes of all the blobs in the store. */
+        std::set< BlobHash > blobHashes() const;
+
+
+        /***
+         * 4. Blobs management
+         ***/
+
+        /*!
+         * \brief Copies the given file into the store (if it isn't there
+         * yet).
+         * \throw std::runtime_error if the file contents don't match the
+         * given hash.
+         */
+        void storeFile( const BlobHash& hash, const std::string& filePath );
+
+        /*!
+         * \brief Copies the given blob to the given file path.
+         * \throw std::runtime_error if the store doesn't contain the blob.
+         */
+        void retrieveFile( const BlobHash& hash, const std::string& filePath ) const;
+
+
+        /***
+         * 5. Operators
+         ***/
+        BlobStore& operator = ( const BlobStore& ) = delete;
+        BlobStore& operator = ( BlobStore&& ) = delete;
+
+
+    private:
+        /***
+         * 6. Auxiliar methods
+         ***/
+        std::string blobPath( const BlobHash& hash ) const;
+
+
+        /***
+         * Attributes
+         ***/
+        const std::string dirPath_;
+        std::set< BlobHash > blobs_;
+};
+
+typedef std::shared_ptr< BlobStore > BlobStorePtr;
+
+} // namespace como
+
+#endif // BLOB_STORE_HPP
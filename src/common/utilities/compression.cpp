@@ -0,0 +1,156 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "compression.hpp"
+#include <stdexcept>
+#include <string>
+#include <zlib.h>
+
+namespace como {
+
+bool compressData( const char* data, std::size_t size, std::vector< char >& buffer, std::size_t offset )
+{
+    uLongf compressedSize = compressBound( size );
+
+    buffer.resize( offset + compressedSize );
+
+    if( compress2( reinterpret_cast< Bytef* >( &buffer[offset] ),
+                   &compressedSize,
+                   reinterpret_cast< const Bytef* >( data ),
+                   size,
+                   Z_BEST_SPEED ) != Z_OK ){
+        return false;
+    }
+
+    buffer.resize( offset + compressedSize );
+
+    return compressedSize < size;
+}
+
+
+void decompressData( const char* compressedData, std::size_t compressedSize, char* data, std::size_t size )
+{
+    uLongf decompressedSize = size;
+
+    const int result = uncompress( reinterpret_cast< Bytef* >( data ),
+                                   &decompressedSize,
+                                   reinterpret_cast< const Bytef* >( compressedData ),
+                                   compressedSize );
+
+    if( ( result != Z_OK ) || ( decompressedSize != size ) ){
+        throw std::runtime_error( std::string( "ERROR: Couldn't decompress data (zlib error " ) +
+                                  std::to_string( result ) +
+                                  ")" );
+    }
+}
+
+
+/***
+ * Compressed streams assembly
+ ***/
+
+bool compressSegment( const char* data, std::size_t size, std::vector< char >& segment )
+{
+    z_stream stream;
+    int result;
+
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+
+    // Raw deflate (no zlib header nor trailer), so the segment can be
+    // placed anywhere in a stream.
+    if( deflateInit2( &stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK ){
+        return false;
+    }
+
+    // Leave room for the empty stored block appended by the sync flush.
+    segment.resize( deflateBound( &stream, size ) + STORED_BLOCK_HEADER_SIZE + 1 );
+
+    stream.next_in = reinterpret_cast< Bytef* >( const_cast< char* >( data ) );
+    stream.avail_in = size;
+    stream.next_out = reinterpret_cast< Bytef* >( segment.data() );
+    stream.avail_out = segment.size();
+
+    // A sync flush ends the segment at a byte boundary without a final
+    // block, so other blocks can follow it.
+    result = deflate( &stream, Z_SYNC_FLUSH );
+    segment.resize( segment.size() - stream.avail_out );
+    deflateEnd( &stream );
+
+    return ( result == Z_OK ) && !stream.avail_in && ( segment.size() < size );
+}
+
+
+std::uint32_t checksum( const char* data, std::size_t size )
+{
+    return adler32( adler32( 0, Z_NULL, 0 ),
+                    reinterpret_cast< const Bytef* >( data ),
+                    size );
+}
+
+
+std::uint32_t combineChecksums( std::uint32_t firstChecksum,
+                                std::uint32_t secondChecksum,
+                                std::size_t secondSize )
+{
+    return adler32_combine( firstChecksum, secondChecksum, secondSize );
+}
+
+
+char* packStreamHeader( char* buffer )
+{
+    // Deflate method with a 32K window and the fastest level.
+    buffer[0] = 0x78;
+    buffer[1] = 0x01;
+
+    return buffer + STREAM_HEADER_SIZE;
+}
+
+
+char* packStoredBlockHeader( char* buffer, std::size_t blockSize )
+{
+    // Non final stored block (the remaining bits of the first byte are
+    // padding), followed by its size and the size's one's complement,
+    // both little endian.
+    buffer[0] = 0x00;
+    buffer[1] = static_cast< char >( blockSize & 0xFF );
+    buffer[2] = static_cast< char >( ( blockSize >> 8 ) & 0xFF );
+    buffer[3] = static_cast< char >( ~blockSize & 0xFF );
+    buffer[4] = static_cast< char >( ( ~blockSize >> 8 ) & 0xFF );
+
+    return buffer + STORED_BLOCK_HEADER_SIZE;
+}
+
+
+char* packStreamTrailer( char* buffer, std::uint32_t dataChecksum )
+{
+    // Final empty block with fixed Huffman codes.
+    buffer[0] = 0x03;
+    buffer[1] = 0x00;
+
+    // Checksum of the uncompressed data, big endian.
+    buffer[2] = static_cast< char >( ( dataChecksum >> 24 ) & 0xFF );
+    buffer[3] = static_cast< char >( ( dataChecksum >> 16 ) & 0xFF );
+    buffer[4] = static_cast< char >( ( dataChecksum >> 8 ) & 0xFF );
+    buffer[5] = static_cast< char >( dataChecksum & 0xFF );
+
+    return buffer + STREAM_TRAILER_SIZE;
+}
+
+} // namespace como
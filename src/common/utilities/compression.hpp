@@ -0,0 +1,128 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace como {
+
+/*!
+ * \brief Compress the given data with a fast compressor (zlib's fastest
+ * level).
+ * \param data data to be compressed.
+ * \param size size of the data to be compressed.
+ * \param buffer buffer where the compressed data is written to, starting at
+ * the given offset. The buffer is resized to fit the compressed data.
+ * \param offset offset in buffer where the compressed data starts.
+ * \return true if the compressed data is smaller than the original one, or
+ * false otherwise (in which case the contents of buffer are undefined).
+ */
+bool compressData( const char* data, std::size_t size, std::vector< char >& buffer, std::size_t offset );
+
+/*!
+ * \brief Decompress data compressed with compressData.
+ * \param compressedData compressed data.
+ * \param compressedSize size of the compressed data.
+ * \param data buffer where the decompressed data is written to.
+ * \param size expected size of the decompressed data.
+ * \throw std::runtime_error if the compressed data is malformed or its
+ * decompressed size doesn't match the expected one.
+ */
+void decompressData( const char* compressedData, std::size_t compressedSize, char* data, std::size_t size );
+
+
+/***
+ * Compressed streams assembly
+ *
+ * The output of compressData is a zlib stream, which can also be assembled
+ * from independent segments (raw deflate blocks ending at a byte boundary):
+ * a stream header, the segments and a stream trailer with the checksum of
+ * the whole uncompressed data. This way, data sent to many peers can be
+ * compressed only once and shared among the streams it is sent in.
+ ***/
+
+// Size of the zlib stream header.
+const std::size_t STREAM_HEADER_SIZE = 2;
+
+// Size of the zlib stream trailer (final empty block and checksum).
+const std::size_t STREAM_TRAILER_SIZE = 6;
+
+// Size of the header of a stored (uncompressed) block.
+const std::size_t STORED_BLOCK_HEADER_SIZE = 5;
+
+// Maximum size of the data in a stored block.
+const std::size_t MAX_STORED_BLOCK_SIZE = 65535;
+
+/*!
+ * \brief Compress the given data into an independent segment of a
+ * compressed stream (see packStreamHeader).
+ * \param data data to be compressed.
+ * \param size size of the data to be compressed.
+ * \param segment buffer where the segment is written to. It is resized to
+ * fit the segment.
+ * \return true if the segment is smaller than the original data, or false
+ * otherwise (in which case the contents of segment are undefined).
+ */
+bool compressSegment( const char* data, std::size_t size, std::vector< char >& segment );
+
+/*!
+ * \brief Returns the checksum of the given data, as stored in the trailer of
+ * a compressed stream. The checksum of no data is checksum( nullptr, 0 ).
+ */
+std::uint32_t checksum( const char* data, std::size_t size );
+
+/*!
+ * \brief Returns the checksum of the concatenation of two data given their
+ * checksums.
+ * \param firstChecksum checksum of the first data.
+ * \param secondChecksum checksum of the second data.
+ * \param secondSize size of the second data.
+ */
+std::uint32_t combineChecksums( std::uint32_t firstChecksum,
+                                std::uint32_t secondChecksum,
+                                std::size_t secondSize );
+
+/*!
+ * \brief Packs the header of a compressed stream into the given buffer.
+ * \return a pointer to the first position after the header.
+ */
+char* packStreamHeader( char* buffer );
+
+/*!
+ * \brief Packs the header of a stored block holding the given number of
+ * bytes (at most MAX_STORED_BLOCK_SIZE) into the given buffer. The data of
+ * the block follows its header, uncompressed.
+ * \return a pointer to the first position after the header.
+ */
+char* packStoredBlockHeader( char* buffer, std::size_t blockSize );
+
+/*!
+ * \brief Packs the trailer of a compressed stream into the given buffer.
+ * \param buffer buffer where the trailer is packed into.
+ * \param dataChecksum checksum of the whole uncompressed data.
+ * \return a pointer to the first position after the trailer.
+ */
+char* packStreamTrailer( char* buffer, std::uint32_t dataChecksum );
+
+} // namespace como
+
+#endif // COMPRESSION_HPP
@@ -0,0 +1,114 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "file_view.hpp"
+#include <boost/filesystem.hpp>
+
+namespace como {
+
+std::map< std::string, std::weak_ptr< const FileView > > FileView::views_;
+std::mutex FileView::viewsMutex_;
+
+
+/***
+ * 1. Construction
+ ***/
+
+FileViewConstPtr FileView::open( const std::string& filePath )
+{
+    std::lock_guard< std::mutex > lock( viewsMutex_ );
+
+    FileViewConstPtr view = views_[filePath].lock();
+    if( ( view == nullptr ) || view->isOutdated( filePath ) ){
+        view = FileViewConstPtr( new FileView( filePath ) );
+        views_[filePath] = view;
+    }
+
+    // Forget the views which are no longer alive.
+    for( auto it = views_.begin(); it != views_.end(); ){
+        if( it->second.expired() ){
+            it = views_.erase( it );
+        }else{
+            it++;
+        }
+    }
+
+    return view;
+}
+
+
+FileView::FileView( const std::string& filePath ) :
+    fileSize_( 0 ),
+    lastWriteTime_( 0 )
+{
+    try{
+        fileSize_ = boost::filesystem::file_size( filePath );
+        lastWriteTime_ = boost::filesystem::last_write_time( filePath );
+
+        // Empty files can't be mapped, so leave the region empty.
+        if( fileSize_ > 0 ){
+            fileMapping_ = boost::interprocess::file_mapping( filePath.c_str(), boost::interprocess::read_only );
+            mappedRegion_ = boost::interprocess::mapped_region( fileMapping_, boost::interprocess::read_only );
+        }
+    }catch( std::exception& ex ){
+        throw std::runtime_error( std::string( "ERROR mapping file [" ) +
+                                  filePath +
+                                  "]: " +
+                                  ex.what() );
+    }
+}
+
+
+/***
+ * 3. Getters
+ ***/
+
+const char* FileView::data() const
+{
+    return static_cast< const char* >( mappedRegion_.get_address() );
+}
+
+
+std::uint32_t FileView::size() const
+{
+    return static_cast< std::uint32_t >( mappedRegion_.get_size() );
+}
+
+
+/***
+ * 5. Auxiliar methods
+ ***/
+
+bool FileView::isOutdated( const std::string& filePath ) const
+{
+    boost::system::error_code errorCode;
+
+    const std::uintmax_t fileSize = boost::filesystem::file_size( filePath, errorCode );
+    if( errorCode ){
+        return false;
+    }
+
+    const std::time_t lastWriteTime = boost::filesystem::last_write_time( filePath, errorCode );
+    if( errorCode ){
+        return false;
+    }
+
+    return ( fileSize != fileSize_ ) || ( lastWriteTime != lastWriteTime_ );
+}
+
+} // namespace como
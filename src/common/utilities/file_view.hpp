@@ -0,0 +1,123 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef FILE_VIEW_HPP
+#define FILE_VIEW_HPP
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace como {
+
+class FileView;
+typedef std::shared_ptr< const FileView > FileViewConstPtr;
+
+/*!
+ * \class FileView
+ *
+ * \brief Read-only memory mapping of a whole file. Views are shared: every
+ * request for the same file while a view of it is alive returns that view,
+ * so the file is mapped (and read from disk) only once.
+ *
+ * Mapped files must not be modified in place (write a temporary file and
+ * rename it instead). A file replaced this way gets a new view, while the
+ * previous views keep mapping the old contents.
+ */
+class FileView
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*!
+         * \brief Returns a view of the given file, mapping the file if
+         * there wasn't any view of it already.
+         * \throw std::runtime_error if the file can't be mapped.
+         */
+        static FileViewConstPtr open( const std::string& filePath );
+
+        FileView() = delete;
+        FileView( const FileView& ) = delete;
+        FileView( FileView&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~FileView() = default;
+
+
+        /***
+         * 3. Getters
+         ***/
+        const char* data() const;
+        std::uint32_t size() const;
+
+
+        /***
+         * 4. Operators
+         ***/
+        FileView& operator = ( const FileView& ) = delete;
+        FileView& operator = ( FileView&& ) = delete;
+
+
+    private:
+        FileView( const std::string& filePath );
+
+
+        /***
+         * 5. Auxiliar methods
+         ***/
+
+        /*!
+         * \brief Returns true if the given file was replaced since this
+         * view of it was mapped.
+         */
+        bool isOutdated( const std::string& filePath ) const;
+
+
+        /***
+         * Attributes
+         ***/
+
+        /*! \brief Views alive, indexed by file path. */
+        static std::map< std::string, std::weak_ptr< const FileView > > views_;
+
+        /*! \brief Mutex protecting views_. */
+        static std::mutex viewsMutex_;
+
+        boost::interprocess::file_mapping fileMapping_;
+        boost::interprocess::mapped_region mappedRegion_;
+
+        /*! \brief Size of the file when it was mapped. */
+        std::uintmax_t fileSize_;
+
+        /*! \brief Last write time of the file when it was mapped. */
+        std::time_t lastWriteTime_;
+};
+
+} // namespace como
+
+#endif // FILE_VIEW_HPP
@@ -0,0 +1,120 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "file_writer.hpp"
+
+namespace como {
+
+/***
+ * 1. Construction
+ ***/
+
+FileWriter::FileWriter( LogPtr log ) :
+    log_( log ),
+    nPendingTasks_( 0 ),
+    thread_( &FileWriter::run, this )
+{}
+
+
+/***
+ * 2. Destruction
+ ***/
+
+FileWriter::~FileWriter()
+{
+    tasks_.close();
+    thread_.join();
+}
+
+
+/***
+ * 3. Tasks
+ ***/
+
+void FileWriter::addTask( std::function< void() > task )
+{
+    pushTask( FileTask{ std::string(), std::move( task ) } );
+}
+
+
+void FileWriter::addFileTask( const std::string& filePath,
+                              std::function< void() > task )
+{
+    pushTask( FileTask{ filePath, std::move( task ) } );
+}
+
+
+bool FileWriter::isBeingWritten( const std::string& filePath )
+{
+    std::lock_guard< std::mutex > lock( pendingTasksMutex_ );
+
+    return nPendingFileTasks_.count( filePath ) != 0;
+}
+
+
+void FileWriter::flush()
+{
+    std::unique_lock< std::mutex > lock( pendingTasksMutex_ );
+
+    while( nPendingTasks_ ){
+        pendingTasksCondition_.wait( lock );
+    }
+}
+
+
+/***
+ * 5. Writer thread
+ ***/
+
+void FileWriter::run()
+{
+    FileTask fileTask;
+
+    while( tasks_.waitPop( fileTask ) ){
+        try{
+            fileTask.task();
+        }catch( std::exception& ex ){
+            log_->error( "ERROR writing file: ", ex.what(), "\n" );
+        }
+
+        std::lock_guard< std::mutex > lock( pendingTasksMutex_ );
+        nPendingTasks_--;
+        if( fileTask.filePath != "" && !--nPendingFileTasks_[fileTask.filePath] ){
+            nPendingFileTasks_.erase( fileTask.filePath );
+        }
+        pendingTasksCondition_.notify_all();
+    }
+}
+
+
+/***
+ * 6. Auxiliar methods
+ ***/
+
+void FileWriter::pushTask( FileTask fileTask )
+{
+    std::lock_guard< std::mutex > lock( pendingTasksMutex_ );
+
+    nPendingTasks_++;
+    if( fileTask.filePath != "" ){
+        nPendingFileTasks_[fileTask.filePath]++;
+    }
+    tasks_.push( std::move( fileTask ) );
+}
+
+} // namespace como
@@ -0,0 +1,138 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef FILE_WRITER_HPP
+#define FILE_WRITER_HPP
+
+#include <common/utilities/log.hpp>
+#include <common/utilities/mpsc_queue.hpp>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace como {
+
+/*!
+ * \class FileWriter
+ *
+ * \brief Background thread performing file writes (or any other file
+ * task) in FIFO order, so the threads receiving files don't block on disk.
+ *
+ * The writer keeps track of the files with pending tasks, so its users can
+ * hold back only the work depending on a file still being written.
+ */
+class FileWriter
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        FileWriter( LogPtr log );
+        FileWriter() = delete;
+        FileWriter( const FileWriter& ) = delete;
+        FileWriter( FileWriter&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+
+        /*! \brief Destructor. Performs the pending tasks and stops the thread. */
+        ~FileWriter();
+
+
+        /***
+         * 3. Tasks
+         ***/
+
+        /*! \brief Queues the given task. Its errors are logged. */
+        void addTask( std::function< void() > task );
+
+        /*!
+         * \brief Queues the given task writing the file with the given path.
+         * The file is considered being written until the task is performed.
+         * Its errors are logged.
+         */
+        void addFileTask( const std::string& filePath,
+                          std::function< void() > task );
+
+        /*!
+         * \brief Returns true if there are tasks queued for the file with
+         * the given path and not performed yet.
+         */
+        bool isBeingWritten( const std::string& filePath );
+
+        /*! \brief Waits until every pending task has been performed. */
+        void flush();
+
+
+        /***
+         * 4. Operators
+         ***/
+        FileWriter& operator = ( const FileWriter& ) = delete;
+        FileWriter& operator = ( FileWriter&& ) = delete;
+
+
+    private:
+        /***
+         * 5. Writer thread
+         ***/
+        void run();
+
+
+        /***
+         * 6. Auxiliar methods
+         ***/
+
+        /*! \brief Pending task along with the path of the file it writes. */
+        struct FileTask
+        {
+            std::string filePath;
+            std::function< void() > task;
+        };
+
+        void pushTask( FileTask fileTask );
+
+
+        /***
+         * Attributes
+         ***/
+        LogPtr log_;
+
+        MPSCQueue< FileTask > tasks_;
+
+        /*! Number of tasks queued and not performed yet */
+        unsigned int nPendingTasks_;
+
+        /*! Number of pending tasks for each file being written */
+        std::map< std::string, unsigned int > nPendingFileTasks_;
+        std::mutex pendingTasksMutex_;
+        std::condition_variable pendingTasksCondition_;
+
+        std::thread thread_;
+};
+
+typedef std::shared_ptr< FileWriter > FileWriterPtr;
+
+} // namespace como
+
+#endif // FILE_WRITER_HPP
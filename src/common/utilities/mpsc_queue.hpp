@@ -0,0 +1,252 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace como {
+
+/*!
+ * \class MPSCQueue
+ *
+ * \brief Unbounded multiple producers, single consumer FIFO queue.
+ *
+ * Producers push elements without taking any lock: every push links a new
+ * node with a single atomic exchange. The consumer can block in waitPop()
+ * until an element is available; only parking and waking it up goes
+ * through a mutex.
+ *
+ * IMPORTANT: Only one thread at a time may call tryPop() or waitPop().
+ * \tparam T type of the elements in the queue. It must be default
+ * constructible and movable.
+ */
+template < class T >
+class MPSCQueue
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+
+        /*! \brief Constructs an empty queue. */
+        MPSCQueue();
+
+        /*! \brief Copy constructor */
+        MPSCQueue( const MPSCQueue& ) = delete;
+
+        /*! \brief Move constructor */
+        MPSCQueue( MPSCQueue&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+
+        /*! \brief Destructor. Frees every element still in the queue. */
+        ~MPSCQueue();
+
+
+        /***
+         * 3. Producers
+         ***/
+
+        /*! \brief Pushes the given element at the end of the queue. */
+        void push( T element );
+
+
+        /***
+         * 4. Consumer
+         ***/
+
+        /*!
+         * \brief Pops the element at the front of the queue, if any.
+         * \return true if an element was popped, false otherwise.
+         */
+        bool tryPop( T& element );
+
+        /*!
+         * \brief Pops the element at the front of the queue, waiting for it
+         * if the queue is empty.
+         * \return true if an element was popped, false if the queue was
+         * closed and there are no more elements.
+         */
+        bool waitPop( T& element );
+
+        /*! \brief Wakes up the consumer and makes waitPop() return false once
+         * the queue is empty. */
+        void close();
+
+
+        /***
+         * 5. Operators
+         ***/
+
+        /*! \brief Copy assignment operator */
+        MPSCQueue& operator = ( const MPSCQueue& ) = delete;
+
+        /*! \brief Move assignment operator */
+        MPSCQueue& operator = ( MPSCQueue&& ) = delete;
+
+
+    private:
+        struct Node
+        {
+            std::atomic< Node* > next;
+            T element;
+        };
+
+        /*! Last node in the queue, where producers link new nodes */
+        std::atomic< Node* > head_;
+
+        /*!
+         * Node preceding the first element in the queue. Only accessed by
+         * the consumer.
+         */
+        Node* tail_;
+
+        /*! Number of elements pushed and not popped yet */
+        std::atomic< std::uint32_t > size_;
+
+        /*! True once close() is called */
+        std::atomic< bool > closed_;
+
+        /*! Synchronization for parking the consumer */
+        std::mutex consumerMutex_;
+        std::condition_variable consumerCondition_;
+};
+
+
+/***
+ * 1. Construction
+ ***/
+
+template < class T >
+MPSCQueue< T >::MPSCQueue() :
+    head_( new Node() ),
+    tail_( head_.load( std::memory_order_relaxed ) ),
+    size_( 0 ),
+    closed_( false )
+{
+    tail_->next.store( nullptr, std::memory_order_relaxed );
+}
+
+
+/***
+ * 2. Destruction
+ ***/
+
+template < class T >
+MPSCQueue< T >::~MPSCQueue()
+{
+    while( tail_ != nullptr ){
+        Node* next = tail_->next.load( std::memory_order_relaxed );
+        delete tail_;
+        tail_ = next;
+    }
+}
+
+
+/***
+ * 3. Producers
+ ***/
+
+template < class T >
+void MPSCQueue< T >::push( T element )
+{
+    Node* node = new Node();
+    node->next.store( nullptr, std::memory_order_relaxed );
+    node->element = std::move( element );
+
+    // Make the new node the last one and link the previous last one to it.
+    Node* previousNode = head_.exchange( node, std::memory_order_acq_rel );
+    previousNode->next.store( node, std::memory_order_release );
+
+    // Wake up the consumer only if the queue was empty, as otherwise it
+    // isn't waiting.
+    if( size_.fetch_add( 1, std::memory_order_acq_rel ) == 0 ){
+        std::lock_guard< std::mutex > lock( consumerMutex_ );
+        consumerCondition_.notify_one();
+    }
+}
+
+
+/***
+ * 4. Consumer
+ ***/
+
+template < class T >
+bool MPSCQueue< T >::tryPop( T& element )
+{
+    if( !size_.load( std::memory_order_acquire ) ){
+        return false;
+    }
+
+    // A producer could be between exchanging the head and linking its
+    // node. Wait for the link, which is imminent.
+    Node* next;
+    while( ( next = tail_->next.load( std::memory_order_acquire ) ) == nullptr ){
+        std::this_thread::yield();
+    }
+
+    element = std::move( next->element );
+    delete tail_;
+    tail_ = next;
+
+    size_.fetch_sub( 1, std::memory_order_acq_rel );
+
+    return true;
+}
+
+
+template < class T >
+bool MPSCQueue< T >::waitPop( T& element )
+{
+    while( !tryPop( element ) ){
+        std::unique_lock< std::mutex > lock( consumerMutex_ );
+
+        consumerCondition_.wait( lock, [this](){
+            return size_.load( std::memory_order_acquire ) ||
+                    closed_.load( std::memory_order_acquire );
+        });
+
+        if( !size_.load( std::memory_order_acquire ) ){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+template < class T >
+void MPSCQueue< T >::close()
+{
+    std::lock_guard< std::mutex > lock( consumerMutex_ );
+    closed_.store( true, std::memory_order_release );
+    consumerCondition_.notify_one();
+}
+
+} // namespace como
+
+#endif // MPSC_QUEUE_HPP
@@ -0,0 +1,148 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "sha1.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace como {
+
+/***
+ * 1. Construction
+ ***/
+
+SHA1::SHA1() :
+    state_( {{ 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 }} ),
+    blockSize_( 0 ),
+    size_( 0 )
+{}
+
+
+/***
+ * 3. Hashing
+ ***/
+
+void SHA1::processBytes( const void* data, std::size_t size )
+{
+    const std::uint8_t* bytes = static_cast< const std::uint8_t* >( data );
+
+    size_ += size;
+    while( size ){
+        const std::size_t copiedSize = std::min( size, block_.size() - blockSize_ );
+
+        std::memcpy( &block_[blockSize_], bytes, copiedSize );
+        blockSize_ += copiedSize;
+        bytes += copiedSize;
+        size -= copiedSize;
+
+        if( blockSize_ == block_.size() ){
+            processBlock();
+        }
+    }
+}
+
+
+SHA1::Digest SHA1::getDigest()
+{
+    const std::uint64_t bitsSize = size_ * 8;
+
+    // Pad the data with a 1 bit, zeros and the data size (in bits, big
+    // endian) so it fills a whole number of blocks.
+    block_[blockSize_++] = 0x80;
+    if( blockSize_ > block_.size() - 8 ){
+        while( blockSize_ < block_.size() ){
+            block_[blockSize_++] = 0;
+        }
+        processBlock();
+    }
+    while( blockSize_ < block_.size() - 8 ){
+        block_[blockSize_++] = 0;
+    }
+    for( int i = 7; i >= 0; i-- ){
+        block_[blockSize_++] = static_cast< std::uint8_t >( bitsSize >> ( 8 * i ) );
+    }
+    processBlock();
+
+    return state_;
+}
+
+
+/***
+ * 5. Auxiliar methods
+ ***/
+
+void SHA1::processBlock()
+{
+    std::uint32_t w[80];
+    std::uint32_t a = state_[0];
+    std::uint32_t b = state_[1];
+    std::uint32_t c = state_[2];
+    std::uint32_t d = state_[3];
+    std::uint32_t e = state_[4];
+
+    for( unsigned int i = 0; i < 16; i++ ){
+        w[i] = ( static_cast< std::uint32_t >( block_[4*i] ) << 24 ) |
+                ( static_cast< std::uint32_t >( block_[4*i+1] ) << 16 ) |
+                ( static_cast< std::uint32_t >( block_[4*i+2] ) << 8 ) |
+                static_cast< std::uint32_t >( block_[4*i+3] );
+    }
+    for( unsigned int i = 16; i < 80; i++ ){
+        w[i] = rotateLeft( w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16], 1 );
+    }
+
+    for( unsigned int i = 0; i < 80; i++ ){
+        std::uint32_t f, k;
+
+        if( i < 20 ){
+            f = ( b & c ) | ( ~b & d );
+            k = 0x5A827999;
+        }else if( i < 40 ){
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        }else if( i < 60 ){
+            f = ( b & c ) | ( b & d ) | ( c & d );
+            k = 0x8F1BBCDC;
+        }else{
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+
+        const std::uint32_t temp = rotateLeft( a, 5 ) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotateLeft( b, 30 );
+        b = a;
+        a = temp;
+    }
+
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+
+    blockSize_ = 0;
+}
+
+
+std::uint32_t SHA1::rotateLeft( std::uint32_t value, unsigned int bits )
+{
+    return ( value << bits ) | ( value >> ( 32 - bits ) );
+}
+
+} // namespace como
@@ -0,0 +1,99 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef SHA1_HPP
+#define SHA1_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace como {
+
+/*!
+ * \class SHA1
+ *
+ * \brief Incremental SHA-1 hash (FIPS 180-4), so content hashes don't
+ * depend on the internals of any library.
+ */
+class SHA1
+{
+    public:
+        /*! SHA-1 digest as five 32 bits words (h0 to h4) */
+        typedef std::array< std::uint32_t, 5 > Digest;
+
+
+        /***
+         * 1. Construction
+         ***/
+        SHA1();
+        SHA1( const SHA1& ) = default;
+        SHA1( SHA1&& ) = default;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~SHA1() = default;
+
+
+        /***
+         * 3. Hashing
+         ***/
+
+        /*! \brief Appends the given bytes to the hashed data. */
+        void processBytes( const void* data, std::size_t size );
+
+        /*!
+         * \brief Returns the digest of all the bytes processed so far. No
+         * more bytes can be processed after calling this method.
+         */
+        Digest getDigest();
+
+
+        /***
+         * 4. Operators
+         ***/
+        SHA1& operator = ( const SHA1& ) = default;
+        SHA1& operator = ( SHA1&& ) = default;
+
+
+    private:
+        /***
+         * 5. Auxiliar methods
+         ***/
+        void processBlock();
+        static std::uint32_t rotateLeft( std::uint32_t value, unsigned int bits );
+
+
+        /***
+         * Attributes
+         ***/
+        Digest state_;
+
+        /*! Current (incomplete) 64 bytes block */
+        std::array< std::uint8_t, 64 > block_;
+        std::size_t blockSize_;
+
+        /*! Total number of bytes processed */
+        std::uint64_t size_;
+};
+
+} // namespace como
+
+#endif // SHA1_HPP
@@ -0,0 +1,182 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef TEXT_PARSING_HPP
+#define TEXT_PARSING_HPP
+
+#include <cmath>
+#include <cstdint>
+
+/*!
+ * Allocation-free helpers for parsing text held in memory (ie. in a
+ * memory-mapped file). Every parsing function takes a cursor into the text,
+ * which is advanced past the parsed token only on success. Numbers are
+ * always parsed with '.' as the decimal separator, whatever the locale.
+ */
+
+namespace como {
+
+/*! \brief Advances the cursor past any spaces or tabs. */
+inline void skipBlanks( const char*& it, const char* end )
+{
+    while( ( it < end ) && ( ( *it == ' ' ) || ( *it == '\t' ) ) ){
+        it++;
+    }
+}
+
+
+/*! \brief Returns true if the cursor is at a space or a tab. */
+inline bool atBlank( const char* it, const char* end )
+{
+    return ( it < end ) && ( ( *it == ' ' ) || ( *it == '\t' ) );
+}
+
+
+/*!
+ * \brief Returns true if the text at the cursor starts with the given
+ * word followed by a blank.
+ */
+inline bool startsWithWord( const char* it, const char* end, const char* word )
+{
+    while( *word ){
+        if( ( it >= end ) || ( *it != *word ) ){
+            return false;
+        }
+        it++;
+        word++;
+    }
+
+    return atBlank( it, end );
+}
+
+
+/*! \brief Parses an unsigned 32 bits integer. */
+inline bool parseUint32( const char*& it, const char* end, std::uint32_t& value )
+{
+    const char* cursor = it;
+    std::uint64_t result = 0;
+
+    while( ( cursor < end ) && ( *cursor >= '0' ) && ( *cursor <= '9' ) ){
+        result = result * 10 + static_cast< std::uint64_t >( *cursor - '0' );
+        if( result > UINT32_MAX ){
+            return false;
+        }
+        cursor++;
+    }
+
+    if( cursor == it ){
+        return false;
+    }
+
+    value = static_cast< std::uint32_t >( result );
+    it = cursor;
+    return true;
+}
+
+
+/*!
+ * \brief Parses a float in decimal notation, with an optional sign and
+ * exponent.
+ */
+inline bool parseFloat( const char*& it, const char* end, float& value )
+{
+    // Exact powers of ten representable as doubles.
+    static const double POWERS_OF_TEN[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const std::uint64_t MAX_MANTISSA = 100000000000000000ULL;
+
+    const char* cursor = it;
+    bool negative = false;
+    std::uint64_t mantissa = 0;
+    int exponent = 0;
+    bool digitsFound = false;
+
+    if( ( cursor < end ) && ( ( *cursor == '-' ) || ( *cursor == '+' ) ) ){
+        negative = ( *cursor == '-' );
+        cursor++;
+    }
+
+    // Integer part. Digits beyond the mantissa's precision only scale it.
+    while( ( cursor < end ) && ( *cursor >= '0' ) && ( *cursor <= '9' ) ){
+        if( mantissa < MAX_MANTISSA ){
+            mantissa = mantissa * 10 + static_cast< std::uint64_t >( *cursor - '0' );
+        }else{
+            exponent++;
+        }
+        digitsFound = true;
+        cursor++;
+    }
+
+    // Fractional part.
+    if( ( cursor < end ) && ( *cursor == '.' ) ){
+        cursor++;
+        while( ( cursor < end ) && ( *cursor >= '0' ) && ( *cursor <= '9' ) ){
+            if( mantissa < MAX_MANTISSA ){
+                mantissa = mantissa * 10 + static_cast< std::uint64_t >( *cursor - '0' );
+                exponent--;
+            }
+            digitsFound = true;
+            cursor++;
+        }
+    }
+
+    if( !digitsFound ){
+        return false;
+    }
+
+    // Exponent (only consumed if it has digits).
+    if( ( cursor < end ) && ( ( *cursor == 'e' ) || ( *cursor == 'E' ) ) ){
+        const char* exponentCursor = cursor + 1;
+        bool negativeExponent = false;
+        std::uint32_t explicitExponent = 0;
+
+        if( ( exponentCursor < end ) && ( ( *exponentCursor == '-' ) || ( *exponentCursor == '+' ) ) ){
+            negativeExponent = ( *exponentCursor == '-' );
+            exponentCursor++;
+        }
+        if( parseUint32( exponentCursor, end, explicitExponent ) ){
+            if( explicitExponent > 1000 ){
+                explicitExponent = 1000;
+            }
+            exponent += negativeExponent ?
+                        -static_cast< int >( explicitExponent ) :
+                        static_cast< int >( explicitExponent );
+            cursor = exponentCursor;
+        }
+    }
+
+    double result = static_cast< double >( mantissa );
+    if( ( exponent >= 0 ) && ( exponent <= 22 ) ){
+        result *= POWERS_OF_TEN[exponent];
+    }else if( ( exponent < 0 ) && ( exponent >= -22 ) ){
+        result /= POWERS_OF_TEN[-exponent];
+    }else{
+        result *= std::pow( 10.0, exponent );
+    }
+
+    value = static_cast< float >( negative ? -result : result );
+    it = cursor;
+    return true;
+}
+
+} // namespace como
+
+#endif // TEXT_PARSING_HPP
@@ -0,0 +1,66 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with COMO.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <common/primitives/primitive_data/imported_primitive_data.hpp>
+#include <clocale>
+#include <iostream>
+
+/*!
+ * Converts primitive files in the old text format to the binary one (in
+ * place). Files which are binary already are left untouched.
+ */
+int main( int argc, char* argv[] )
+{
+    int i;
+    int nErrors = 0;
+
+    if( argc < 2 ){
+        std::cerr << "Usage: prim_converter <prim_file> [<prim_file> ...]" << std::endl;
+        return -1;
+    }
+
+    // Text primitive files use '.' as the float separator.
+    setlocale( LC_NUMERIC, "C" );
+
+    for( i = 1; i < argc; i++ ){
+        const std::string filePath = argv[i];
+
+        try {
+            if( como::PrimitiveFileReader::isPrimitiveFile( filePath ) ){
+                std::cout << "[" << filePath << "] is already binary" << std::endl;
+                continue;
+            }
+
+            como::ImportedPrimitiveData primitiveData;
+            primitiveData.importFromFile( filePath );
+
+            // Write the converted primitive next to the original one and
+            // replace it afterwards, so a failed conversion doesn't lose it.
+            const std::string tempFilePath = filePath + ".tmp";
+            primitiveData.exportToFile( tempFilePath );
+            boost::filesystem::rename( tempFilePath, filePath );
+
+            std::cout << "[" << filePath << "] converted" << std::endl;
+        }catch( std::exception& ex ){
+            std::cerr << "ERROR converting [" << filePath << "]: " << ex.what() << std::endl;
+            nErrors++;
+        }
+    }
+
+    return nErrors ? -1 : 0;
+}
@@ -21,22 +21,12 @@
 namespace como {
 
 
-/***
- * 1. Construction
- ***/
-
-CommandsHistoric::CommandsHistoric( std::function< void () > broadcastCallback ) :
-    broadcastCallback_( broadcastCallback )
-{
-}
-
 /***
  * 3. Getters
  ***/
 
 unsigned int CommandsHistoric::getSize() const
 {
-    LOCK
     return commands_.size();
 }
 
@@ -45,17 +35,33 @@ unsigned int CommandsHistoric::getSize() const
  * 4. Historic modification
  ***/
 
-void CommandsHistoric::addCommand( CommandConstPtr command )
+PackedCommandConstPtr CommandsHistoric::addCommand( CommandConstPtr command )
 {
+    // Pack the command only once, outside the lock. Its packed bytes will
+    // be shared by every SCENE_UPDATE packet it is sent in.
+    PackedCommandConstPtr packedCommand =
+            std::make_shared< const PackedCommand >( *command,
+                                                     mustSendCommandToAuthor( *command ) );
+
     {
         LOCK
 
-        // Push back the given command.
-        commands_.push_back( std::move( command ) );
+        // Append the given command and publish it to the readers.
+        commands_.append( packedCommand );
     }
 
-    // Broadcast the added command.
-    broadcastCallback_();
+    return packedCommand;
+}
+
+
+void CommandsHistoric::discardCommandsBefore( std::uint32_t firstCommand )
+{
+    LOCK
+
+    // Users joining the scene are synchronized with a snapshot of it, so
+    // the commands already sent to every connected user aren't needed
+    // anymore.
+    commands_.discardBefore( firstCommand );
 }
 
 
@@ -63,38 +69,29 @@ void CommandsHistoric::addCommand( CommandConstPtr command )
  * 5. Auxiliar methods
  ***/
 
-std::uint32_t CommandsHistoric::fillSceneUpdatePacketPacket( SceneUpdatePacket& packet,
+std::uint32_t CommandsHistoric::fillSceneUpdatePacketPacket( PackedSceneUpdatePacket& packet,
                                                        const unsigned int firstCommand,
-                                                       const unsigned int nCommands,
                                                        UserID userID ) const
 {
-    LOCK
-
-    /*
-    // Validity check: maxCommands can't be zero.
-    if( !nCommands ){
-        commandsMutex_.unlock();
-        return false;
-    }
-    */
-
-    // Go to the first desired command in the commands historic.
-    CommandsList::const_iterator it = commands_.begin();
-    std::advance( it, firstCommand );
+    // No lock needed: every command below the current size of the log is
+    // already published and won't change anymore.
+    const std::uint32_t historicSize = commands_.size();
 
-    // Keep adding commands to the SCENE_UPDATE packet until the  packet is
-    // full, or until we reach the commands historic end.
-    uint32_t i = 0;
+    // Keep adding commands to the SCENE_UPDATE packet until the next one
+    // doesn't fit in it, or until we reach the commands historic end.
     uint32_t nextCommand = firstCommand;
-    while( ( i < nCommands ) && ( it != commands_.end() ) ){
+    while( nextCommand < historicSize ){
+        const PackedCommandConstPtr& command = commands_[nextCommand];
+
         // Don't send to the user its own commands (unless they are commands
         // with target RESOURCE).
-        if( mustSendCommandToUser( *(*it), userID ) ){
-            packet.addCommand( CommandConstPtr( (*it)->clone() ), firstCommand + i, commands_.size() );
-            i++;
+        if( command->mustBeSentToUser( userID ) ){
+            if( !packet.fits( *command ) ){
+                break;
+            }
+            packet.addCommand( command, nextCommand, historicSize );
         }
         nextCommand++;
-        it++;
     }
 
     return nextCommand;
@@ -105,13 +102,10 @@ std::uint32_t CommandsHistoric::fillSceneUpdatePacketPacket( SceneUpdatePacket&
  * 7. Getters (private)
  ***/
 
-bool CommandsHistoric::mustSendCommandToUser( const Command& command,
-                                              const UserID& userID ) const
+bool CommandsHistoric::mustSendCommandToAuthor( const Command& command )
 {
-    // Send all the commands performed by other users.
-    if( command.getUserID() != userID ){
-        return true;
-    }
+    // Commands performed by other users are always sent, so here we only
+    // decide which commands are also sent back to their author.
 
     // Send all RESOURCE commands (locks and lock denials).
     if( ( command.getTarget() == CommandTarget::RESOURCE ) ){
@@ -23,29 +23,32 @@
 
 #include <list>
 #include <common/packets/packets.hpp>
+#include <common/packets/packed_scene_update_packet.hpp>
 #include <common/utilities/lockable.hpp>
+#include <common/utilities/append_only_log.hpp>
 
 namespace como {
 
 typedef std::list< CommandConstPtr > CommandsList;
+typedef std::list< PackedCommandConstPtr > PackedCommandsList;
+typedef AppendOnlyLog< PackedCommandConstPtr > PackedCommandsLog;
 
 class CommandsHistoric : public Lockable
 {
     private:
-        // List of commands in the historic.
-        CommandsList commands_;
-
-        // Function to be called when a command is added to the historic.
-        std::function< void () > broadcastCallback_;
+        // Log of commands in the historic. Every command is packed once
+        // when added and its packed bytes are shared by all the users.
+        // Readers access the log by index without taking the historic's
+        // lock, which only serializes the writers.
+        PackedCommandsLog commands_;
 
     public:
         /***
          * 1. Construction
          ***/
-        CommandsHistoric() = delete;
+        CommandsHistoric() = default;
         CommandsHistoric( const CommandsHistoric& ) = delete;
         CommandsHistoric( CommandsHistoric&& ) = delete;
-        CommandsHistoric( std::function< void () > broadcastCallback );
 
 
         /***
@@ -63,15 +66,15 @@ class CommandsHistoric : public Lockable
         /***
          * 4. Historic modification
          ***/
-        void addCommand( CommandConstPtr command );
+        PackedCommandConstPtr addCommand( CommandConstPtr command );
+        void discardCommandsBefore( std::uint32_t firstCommand );
 
 
         /***
          * 5. Auxiliar methods
          ***/
-        std::uint32_t fillSceneUpdatePacketPacket( SceneUpdatePacket& packet,
+        std::uint32_t fillSceneUpdatePacketPacket( PackedSceneUpdatePacket& packet,
                                              const unsigned int firstCommand,
-                                             const unsigned int nCommands,
                                              UserID userID ) const ;
 
 
@@ -86,7 +89,7 @@ class CommandsHistoric : public Lockable
         /***
          * 7. Getters (private)
          ***/
-        bool mustSendCommandToUser( const Command& command, const UserID& userID ) const;
+        static bool mustSendCommandToAuthor( const Command& command );
 };
 
 typedef std::shared_ptr< CommandsHistoric > CommandsHistoricPtr;
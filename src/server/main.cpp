@@ -31,8 +31,15 @@ int main( int argc, char* argv[] )
     boost::system::error_code errorCode;
 
     try {
+        // Directions and angles are packed with 16 bits if the last argument
+        // is "--quantized-floats".
+        if( ( argc > 1 ) && !strcmp( argv[argc-1], "--quantized-floats" ) ){
+            como::setFloatEncoding( como::FloatEncoding::QUANTIZED_16 );
+            argc--;
+        }
+
         if( argc < 4 ){
-            std::cerr << "Usage: server <port> <max_users> <scene_name> [scene_load_file]" << std::endl;
+            std::cerr << "Usage: server <port> <max_users> <scene_name> [scene_load_file] [--quantized-floats]" << std::endl;
             exit( -1 );
         }
 
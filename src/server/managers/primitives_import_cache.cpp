@@ -0,0 +1,197 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "primitives_import_cache.hpp"
+#include <common/primitives/obj_primitives_importer.hpp>
+#include <common/primitives/primitive_data/primitive_file.hpp>
+#include <common/utilities/blob_store.hpp>
+#include <fstream>
+
+namespace como {
+
+const char CACHE_ENTRY_EXTENSION[] = ".prim";
+
+
+/***
+ * 1. Construction
+ ***/
+
+PrimitivesImportCache::PrimitivesImportCache( const std::string& cacheDirPath ) :
+    cacheDirPath_( cacheDirPath )
+{
+    boost::filesystem::create_directories( cacheDirPath_ );
+}
+
+
+/***
+ * 3. Primitives import
+ ***/
+
+PrimitiveInfo PrimitivesImportCache::importPrimitive( const std::string& srcFilePath,
+                                                      const std::string& dstDirectory,
+                                                      const std::string& nameSuffix,
+                                                      unsigned int maxThreads,
+                                                      bool& cached )
+{
+    PrimitiveInfo primitiveInfo;
+    const std::string key = generateKey( srcFilePath );
+    const std::string entryPath = cacheDirPath_ + "/" + key + CACHE_ENTRY_EXTENSION;
+
+    {
+        LOCK
+        usedKeys_.insert( key );
+    }
+
+    cached = boost::filesystem::exists( entryPath );
+    if( cached ){
+        // Converted primitives don't depend on their names, so the cached
+        // one only has to be copied with the requested name.
+        primitiveInfo.name = boost::filesystem::basename( srcFilePath ) + nameSuffix;
+        primitiveInfo.filePath =
+                ( boost::filesystem::path( dstDirectory ) /
+                  boost::filesystem::path( primitiveInfo.name ) ).string() +
+                ".prim";
+
+        // Copy it through a temporary file, so the views of a previous file
+        // with the same path (see FileView) aren't truncated.
+        const std::string tempFilePath = primitiveInfo.filePath + ".tmp";
+        boost::filesystem::copy_file( entryPath,
+                                      tempFilePath,
+                                      boost::filesystem::copy_option::overwrite_if_exists );
+        boost::filesystem::rename( tempFilePath, primitiveInfo.filePath );
+    }else{
+        OBJPrimitivesImporter primitivesImporter( maxThreads );
+        primitiveInfo = primitivesImporter.importPrimitive( srcFilePath, dstDirectory, nameSuffix );
+
+        // Two source files could have the same contents, so copy the entry
+        // to a path unique to this primitive and rename it afterwards.
+        const std::string tempEntryPath = entryPath + "." + primitiveInfo.name + ".tmp";
+        boost::filesystem::copy_file( primitiveInfo.filePath,
+                                      tempEntryPath,
+                                      boost::filesystem::copy_option::overwrite_if_exists );
+        boost::filesystem::rename( tempEntryPath, entryPath );
+    }
+
+    return primitiveInfo;
+}
+
+
+/***
+ * 4. Cache management
+ ***/
+
+void PrimitivesImportCache::removeUnusedEntries()
+{
+    LOCK
+    const boost::filesystem::directory_iterator endIterator;
+    boost::filesystem::directory_iterator fileIterator( cacheDirPath_ );
+    std::list< boost::filesystem::path > unusedEntries;
+
+    for( ; fileIterator != endIterator; fileIterator++ ){
+        const boost::filesystem::path entryPath = fileIterator->path();
+
+        if( !usedKeys_.count( entryPath.stem().string() ) ){
+            unusedEntries.push_back( entryPath );
+        }
+    }
+
+    for( const auto& entryPath : unusedEntries ){
+        boost::filesystem::remove( entryPath );
+    }
+}
+
+
+/***
+ * 6. Auxiliar methods
+ ***/
+
+std::string PrimitivesImportCache::generateKey( const std::string& srcFilePath )
+{
+    // Two OBJ files with the same contents could reference different
+    // material files (they are relative to each OBJ file), so the
+    // referenced files are part of the key too.
+    const std::string dependencies = generateDependenciesSignature( srcFilePath );
+    const BlobHash dependenciesHash = computeDataHash( dependencies.data(), dependencies.size() );
+
+    return blobHashToString( computeFileHash( srcFilePath ) ) +
+            "_" +
+            std::to_string( boost::filesystem::last_write_time( srcFilePath ) ) +
+            "_" +
+            blobHashToString( dependenciesHash ).substr( 0, 8 ) +
+            "_v" +
+            std::to_string( PRIMITIVE_FILE_VERSION ) +
+            "." +
+            std::to_string( OBJ_PRIMITIVES_IMPORTER_REVISION );
+}
+
+
+std::string PrimitivesImportCache::generateDependenciesSignature( const std::string& srcFilePath )
+{
+    std::string signature;
+
+    for( const std::string& materialFilePath : readReferencedFiles( srcFilePath, "mtllib" ) ){
+        signature += generateFileSignature( materialFilePath );
+
+        if( boost::filesystem::exists( materialFilePath ) ){
+            for( const std::string& textureFilePath : readReferencedFiles( materialFilePath, "map_Kd" ) ){
+                signature += generateFileSignature( textureFilePath );
+            }
+        }
+    }
+
+    return signature;
+}
+
+
+std::list< std::string > PrimitivesImportCache::readReferencedFiles( const std::string& filePath,
+                                                                     const std::string& lineHeader )
+{
+    std::list< std::string > referencedFiles;
+    std::ifstream file( filePath.c_str() );
+    const std::string dirPath = boost::filesystem::path( filePath ).parent_path().string();
+    std::string fileLine;
+
+    while( std::getline( file, fileLine ) ){
+        if( fileLine.size() && ( fileLine[ fileLine.size() - 1 ] == '\r' ) ){
+            fileLine = fileLine.substr( 0, fileLine.size() - 1 );
+        }
+
+        if( !fileLine.compare( 0, lineHeader.size() + 1, lineHeader + ' ' ) ){
+            referencedFiles.push_back( dirPath + '/' + fileLine.substr( lineHeader.size() + 1 ) );
+        }
+    }
+
+    return referencedFiles;
+}
+
+
+std::string PrimitivesImportCache::generateFileSignature( const std::string& filePath )
+{
+    if( !boost::filesystem::exists( filePath ) ){
+        return filePath + ":missing\n";
+    }
+
+    return filePath +
+            ":" +
+            std::to_string( boost::filesystem::file_size( filePath ) ) +
+            ":" +
+            std::to_string( boost::filesystem::last_write_time( filePath ) ) +
+            "\n";
+}
+
+} // namespace como
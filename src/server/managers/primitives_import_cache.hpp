@@ -0,0 +1,142 @@
+/***
+ * Copyright 2013, 2014 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of COMO.
+ *
+ * COMO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v3 as published by
+ * the Free Software Foundation.
+ *
+ * COMO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Foobar.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PRIMITIVES_IMPORT_CACHE_HPP
+#define PRIMITIVES_IMPORT_CACHE_HPP
+
+#include <common/primitives/primitive_info.hpp>
+#include <common/utilities/lockable.hpp>
+#include <list>
+#include <set>
+#include <string>
+
+namespace como {
+
+/*!
+ * \class PrimitivesImportCache
+ *
+ * \brief Persistent cache of the primitives converted from OBJ files,
+ * indexed by the hash and modification time of their source files, so
+ * unchanged primitives aren't converted again on every server start.
+ *
+ * The key also covers the size and modification time of the material and
+ * texture files referenced by the source file, the version of the
+ * primitive file format and the revision of the importer
+ * (OBJ_PRIMITIVES_IMPORTER_REVISION).
+ */
+class PrimitivesImportCache : public Lockable
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        PrimitivesImportCache() = delete;
+
+        /*!
+         * \brief Constructor. Creates the cache directory if it doesn't
+         * exist.
+         */
+        PrimitivesImportCache( const std::string& cacheDirPath );
+        PrimitivesImportCache( const PrimitivesImportCache& ) = delete;
+        PrimitivesImportCache( PrimitivesImportCache&& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~PrimitivesImportCache() = default;
+
+
+        /***
+         * 3. Primitives import
+         ***/
+
+        /*!
+         * \brief Same as OBJPrimitivesImporter::importPrimitive(), but the
+         * converted primitive is copied from the cache if it's there. This
+         * method can be called from several threads at once.
+         * \param maxThreads maximum number of threads the importer can use
+         * for parsing the source file.
+         * \param cached set to true if the primitive was in the cache.
+         */
+        PrimitiveInfo importPrimitive( const std::string& srcFilePath,
+                                       const std::string& dstDirectory,
+                                       const std::string& nameSuffix,
+                                       unsigned int maxThreads,
+                                       bool& cached );
+
+
+        /***
+         * 4. Cache management
+         ***/
+
+        /*!
+         * \brief Removes the cache entries which haven't been used since
+         * this cache was created (ie. those of modified or removed source
+         * files).
+         */
+        void removeUnusedEntries();
+
+
+        /***
+         * 5. Operators
+         ***/
+        PrimitivesImportCache& operator = ( const PrimitivesImportCache& ) = delete;
+        PrimitivesImportCache& operator = ( PrimitivesImportCache&& ) = delete;
+
+
+    private:
+        /***
+         * 6. Auxiliar methods
+         ***/
+
+        /*! \brief Returns the cache key for the given source file. */
+        static std::string generateKey( const std::string& srcFilePath );
+
+        /*!
+         * \brief Returns a string identifying the current version of the
+         * material and texture files referenced by the given source file.
+         */
+        static std::string generateDependenciesSignature( const std::string& srcFilePath );
+
+        /*!
+         * \brief Returns the paths of the files referenced by the lines of
+         * the given file starting with the given header.
+         */
+        static std::list< std::string > readReferencedFiles( const std::string& filePath,
+                                                             const std::string& lineHeader );
+
+        /*!
+         * \brief Returns a string identifying the current version of the
+         * given file (its size and modification time).
+         */
+        static std::string generateFileSignature( const std::string& filePath );
+
+
+        /***
+         * Attributes
+         ***/
+        const std::string cacheDirPath_;
+
+        /*! \brief Keys of the entries used since this cache was created. */
+        std::set< std::string > usedKeys_;
+};
+
+} // namespace como
+
+#endif // PRIMITIVES_IMPORT_CACHE_HPP
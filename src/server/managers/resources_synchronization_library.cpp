@@ -60,7 +60,22 @@ void ResourcesSynchronizationLibrary::processCommand( const Command &command )
     log()->debug( "Processing command (target: ",
                   commandTargetStrings[(int)( command.getTarget())],
                   ")\n" );
+
+    // The file referenced by this command (if any) is complete, so its
+    // chunks are no longer needed for snapshots.
+    if( command.getFile() != nullptr ){
+        pendingFileChunks_.erase( command.getFile()->getFileID() );
+    }
+
     switch( command.getTarget() ){
+        case CommandTarget::FILE:{
+            const FileChunkCommand& fileChunkCommand =
+                    dynamic_cast< const FileChunkCommand& >( command );
+
+            pendingFileChunks_[ fileChunkCommand.fileID() ].push_back(
+                        commandsHistoric_->addCommand( CommandConstPtr( command.clone() ) ) );
+            return;
+        }break;
         case CommandTarget::RESOURCE:{
             const ResourceCommand& resourceCommand = dynamic_cast< const ResourceCommand& >( command );
             executeResourceCommand( resourceCommand );
@@ -211,9 +226,10 @@ void ResourcesSynchronizationLibrary::processCommand( const Command &command )
         case CommandTarget::SELECTION:{
             // We have a command that updates the user's selection, so apply
             // it to all resources currently owned by user.
-            for( std::pair< const ResourceID, ResourceSyncDataPtr >& resourcePair : resourcesSyncData_ ){
-                if( resourcePair.second->resourceOwner() == command.getUserID() ){
-                    resourcePair.second->processCommand( command );
+            const auto userResources = ownedResources_.find( command.getUserID() );
+            if( userResources != ownedResources_.end() ){
+                for( const ResourceID& resourceID : userResources->second ){
+                    resourcesSyncData_.at( resourceID )->processCommand( command );
                 }
             }
         }break;
@@ -328,18 +344,124 @@ void ResourcesSynchronizationLibrary::removeUser( UserID userID )
     LOCK
 
     unlockResourcesSelection( userID );
+
+    // Discard the files the user didn't finish streaming.
+    for( auto it = pendingFileChunks_.begin(); it != pendingFileChunks_.end(); ){
+        if( it->first.getCreatorID() == userID ){
+            it = pendingFileChunks_.erase( it );
+        }else{
+            it++;
+        }
+    }
+    PackableFile::discardFileStreams( userID );
+}
+
+
+/***
+ * 6. Scene snapshot
+ ***/
+
+std::uint32_t ResourcesSynchronizationLibrary::generateSnapshot( PackedCommandsList& snapshot, const std::set< BlobHash >& knownBlobs ) const
+{
+    LOCK
+    CommandsList commands;
+
+    // Every command modifying this library is added to the historic while
+    // holding its lock, so the snapshot generated here is equivalent to
+    // the historic commands up to this point.
+    const std::uint32_t historicSize = commandsHistoric_->getSize();
+
+    // Users currently connected to the scene.
+    for( const auto& userPair : users_ ){
+        const std::uint32_t userColor = userPair.second->getColor();
+        UserConnectionCommand userConnectionCommand( userPair.first );
+
+        userConnectionCommand.setName( userPair.second->getName().c_str() );
+        userConnectionCommand.setSelectionColor( ( userColor & 0xFF0000 ) >> 16,
+                                                 ( userColor & 0xFF00 ) >> 8,
+                                                 userColor & 0xFF,
+                                                 0xFF );
+        snapshot.push_back( std::make_shared< const PackedCommand >( userConnectionCommand, true ) );
+    }
+
+    // Contents of the streamed files, which must be received before the
+    // creation commands referencing them. Primitives files are taken from
+    // the primitives manager, which registers them all.
+    std::map< ResourceID, PackedCommandsList > usedFileChunks;
+    for( const PackableFile& primitiveFile : primitivesManager_.streamedFiles() ){
+        addFileChunks( primitiveFile, knownBlobs, snapshot, usedFileChunks );
+    }
+    for( const auto& resourceSyncDataPair : resourcesSyncData_ ){
+        CommandConstPtr creationCommand = resourceSyncDataPair.second->getCreationCommand();
+
+        if( ( creationCommand != nullptr ) &&
+            ( creationCommand->getTarget() != CommandTarget::PRIMITIVE ) &&
+            ( creationCommand->getFile() != nullptr ) &&
+            creationCommand->getFile()->isStreamed() ){
+            addFileChunks( *( creationCommand->getFile() ), knownBlobs, snapshot, usedFileChunks );
+        }
+    }
+    packedFileChunks_.swap( usedFileChunks );
+    for( const auto& fileChunksPair : pendingFileChunks_ ){
+        snapshot.insert( snapshot.end(),
+                         fileChunksPair.second.begin(),
+                         fileChunksPair.second.end() );
+    }
+
+    // Creation commands, first pass. Primitives and their categories are
+    // created before any resource which could instantiate them. Their
+    // commands were already packed when added to the historic.
+    const PackedCommandsList& primitivesCreationCommands = primitivesManager_.creationCommands();
+    snapshot.insert( snapshot.end(),
+                     primitivesCreationCommands.begin(),
+                     primitivesCreationCommands.end() );
+
+    // Creation commands, second pass: remaining resources.
+    for( const auto& resourceSyncDataPair : resourcesSyncData_ ){
+        CommandConstPtr creationCommand = resourceSyncDataPair.second->getCreationCommand();
+
+        if( ( creationCommand != nullptr ) &&
+            !( ( creationCommand->getTarget() == CommandTarget::PRIMITIVE ) &&
+               ( dynamic_cast< const PrimitiveCommand& >( *creationCommand ).getType() ==
+                 PrimitiveCommandType::PRIMITIVE_CREATION ) ) ){
+            commands.push_back( std::move( creationCommand ) );
+        }
+    }
+
+    // Update commands.
+    for( const auto& resourceSyncDataPair : resourcesSyncData_ ){
+        commands.splice( commands.end(), resourceSyncDataPair.second->generateUpdateCommands() );
+    }
+
+    // Current resources locks.
+    for( const auto& userResources : ownedResources_ ){
+        for( const ResourceID& resourceID : userResources.second ){
+            commands.push_back(
+                        CommandConstPtr(
+                            new ResourceCommand(
+                                ResourceCommandType::RESOURCE_LOCK,
+                                userResources.first,
+                                resourceID ) ) );
+        }
+    }
+
+    for( const auto& command : commands ){
+        snapshot.push_back( std::make_shared< const PackedCommand >( *command, true ) );
+    }
+
+    return historicSize;
 }
 
 
 /***
- * 6. Resources ownership management
+ * 7. Resources ownership management
  ***/
 
 void ResourcesSynchronizationLibrary::lockResource( const ResourceID& resourceID, UserID userID )
 {
     log()->debug( "User (", userID, ") tries to lock resource (", resourceID, "): " );
     if( resourcesSyncData_.at( resourceID )->resourceOwner() == NO_USER ){
-        resourcesSyncData_.at( resourceID )->setResourceOwner( userID );
+        setResourceOwner( resourceID, userID );
         //notifyElementUpdate( resourceID );
 
         // Add the lock command to the commands historic.
@@ -366,30 +488,31 @@ void ResourcesSynchronizationLibrary::lockResource( const ResourceID& resourceID
 void ResourcesSynchronizationLibrary::unlockResourcesSelection( UserID userID )
 {
     log()->debug( "(User: ", userID, ") Unlocking Selection\n" );
-    for( auto& resourceSyncData : resourcesSyncData_ ){
-        if( resourceSyncData.second->resourceOwner() == userID ){
-            resourceSyncData.second->setResourceOwner( NO_USER );
+    const auto userResources = ownedResources_.find( userID );
+    if( userResources != ownedResources_.end() ){
+        for( const ResourceID& resourceID : userResources->second ){
+            resourcesSyncData_.at( resourceID )->setResourceOwner( NO_USER );
         }
+        ownedResources_.erase( userResources );
     }
 }
 
 void ResourcesSynchronizationLibrary::deleteResourcesSelection( UserID userID )
 {
     log()->debug( "(User: ", userID, ") Deleting Selection\n" );
-    std::map< ResourceID, ResourceSyncDataPtr >::iterator currentElement;
-
-    currentElement = resourcesSyncData_.begin();
-    while( currentElement != resourcesSyncData_.end() ){
-        if( currentElement->second->resourceOwner() == userID ){
-            deleteResource( currentElement->first );
-
-            // deleteResource() removes resources recursively, so this
-            // iterator could end invalidated. Start again from the
-            // begining.
-            // TODO: Optimize this!.
-            currentElement = resourcesSyncData_.begin();
-        }else{
-            currentElement++;
+    const auto userResources = ownedResources_.find( userID );
+    if( userResources == ownedResources_.end() ){
+        return;
+    }
+
+    // deleteResource() updates the owners index, so iterate over a copy of
+    // the user's selection.
+    const std::set< ResourceID > selection = userResources->second;
+    for( const ResourceID& resourceID : selection ){
+        // The resource could have been already deleted as a child of a
+        // previous one.
+        if( resourcesSyncData_.count( resourceID ) ){
+            deleteResource( resourceID );
         }
     }
 }
@@ -413,10 +536,11 @@ void ResourcesSynchronizationLibrary::deleteResource( const ResourceID &resource
         }
 
         //notifyElementDeletion( currentElement->first );
+        setResourceOwner( resourceID, NO_USER );
         resourcesSyncData_.erase( resourceID );
     }else{
         //notifyElementUpdate( currentElement->first );
-        resourceSyncData.setResourceOwner( NO_USER );
+        setResourceOwner( resourceID, NO_USER );
     }
 }
 
@@ -429,4 +553,67 @@ void ResourcesSynchronizationLibrary::processLockDenial( const ResourceID& resou
 }
 
 
+/***
+ * 8. Owners index management
+ ***/
+
+void ResourcesSynchronizationLibrary::setResourceOwner( const ResourceID& resourceID, UserID newOwner )
+{
+    ResourceSyncData& resourceSyncData = *( resourcesSyncData_.at( resourceID ) );
+    const UserID currentOwner = resourceSyncData.resourceOwner();
+
+    if( currentOwner == newOwner ){
+        return;
+    }
+
+    // Remove the resource from its current owner's index.
+    if( currentOwner != NO_USER ){
+        std::set< ResourceID >& currentOwnerResources = ownedResources_.at( currentOwner );
+        currentOwnerResources.erase( resourceID );
+        if( currentOwnerResources.empty() ){
+            ownedResources_.erase( currentOwner );
+        }
+    }
+
+    // Add the resource to its new owner's index.
+    if( newOwner != NO_USER ){
+        ownedResources_[newOwner].insert( resourceID );
+    }
+
+    resourceSyncData.setResourceOwner( newOwner );
+}
+
+
+/***
+ * 9. Snapshot auxiliar methods
+ ***/
+
+void ResourcesSynchronizationLibrary::addFileChunks( const PackableFile& file,
+                                                     const std::set< BlobHash >& knownBlobs,
+                                                     PackedCommandsList& snapshot,
+                                                     std::map< ResourceID, PackedCommandsList >& usedFileChunks ) const
+{
+    const ResourceID fileID = file.getFileID();
+    const auto packedChunksIt = packedFileChunks_.find( fileID );
+
+    // Keep the chunks already packed, even if this user doesn't need them.
+    if( packedChunksIt != packedFileChunks_.end() ){
+        usedFileChunks[fileID] = packedChunksIt->second;
+    }
+
+    // The user will retrieve the files it already has from its blob store.
+    if( knownBlobs.count( file.getContentHash() ) ){
+        return;
+    }
+
+    PackedCommandsList& packedChunks = usedFileChunks[fileID];
+    if( packedChunks.empty() ){
+        for( const auto& chunk : FileChunkCommand::generateFileChunks( NO_USER, file ) ){
+            packedChunks.push_back( std::make_shared< const PackedCommand >( *chunk, true ) );
+        }
+    }
+
+    snapshot.insert( snapshot.end(), packedChunks.begin(), packedChunks.end() );
+}
+
 } // namespace como
@@ -81,9 +81,15 @@ class ResourcesSynchronizationLibrary : public AbstractResourcesOwnershipManager
         void removeUser( UserID userID );
 
 
+        /***
+         * 6. Scene snapshot
+         ***/
+        std::uint32_t generateSnapshot( PackedCommandsList& snapshot, const std::set< BlobHash >& knownBlobs ) const;
+
+
     protected:
         /***
-         * 6. Resources ownership management
+         * 7. Resources ownership management
          ***/
         virtual void lockResource( const ResourceID &resourceID, UserID userID );
         virtual void unlockResourcesSelection( UserID userID );
@@ -93,8 +99,38 @@ class ResourcesSynchronizationLibrary : public AbstractResourcesOwnershipManager
 
 
     private:
+        /***
+         * 8. Owners index management
+         ***/
+        void setResourceOwner( const ResourceID& resourceID, UserID newOwner );
+
+
+        /***
+         * 9. Snapshot auxiliar methods
+         ***/
+        /*!
+         * \brief Adds the packed chunks of the given streamed file to the
+         * snapshot, unless the user already has the file. The chunks are
+         * packed only once and shared by all the snapshots (see
+         * packedFileChunks_).
+         * \param usedFileChunks packed chunks of the files in the scene,
+         * where the given file's ones are added.
+         */
+        void addFileChunks( const PackableFile& file,
+                            const std::set< BlobHash >& knownBlobs,
+                            PackedCommandsList& snapshot,
+                            std::map< ResourceID, PackedCommandsList >& usedFileChunks ) const;
+
+
+        /***
+         * Attributes
+         ***/
         std::map< ResourceID, ResourceSyncDataPtr > resourcesSyncData_;
 
+        // Index of the resources currently owned by every user, kept in
+        // sync with the owners in resourcesSyncData_.
+        std::map< UserID, std::set< ResourceID > > ownedResources_;
+
         CommandsHistoricPtr commandsHistoric_;
         const std::string unpackingDirPath_;
 
@@ -103,6 +139,16 @@ class ResourcesSynchronizationLibrary : public AbstractResourcesOwnershipManager
 
         ServerPrimitivesManager primitivesManager_;
         std::set< ResourceID > lights_;
+
+        // Chunks of the files still being streamed by users, indexed by file
+        // ID. They are included in the snapshots until the command
+        // referencing the file is processed.
+        std::map< ResourceID, PackedCommandsList > pendingFileChunks_;
+
+        // Packed chunks of the streamed files in the scene, indexed by file
+        // ID, reused by every snapshot. Only the files present in the last
+        // snapshot are kept.
+        mutable std::map< ResourceID, PackedCommandsList > packedFileChunks_;
 };
 
 typedef std::unique_ptr< ResourcesSynchronizationLibrary > ResourcesSynchronizationLibraryPtr;
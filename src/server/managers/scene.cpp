@@ -160,6 +160,13 @@ void Scene::removeUser( UserID userID )
 }
 
 
+std::uint32_t Scene::generateSnapshot( PackedCommandsList& snapshot, const std::set< BlobHash >& knownBlobs ) const
+{
+    LOCK
+    return resourcesSyncLibrary_.generateSnapshot( snapshot, knownBlobs );
+}
+
+
 /***
  * 7. Auxiliar I/O methods
  ***/
@@ -70,6 +70,7 @@ class Scene : public BasicScene
          * 6. Users management
          ***/
         void removeUser( UserID userID );
+        std::uint32_t generateSnapshot( PackedCommandsList& snapshot, const std::set< BlobHash >& knownBlobs ) const;
 
 
         /***
@@ -18,10 +18,14 @@
 
 #include "server_primitives_manager.hpp"
 #include <common/primitives/obj_primitives_importer.hpp>
+#include <boost/thread.hpp>
+#include <atomic>
+#include <chrono>
 
 namespace como {
 
 const char LOCAL_PRIMITIVES_DIR[] = "data/local/primitives";
+const char PRIMITIVES_CACHE_DIR[] = "data/cache/primitives";
 
 /***
  * 1. Construction
@@ -34,7 +38,8 @@ ServerPrimitivesManager::ServerPrimitivesManager(const std::string& sceneDirPath
                                                   ResourceIDsGeneratorPtr resourceIDsGenerator ) :
     AbstractPrimitivesManager( sceneDirPath, tempDirPath, log ),
     commandsHistoric_( commandsHistoric ),
-    resourceIDsGenerator_( resourceIDsGenerator )
+    resourceIDsGenerator_( resourceIDsGenerator ),
+    importCache_( PRIMITIVES_CACHE_DIR )
 {
     // Sync server's local primitives directory.
     syncPrimitivesDir();
@@ -65,6 +70,20 @@ std::list<PlainMaterialData> ServerPrimitivesManager::primitivePlainMaterialsDat
 }
 
 
+const PackedCommandsList& ServerPrimitivesManager::creationCommands() const
+{
+    LOCK
+    return creationCommands_;
+}
+
+
+const std::list< PackableFile >& ServerPrimitivesManager::streamedFiles() const
+{
+    LOCK
+    return streamedFiles_;
+}
+
+
 /***
  * 4. Primitives management
  ***/
@@ -90,10 +109,20 @@ void ServerPrimitivesManager::registerPrimitive(PrimitiveInfo primitive, const R
 
     AbstractPrimitivesManager::registerPrimitive( primitiveID, primitive );
 
-    commandsHistoric_->addCommand( CommandConstPtr( new PrimitiveCreationCommand( primitiveID.getCreatorID(),
-                                                                                  primitiveID,
-                                                                                  primitiveCopy,
-                                                                                  tempDirPath_ ) ) );
+    CommandConstPtr primitiveCreationCommand(
+                new PrimitiveCreationCommand( primitiveID.getCreatorID(),
+                                              primitiveID,
+                                              primitiveCopy,
+                                              tempDirPath_ ) );
+
+    // Users joining the scene will need the primitive file's chunks before
+    // its creation command. Users already in the scene received them from
+    // the primitive's author.
+    if( primitiveCreationCommand->getFile()->isStreamed() ){
+        streamedFiles_.push_back( *( primitiveCreationCommand->getFile() ) );
+    }
+
+    creationCommands_.push_back( commandsHistoric_->addCommand( std::move( primitiveCreationCommand ) ) );
 }
 
 
@@ -132,21 +161,74 @@ void ServerPrimitivesManager::syncPrimitivesDir()
 {
     //createPrimitivesDir();
 
-    const char* filePath = nullptr;
     const boost::filesystem::directory_iterator endIterator;
     boost::filesystem::directory_iterator fileIterator( LOCAL_PRIMITIVES_DIR );
+    std::vector< std::pair< ResourceID, std::string > > categories;
+    std::vector< PrimitiveImport > imports;
+    const auto startTime = std::chrono::steady_clock::now();
 
     log_->debug( "Adding primitives to scene [", LOCAL_PRIMITIVES_DIR, "] ...\n" );
 
+    // Create the categories and collect the primitives to be imported.
     for( ; fileIterator != endIterator; fileIterator++ ){
         if( boost::filesystem::is_directory( *fileIterator ) ){
-            filePath = fileIterator->path().string().c_str();
+            const std::string dirPath = fileIterator->path().string();
+
+            categories.push_back( std::make_pair( syncPrimitivesCategoryDir( dirPath, imports ), dirPath ) );
+        }
+    }
+
+    importPrimitives( imports );
+
+    // Register the imported primitives in the order they were found, so
+    // the commands historic doesn't depend on the import order.
+    for( const auto& category : categories ){
+        unsigned int nPrimitives = 0;
+        unsigned int nCachedPrimitives = 0;
+        std::chrono::steady_clock::time_point importStart = std::chrono::steady_clock::time_point::max();
+        std::chrono::steady_clock::time_point importEnd = std::chrono::steady_clock::time_point::min();
+
+        for( PrimitiveImport& primitiveImport : imports ){
+            if( primitiveImport.categoryID != category.first ){
+                continue;
+            }
 
-            syncPrimitivesCategoryDir( filePath );
+            // The category's primitives are imported in parallel (along
+            // with other categories' ones), so report the wall-clock time
+            // from the first import start to the last import end.
+            importStart = std::min( importStart, primitiveImport.importStart );
+            importEnd = std::max( importEnd, primitiveImport.importEnd );
+
+            if( primitiveImport.errorMessage != "" ){
+                log_->error( "\n\nError importing primitive [",
+                             primitiveImport.srcFilePath, "] - ",
+                             primitiveImport.errorMessage, "\n\n" );
+                continue;
+            }
+
+            primitiveImport.primitive.category = category.first;
+            registerPrimitive( primitiveImport.primitive, primitiveImport.primitiveID );
+
+            nPrimitives++;
+            if( primitiveImport.cached ){
+                nCachedPrimitives++;
+            }
         }
+
+        log_->debug( "Category [", category.second, "] synchronized - primitives (",
+                     nPrimitives, "), from cache (",
+                     nCachedPrimitives, "), import time (",
+                     ( importStart < importEnd ) ?
+                         std::chrono::duration_cast< std::chrono::milliseconds >( importEnd - importStart ).count() : 0,
+                     " ms)\n" );
     }
 
-    log_->debug( "Adding primitives to scene [", LOCAL_PRIMITIVES_DIR, "] ...OK\n" );
+    // Forget the primitives which aren't in the local directory anymore.
+    importCache_.removeUnusedEntries();
+
+    log_->debug( "Adding primitives to scene [", LOCAL_PRIMITIVES_DIR, "] ...OK (",
+                 std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - startTime ).count(),
+                 " ms)\n" );
 }
 
 
@@ -156,24 +238,22 @@ ResourceID ServerPrimitivesManager::createCategory( std::string name )
 
     AbstractPrimitivesManager::createCategory( categoryID, name );
 
-    commandsHistoric_->addCommand( CommandConstPtr(
-                                       new PrimitiveCategoryCreationCommand( 0,
-                                                                             categoryID,
-                                                                             name ) ) );
+    creationCommands_.push_back(
+                commandsHistoric_->addCommand( CommandConstPtr(
+                                                   new PrimitiveCategoryCreationCommand( 0,
+                                                                                         categoryID,
+                                                                                         name ) ) ) );
 
     return categoryID;
 }
 
 
-void ServerPrimitivesManager::syncPrimitivesCategoryDir( std::string dirPath )
+ResourceID ServerPrimitivesManager::syncPrimitivesCategoryDir( std::string dirPath, std::vector< PrimitiveImport >& imports )
 {
     const boost::filesystem::directory_iterator endIterator;
     boost::filesystem::directory_iterator fileIterator( dirPath );
     std::string filePath;
-    OBJPrimitivesImporter primitivesImporter;
     ResourceID categoryID;
-    PrimitiveInfo primitive;
-    char nameSuffix[30] = {0};
 
     log_->debug( "Synchronizing category dir [", dirPath, "]\n" );
 
@@ -188,25 +268,71 @@ void ServerPrimitivesManager::syncPrimitivesCategoryDir( std::string dirPath )
             log_->debug( "filePath: ", filePath, "\n" );
 
             if( boost::filesystem::extension( filePath ) == ".obj" ){
-                try {
-                    ResourceID primitiveID = resourceIDsGenerator_->generateResourceIDs( 1 );
-
-                    sprintf( nameSuffix, "__%i_%i", primitiveID.getCreatorID(), primitiveID.getResourceIndex() );
-
-                    primitive = primitivesImporter.importPrimitive( filePath,
-                                                                    getCategoryAbsoluteePath( categoryID ),
-                                                                    nameSuffix );
-                    primitive.category = categoryID;
-
-                    registerPrimitive( primitive, primitiveID );
-                }catch( std::exception& ex ){
-                    log_->error( "\n\nError importing primitive [",
-                                 filePath, "] - ",
-                                 ex.what(), "\n\n" );
-                }
+                PrimitiveImport primitiveImport;
+
+                primitiveImport.srcFilePath = filePath;
+                primitiveImport.categoryID = categoryID;
+                primitiveImport.primitiveID = resourceIDsGenerator_->generateResourceIDs( 1 );
+                primitiveImport.cached = false;
+
+                imports.push_back( primitiveImport );
             }
         }
     }
+
+    return categoryID;
+}
+
+
+void ServerPrimitivesManager::importPrimitives( std::vector< PrimitiveImport >& imports )
+{
+    std::atomic< unsigned int > nextImport( 0 );
+    boost::thread_group importThreads;
+    unsigned int i;
+
+    // Share the hardware threads between the imports running at once and
+    // the parsing threads of each import, so they don't multiply.
+    const unsigned int nHardwareThreads = std::max( boost::thread::hardware_concurrency(), 1u );
+    const unsigned int nThreads =
+            std::min< unsigned int >( nHardwareThreads, imports.size() );
+    const unsigned int nParsingThreads = std::max( nHardwareThreads / std::max( nThreads, 1u ), 1u );
+
+    // The OBJ parser reads floats with '.' as separator. Set it here, as
+    // changing the locale isn't safe once the import threads are running.
+    setlocale( LC_NUMERIC, "C" );
+
+    auto importThread = [&](){
+        unsigned int importIndex;
+        char nameSuffix[30] = {0};
+
+        while( ( importIndex = nextImport++ ) < imports.size() ){
+            PrimitiveImport& primitiveImport = imports[importIndex];
+
+            primitiveImport.importStart = std::chrono::steady_clock::now();
+
+            sprintf( nameSuffix, "__%i_%i",
+                     primitiveImport.primitiveID.getCreatorID(),
+                     primitiveImport.primitiveID.getResourceIndex() );
+
+            try {
+                primitiveImport.primitive =
+                        importCache_.importPrimitive( primitiveImport.srcFilePath,
+                                                      getCategoryAbsoluteePath( primitiveImport.categoryID ),
+                                                      nameSuffix,
+                                                      nParsingThreads,
+                                                      primitiveImport.cached );
+            }catch( std::exception& ex ){
+                primitiveImport.errorMessage = ex.what();
+            }
+
+            primitiveImport.importEnd = std::chrono::steady_clock::now();
+        }
+    };
+
+    for( i = 0; i < nThreads; i++ ){
+        importThreads.create_thread( importThread );
+    }
+    importThreads.join_all();
 }
 
 
@@ -223,7 +349,8 @@ ResourceID ServerPrimitivesManager::registerCategory( std::string categoryName )
 
     // Add the appropriate category creation command to the commands historic.
     log_->debug( "\tAdding primitive category [", categoryName, "] to scene ...\n" );
-    commandsHistoric_->addCommand( CommandConstPtr( new PrimitiveCategoryCreationCommand( 0, categoryID, categoryName  ) ) );
+    creationCommands_.push_back(
+                commandsHistoric_->addCommand( CommandConstPtr( new PrimitiveCategoryCreationCommand( 0, categoryID, categoryName  ) ) ) );
     log_->debug( "\tAdding primitive category [", categoryName, "] to scene ...OK\n" );
 
     return categoryID;
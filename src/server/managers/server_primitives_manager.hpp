@@ -21,13 +21,35 @@
 
 #include <common/managers/primitives/abstract_primitives_manager.hpp>
 #include <common/ids/resource_id.hpp>
+#include <chrono>
 #include <string>
 #include <server/commands_historic.hpp>
 #include <common/ids/resource_ids_generator.hpp>
+#include "primitives_import_cache.hpp"
+#include <vector>
 
 
 namespace como {
 
+/*!
+ * Import of a local primitive at server startup. The import itself is
+ * performed by a worker thread, and its result is registered afterwards.
+ */
+struct PrimitiveImport
+{
+    std::string srcFilePath;
+    ResourceID categoryID;
+    ResourceID primitiveID;
+
+    PrimitiveInfo primitive;
+    bool cached;
+    std::string errorMessage;
+
+    // Wall-clock interval the primitive was imported in.
+    std::chrono::steady_clock::time_point importStart;
+    std::chrono::steady_clock::time_point importEnd;
+};
+
 class ServerPrimitivesManager : public AbstractPrimitivesManager
 {
     public:
@@ -54,6 +76,8 @@ class ServerPrimitivesManager : public AbstractPrimitivesManager
          * 3. Getters
          ***/
         std::list< PlainMaterialData > primitivePlainMaterialsData( const ResourceID& primitiveID );
+        const PackedCommandsList& creationCommands() const;
+        const std::list< PackableFile >& streamedFiles() const;
 
 
         /***
@@ -77,7 +101,8 @@ class ServerPrimitivesManager : public AbstractPrimitivesManager
         void createPrimitivesDir();
         void syncPrimitivesDir();
         ResourceID createCategory( std::string name );
-        void syncPrimitivesCategoryDir( std::string dirPath );
+        ResourceID syncPrimitivesCategoryDir( std::string dirPath, std::vector< PrimitiveImport >& imports );
+        void importPrimitives( std::vector< PrimitiveImport >& imports );
 
 
         /***
@@ -89,6 +114,16 @@ class ServerPrimitivesManager : public AbstractPrimitivesManager
     private:
         CommandsHistoricPtr commandsHistoric_;
         ResourceIDsGeneratorPtr resourceIDsGenerator_;
+
+        // Primitives converted in previous server runs.
+        PrimitivesImportCache importCache_;
+
+        // Categories and primitives creation commands, in the same order
+        // they were added to the commands historic.
+        PackedCommandsList creationCommands_;
+
+        // Primitives files streamed apart from their creation commands.
+        std::list< PackableFile > streamedFiles_;
 };
 
 } // namespace como
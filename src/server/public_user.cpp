@@ -33,20 +33,26 @@ PublicUser::PublicUser( UserID id, const char* name,
             CommandsHistoricPtr commandsHistoric,
             LogPtr log,
             std::uint32_t color,
-            const std::string& unpackingDirPath ) :
+            const std::string& unpackingDirPath,
+            PackedCommandsList snapshot,
+            std::uint32_t firstCommand,
+            std::uint8_t capabilities ) :
     User( id, name ),
     io_service_( io_service ),
     socket_( std::move( socket ) ),
     processSceneUpdatePacketCallback_( processSceneUpdatePacketCallback ),
     removeUserCallback_( removeUserCallback ),
-    nextCommand_( 0 ),
+    nextCommand_( firstCommand ),
     sceneUpdatePacketFromUser_( unpackingDirPath ),
-    outSceneUpdatePacketPacket_( unpackingDirPath ),
     commandsHistoric_( commandsHistoric ),
     log_( log ),
     updateRequested_( false ),
+    pendingSnapshotCommands_( std::move( snapshot ) ),
     color_( color )
 {
+    outSceneUpdatePacketPacket_.setCompressionEnabled( capabilities & COMPRESSION_CAPABILITY );
+    sceneUpdatePacketFromUser_.setCompressionEnabled( capabilities & COMPRESSION_CAPABILITY );
+
     readSceneUpdatePacket();
     requestUpdate();
 }
@@ -63,6 +69,13 @@ std::uint32_t PublicUser::getColor()
 }
 
 
+std::uint32_t PublicUser::getNextCommand()
+{
+    LOCK
+    return nextCommand_;
+}
+
+
 /***
  * 4. User synchronization
  ***/
@@ -93,7 +106,8 @@ void PublicUser::readSceneUpdatePacket()
 void PublicUser::addResponseCommand( CommandConstPtr responseCommand)
 {
     LOCK
-    pendingResponseCommands_.push( std::move( responseCommand ) );
+    pendingResponseCommands_.push(
+                std::make_shared< const PackedCommand >( *responseCommand, true ) );
     requestUpdate();
 }
 
@@ -106,7 +120,8 @@ bool PublicUser::needsSceneUpdatePacket() const
 {
     LOCK
     return ( nextCommand_ < commandsHistoric_->getSize() ) ||
-            ( pendingResponseCommands_.size() );
+            ( pendingResponseCommands_.size() ) ||
+            ( pendingSnapshotCommands_.size() );
 }
 
 
@@ -114,14 +129,19 @@ bool PublicUser::needsSceneUpdatePacket() const
  * 7. Handlers
  ***/
 
-void PublicUser::onReadSceneUpdatePacket( const boost::system::error_code& errorCode, PacketPtr packet )
+void PublicUser::onReadSceneUpdatePacket( const boost::system::error_code& errorCode, const Packet& )
 {
-    // Call to the processing callback in the server.
-    processSceneUpdatePacketCallback_( errorCode, getID(), *( std::dynamic_pointer_cast<const SceneUpdatePacket>( packet ) ) );
+    // Hand the received commands to the server and, unless there was an
+    // error, keep reading without waiting for them to be applied.
+    processSceneUpdatePacketCallback_( errorCode, getID(), sceneUpdatePacketFromUser_.takeCommands() );
+
+    if( !errorCode ){
+        readSceneUpdatePacket();
+    }
 }
 
 
-void PublicUser::onWriteSceneUpdatePacket( const boost::system::error_code& errorCode, PacketPtr packet )
+void PublicUser::onWriteSceneUpdatePacket( const boost::system::error_code& errorCode )
 {
     LOCK
 
@@ -136,7 +156,7 @@ void PublicUser::onWriteSceneUpdatePacket( const boost::system::error_code& erro
         log_->debug( "SCENE_UPDATE sent to user (",
                      getName(),
                      ") - commands(",
-                     dynamic_cast< const SceneUpdatePacket* >( packet.get() )->getCommands()->size(),
+                     outSceneUpdatePacketPacket_.nCommands(),
                      ") - nextCommand_(",
                      (int)nextCommand_, ")\n" );
 
@@ -159,22 +179,34 @@ void PublicUser::sendNextSceneUpdatePacket()
     // If there is any response command to be sent to the user, add it to the
     // scene update packet.
     while( pendingResponseCommands_.size() &&
-            ( outSceneUpdatePacketPacket_.getCommands()->size() < MAX_COMMANDS_PER_PACKET ) ){
+            outSceneUpdatePacketPacket_.fits( *( pendingResponseCommands_.front() ) ) ){
         outSceneUpdatePacketPacket_.addCommand( std::move( pendingResponseCommands_.front() ) );
         pendingResponseCommands_.pop();
     }
 
-    nextCommand_ = commandsHistoric_->fillSceneUpdatePacketPacket( outSceneUpdatePacketPacket_, nextCommand_, MAX_COMMANDS_PER_PACKET, getID() );
-    log_->debug( "Sending scene update - nextCommand: (", (int)nextCommand_, ")\n" );
+    // Send the scene snapshot before any command from the historic.
+    while( pendingSnapshotCommands_.size() &&
+            outSceneUpdatePacketPacket_.fits( *( pendingSnapshotCommands_.front() ) ) ){
+        outSceneUpdatePacketPacket_.addCommand( std::move( pendingSnapshotCommands_.front() ) );
+        pendingSnapshotCommands_.pop_front();
+    }
 
-    //outSceneUpdatePacketPacket_.addCommands( commandsHistoric, nextCommand_, MAX_COMMANDS_PER_PACKET );
+    if( pendingSnapshotCommands_.size() ){
+        outSceneUpdatePacketPacket_.setNUnsyncCommands( pendingSnapshotCommands_.size() +
+                                                        commandsHistoric_->getSize() -
+                                                        nextCommand_ );
+    }else{
+        nextCommand_ = commandsHistoric_->fillSceneUpdatePacketPacket( outSceneUpdatePacketPacket_, nextCommand_, getID() );
+    }
+    log_->debug( "Sending scene update - nextCommand: (", (int)nextCommand_, ")\n" );
 
     // Get the number of commands in the packet.
-    nCommandsInLastPacket_ = (std::uint8_t)( outSceneUpdatePacketPacket_.getCommands()->size() );
+    nCommandsInLastPacket_ = outSceneUpdatePacketPacket_.nCommands();
 
     if( nCommandsInLastPacket_ ){
-        // Pack the previous packet and send it to the client.
-        outSceneUpdatePacketPacket_.asyncSend( socket_, boost::bind( &PublicUser::onWriteSceneUpdatePacket, this, _1, _2 ) );
+        // Send the previous packet to the client. Its commands were already
+        // packed when they were added to the historic.
+        outSceneUpdatePacketPacket_.asyncSend( socket_, boost::bind( &PublicUser::onWriteSceneUpdatePacket, this, _1 ) );
     }else{
         // This can be executed, for example, when all pending commands in the
         // historic where sent by this user, so the server doesn't have to
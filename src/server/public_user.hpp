@@ -23,6 +23,7 @@
 #include <boost/bind.hpp>
 #include <functional>
 #include <common/packets/packets.hpp>
+#include <common/packets/packed_scene_update_packet.hpp>
 #include <common/utilities/log.hpp>
 #include <list>
 #include "commands_historic.hpp"
@@ -33,13 +34,11 @@
 
 namespace como {
 
-const unsigned int MAX_COMMANDS_PER_PACKET = 4;
-
 const unsigned int BUFFER_SIZE = 1024;
 
 typedef std::function< void (const boost::system::error_code& errorCode,
                              UserID userID,
-                             const SceneUpdatePacket& sceneUpdate) > ProcessSceneUpdatePacketCallback;
+                             CommandsList commands) > ProcessSceneUpdatePacketCallback;
 
 class PublicUser : public User, public Lockable
 {
@@ -53,11 +52,11 @@ class PublicUser : public User, public Lockable
         std::function<void (UserID)> removeUserCallback_;
 
         std::uint32_t nextCommand_;
-        std::uint8_t nCommandsInLastPacket_;
+        std::uint32_t nCommandsInLastPacket_;
         std::uint32_t lastCommandSent_;
 
         SceneUpdatePacket sceneUpdatePacketFromUser_;
-        SceneUpdatePacket outSceneUpdatePacketPacket_;
+        PackedSceneUpdatePacket outSceneUpdatePacketPacket_;
 
         CommandsHistoricPtr commandsHistoric_;
 
@@ -65,7 +64,11 @@ class PublicUser : public User, public Lockable
 
         bool updateRequested_;
 
-        std::queue< CommandConstPtr > pendingResponseCommands_; // TODO: Create and use a new ResponseCommand base class.
+        std::queue< PackedCommandConstPtr > pendingResponseCommands_; // TODO: Create and use a new ResponseCommand base class.
+
+        // Snapshot of the scene taken when the user joined it. Its commands
+        // are sent before the historic ones from nextCommand_ onwards.
+        PackedCommandsList pendingSnapshotCommands_;
 
         std::uint32_t color_;
 
@@ -84,7 +87,10 @@ class PublicUser : public User, public Lockable
                     CommandsHistoricPtr commandsHistoric,
                     LogPtr log,
                     std::uint32_t color,
-                    const std::string& unpackingDirPath );
+                    const std::string& unpackingDirPath,
+                    PackedCommandsList snapshot,
+                    std::uint32_t firstCommand,
+                    std::uint8_t capabilities );
 
 
         /***
@@ -97,6 +103,7 @@ class PublicUser : public User, public Lockable
          * 3. Getters
          ***/
         std::uint32_t getColor();
+        std::uint32_t getNextCommand();
 
 
         /***
@@ -122,8 +129,8 @@ class PublicUser : public User, public Lockable
         /***
          * 7. Handlers
          ***/
-        void onReadSceneUpdatePacket( const boost::system::error_code& errorCode, PacketPtr packet );
-        void onWriteSceneUpdatePacket( const boost::system::error_code& errorCode, PacketPtr packet );
+        void onReadSceneUpdatePacket( const boost::system::error_code& errorCode, const Packet& packet );
+        void onWriteSceneUpdatePacket( const boost::system::error_code& errorCode );
 
 
         /***
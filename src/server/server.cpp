@@ -18,6 +18,7 @@
 
 #include "server.hpp"
 #include <memory>
+#include <algorithm>
 
 namespace como {
 
@@ -34,17 +35,24 @@ Server::Server( unsigned int port_, unsigned int maxSessions, const char* sceneN
     work_( *io_service_ ),
     N_THREADS( nThreads ),
     MAX_SESSIONS( maxSessions ),
-    newSocket_( *io_service_ ),
+    nPendingConnections_( 0 ),
     port_( port_ ),
-    commandsHistoric_( new CommandsHistoric( std::bind( &Server::broadcast, this ) ) ),
-    scene_( sceneName, commandsHistoric_, users_, resourceIDsGenerator_, log_, sceneFilePath )
+    commandsHistoric_( new CommandsHistoric ),
+    scene_( sceneName, commandsHistoric_, users_, resourceIDsGenerator_, log_, sceneFilePath ),
+    fileWriter_( new FileWriter( log_ ) )
 {
     unsigned int i;
 
+    // Write the files received from users in their own thread.
+    PackableFile::setFileWriter( fileWriter_ );
+
     // Create the threads pool.
     for( i=0; i<N_THREADS; i++ ){
         threads_.create_thread( boost::bind( &Server::workerThread, this ) );
     }
+
+    // Create the thread which applies the scene updates.
+    sceneThread_ = boost::thread( boost::bind( &Server::sceneThread, this ) );
 }
 
 
@@ -144,12 +152,6 @@ void Server::disconnect()
 
         boost::system::error_code errorCode;
 
-        // Close the server's socket used for accepting new connections.
-        if( newSocket_.is_open() ){
-            newSocket_.shutdown( boost::asio::ip::tcp::socket::shutdown_both, errorCode );
-            newSocket_.close( errorCode );
-        }
-
         // Free the server's TCP acceptor.
         acceptor_.close( errorCode );
 
@@ -159,6 +161,15 @@ void Server::disconnect()
 
     // Wait for the server's threads to finish.
     threads_.join_all();
+
+    // Write the pending files, so every scene update is released.
+    fileWriter_->flush();
+    PackableFile::setFileWriter( nullptr );
+
+    // Let the scene thread apply the pending scene updates and wait for it
+    // to finish.
+    sceneUpdates_.close();
+    sceneThread_.join();
 }
 
 
@@ -168,14 +179,27 @@ void Server::disconnect()
 
 void Server::broadcast()
 {
-    LOCK
-
     log_->debug( "Server - broadcasting\n" );
     UsersMap::iterator user;
 
-    for( user = users_.begin(); user != users_.end(); user++ ){
-        user->second->requestUpdate();
+    std::uint32_t firstUnsentCommand = commandsHistoric_->getSize();
+
+    {
+        LOCK
+
+        for( user = users_.begin(); user != users_.end(); user++ ){
+            user->second->requestUpdate();
+
+            firstUnsentCommand = std::min( firstUnsentCommand,
+                                           user->second->getNextCommand() );
+        }
     }
+
+    // New users are synchronized from a snapshot of the scene, so the
+    // commands already sent to every user can be discarded. The historic
+    // has its own lock, and the users joining meanwhile start from a
+    // snapshot taken at its current end.
+    commandsHistoric_->discardCommandsBefore( firstUnsentCommand );
 }
 
 
@@ -211,7 +235,10 @@ void Server::listen()
     log_->debug( "Listening on port (", port_, ")\n" );
 
     // Wait for a new user connection.
-    acceptor_.async_accept( newSocket_, boost::bind( &Server::onAccept, this, _1 ) );
+    PendingConnectionPtr pendingConnection =
+            std::make_shared< PendingConnection >( *io_service_ );
+    acceptor_.async_accept( pendingConnection->socket,
+                            boost::bind( &Server::onAccept, this, _1, pendingConnection ) );
 }
 
 
@@ -219,123 +246,277 @@ void Server::listen()
  * 9. Handlers
  ***/
 
-void Server::onAccept( const boost::system::error_code& errorCode )
+void Server::onAccept( const boost::system::error_code& errorCode,
+                       PendingConnectionPtr pendingConnection )
 {
     LOCK
 
     boost::system::error_code closingErrorCode;
 
-    como::NewUserPacket newUserPacket;
-    como::UserAcceptancePacket userAcceptedPacket;
-    char buffer[128];
+    if( errorCode ){
+        log_->error( "[", boost::this_thread::get_id(), "]: ERROR(", errorCode.message(), ")\n" );
+
+        // Keep accepting connections, unless the acceptor was closed.
+        if( ( errorCode != boost::asio::error::operation_aborted ) && acceptor_.is_open() ){
+            listen();
+        }
+        return;
+    }
+
+    // Connection established. Wait asynchronously (and for a limited time)
+    // for a NEW_USER package.
+    log_->debug( "New user (", boost::this_thread::get_id(), "): Connecting!\n" );
+    nPendingConnections_++;
 
-    std::uint32_t userColor = 0;
+    pendingConnection->timer.expires_from_now( boost::posix_time::seconds( HANDSHAKE_TIMEOUT ) );
+    pendingConnection->timer.async_wait(
+                boost::bind( &Server::onHandshakeTimeout, this, _1, pendingConnection ) );
+
+    pendingConnection->newUserPacket.asyncRecv(
+                pendingConnection->socket,
+                std::bind( &Server::onNewUserPacket, this, std::placeholders::_1, pendingConnection ) );
+
+    // Don't wait for the handshake to complete before accepting new
+    // connections.
+    if( getNSessions() < MAX_SESSIONS ){
+        // There is room for more users, wait for a new connection.
+        listen();
+    }else{
+        // There isn't room for more users, close the acceptor.
+        acceptor_.close( closingErrorCode );
+
+        log_->debug( "Server is full (MAX_SESSIONS: ", MAX_SESSIONS, ")\n" );
+    }
+}
+
+
+void Server::onNewUserPacket( const boost::system::error_code& errorCode,
+                              PendingConnectionPtr pendingConnection )
+{
+    LOCK
+
+    const NewUserPacket& newUserPacket = pendingConnection->newUserPacket;
+    UserAcceptancePacket& userAcceptedPacket = pendingConnection->userAcceptedPacket;
+    char buffer[128];
 
     if( errorCode ){
-        log_->error( "[", boost::this_thread::get_id(), "]: ERROR(", errorCode.message(), ")\n" );
+        log_->error( "ERROR receiving NEW_USER packet: ", errorCode.message(), "\n" );
+        closePendingConnection( pendingConnection );
+        return;
+    }
+
+    // All the commands in the session are packed with the same float
+    // encoding, so reject the users which don't support it.
+    if( !( newUserPacket.getFloatEncodings() & floatEncodingBit( getFloatEncoding() ) ) ){
+        log_->error( "User [", newUserPacket.getName(), "] rejected: float encoding (",
+                     static_cast< int >( getFloatEncoding() ), ") not supported\n" );
+        closePendingConnection( pendingConnection );
+        return;
+    }
+
+    log_->debug( "User [", newUserPacket.getName(), "] (", boost::this_thread::get_id(), "): Connected!\n" );
+
+    /*** Prepare an USER_ACCEPTED package in respond to the previous NEW_USER one ***/
+
+    const UserID newUserID = scene_.generateUserID();
+
+    // Assign a id to the new user.
+    userAcceptedPacket.setId( newUserID );
+
+    // Check if the new user's name is already in use in the server. If
+    // yes, concatenate the string (<id>) to it.
+    if( !nameInUse( newUserPacket.getName() ) ){
+        userAcceptedPacket.setName( newUserPacket.getName() );
     }else{
-        // Connection established. Wait synchronously for a NEW_USER package.
-        log_->debug( "New user (", boost::this_thread::get_id(), "): Connecting!\n" );
-        newUserPacket.recv( newSocket_ );
-        log_->debug( "User [", newUserPacket.getName(), "] (", boost::this_thread::get_id(), "): Connected!\n" );
+        sprintf( buffer, "%s (%d)", newUserPacket.getName(), newUserID );
+        userAcceptedPacket.setName( buffer );
+    }
 
-        /*** Prepare an USER_ACCEPTED package in respond to the previous NEW_USER one ***/
+    // Reserve the name until the handshake finishes, so no other pending
+    // connection takes it meanwhile.
+    pendingUserNames_.insert( userAcceptedPacket.getName() );
+
+    // Send the scene name and the float encoding used in the session within
+    // the UserAcceptancePacket.
+    userAcceptedPacket.setSceneName( scene_.getName().c_str() );
+    userAcceptedPacket.setFloatEncoding( getFloatEncoding() );
+
+    // Enable the optional capabilities supported by both the user and the
+    // server.
+    userAcceptedPacket.setCapabilities( newUserPacket.getCapabilities() & SUPPORTED_CAPABILITIES );
+
+    // Get a color from the queue of free colors and assign it to the new
+    // user.
+    pendingConnection->userColor = freeUserColors_.front();
+    freeUserColors_.pop();
+
+    userAcceptedPacket.setSelectionColor( ( pendingConnection->userColor & 0xFF0000 ) >> 16,
+                                          ( pendingConnection->userColor & 0xFF00 ) >> 8,
+                                          pendingConnection->userColor & 0xFF,
+                                          0xFF );
+
+    // Pack the network package and send it asynchronously to the client.
+    userAcceptedPacket.asyncSend(
+                pendingConnection->socket,
+                std::bind( &Server::onUserAcceptedPacket, this, std::placeholders::_1, pendingConnection ) );
+}
 
-        const UserID newUserID = scene_.generateUserID();
 
-        // Assign a id to the new user.
-        userAcceptedPacket.setId( newUserID );
+void Server::onUserAcceptedPacket( const boost::system::error_code& errorCode,
+                                   PendingConnectionPtr pendingConnection )
+{
+    LOCK
 
-        // Check if the new user's name is already in use in the server. If
-        // yes, concatenate the string (<id>) to it.
-        if( !nameInUse( newUserPacket.getName() ) ){
-            userAcceptedPacket.setName( newUserPacket.getName() );
-        }else{
-            sprintf( buffer, "%s (%d)", newUserPacket.getName(), newUserID );
-            userAcceptedPacket.setName( buffer );
-        }
+    const UserAcceptancePacket& userAcceptedPacket = pendingConnection->userAcceptedPacket;
+    const UserID newUserID = userAcceptedPacket.getId();
 
-        // Send the scene name within the UserAcceptancePacket.
-        userAcceptedPacket.setSceneName( scene_.getName().c_str() );
-
-        // Get a color from the queue of free colors and assign it to the new
-        // user.
-        userColor = freeUserColors_.front();
-        freeUserColors_.pop();
-
-        userAcceptedPacket.setSelectionColor( ( userColor & 0xFF0000 ) >> 16,
-                                              ( userColor & 0xFF00 ) >> 8,
-                                              userColor & 0xFF,
-                                              0xFF );
-
-        // Pack the network package and send it synchronously to the client.
-        userAcceptedPacket.send( newSocket_ );
-
-        // Add the new user to the users map.
-        users_[newUserID] =
-                std::make_shared<PublicUser>(
-                        newUserID,
-                        userAcceptedPacket.getName(),
-                        io_service_,
-                        std::move( newSocket_ ),
-                        std::bind( &Server::processSceneUpdatePacket, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3 ),
-                        std::bind( &Server::deleteUser, this, std::placeholders::_1 ),
-                        commandsHistoric_,
-                        log_,
-                        userColor,
-                        scene_.getTempDirPath()
-                    );
-
-        // Add an USER_CONNECTION scene command to the server historic.
-        addCommand( CommandConstPtr( new UserConnectionCommand( userAcceptedPacket ) ) );
-
-        if( users_.size() < MAX_SESSIONS ){
-            // There is room for more users, wait for a new connection.
-            listen();
-        }else{
-            // There isn't room for more users, close the acceptor.
-            acceptor_.close( closingErrorCode );
-            //acceptor_.cancel();
+    // The name is either released or taken by the new user below.
+    pendingUserNames_.erase( userAcceptedPacket.getName() );
 
-            log_->debug( "Server is full (MAX_SESSIONS: ", MAX_SESSIONS, ")\n" );
-        }
+    if( errorCode ){
+        log_->error( "ERROR sending USER_ACCEPTED packet: ", errorCode.message(), "\n" );
+        freeUserColors_.push( pendingConnection->userColor );
+        closePendingConnection( pendingConnection );
+        return;
     }
+
+    // The handshake is complete.
+    pendingConnection->completed = true;
+    pendingConnection->timer.cancel();
+    nPendingConnections_--;
+
+    // Take a snapshot of the current scene. The new user will be
+    // synchronized with it and with the historic commands added after
+    // it was taken. Files the user already has aren't sent again.
+    PackedCommandsList snapshot;
+    const std::uint32_t firstCommand =
+            scene_.generateSnapshot( snapshot,
+                                     pendingConnection->newUserPacket.getKnownBlobs() );
+
+    // Add the new user to the users map.
+    users_[newUserID] =
+            std::make_shared<PublicUser>(
+                    newUserID,
+                    userAcceptedPacket.getName(),
+                    io_service_,
+                    std::move( pendingConnection->socket ),
+                    std::bind( &Server::processSceneUpdatePacket, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3 ),
+                    std::bind( &Server::removeUser, this, std::placeholders::_1 ),
+                    commandsHistoric_,
+                    log_,
+                    pendingConnection->userColor,
+                    scene_.getTempDirPath(),
+                    std::move( snapshot ),
+                    firstCommand,
+                    userAcceptedPacket.getCapabilities()
+                );
+
+    // Add an USER_CONNECTION scene command to the server historic.
+    addCommand( CommandConstPtr( new UserConnectionCommand( userAcceptedPacket ) ) );
+    broadcast();
 }
 
 
-void Server::processSceneUpdatePacket( const boost::system::error_code& errorCode,
-                                 UserID userID,
-                                 const SceneUpdatePacket& sceneUpdate )
+void Server::onHandshakeTimeout( const boost::system::error_code& errorCode,
+                                 PendingConnectionPtr pendingConnection )
 {
     LOCK
 
-    const CommandsList* commands = nullptr;
+    boost::system::error_code shutdownErrorCode;
 
+    // The timer was cancelled or the handshake already finished.
+    if( errorCode == boost::asio::error::operation_aborted ||
+            pendingConnection->completed ){
+        return;
+    }
+
+    log_->error( "Handshake timeout (", HANDSHAKE_TIMEOUT, " seconds) expired\n" );
+
+    // Shut down the socket so the pending operation of the handshake
+    // completes with an error. The socket itself is closed by the
+    // handler of that operation.
+    pendingConnection->socket.shutdown( boost::asio::ip::tcp::socket::shutdown_both, shutdownErrorCode );
+}
+
+
+void Server::processSceneUpdatePacket( const boost::system::error_code& errorCode,
+                                 UserID userID,
+                                 CommandsList commands )
+{
+    // This is called from the I/O threads, so don't take the server's lock
+    // here. Just queue the commands for the scene thread.
     if( errorCode ){
-        log_->error( "ERROR reading SCENE_UPDATE packet from [", users_.at(userID)->getName(), "] : ", errorCode.message(), "\n" );
-        deleteUser( userID );
+        log_->error( "ERROR reading SCENE_UPDATE packet from user (", userID, ") : ", errorCode.message(), "\n" );
+        removeUser( userID );
     }else{
-        // Get the commands from the packet.
-        commands = sceneUpdate.getCommands();
+        log_->debug( "SCENE_UPDATE received from user (", userID, ") with (", commands.size(), ") commands\n" );
+        pushSceneUpdate( SceneUpdate{ userID, std::move( commands ), false } );
+    }
+}
 
-        log_->debug( "SCENE_UPDATE received from [", users_.at( userID )->getName(), "] with (", commands->size(), ") commands\n" );
 
-        // Process and add the commands to the historic.
-        for( const auto& command : *commands ){
-            processSceneCommand( *command );
+void Server::pushSceneUpdate( SceneUpdate sceneUpdate )
+{
+    std::lock_guard< std::mutex > lock( heldSceneUpdatesMutex_ );
+
+    const UserID userID = sceneUpdate.userID;
+
+    // An update is held back if it references a file still being written,
+    // or if a previous update from the same user is held (so the user's
+    // updates keep their order). Any other update goes straight to the
+    // scene thread.
+    bool hold = ( nHeldSceneUpdates_.count( userID ) != 0 );
+    for( const auto& command : sceneUpdate.commands ){
+        if( hold ){
+            break;
         }
 
-        //broadcastCallback_();
-        users_.at( userID )->readSceneUpdatePacket();
+        const PackableFile* file = command->getFile();
+        hold = ( file != nullptr ) &&
+                fileWriter_->isBeingWritten( file->getFilePath() );
     }
+
+    if( !hold ){
+        sceneUpdates_.push( std::move( sceneUpdate ) );
+        return;
+    }
+
+    // The file writer performs its tasks in FIFO order, so this update is
+    // released once the files it depends on (and the previous held updates
+    // from the same user) have been written.
+    const std::shared_ptr< SceneUpdate > sharedSceneUpdate(
+                new SceneUpdate( std::move( sceneUpdate ) ) );
+
+    nHeldSceneUpdates_[userID]++;
+    fileWriter_->addTask( [this, sharedSceneUpdate, userID](){
+        std::lock_guard< std::mutex > lock( heldSceneUpdatesMutex_ );
+
+        sceneUpdates_.push( std::move( *sharedSceneUpdate ) );
+        if( !--nHeldSceneUpdates_[userID] ){
+            nHeldSceneUpdates_.erase( userID );
+        }
+    });
 }
 
-void Server::processSceneCommand( const Command& sceneCommand )
+
+void Server::applySceneUpdate( const SceneUpdate& sceneUpdate )
 {
     LOCK
 
-    // This includes inserting the command into the historic.
-    scene_.processCommand( sceneCommand );
+    // Ignore the updates from users already deleted (a packet could be
+    // received from a user after an error writing to it).
+    if( !users_.count( sceneUpdate.userID ) ){
+        return;
+    }
+
+    if( sceneUpdate.userDisconnection ){
+        deleteUser( sceneUpdate.userID );
+    }else{
+        // This includes inserting the commands into the historic.
+        for( const auto& command : sceneUpdate.commands ){
+            scene_.processCommand( *command );
+        }
+    }
 }
 
 
@@ -367,7 +548,15 @@ bool Server::nameInUse( const char* newName ) const
         }
     }
 
-    return false;
+    return pendingUserNames_.count( newName ) != 0;
+}
+
+
+void Server::removeUser( UserID id )
+{
+    // The user is deleted by the scene thread, after applying the updates
+    // already received from it.
+    pushSceneUpdate( SceneUpdate{ id, CommandsList(), true } );
 }
 
 
@@ -389,8 +578,39 @@ void Server::deleteUser( UserID id )
     // disconnection.
     addCommand( CommandConstPtr( new UserDisconnectionCommand( id ) ) );
 
-    if( users_.size() == (MAX_SESSIONS - 1) ){
-        // If the server was full before this user got out, that means the acceptor wasn't
+    onSessionClosed();
+}
+
+
+unsigned int Server::getNSessions() const
+{
+    LOCK
+
+    return users_.size() + nPendingConnections_;
+}
+
+
+void Server::closePendingConnection( PendingConnectionPtr pendingConnection )
+{
+    LOCK
+
+    boost::system::error_code closingErrorCode;
+
+    pendingConnection->completed = true;
+    pendingConnection->timer.cancel();
+    pendingConnection->socket.close( closingErrorCode );
+    nPendingConnections_--;
+
+    onSessionClosed();
+}
+
+
+void Server::onSessionClosed()
+{
+    LOCK
+
+    if( getNSessions() == (MAX_SESSIONS - 1) ){
+        // If the server was full before this session got out, that means the acceptor wasn't
         // listening for new connections. Start listening now that there is room again.
         openAcceptor();
         listen();
@@ -422,4 +642,32 @@ void Server::workerThread()
     log_->debug( "[", boost::this_thread::get_id(), "] thread end\n" );
 }
 
+
+void Server::sceneThread()
+{
+    SceneUpdate sceneUpdate;
+
+    log_->debug( "[", boost::this_thread::get_id(), "] scene thread start\n" );
+
+    while( sceneUpdates_.waitPop( sceneUpdate ) ){
+        // Apply every scene update already queued before broadcasting, so
+        // the users are notified once per batch. The server's lock is only
+        // taken for applying each update (the commands processing looks up
+        // the users), so the I/O threads aren't stalled by a long batch.
+        do {
+            try{
+                applySceneUpdate( sceneUpdate );
+            }catch( std::exception& ex ){
+                log_->error( "Error applying scene update from user (",
+                             sceneUpdate.userID, "): ",
+                             ex.what(), "\n" );
+            }
+        }while( sceneUpdates_.tryPop( sceneUpdate ) );
+
+        broadcast();
+    }
+
+    log_->debug( "[", boost::this_thread::get_id(), "] scene thread end\n" );
+}
+
 } // namespace como
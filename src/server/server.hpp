@@ -30,11 +30,14 @@
 #include "commands_historic.hpp"
 #include <map>
 #include <queue>
+#include <set>
 #include <server/managers/server_primitives_manager.hpp>
 #include <common/scene/basic_scene.hpp>
 #include <server/managers/scene.hpp>
 #include <common/ids/resource_ids_generator.hpp>
 #include <common/utilities/lockable.hpp>
+#include <common/utilities/mpsc_queue.hpp>
+#include <common/utilities/file_writer.hpp>
 
 using boost::asio::ip::tcp;
 
@@ -42,6 +45,46 @@ namespace como {
 
 typedef std::map< ResourceID, UserID > DrawableOwners;
 
+// Maximum time (seconds) a new connection has for completing the
+// NEW_USER / USER_ACCEPTED handshake.
+const long HANDSHAKE_TIMEOUT = 10;
+
+/*!
+ * Connection accepted by the server which hasn't completed the
+ * NEW_USER / USER_ACCEPTED handshake yet.
+ */
+struct PendingConnection
+{
+    PendingConnection( boost::asio::io_service& io_service ) :
+        socket( io_service ),
+        timer( io_service ),
+        userColor( 0 ),
+        completed( false )
+    {}
+
+    Socket socket;
+    boost::asio::deadline_timer timer;
+    NewUserPacket newUserPacket;
+    UserAcceptancePacket userAcceptedPacket;
+    std::uint32_t userColor;
+
+    // The handshake has finished (successfully or not), so the timeout
+    // must be ignored.
+    bool completed;
+};
+typedef std::shared_ptr< PendingConnection > PendingConnectionPtr;
+
+/*!
+ * Work unit for the scene thread: the commands received from a user or,
+ * if userDisconnection is true, the disconnection of that user.
+ */
+struct SceneUpdate
+{
+    UserID userID;
+    CommandsList commands;
+    bool userDisconnection;
+};
+
 /*! Main server manager */
 class Server : public Lockable
 {
@@ -111,23 +154,45 @@ class Server : public Lockable
         /***
          * 9. Handlers
          ***/
-        /*! \brief Handler for a new connection */
-        void onAccept( const boost::system::error_code& errorCode );
-
-        /*! \brief Process a SCENE_UPDATE packet received from client
+        /*! \brief Handler for a new connection. Starts the handshake with the
+         * new user and goes back to listening. */
+        void onAccept( const boost::system::error_code& errorCode,
+                       PendingConnectionPtr pendingConnection );
+
+        /*! \brief Handler for the NEW_USER packet of a pending connection */
+        void onNewUserPacket( const boost::system::error_code& errorCode,
+                              PendingConnectionPtr pendingConnection );
+
+        /*! \brief Handler for the USER_ACCEPTED packet sent to a pending
+         * connection. Completes the handshake by creating the new user. */
+        void onUserAcceptedPacket( const boost::system::error_code& errorCode,
+                                   PendingConnectionPtr pendingConnection );
+
+        /*! \brief Handler for the timeout of a pending connection. */
+        void onHandshakeTimeout( const boost::system::error_code& errorCode,
+                                 PendingConnectionPtr pendingConnection );
+
+        /*! \brief Process a SCENE_UPDATE packet received from client by
+         * queueing its commands for the scene thread.
          * \param errorCode Error code associated with the packet reception.
          * \param userID ID of the user who sent the packet.
-         * \param sceneUpdate SCENE_UPDATE packet received from client.
+         * \param commands commands in the SCENE_UPDATE packet.
         */
         void processSceneUpdatePacket( const boost::system::error_code& errorCode,
                                  UserID userID,
-                                 const SceneUpdatePacket& sceneUpdate );
+                                 CommandsList commands );
 
-        /*! \brief Process a scene command.
-         * \param userID ID of the user who sent the command.
-         * \param sceneCommand Scene command.
+        /*! \brief Queue a scene update for the scene thread. Updates
+         * referencing files still being written (and the following updates
+         * from the same user) are held until those files are written.
+         * \param sceneUpdate Scene update to be queued.
          */
-        void processSceneCommand( const Command& sceneCommand );
+        void pushSceneUpdate( SceneUpdate sceneUpdate );
+
+        /*! \brief Apply a scene update in the scene thread.
+         * \param sceneUpdate Scene update popped from the queue.
+         */
+        void applySceneUpdate( const SceneUpdate& sceneUpdate );
 
 
         /***
@@ -140,7 +205,13 @@ class Server : public Lockable
         /***
          * 11. Users management
          ***/
+        /*! \brief Returns true if the given name is taken by a user or
+         * reserved by a pending connection. */
         bool nameInUse( const char* newName ) const;
+        unsigned int getNSessions() const;
+        void closePendingConnection( PendingConnectionPtr pendingConnection );
+        void onSessionClosed();
+        void removeUser( UserID id );
         void deleteUser( UserID id );
 
 
@@ -148,6 +219,7 @@ class Server : public Lockable
          * 12. Auxiliar methods
          ***/
         void workerThread();
+        void sceneThread();
 
 
     private:
@@ -167,6 +239,10 @@ class Server : public Lockable
         // Users map (ID, user).
         UsersMap users_;
 
+        // Names reserved by the pending connections which have been sent
+        // an USER_ACCEPTED packet.
+        std::set< std::string > pendingUserNames_;
+
         // Number of worker threads in the server.
         const unsigned int N_THREADS;
 
@@ -176,8 +252,8 @@ class Server : public Lockable
         // Threads pool
         boost::thread_group threads_;
 
-        // New socket
-        Socket newSocket_;
+        // Number of connections which haven't completed the handshake yet.
+        unsigned int nPendingConnections_;
 
         // Server's port.
         unsigned int port_;
@@ -189,6 +265,23 @@ class Server : public Lockable
         CommandsHistoricPtr commandsHistoric_;
 
         Scene scene_;
+
+        // Scene updates received from users, to be applied by the scene
+        // thread.
+        MPSCQueue< SceneUpdate > sceneUpdates_;
+
+        // Writer of the files received from users. Scene updates are
+        // released to the scene thread only once the files they depend on
+        // have been written.
+        FileWriterPtr fileWriter_;
+
+        // Number of scene updates held in the file writer for each user.
+        std::map< UserID, unsigned int > nHeldSceneUpdates_;
+        std::mutex heldSceneUpdatesMutex_;
+
+        // Thread applying the scene updates. It is the only one modifying
+        // the scene after its initialization.
+        boost::thread sceneThread_;
 };
 
 } // namespace como